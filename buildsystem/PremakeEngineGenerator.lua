@@ -135,7 +135,31 @@ function exeliusGenerator.GenerateEditorProject()
         }
 end
 
-function exeliusGenerator.LinkEngineToProject()
+-- Generates a console app that sits next to the engine, with its sources under <folder>/source/.
+function exeliusGenerator.GenerateToolProject(name, folder)
+    project(folder)
+        defaultSettings.SetGlobalProjectDefaultSettings()
+
+        local toolPath = os.realpath("../" .. folder)
+        log.Log("[Premake] Generating " .. name .. " at Path: " .. toolPath)
+
+        location(toolPath)
+        kind("ConsoleApp")
+
+        files
+        {
+            "../%{prj.name}/source/**.h",
+            "../%{prj.name}/source/**.cpp"
+        }
+
+        includedirs
+        {
+            "../%{prj.name}/source/"
+        }
+end
+
+-- Links the engine without copying the config and assets, for tools that don't run the engine.
+function exeliusGenerator.LinkEngineToTool()
     local engineIncludePath = os.realpath("../" .. defaultSettings.engineProjectName)
 
     -- Use a relative path here only because it logs nicer. Totally unnessesary.
@@ -151,6 +175,10 @@ function exeliusGenerator.LinkEngineToProject()
     {
         engineIncludePath
     }
+end
+
+function exeliusGenerator.LinkEngineToProject()
+    exeliusGenerator.LinkEngineToTool()
 
     SetWindowsPostBuildCommands()
     SetLinuxPostBuildCommands()
@@ -1,4 +1,5 @@
 local log = require("PremakeConsoleLog")
+local defaultSettings = require("PremakeSettings")
 local engineGenerator = require("PremakeEngineGenerator")
 local dependencyGenerator = require("PremakeDependancyGenerator")
 
@@ -74,4 +75,25 @@ engineGenerator.LinkEngineToProject()
 dependencyGenerator.LinkDependencies()
 log.Info("[Premake] ExeliusEditor Project Created.")
 
+log.Log("[Premake] Creating ExeliusBenchmarks Project.")
+engineGenerator.GenerateToolProject("Benchmarks", defaultSettings.exeliusBenchmarksName)
+dependencyGenerator.IncludeDependencies()
+engineGenerator.LinkEngineToTool()
+dependencyGenerator.LinkDependencies()
+log.Info("[Premake] ExeliusBenchmarks Project Created.")
+
+log.Log("[Premake] Creating ExeliusCooker Project.")
+engineGenerator.GenerateToolProject("Asset Cooker", defaultSettings.exeliusCookerName)
+dependencyGenerator.IncludeDependencies()
+engineGenerator.LinkEngineToTool()
+dependencyGenerator.LinkDependencies()
+log.Info("[Premake] ExeliusCooker Project Created.")
+
+log.Log("[Premake] Creating ExeliusPacker Project.")
+engineGenerator.GenerateToolProject("Asset Packer", defaultSettings.exeliusPackerName)
+dependencyGenerator.IncludeDependencies()
+engineGenerator.LinkEngineToTool()
+dependencyGenerator.LinkDependencies()
+log.Info("[Premake] ExeliusPacker Project Created.")
+
 log.Info("[Premake] Engine Generation Complete!")
\ No newline at end of file
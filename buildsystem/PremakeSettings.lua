@@ -5,6 +5,9 @@ local exeliusDefaultSettings = premake.modules.exeliusDefaultSettingsClass
 exeliusDefaultSettings.workspaceName = "exeliusengine"
 exeliusDefaultSettings.engineProjectName = "exelius"
 exeliusDefaultSettings.exeliusEditorName = "exeliuseditor"
+exeliusDefaultSettings.exeliusBenchmarksName = "exeliusbenchmarks"
+exeliusDefaultSettings.exeliusCookerName = "exeliuscooker"
+exeliusDefaultSettings.exeliusPackerName = "exeliuspacker"
 exeliusDefaultSettings.startProjectName = exeliusDefaultSettings.exeliusEditorName
 
 exeliusDefaultSettings.precompiledHeader = "EXEPCH.h"
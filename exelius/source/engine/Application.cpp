@@ -4,6 +4,8 @@
 
 #include "source/engine/settings/ConfigFile.h"
 
+#include "source/engine/framegraph/FrameGraph.h"
+
 #include "source/engine/resources/ExeliusResourceFactory.h"
 
 #include "source/engine/gameobjectsystem/GameObjectSystem.h"
@@ -70,6 +72,7 @@ namespace Exelius
 		, m_pResourceFactory(nullptr)
 		, m_pComponentFactory(nullptr)
 		, m_pMessageFactory(nullptr)
+		, m_pFrameGraph(nullptr)
 		, m_lastFrameTime(0.0f)
 		, m_isRunning(true)
 		, m_hasLostFocus(false)
@@ -79,6 +82,16 @@ namespace Exelius
 
 	Application::~Application()
 	{
+		EXELIUS_DELETE(m_pFrameGraph);
+
+		// The resource I/O threads push decode jobs, so they have to stop first.
+		if (ResourceLoader::GetInstance())
+			ResourceLoader::GetInstance()->StopIOThreads();
+
+		// Finish all outstanding work and join the workers before any system a job could be using goes away.
+		if (s_pGlobalJobSystem)
+			s_pGlobalJobSystem->Shutdown();
+
 		GameObjectSystem::DestroySingleton();
 
 		EXELIUS_DELETE(m_pComponentFactory);
@@ -167,9 +180,8 @@ namespace Exelius
 		// Job System - Initialization
 		//-----------------------------------------------
 
-		if (!s_pGlobalJobSystem)
-			s_pGlobalJobSystem = EXELIUS_NEW(JobSystem());
-		s_pGlobalJobSystem->Initialize();
+		if (!InitializeJobSystem(configFile))
+			return false;
 
 		//-----------------------------------------------
 		// Networking System - Initialization
@@ -230,6 +242,13 @@ namespace Exelius
 		if (!InitializeGameObjectSystem(configFile))
 			return false;
 
+		//-----------------------------------------------
+		// Frame Graph - Initialization
+		//-----------------------------------------------
+
+		if (!InitializeFrameGraph(configFile))
+			return false;
+
 		//-----------------------------------------------
 		// Client Application - Initialization
 		//-----------------------------------------------
@@ -244,6 +263,7 @@ namespace Exelius
 	void Application::Run()
 	{
 		EXE_ASSERT(m_pApplicationLog);
+		EXE_ASSERT(m_pFrameGraph);
 
 		constexpr int kNumFramesToAVG = 6000;
 		int numFramesSinceAVG = 0;
@@ -271,29 +291,8 @@ namespace Exelius
 				accumulatedDeltaTime = 0.0f;
 			}
 
-			// Dispatch Messages
-			MessageServer::GetInstance()->DispatchMessages();
-
-			// Poll Window Events.
-			RenderManager::GetInstance()->Update();
-
-			// Update Components.
-			GameObjectSystem::GetInstance()->Update();
-
-			// Client Update.
-			Update();
-
-			// Refresh Input State.
-			InputManager::GetInstance()->NextFrame();
-
-			// Queue all renderable Components.
-			GameObjectSystem::GetInstance()->Render();
-
-			// Push render list to render thread.
-			RenderManager::GetInstance()->EndRenderFrame();
-
-			// Deallocate any resources necessary.
-			ResourceLoader::GetInstance()->ProcessUnloadQueue();
+			// Run every phase of the frame. @see InitializeFrameGraph().
+			m_pFrameGraph->Execute();
 		}
 	}
 
@@ -402,6 +401,33 @@ namespace Exelius
 		return true;
 	}
 
+	/// <summary>
+	/// Initialize the JobSystem using the config file data if necessary.
+	/// </summary>
+	/// <param name="configFile">- The pre-parsed config file.</param>
+	/// <returns>True on success, false otherwise.</returns>
+	bool Application::InitializeJobSystem(const ConfigFile& configFile) const
+	{
+		EXE_ASSERT(m_pApplicationLog);
+
+		JobSystemDefinition jobSystemDefinition;
+		if (!configFile.PopulateJobSystemData(jobSystemDefinition))
+		{
+			m_pApplicationLog->Warn("Failed to populate job system data correctly. Please verify config file.");
+		}
+
+		if (!s_pGlobalJobSystem)
+			s_pGlobalJobSystem = EXELIUS_NEW(JobSystem());
+		EXE_ASSERT(s_pGlobalJobSystem);
+		if (!s_pGlobalJobSystem->Initialize(jobSystemDefinition))
+		{
+			m_pApplicationLog->Fatal("Exelius::JobSystem failed to initialize.");
+			return false;
+		}
+
+		return true;
+	}
+
 	/// <summary>
 	/// Initialize the RenderManager using the config file data if necessary.
 	/// </summary>
@@ -460,14 +486,20 @@ namespace Exelius
 	/// </summary>
 	/// <param name="configFile">- The pre-parsed config file.</param>
 	/// <returns>True on success, false otherwise.</returns>
-	bool Application::InitializeResourceLoader([[maybe_unused]] const ConfigFile& configFile) const
+	bool Application::InitializeResourceLoader(const ConfigFile& configFile) const
 	{
 		EXE_ASSERT(m_pApplicationLog);
 
+		ResourceLoaderDefinition resourceLoaderDefinition;
+		if (!configFile.PopulateResourceLoaderData(resourceLoaderDefinition))
+		{
+			m_pApplicationLog->Warn("Failed to populate resource loader data correctly. Please verify config file.");
+		}
+
 		// Create Resource Manager Singleton.
 		ResourceLoader::SetSingleton(EXELIUS_NEW(ResourceLoader()));
 		EXE_ASSERT(ResourceLoader::GetInstance());
-		if (!ResourceLoader::GetInstance()->Initialize(m_pResourceFactory, "EngineResources/", true))
+		if (!ResourceLoader::GetInstance()->Initialize(m_pResourceFactory, "EngineResources/", true, resourceLoaderDefinition))
 		{
 			m_pApplicationLog->Fatal("Exelius::ResourceLoader failed to initialize.");
 			return false;
@@ -495,4 +527,71 @@ namespace Exelius
 
 		return true;
 	}
+
+	/// <summary>
+	/// Declare the phases of the main loop, and what each of them reads and writes.
+	/// </summary>
+	/// <param name="configFile">- The pre-parsed config file.</param>
+	/// <returns>True on success, false otherwise.</returns>
+	bool Application::InitializeFrameGraph([[maybe_unused]] const ConfigFile& configFile)
+	{
+		EXE_ASSERT(m_pApplicationLog);
+
+		m_pFrameGraph = EXELIUS_NEW(FrameGraph());
+		EXE_ASSERT(m_pFrameGraph);
+
+		// Phases are declared in the order they used to run in serially. A phase is only kept on the
+		// main thread when it touches something that is not thread safe, and the reason is given with it.
+
+		// Dispatch Messages. Main thread, as message callbacks are client code, and receivers are added without a lock.
+		m_pFrameGraph->AddPhase("DispatchMessages", []() { MessageServer::GetInstance()->DispatchMessages(); },
+			{ FrameResource::kMessages }, { FrameResource::kMessages }, true);
+
+		// Poll Window Events. Main thread, as the OS only delivers a window's events to the thread that created it.
+		m_pFrameGraph->AddPhase("PollWindowEvents", []() { RenderManager::GetInstance()->Update(); },
+			{}, { FrameResource::kWindow, FrameResource::kInput }, true);
+
+		// Reload resources whose files changed on disk. Does nothing unless hot reload is enabled.
+		// Main thread, as reloaded resources are swapped in under listeners that expect the main thread.
+		m_pFrameGraph->AddPhase("ReloadChangedResources", []() { ResourceLoader::GetInstance()->ProcessFileChanges(); },
+			{}, { FrameResource::kResources }, true);
+
+		// Notify listeners of resources that finished loading on other threads, within the
+		// frame's budget. Listeners create GameObjects and Components, so this runs before they update.
+		// Main thread, as that is where listeners are promised to be notified.
+		m_pFrameGraph->AddPhase("ProcessResourceCompletions", []() { ResourceLoader::GetInstance()->ProcessCompletions(); },
+			{}, { FrameResource::kComponents, FrameResource::kResources }, true);
+
+		// Update Components. Main thread, as components set the window's view.
+		m_pFrameGraph->AddPhase("UpdateComponents", []() { GameObjectSystem::GetInstance()->Update(); },
+			{ FrameResource::kInput }, { FrameResource::kComponents, FrameResource::kWindow }, true);
+
+		// Client Update. The client may touch anything, so it is ordered after everything above, on the main thread.
+		m_pFrameGraph->AddPhase("ClientUpdate", [this]() { Update(); },
+			{ FrameResource::kInput }, { FrameResource::kComponents, FrameResource::kMessages, FrameResource::kWindow }, true);
+
+		// Refresh Input State. Runs alongside the phases below.
+		m_pFrameGraph->AddPhase("RefreshInput", []() { InputManager::GetInstance()->NextFrame(); },
+			{}, { FrameResource::kInput });
+
+		// Queue all renderable Components. Only fills the RenderManager's command buffer, which nothing
+		// else touches until EndRenderFrame.
+		m_pFrameGraph->AddPhase("QueueRenderables", []() { GameObjectSystem::GetInstance()->Render(); },
+			{ FrameResource::kComponents }, { FrameResource::kRenderCommands });
+
+		// Start loading any resources that were queued without signaling this frame. The loader's queues
+		// are locked, and the loads were already claimed, so this runs alongside rendering.
+		m_pFrameGraph->AddPhase("DispatchResourceLoads", []() { ResourceLoader::GetInstance()->DispatchQueuedLoads(); },
+			{ FrameResource::kComponents }, {});
+
+		// Push render list to render thread. Main thread, as the single threaded renderer draws here, on the window's context.
+		m_pFrameGraph->AddPhase("EndRenderFrame", []() { RenderManager::GetInstance()->EndRenderFrame(); },
+			{ FrameResource::kRenderCommands, FrameResource::kResources }, { FrameResource::kWindow }, true);
+
+		// Deallocate any resources necessary. The database is locked, so this runs on any thread.
+		m_pFrameGraph->AddPhase("ProcessUnloadQueue", []() { ResourceLoader::GetInstance()->ProcessUnloadQueue(); },
+			{}, { FrameResource::kResources });
+
+		return true;
+	}
 }
\ No newline at end of file
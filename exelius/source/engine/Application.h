@@ -15,6 +15,7 @@ namespace Exelius
 	class ComponentFactory;
 	class MessageFactory;
 	class ConfigFile;
+	class FrameGraph;
 
 	/// <summary>
 	/// The application class is to be inhereted by the client,
@@ -30,6 +31,9 @@ namespace Exelius
 		ComponentFactory* m_pComponentFactory;
 		MessageFactory* m_pMessageFactory;
 
+		// The phases of the main loop. Clients may add their own phases in Initialize().
+		FrameGraph* m_pFrameGraph;
+
 	private:
 		float m_lastFrameTime;
 		bool m_isRunning;
@@ -150,6 +154,13 @@ namespace Exelius
 		/// <returns>True on success, false otherwise.</returns>
 		bool InitializeLogManager(const ConfigFile& configFile) const;
 
+		/// <summary>
+		/// Initialize the JobSystem using the config file data if necessary.
+		/// </summary>
+		/// <param name="configFile">- The pre-parsed config file.</param>
+		/// <returns>True on success, false otherwise.</returns>
+		bool InitializeJobSystem(const ConfigFile& configFile) const;
+
 		/// <summary>
 		/// Initialize the RenderManager using the config file data if necessary.
 		/// </summary>
@@ -177,6 +188,13 @@ namespace Exelius
 		/// <param name="configFile">- The pre-parsed config file.</param>
 		/// <returns>True on success, false otherwise.</returns>
 		bool InitializeGameObjectSystem(const ConfigFile& configFile) const;
+
+		/// <summary>
+		/// Declare the phases of the main loop, and what each of them reads and writes.
+		/// </summary>
+		/// <param name="configFile">- The pre-parsed config file.</param>
+		/// <returns>True on success, false otherwise.</returns>
+		bool InitializeFrameGraph(const ConfigFile& configFile);
 	};
 
 	/// <summary>
@@ -0,0 +1,278 @@
+#include "EXEPCH.h"
+#include "source/engine/framegraph/FrameGraph.h"
+#include "source/os/threads/JobSystem.h"
+
+#include <EASTL/algorithm.h>
+#include <EASTL/numeric_limits.h>
+#include <EASTL/unordered_map.h>
+#include <thread>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	FrameGraph::FrameGraph()
+		: m_frameGraphLog("FrameGraph")
+		, m_pRemainingDependencies(nullptr)
+		, m_remainingPhases(0)
+		, m_frameTime(0)
+		, m_isCompiled(false)
+		, m_dumpEveryFrame(false)
+	{
+		//
+	}
+
+	FrameGraph::~FrameGraph()
+	{
+		EXE_ASSERT(m_remainingPhases.load() == 0);
+		EXELIUS_DELETE_ARRAY(m_pRemainingDependencies);
+	}
+
+	/// <summary>
+	/// Adds a phase after every phase added so far. Must not be called during Execute().
+	/// </summary>
+	/// <param name="pName">- Name of the phase, used in the schedule dump.</param>
+	/// <param name="function">- The work to do each frame.</param>
+	/// <param name="reads">- The resources this phase reads.</param>
+	/// <param name="writes">- The resources this phase writes.</param>
+	/// <param name="isMainThreadOnly">- True if this phase must run on the thread that calls Execute().</param>
+	void FrameGraph::AddPhase(const char* pName, PhaseFunction&& function, std::initializer_list<FrameResource::Type> reads,
+		std::initializer_list<FrameResource::Type> writes, bool isMainThreadOnly /* = false */)
+	{
+		EXE_ASSERT(m_remainingPhases.load() == 0);
+
+		Phase& phase = m_phases.emplace_back();
+		phase.m_name = pName;
+		phase.m_function = eastl::move(function);
+		phase.m_reads.assign(reads.begin(), reads.end());
+		phase.m_writes.assign(writes.begin(), writes.end());
+		phase.m_isMainThreadOnly = isMainThreadOnly;
+		phase.m_depth = 0;
+		phase.m_startTime = eastl::chrono::microseconds(0);
+		phase.m_endTime = eastl::chrono::microseconds(0);
+		phase.m_workerIndex = 0;
+
+		m_isCompiled = false;
+	}
+
+	/// <summary>
+	/// Runs every phase once, respecting the declared dependencies.
+	/// The graph is rebuilt first if phases were added since the last call.
+	/// </summary>
+	void FrameGraph::Execute()
+	{
+		if (!m_isCompiled)
+			Compile();
+
+		if (m_phases.empty())
+			return;
+
+		m_frameStartTime = Clock::now();
+
+		for (size_t phaseIndex = 0; phaseIndex < m_phases.size(); ++phaseIndex)
+		{
+			m_pRemainingDependencies[phaseIndex].store(static_cast<uint32_t>(m_phases[phaseIndex].m_dependencies.size()), std::memory_order_relaxed);
+		}
+		m_remainingPhases.store(m_phases.size(), std::memory_order_release);
+
+		for (size_t phaseIndex = 0; phaseIndex < m_phases.size(); ++phaseIndex)
+		{
+			if (m_phases[phaseIndex].m_dependencies.empty())
+				LaunchPhase(phaseIndex);
+		}
+
+		// Run our own phases as they become ready, and help the workers with theirs in between.
+		while (m_remainingPhases.load(std::memory_order_acquire) != 0)
+		{
+			size_t phaseIndex = 0;
+			if (PopReadyMainThreadPhase(phaseIndex))
+			{
+				RunPhase(phaseIndex);
+				continue;
+			}
+
+			if (!s_pGlobalJobSystem || !s_pGlobalJobSystem->TryExecuteJob())
+				std::this_thread::yield();
+		}
+
+		m_frameTime = eastl::chrono::duration_cast<eastl::chrono::microseconds>(Clock::now() - m_frameStartTime);
+
+		if (m_dumpEveryFrame)
+			DumpSchedule();
+	}
+
+	/// <summary>
+	/// Logs the graph, and when and where each phase ran during the last Execute().
+	/// </summary>
+	void FrameGraph::DumpSchedule() const
+	{
+		m_frameGraphLog.Info("Frame Schedule: {} phases, {:.3f}ms.", m_phases.size(), static_cast<float>(m_frameTime.count()) / 1000.0f);
+
+		for (size_t phaseIndex = 0; phaseIndex < m_phases.size(); ++phaseIndex)
+		{
+			const Phase& phase = m_phases[phaseIndex];
+
+			eastl::string dependencies;
+			for (size_t dependency : phase.m_dependencies)
+			{
+				if (!dependencies.empty())
+					dependencies += ", ";
+				dependencies += m_phases[dependency].m_name;
+			}
+
+			m_frameGraphLog.Info("  [{}] {} - Depth: {}, Worker: {}{}, Start: {:.3f}ms, End: {:.3f}ms, After: {}",
+				phaseIndex,
+				phase.m_name.c_str(),
+				phase.m_depth,
+				phase.m_workerIndex,
+				phase.m_isMainThreadOnly ? " (Main Thread Only)" : "",
+				static_cast<float>(phase.m_startTime.count()) / 1000.0f,
+				static_cast<float>(phase.m_endTime.count()) / 1000.0f,
+				dependencies.empty() ? "-" : dependencies.c_str());
+		}
+	}
+
+	/// <summary>
+	/// Builds the dependency graph from the declared reads and writes.
+	/// </summary>
+	void FrameGraph::Compile()
+	{
+		struct ResourceAccess
+		{
+			size_t m_lastWriter = eastl::numeric_limits<size_t>::max();
+			eastl::vector<size_t> m_readersSinceWrite;
+		};
+
+		eastl::unordered_map<FrameResource::Type, ResourceAccess> resourceAccesses;
+
+		const auto addDependency = [](Phase& phase, size_t dependency)
+		{
+			if (dependency == eastl::numeric_limits<size_t>::max())
+				return;
+
+			if (eastl::find(phase.m_dependencies.begin(), phase.m_dependencies.end(), dependency) == phase.m_dependencies.end())
+				phase.m_dependencies.emplace_back(dependency);
+		};
+
+		for (Phase& phase : m_phases)
+		{
+			phase.m_dependencies.clear();
+			phase.m_dependents.clear();
+			phase.m_depth = 0;
+		}
+
+		// Declaration order is the serial order, so every edge points backwards and the graph can't have cycles.
+		for (size_t phaseIndex = 0; phaseIndex < m_phases.size(); ++phaseIndex)
+		{
+			Phase& phase = m_phases[phaseIndex];
+
+			// Read after write.
+			for (FrameResource::Type resource : phase.m_reads)
+			{
+				addDependency(phase, resourceAccesses[resource].m_lastWriter);
+			}
+
+			// Write after write, and write after read.
+			for (FrameResource::Type resource : phase.m_writes)
+			{
+				ResourceAccess& access = resourceAccesses[resource];
+				addDependency(phase, access.m_lastWriter);
+
+				for (size_t reader : access.m_readersSinceWrite)
+				{
+					if (reader != phaseIndex)
+						addDependency(phase, reader);
+				}
+			}
+
+			for (FrameResource::Type resource : phase.m_reads)
+			{
+				resourceAccesses[resource].m_readersSinceWrite.emplace_back(phaseIndex);
+			}
+
+			for (FrameResource::Type resource : phase.m_writes)
+			{
+				ResourceAccess& access = resourceAccesses[resource];
+				access.m_lastWriter = phaseIndex;
+				access.m_readersSinceWrite.clear();
+			}
+
+			for (size_t dependency : phase.m_dependencies)
+			{
+				m_phases[dependency].m_dependents.emplace_back(phaseIndex);
+				phase.m_depth = eastl::max(phase.m_depth, m_phases[dependency].m_depth + 1);
+			}
+		}
+
+		EXELIUS_DELETE_ARRAY(m_pRemainingDependencies);
+		m_pRemainingDependencies = EXELIUS_NEW_ARRAY(std::atomic<uint32_t>, m_phases.size());
+
+		m_readyMainThreadPhases.clear();
+		m_readyMainThreadPhases.reserve(m_phases.size());
+
+		m_isCompiled = true;
+	}
+
+	/// <summary>
+	/// Queues a phase whose dependencies have all finished.
+	/// </summary>
+	/// <param name="phaseIndex">- The phase to queue.</param>
+	void FrameGraph::LaunchPhase(size_t phaseIndex)
+	{
+		if (m_phases[phaseIndex].m_isMainThreadOnly || !s_pGlobalJobSystem)
+		{
+			std::lock_guard<std::mutex> lock(m_readyPhaseLock);
+			m_readyMainThreadPhases.emplace_back(phaseIndex);
+			return;
+		}
+
+		s_pGlobalJobSystem->PushJob([this, phaseIndex]()
+			{
+				RunPhase(phaseIndex);
+			}, JobHandle(), nullptr, JobPriority::kFrameCritical);
+	}
+
+	/// <summary>
+	/// Runs a phase, then launches any dependents it was the last dependency of.
+	/// </summary>
+	/// <param name="phaseIndex">- The phase to run.</param>
+	void FrameGraph::RunPhase(size_t phaseIndex)
+	{
+		Phase& phase = m_phases[phaseIndex];
+
+		phase.m_workerIndex = s_pGlobalJobSystem ? s_pGlobalJobSystem->GetCurrentWorkerIndex() : 0;
+		phase.m_startTime = eastl::chrono::duration_cast<eastl::chrono::microseconds>(Clock::now() - m_frameStartTime);
+
+		phase.m_function();
+
+		phase.m_endTime = eastl::chrono::duration_cast<eastl::chrono::microseconds>(Clock::now() - m_frameStartTime);
+
+		for (size_t dependent : phase.m_dependents)
+		{
+			if (m_pRemainingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+				LaunchPhase(dependent);
+		}
+
+		// Nothing in the graph may be touched after this, Execute() is free to return.
+		m_remainingPhases.fetch_sub(1, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Takes the earliest declared main thread phase that is ready to run.
+	/// </summary>
+	/// <param name="phaseIndex">- The phase to run, if any.</param>
+	/// <returns>True if a phase was ready.</returns>
+	bool FrameGraph::PopReadyMainThreadPhase(size_t& phaseIndex)
+	{
+		std::lock_guard<std::mutex> lock(m_readyPhaseLock);
+
+		if (m_readyMainThreadPhases.empty())
+			return false;
+
+		auto earliestPhase = eastl::min_element(m_readyMainThreadPhases.begin(), m_readyMainThreadPhases.end());
+		phaseIndex = *earliestPhase;
+		m_readyMainThreadPhases.erase(earliestPhase);
+		return true;
+	}
+}
\ No newline at end of file
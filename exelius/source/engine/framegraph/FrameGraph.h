@@ -0,0 +1,174 @@
+#pragma once
+#include "source/debug/Log.h"
+#include "source/utility/string/StringHash.h"
+
+#include <EASTL/chrono.h>
+#include <EASTL/functional.h>
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+#include <initializer_list>
+#include <atomic>
+#include <mutex>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// Shared state that frame phases declare they read or write. The FrameGraph only compares these,
+	/// so any name works. Clients may declare their own with StringHash::HashString32("Name").
+	/// </summary>
+	namespace FrameResource
+	{
+		using Type = uint32_t;
+
+		/// <summary>
+		/// Messages queued in the MessageServer.
+		/// </summary>
+		static constexpr Type kMessages = StringHash::HashString32("Messages");
+
+		/// <summary>
+		/// The OS window, and anything that has to happen on the thread that owns it.
+		/// </summary>
+		static constexpr Type kWindow = StringHash::HashString32("Window");
+
+		/// <summary>
+		/// The current and previous frame input state.
+		/// </summary>
+		static constexpr Type kInput = StringHash::HashString32("Input");
+
+		/// <summary>
+		/// All GameObjects and the ComponentLists.
+		/// </summary>
+		static constexpr Type kComponents = StringHash::HashString32("Components");
+
+		/// <summary>
+		/// The RenderManager's command buffers.
+		/// </summary>
+		static constexpr Type kRenderCommands = StringHash::HashString32("RenderCommands");
+
+		/// <summary>
+		/// Loaded resources, including the unload queue.
+		/// </summary>
+		static constexpr Type kResources = StringHash::HashString32("Resources");
+	}
+
+	/// <summary>
+	/// Schedules the phases of a frame as a graph of jobs.
+	///
+	/// Each phase declares the FrameResources it reads and writes. Phases are ordered by declaration,
+	/// and a phase only waits on the earlier phases it actually conflicts with: the last writer of
+	/// anything it reads or writes, and every reader since that write for anything it writes. Phases
+	/// that do not conflict run at the same time on the JobSystem.
+	///
+	/// Phases flagged as main thread only always run on the thread that calls Execute(). Execute()
+	/// helps with other jobs while it waits, and returns once every phase has finished.
+	///
+	/// Example:
+	///		frameGraph.AddPhase("Physics", [this]() { StepPhysics(); }, { FrameResource::kInput }, { FrameResource::kComponents });
+	/// </summary>
+	class FrameGraph
+	{
+		using PhaseFunction = eastl::function<void()>;
+		using Clock = eastl::chrono::high_resolution_clock;
+
+		struct Phase
+		{
+			eastl::string m_name;
+			PhaseFunction m_function;
+			eastl::vector<FrameResource::Type> m_reads;
+			eastl::vector<FrameResource::Type> m_writes;
+			bool m_isMainThreadOnly;
+
+			// Built by Compile().
+			eastl::vector<size_t> m_dependencies;
+			eastl::vector<size_t> m_dependents;
+			size_t m_depth;
+
+			// Last executed frame, for DumpSchedule().
+			eastl::chrono::microseconds m_startTime;
+			eastl::chrono::microseconds m_endTime;
+			uint32_t m_workerIndex;
+		};
+
+		Log m_frameGraphLog;
+
+		eastl::vector<Phase> m_phases;
+
+		// Per frame execution state. One entry per phase.
+		std::atomic<uint32_t>* m_pRemainingDependencies;
+		std::atomic<size_t> m_remainingPhases;
+
+		// Main thread phases whose dependencies have finished.
+		eastl::vector<size_t> m_readyMainThreadPhases;
+		std::mutex m_readyPhaseLock;
+
+		Clock::time_point m_frameStartTime;
+		eastl::chrono::microseconds m_frameTime;
+
+		bool m_isCompiled;
+		bool m_dumpEveryFrame;
+
+	public:
+		FrameGraph();
+		FrameGraph(const FrameGraph&) = delete;
+		FrameGraph(FrameGraph&&) = delete;
+		FrameGraph& operator=(const FrameGraph&) = delete;
+		FrameGraph& operator=(FrameGraph&&) = delete;
+		~FrameGraph();
+
+		/// <summary>
+		/// Adds a phase after every phase added so far. Must not be called during Execute().
+		/// </summary>
+		/// <param name="pName">- Name of the phase, used in the schedule dump.</param>
+		/// <param name="function">- The work to do each frame.</param>
+		/// <param name="reads">- The resources this phase reads.</param>
+		/// <param name="writes">- The resources this phase writes.</param>
+		/// <param name="isMainThreadOnly">- True if this phase must run on the thread that calls Execute().</param>
+		void AddPhase(const char* pName, PhaseFunction&& function, std::initializer_list<FrameResource::Type> reads,
+			std::initializer_list<FrameResource::Type> writes, bool isMainThreadOnly = false);
+
+		/// <summary>
+		/// Runs every phase once, respecting the declared dependencies.
+		/// The graph is rebuilt first if phases were added since the last call.
+		/// </summary>
+		void Execute();
+
+		/// <summary>
+		/// Logs the graph, and when and where each phase ran during the last Execute().
+		/// </summary>
+		void DumpSchedule() const;
+
+		/// <summary>
+		/// Logs the schedule at the end of every Execute().
+		/// </summary>
+		/// <param name="dumpEveryFrame">- True to dump every frame.</param>
+		void SetDumpEveryFrame(bool dumpEveryFrame) { m_dumpEveryFrame = dumpEveryFrame; }
+
+	private:
+		/// <summary>
+		/// Builds the dependency graph from the declared reads and writes.
+		/// </summary>
+		void Compile();
+
+		/// <summary>
+		/// Queues a phase whose dependencies have all finished.
+		/// </summary>
+		/// <param name="phaseIndex">- The phase to queue.</param>
+		void LaunchPhase(size_t phaseIndex);
+
+		/// <summary>
+		/// Runs a phase, then launches any dependents it was the last dependency of.
+		/// </summary>
+		/// <param name="phaseIndex">- The phase to run.</param>
+		void RunPhase(size_t phaseIndex);
+
+		/// <summary>
+		/// Takes the earliest declared main thread phase that is ready to run.
+		/// </summary>
+		/// <param name="phaseIndex">- The phase to run, if any.</param>
+		/// <returns>True if a phase was ready.</returns>
+		bool PopReadyMainThreadPhase(size_t& phaseIndex);
+	};
+}
\ No newline at end of file
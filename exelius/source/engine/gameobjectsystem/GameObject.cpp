@@ -1,8 +1,8 @@
 #include "EXEPCH.h"
 #include "source/engine/gameobjectsystem/GameObject.h"
+#include "source/engine/gameobjectsystem/GameObjectPrefab.h"
 
 #include "source/resource/ResourceHandle.h"
-#include "source/engine/resources/resourcetypes/TextFileResource.h"
 
 /// <summary>
 /// Engine namespace. Everything owned by the engine will be inside this namespace.
@@ -38,36 +38,51 @@ namespace Exelius
 	/// <returns>True on success, false on failure.</returns>
 	bool GameObject::Initialize(const eastl::string& pRawText)
 	{
-		rapidjson::Document jsonDoc;
-		if (jsonDoc.Parse(pRawText.c_str()).HasParseError())
-		{
-			m_gameObjectSystemLog.Error("Failed to Parse JSON.");
+		GameObjectPrefab prefab;
+		if (!prefab.Initialize(pRawText) || !Initialize(prefab))
 			return false;
-		}
 
-		EXE_ASSERT(jsonDoc.IsObject());
+		m_gameObjectSystemLog.Info("GameObject '{}' : '{}' has completed loading.", m_name.c_str(), m_id);
 
-		// Set any game object specific values.
-		auto nameMember = jsonDoc.FindMember("Name");
+		return true;
+	}
 
-		if (nameMember != jsonDoc.MemberEnd())
+	/// <summary>
+	/// Initialize this object from an already parsed GameObject file.
+	/// This will set any values specified in the prefab,
+	/// and will create (or get from the pool) any necessary
+	/// components and intialize those.
+	/// </summary>
+	/// <param name="prefab">The parsed object data.</param>
+	/// <returns>True on success, false on failure.</returns>
+	bool GameObject::Initialize(const GameObjectPrefab& prefab)
+	{
+		auto* pGameObjectSystem = GameObjectSystem::GetInstance();
+		EXE_ASSERT(pGameObjectSystem);
+
+		// Set any game object specific values.
+		if (!prefab.GetName().empty())
 		{
-			EXE_ASSERT(nameMember->value.IsString());
-			m_name = nameMember->value.GetString();
+			m_name = prefab.GetName();
 		}
 		else
 		{
-			m_gameObjectSystemLog.Error("No 'Name' field found. Setting object name to a default value.");
 			// Name the object based on it's ID.
 			m_name = "New GameObject (";
 			//m_name += eastl::to_string(m_id);														<-- Why does this cause errors?!!
 			m_name += ")";
 		}
 
-		// Create and Initialize any Components.
-		ParseComponentArray(jsonDoc);
+		// Create and Initialize any Components. The types were hashed when the prefab was built.
+		m_components.reserve(prefab.GetComponents().size());
+		for (const GameObjectPrefab::ComponentTemplate& componentTemplate : prefab.GetComponents())
+		{
+			Handle newComponentHandle = pGameObjectSystem->CreateComponentFromFactory(componentTemplate.m_type, this, *componentTemplate.m_pComponentData);
+			if (!newComponentHandle.IsValid())
+				continue;
 
-		m_gameObjectSystemLog.Info("GameObject '{}' : '{}' has completed loading.", m_name.c_str(), m_id);
+			m_components.try_emplace(componentTemplate.m_type, newComponentHandle);
+		}
 
 		return true;
 	}
@@ -107,10 +122,19 @@ namespace Exelius
 
 		//EXE_ASSERT(textFileResource.IsReferenceHeld()); // This is literally what we are being informed about!
 
-		if (!Initialize(textFileResource.GetAs<TextFileResource>()->GetRawText()))
+		auto* pGameObjectSystem = GameObjectSystem::GetInstance();
+		EXE_ASSERT(pGameObjectSystem);
+
+		// Parsed by the first object created from this resource, and shared by the rest.
+		eastl::shared_ptr<const GameObjectPrefab> pPrefab = pGameObjectSystem->GetPrefab(resourceID);
+		if (!pPrefab || !Initialize(*pPrefab))
 		{
 			m_gameObjectSystemLog.Error("GameObject failed to initialize.");
 		}
+		else
+		{
+			m_gameObjectSystemLog.Info("GameObject '{}' : '{}' has completed loading.", m_name.c_str(), m_id);
+		}
 
 		// TODO:
 		//	In MOST cases.. the ref count is currently 2 for the gameobject file.
@@ -126,40 +150,4 @@ namespace Exelius
 
 		return true;
 	}
-
-	/// <summary>
-	/// Parses and creates the components in the JSON object document.
-	/// This will create (or get from the pool), attach, and initialize these components.
-	/// </summary>
-	/// <param name="jsonDoc">The JSON document with the Object data.</param>
-	void GameObject::ParseComponentArray(const rapidjson::Document& jsonDoc)
-	{
-		auto* pGameObjectSystem = GameObjectSystem::GetInstance();
-		EXE_ASSERT(pGameObjectSystem);
-
-		// Find an Array with name 'Components'
-		auto componentArrayMember = jsonDoc.FindMember("Components");
-
-		// If the Array does not exist then bail.
-		if (componentArrayMember == jsonDoc.MemberEnd())
-		{
-			m_gameObjectSystemLog.Info("No 'Components' field found.");
-			return;
-		}
-
-		auto& componentArrayValue = componentArrayMember->value;
-
-		// Make sure it's value is an Object (List of).
-		EXE_ASSERT(componentArrayValue.IsObject());
-
-		// For each Component in the Components List.
-		for (auto componentMember = componentArrayValue.MemberBegin(); componentMember != componentArrayValue.MemberEnd(); ++componentMember)
-		{
-			Handle newComponentHandle = pGameObjectSystem->CreateComponentFromFactory(StringHash::HashString32(componentMember->name.GetString()), this, componentMember->value);
-			if (!newComponentHandle.IsValid())
-				continue;
-
-			m_components.try_emplace(StringHash::HashString32(componentMember->name.GetString()), newComponentHandle);
-		}
-	}
 }
\ No newline at end of file
@@ -13,6 +13,8 @@
 /// </summary>
 namespace Exelius
 {
+    class GameObjectPrefab;
+
     class GameObject
         : public ResourceListener
 	{
@@ -95,6 +97,16 @@ namespace Exelius
         /// <returns>True on success, false on failure.</returns>
         bool Initialize(const eastl::string& rawText);
 
+        /// <summary>
+        /// Initialize this object from an already parsed GameObject file.
+        /// This will set any values specified in the prefab,
+        /// and will create (or get from the pool) any necessary
+        /// components and intialize those.
+        /// </summary>
+        /// <param name="prefab">The parsed object data.</param>
+        /// <returns>True on success, false on failure.</returns>
+        bool Initialize(const GameObjectPrefab& prefab);
+
         /// <summary>
         /// Removes all the components attached to this GameObject.
         /// This returns them to their respective pools.
@@ -179,13 +191,5 @@ namespace Exelius
         /// <param name="resourceID">- The ID of the loaded resource.</param>
         /// <returns>True if the resource was flushed here, false if not.</returns>
         virtual bool OnResourceLoaded(const ResourceID& resourceID) final override;
-
-    private:
-        /// <summary>
-        /// Parses and creates the components in the JSON object document.
-        /// This will create (or get from the pool), attach, and initialize these components.
-        /// </summary>
-        /// <param name="jsonDoc">The JSON document with the Object data.</param>
-        void ParseComponentArray(const rapidjson::Document& jsonDoc);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "EXEPCH.h"
+#include "source/engine/gameobjectsystem/GameObjectPrefab.h"
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	GameObjectPrefab::GameObjectPrefab()
+		: m_gameObjectSystemLog("GameObjectSystem")
+	{
+		//
+	}
+
+	/// <summary>
+	/// Parses a GameObject file. Must only be called once.
+	/// </summary>
+	/// <param name="rawText">- The JSON text of the file.</param>
+	/// <returns>True on success, false if the text is not a valid GameObject.</returns>
+	bool GameObjectPrefab::Initialize(const eastl::string& rawText)
+	{
+		EXE_ASSERT(m_components.empty());
+
+		if (m_document.Parse(rawText.c_str()).HasParseError())
+		{
+			m_gameObjectSystemLog.Error("Failed to Parse JSON.");
+			return false;
+		}
+
+		EXE_ASSERT(m_document.IsObject());
+
+		// Set any game object specific values.
+		auto nameMember = m_document.FindMember("Name");
+
+		if (nameMember != m_document.MemberEnd())
+		{
+			EXE_ASSERT(nameMember->value.IsString());
+			m_name = nameMember->value.GetString();
+		}
+		else
+		{
+			m_gameObjectSystemLog.Error("No 'Name' field found. Objects will be given a default name.");
+		}
+
+		// Find an Array with name 'Components'
+		auto componentArrayMember = m_document.FindMember("Components");
+
+		// If the Array does not exist then there is nothing more to parse.
+		if (componentArrayMember == m_document.MemberEnd())
+		{
+			m_gameObjectSystemLog.Info("No 'Components' field found.");
+			return true;
+		}
+
+		auto& componentArrayValue = componentArrayMember->value;
+
+		// Make sure it's value is an Object (List of).
+		EXE_ASSERT(componentArrayValue.IsObject());
+
+		m_components.reserve(componentArrayValue.MemberCount());
+
+		// Hash each Component's name here, so instances never have to.
+		for (auto componentMember = componentArrayValue.MemberBegin(); componentMember != componentArrayValue.MemberEnd(); ++componentMember)
+		{
+			ComponentTemplate componentTemplate;
+			componentTemplate.m_type = StringHash::HashString32(componentMember->name.GetString());
+			componentTemplate.m_pComponentData = &componentMember->value;
+			m_components.emplace_back(componentTemplate);
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
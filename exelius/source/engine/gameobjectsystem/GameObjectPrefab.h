@@ -0,0 +1,91 @@
+#pragma once
+#include "source/engine/gameobjectsystem/components/Component.h"
+#include "source/debug/Log.h"
+
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+#include <rapidjson/document.h>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// The parsed form of a GameObject file, shared by every GameObject created from it.
+	/// The JSON is parsed and the component names are hashed once, when the prefab is
+	/// built. Each GameObject is then created by handing the component data, already
+	/// decoded, to the ComponentFactory.
+	///
+	/// A prefab is immutable once built. It is cached by the GameObjectSystem until
+	/// the file it was built from is reloaded or unloaded.
+	/// @see GameObjectSystem::GetPrefab
+	/// </summary>
+	class GameObjectPrefab
+	{
+	public:
+		/// <summary>
+		/// A component every instance is created with.
+		/// </summary>
+		struct ComponentTemplate
+		{
+			/// <summary>
+			/// The hashed component name.
+			/// </summary>
+			Component::Type m_type;
+
+			/// <summary>
+			/// The component's initial values. Owned by the prefab's document.
+			/// </summary>
+			const rapidjson::Value* m_pComponentData;
+		};
+
+	private:
+		/// <summary>
+		/// Log for the GameObjectSystem.
+		/// </summary>
+		Log m_gameObjectSystemLog;
+
+		/// <summary>
+		/// The parsed file, which the component data points into.
+		/// </summary>
+		rapidjson::Document m_document;
+
+		/// <summary>
+		/// The name given to every instance. Empty if the file has no name.
+		/// </summary>
+		eastl::string m_name;
+
+		/// <summary>
+		/// The components of every instance, in the order they appear in the file.
+		/// </summary>
+		eastl::vector<ComponentTemplate> m_components;
+
+	public:
+		GameObjectPrefab();
+		GameObjectPrefab(const GameObjectPrefab&) = delete;
+		GameObjectPrefab(GameObjectPrefab&&) = delete;
+		GameObjectPrefab& operator=(const GameObjectPrefab&) = delete;
+		GameObjectPrefab& operator=(GameObjectPrefab&&) = delete;
+		~GameObjectPrefab() = default;
+
+		/// <summary>
+		/// Parses a GameObject file. Must only be called once.
+		/// </summary>
+		/// <param name="rawText">- The JSON text of the file.</param>
+		/// <returns>True on success, false if the text is not a valid GameObject.</returns>
+		bool Initialize(const eastl::string& rawText);
+
+		/// <summary>
+		/// Get the name given to every instance.
+		/// </summary>
+		/// <returns>The name, or an empty string if the file has none.</returns>
+		const eastl::string& GetName() const { return m_name; }
+
+		/// <summary>
+		/// Get the components every instance is created with.
+		/// </summary>
+		/// <returns>The component templates, in file order.</returns>
+		const eastl::vector<ComponentTemplate>& GetComponents() const { return m_components; }
+	};
+}
\ No newline at end of file
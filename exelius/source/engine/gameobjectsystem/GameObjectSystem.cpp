@@ -2,16 +2,83 @@
 #include "source/engine/gameobjectsystem/GameObjectSystem.h"
 #include "source/engine/gameobjectsystem/components/ComponentFactory.h"
 #include "source/engine/gameobjectsystem/GameObject.h"
+#include "source/engine/gameobjectsystem/GameObjectPrefab.h"
 #include "source/resource/ResourceLoader.h"
+#include "source/resource/ResourceListener.h"
 #include "source/engine/resources/resourcetypes/TextFileResource.h"
 
 #include "source/resource/ResourceHandle.h"
 
+#include <EASTL/algorithm.h>
+
 /// <summary>
 /// Engine namespace. Everything owned by the engine will be inside this namespace.
 /// </summary>
 namespace Exelius
 {
+	/// <summary>
+	/// Initializes the objects of a CreateGameObjects() batch
+	/// whose resource was not loaded yet, once it has.
+	/// </summary>
+	class GameObjectSystem::SpawnListener
+		: public ResourceListener
+	{
+		/// <summary>
+		/// The objects in the batch. Objects destroyed before the load completes are skipped.
+		/// </summary>
+		eastl::vector<eastl::weak_ptr<GameObject>> m_gameObjects;
+
+	public:
+		void AddGameObject(const eastl::shared_ptr<GameObject>& pGameObject) { m_gameObjects.emplace_back(pGameObject); }
+
+		/// <summary>
+		/// Initializes every object in the batch that still exists, then removes this batch
+		/// from the pending spawns. Unlocks the resource, like GameObject::OnResourceLoaded().
+		/// </summary>
+		/// <param name="resourceID">- The ID of the loaded resource.</param>
+		/// <returns>True if the resource was flushed here, false if not.</returns>
+		virtual bool OnResourceLoaded(const ResourceID& resourceID) final override
+		{
+			auto* pGameObjectSystem = GameObjectSystem::GetInstance();
+			EXE_ASSERT(pGameObjectSystem);
+
+			EXE_ASSERT(resourceID.IsValid());
+			ResourceHandle gameObjectData(resourceID);
+
+			// The system still owns every object that hasn't been destroyed, so these stay valid.
+			eastl::vector<GameObject*> gameObjects;
+			gameObjects.reserve(m_gameObjects.size());
+			for (const auto& pWeakGameObject : m_gameObjects)
+			{
+				if (auto pGameObject = pWeakGameObject.lock())
+					gameObjects.emplace_back(pGameObject.get());
+			}
+
+			eastl::shared_ptr<const GameObjectPrefab> pPrefab = pGameObjectSystem->GetPrefab(resourceID);
+			if (!pPrefab)
+			{
+				pGameObjectSystem->m_gameObjectSystemLog.Error("{} GameObjects from '{}' failed to initialize.", gameObjects.size(), resourceID.Get().c_str());
+			}
+			else
+			{
+				pGameObjectSystem->InitializeGameObjects(*pPrefab, gameObjects);
+				pGameObjectSystem->m_gameObjectSystemLog.Info("{} GameObjects from '{}' have completed loading.", gameObjects.size(), resourceID.Get().c_str());
+			}
+
+			// Locked by CreateGameObjects() while the load was queued.
+			gameObjectData.UnlockResource();
+
+			// The loader holds this listener until it returns, so it is safe to remove it here.
+			auto& pendingSpawns = pGameObjectSystem->m_pendingSpawns;
+			pendingSpawns.erase(eastl::remove_if(pendingSpawns.begin(), pendingSpawns.end(), [this](const eastl::shared_ptr<SpawnListener>& pSpawn)
+				{
+					return pSpawn.get() == this;
+				}), pendingSpawns.end());
+
+			return true;
+		}
+	};
+
 	/// <summary>
 	/// Constructor - initializes member values.
 	/// </summary>
@@ -34,6 +101,9 @@ namespace Exelius
 		// created it. TODO: Consider making it a smart ptr.
 		m_pComponentFactory = nullptr;
 
+		// Batches still loading have nothing left to initialize.
+		m_pendingSpawns.clear();
+
 		for (auto& gameObjectPair : m_gameObjects)
 		{
 			gameObjectPair.second->RemoveComponents();
@@ -162,6 +232,150 @@ namespace Exelius
 		return id;
 	}
 
+	/// <summary>
+	/// Creates many GameObjects from the same ResourceID, for wave spawns.
+	/// The resource is acquired and loaded once for the whole batch, and
+	/// the IDs are allocated together. Once the resource is loaded, every
+	/// component list is grown once and the objects are initialized from
+	/// the resource's prefab together. A single summary is logged.
+	/// 
+	/// When the resource is not loaded, the CreationMode is handled the
+	/// same as CreateGameObject(). Queued batches are initialized together
+	/// when the load completes.
+	/// @see GameObjectPrefab
+	/// </summary>
+	/// <param name="resourceID">- The ResourceID referring to a JSON file containing object data.</param>
+	/// <param name="count">- The number of GameObjects to create.</param>
+	/// <param name="gameObjectIDs">- Receives the ID of each created object. Must hold at least count IDs. Set to kInvalidGameObjectID upon failure.</param>
+	/// <param name="createMode">- How the GameObjectSystem should handle object creation if the resource isn't loaded.</param>
+	/// <returns>True if the objects were created, false otherwise.</returns>
+	bool GameObjectSystem::CreateGameObjects(const ResourceID& resourceID, size_t count, eastl::span<GameObjectID> gameObjectIDs, CreationMode createMode)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+		EXE_ASSERT(gameObjectIDs.size() >= count);
+
+		eastl::span<GameObjectID> newObjectIDs(gameObjectIDs.data(), count);
+		eastl::fill(newObjectIDs.begin(), newObjectIDs.end(), kInvalidGameObjectID);
+
+		if (count == 0)
+			return true;
+
+		// One reference for the whole batch. Increments reference count *if* resource exists.
+		ResourceHandle gameObjectData(resourceID);
+
+		// Loading on the main thread finishes before any object is made, so they can all be initialized below.
+		if (!gameObjectData.IsReferenceHeld() && createMode == CreationMode::kLoadImmediate)
+		{
+			m_gameObjectSystemLog.Info("GameObject resource loading on Main thread.");
+			gameObjectData.LoadNow();
+		}
+
+		// If the resource is not loaded and we opted not to do so, then bail.
+		if (!gameObjectData.IsReferenceHeld() && (createMode == CreationMode::kDoNotLoad || createMode == CreationMode::kLoadImmediate))
+		{
+			m_gameObjectSystemLog.Warn("GameObjects from '{}' did not exist and will not be created.", resourceID.Get().c_str());
+			return false;
+		}
+
+		// A resource that is held but failed to load or parse would leave every object uninitialized.
+		eastl::shared_ptr<const GameObjectPrefab> pPrefab;
+		if (gameObjectData.IsReferenceHeld())
+		{
+			pPrefab = GetPrefab(resourceID);
+			if (!pPrefab)
+			{
+				m_gameObjectSystemLog.Error("GameObjects from '{}' could not be read and will not be created.", resourceID.Get().c_str());
+				return false;
+			}
+		}
+
+		GetNextObjectIds(newObjectIDs);
+
+		// Create the new objects.
+		eastl::vector<GameObject*> newObjects;
+		newObjects.reserve(count);
+		m_gameObjects.reserve(m_gameObjects.size() + count);
+		for (GameObjectID id : newObjectIDs)
+		{
+			auto& pNewObject = m_gameObjects.try_emplace(id, eastl::make_shared<GameObject>(id, createMode)).first->second;
+			EXE_ASSERT(pNewObject);
+			newObjects.emplace_back(pNewObject.get());
+		}
+
+		// If the resource was already loaded, then initialize every object now.
+		if (pPrefab)
+		{
+			InitializeGameObjects(*pPrefab, newObjects);
+			m_gameObjectSystemLog.Info("Created {} GameObjects from '{}'.", count, resourceID.Get().c_str());
+			return true;
+		}
+
+		// Otherwise one listener initializes the whole batch once the resource has loaded.
+		auto pSpawn = eastl::make_shared<SpawnListener>();
+		for (GameObjectID id : newObjectIDs)
+		{
+			pSpawn->AddGameObject(m_gameObjects.at(id));
+		}
+		m_pendingSpawns.emplace_back(pSpawn);
+
+		gameObjectData.QueueLoad(createMode == CreationMode::kQueueAndSignal, pSpawn);
+
+		// Same as CreateGameObject(), the lock keeps the resource while it is queued. The listener unlocks it.
+		gameObjectData.LockResource();
+		EXE_ASSERT(gameObjectData.IsReferenceHeld());
+
+		m_gameObjectSystemLog.Info("Created {} GameObjects from '{}'. They will be initialized once it has loaded.", count, resourceID.Get().c_str());
+		return true;
+	}
+
+	/// <summary>
+	/// Get the parsed form of a loaded GameObject file. It is parsed the first time
+	/// it is asked for, and shared by every later call. Once the file is reloaded or
+	/// unloaded, the old prefab is dropped and the next call parses the new version.
+	/// </summary>
+	/// <param name="resourceID">- The ResourceID referring to a loaded JSON file containing object data.</param>
+	/// <returns>The prefab, or nullptr if the file is not loaded or is not a valid GameObject.</returns>
+	eastl::shared_ptr<const GameObjectPrefab> GameObjectSystem::GetPrefab(const ResourceID& resourceID)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+
+		ResourceLoader* pResourceLoader = ResourceLoader::GetInstance();
+		EXE_ASSERT(pResourceLoader);
+
+		// The slot's generation tells which version of the file is loaded now.
+		uint32_t slotIndex = 0;
+		uint32_t slotGeneration = 0;
+		const TextFileResource* pGameObjectResource = static_cast<const TextFileResource*>(pResourceLoader->GetResource(resourceID, false, slotIndex, slotGeneration));
+		if (!pGameObjectResource)
+			return nullptr;
+
+		std::lock_guard<std::mutex> lock(m_prefabLock);
+
+		auto found = m_prefabs.find(resourceID);
+		if (found != m_prefabs.end() && found->second.m_slotIndex == slotIndex && found->second.m_slotGeneration == slotGeneration)
+			return found->second.m_pPrefab;
+
+		// Drop every prefab whose file has since been reloaded or unloaded. Objects still being built from one keep it alive.
+		for (auto it = m_prefabs.begin(); it != m_prefabs.end();)
+		{
+			if (pResourceLoader->IsResourceSlotCurrent(it->second.m_slotIndex, it->second.m_slotGeneration))
+				++it;
+			else
+				it = m_prefabs.erase(it);
+		}
+
+		eastl::shared_ptr<GameObjectPrefab> pPrefab = eastl::make_shared<GameObjectPrefab>();
+		if (!pPrefab->Initialize(pGameObjectResource->GetRawText()))
+			pPrefab.reset();
+
+		CachedPrefab& cachedPrefab = m_prefabs[resourceID];
+		cachedPrefab.m_slotIndex = slotIndex;
+		cachedPrefab.m_slotGeneration = slotGeneration;
+		cachedPrefab.m_pPrefab = pPrefab;
+
+		return pPrefab;
+	}
+
 	/// <summary>
 	/// Gets the GameObject with the given ID.
 	/// 
@@ -226,6 +440,37 @@ namespace Exelius
 		m_freeObjectIDs.push_back(gameObjectID);
 	}
 
+	/// <summary>
+	/// Destroys many GameObjects, like DestroyGameObject(), logging a single summary.
+	/// </summary>
+	/// <param name="gameObjectIDs">GameObjectIDs for the objects to be destroyed. Invalid IDs are skipped.</param>
+	void GameObjectSystem::DestroyGameObjects(eastl::span<const GameObjectID> gameObjectIDs)
+	{
+		size_t destroyedCount = 0;
+		for (GameObjectID gameObjectID : gameObjectIDs)
+		{
+			if (gameObjectID == kInvalidGameObjectID)
+				continue;
+
+			auto found = m_gameObjects.find(gameObjectID);
+			if (found == m_gameObjects.end())
+				continue;
+
+			// This GameObject MUST exist.
+			EXE_ASSERT(found->second);
+			found->second->RemoveComponents();
+
+			m_gameObjects.erase(found);
+			m_freeObjectIDs.push_back(gameObjectID);
+			++destroyedCount;
+		}
+
+		if (destroyedCount < gameObjectIDs.size())
+			m_gameObjectSystemLog.Warn("Destroyed {} of {} GameObjects. The rest were invalid or did not exist.", destroyedCount, gameObjectIDs.size());
+		else
+			m_gameObjectSystemLog.Info("Destroyed {} GameObjects.", destroyedCount);
+	}
+
 	/// <summary>
 	/// Requests that the Component of the given type be created
 	/// from the factory used by this GameObjectSystem.
@@ -322,4 +567,57 @@ namespace Exelius
 		EXE_ASSERT(id != kInvalidGameObjectID);
 		return id;
 	}
+
+	/// <summary>
+	/// Allocates IDs for many GameObjects. Free IDs are used first,
+	/// and the rest are taken from m_nextObjectId as one block.
+	/// </summary>
+	/// <param name="gameObjectIDs">Receives an available GameObjectID for each new GameObject.</param>
+	void GameObjectSystem::GetNextObjectIds(eastl::span<GameObjectID> gameObjectIDs)
+	{
+		size_t i = 0;
+		for (; i < gameObjectIDs.size() && !m_freeObjectIDs.empty(); ++i)
+		{
+			gameObjectIDs[i] = m_freeObjectIDs.front();
+			m_freeObjectIDs.pop_front();
+			EXE_ASSERT(gameObjectIDs[i] != kInvalidGameObjectID);
+		}
+
+		// The block must not reach the invalid ID.
+		EXE_ASSERT(gameObjectIDs.size() - i < static_cast<size_t>(kInvalidGameObjectID - m_nextObjectID));
+		for (; i < gameObjectIDs.size(); ++i)
+		{
+			gameObjectIDs[i] = m_nextObjectID++;
+		}
+	}
+
+	/// <summary>
+	/// Initializes GameObjects created together from the same prefab. Every
+	/// component list they use is grown once, before any object is initialized.
+	/// </summary>
+	/// <param name="prefab">The parsed JSON file containing object data.</param>
+	/// <param name="gameObjects">The objects to initialize.</param>
+	void GameObjectSystem::InitializeGameObjects(const GameObjectPrefab& prefab, const eastl::vector<GameObject*>& gameObjects)
+	{
+		// Grow each list once for the whole batch.
+		eastl::unordered_map<Component::Type, size_t> componentCounts;
+		for (const GameObjectPrefab::ComponentTemplate& componentTemplate : prefab.GetComponents())
+		{
+			componentCounts[componentTemplate.m_type] += gameObjects.size();
+		}
+
+		for (const auto& componentCountPair : componentCounts)
+		{
+			auto found = m_componentLists.find(componentCountPair.first);
+			if (found != m_componentLists.end())
+				found->second->ReserveComponents(componentCountPair.second);
+		}
+
+		// Serial, since client component factories and Initialize() are free to touch shared state.
+		for (GameObject* pGameObject : gameObjects)
+		{
+			EXE_ASSERT(pGameObject);
+			pGameObject->Initialize(prefab);
+		}
+	}
 }
\ No newline at end of file
@@ -9,8 +9,12 @@
 #include "source/debug/Log.h"
 
 #include <EASTL/deque.h>
+#include <EASTL/span.h>
 #include <EASTL/unordered_map.h>
 #include <EASTL/shared_ptr.h>
+#include <EASTL/vector.h>
+
+#include <mutex>
 
 /// <summary>
 /// Engine namespace. Everything owned by the engine will be inside this namespace.
@@ -18,6 +22,7 @@
 namespace Exelius
 {
 	class GameObject;
+	class GameObjectPrefab;
 	class ComponentFactory;
 
 	/// <summary>
@@ -39,6 +44,30 @@ namespace Exelius
 	class GameObjectSystem
 		: public Singleton<GameObjectSystem>
 	{
+		/// <summary>
+		/// Initializes the objects of a CreateGameObjects() batch
+		/// whose resource was not loaded yet, once it has.
+		/// </summary>
+		class SpawnListener;
+
+		/// <summary>
+		/// A prefab, along with the version of the file it was built from.
+		/// </summary>
+		struct CachedPrefab
+		{
+			/// <summary>
+			/// The slot and generation of the resource it was built from. Reloading or
+			/// unloading the resource advances the generation, so the prefab is out of date.
+			/// </summary>
+			uint32_t m_slotIndex;
+			uint32_t m_slotGeneration;
+
+			/// <summary>
+			/// The parsed file. nullptr if it is not a valid GameObject, so it isn't parsed again.
+			/// </summary>
+			eastl::shared_ptr<const GameObjectPrefab> m_pPrefab;
+		};
+
 		/// <summary>
 		/// Log for the GameObjectSystem.
 		/// </summary>
@@ -76,6 +105,22 @@ namespace Exelius
 		/// </summary>
 		eastl::unordered_map<GameObjectID, eastl::shared_ptr<GameObject>> m_gameObjects;
 
+		/// <summary>
+		/// Batches waiting on their resource to load. Each is removed once it is notified.
+		/// </summary>
+		eastl::vector<eastl::shared_ptr<SpawnListener>> m_pendingSpawns;
+
+		/// <summary>
+		/// The parsed GameObject files objects have been created from, keyed by file.
+		/// @see GetPrefab
+		/// </summary>
+		eastl::unordered_map<ResourceID, CachedPrefab> m_prefabs;
+
+		/// <summary>
+		/// A mutex used to protect the prefab cache from data race conditions.
+		/// </summary>
+		std::mutex m_prefabLock;
+
 	public:
 		/// <summary>
 		/// Constructor - initializes member values.
@@ -127,6 +172,35 @@ namespace Exelius
 		/// </returns>
 		GameObjectID CreateGameObject(const ResourceID& resourceID, CreationMode createMode = CreationMode::kQueueAndSignal);
 
+		/// <summary>
+		/// Creates many GameObjects from the same ResourceID, for wave spawns.
+		/// The resource is acquired and loaded once for the whole batch, and
+		/// the IDs are allocated together. Once the resource is loaded, every
+		/// component list is grown once and the objects are initialized from
+		/// the resource's prefab together. A single summary is logged.
+		/// 
+		/// When the resource is not loaded, the CreationMode is handled the
+		/// same as CreateGameObject(). Queued batches are initialized together
+		/// when the load completes.
+		/// @see GameObjectPrefab
+		/// </summary>
+		/// <param name="resourceID">- The ResourceID referring to a JSON file containing object data.</param>
+		/// <param name="count">- The number of GameObjects to create.</param>
+		/// <param name="gameObjectIDs">- Receives the ID of each created object. Must hold at least count IDs. Set to kInvalidGameObjectID upon failure.</param>
+		/// <param name="createMode">- How the GameObjectSystem should handle object creation if the resource isn't loaded.</param>
+		/// <returns>True if the objects were created, false otherwise.</returns>
+		bool CreateGameObjects(const ResourceID& resourceID, size_t count, eastl::span<GameObjectID> gameObjectIDs,
+			CreationMode createMode = CreationMode::kQueueAndSignal);
+
+		/// <summary>
+		/// Get the parsed form of a loaded GameObject file. It is parsed the first time
+		/// it is asked for, and shared by every later call. Once the file is reloaded or
+		/// unloaded, the old prefab is dropped and the next call parses the new version.
+		/// </summary>
+		/// <param name="resourceID">- The ResourceID referring to a loaded JSON file containing object data.</param>
+		/// <returns>The prefab, or nullptr if the file is not loaded or is not a valid GameObject.</returns>
+		eastl::shared_ptr<const GameObjectPrefab> GetPrefab(const ResourceID& resourceID);
+
 		/// <summary>
 		/// Gets the GameObject with the given ID.
 		/// 
@@ -146,6 +220,12 @@ namespace Exelius
 		/// <param name="gameObjectID">GameObjectID for an object to be destroyed.</param>
 		void DestroyGameObject(GameObjectID gameObjectID);
 
+		/// <summary>
+		/// Destroys many GameObjects, like DestroyGameObject(), logging a single summary.
+		/// </summary>
+		/// <param name="gameObjectIDs">GameObjectIDs for the objects to be destroyed. Invalid IDs are skipped.</param>
+		void DestroyGameObjects(eastl::span<const GameObjectID> gameObjectIDs);
+
 		/// <summary>
 		/// Requests that the Component of the given type be created
 		/// from the factory used by this GameObjectSystem.
@@ -294,8 +374,9 @@ namespace Exelius
 		/// <param name="componentType">The Registered component Type. This is the Key for component lookups.</param>
 		/// <param name="isUpdated">The type of component to be Released.</param>
 		/// <param name="isRendered">The type of component to be Released.</param>
+		/// <param name="isUpdatedInParallel">Split updates across the JobSystem workers. Only for components whose Update() touches nothing but their own data.</param>
 		template <class ComponentType>
-		void RegisterComponent(const Component::Type& componentType, bool isUpdated = false, bool isRendered = false)
+		void RegisterComponent(const Component::Type& componentType, bool isUpdated = false, bool isRendered = false, bool isUpdatedInParallel = false)
 		{
 			EXE_ASSERT(componentType == ComponentType::kType);
 			Log log("GameObjectSystem");
@@ -304,7 +385,7 @@ namespace Exelius
 
 			if (found == m_componentLists.end())
 			{
-				m_componentLists.try_emplace(componentType, new ComponentList<ComponentType>(isUpdated, isRendered));
+				m_componentLists.try_emplace(componentType, new ComponentList<ComponentType>(isUpdated, isRendered, isUpdatedInParallel));
 			}
 			else
 			{
@@ -319,5 +400,20 @@ namespace Exelius
 		/// </summary>
 		/// <returns>The available GameObjectID for a new GameObject.</returns>
 		GameObjectID GetNextObjectId();
+
+		/// <summary>
+		/// Allocates IDs for many GameObjects. Free IDs are used first,
+		/// and the rest are taken from m_nextObjectId as one block.
+		/// </summary>
+		/// <param name="gameObjectIDs">Receives an available GameObjectID for each new GameObject.</param>
+		void GetNextObjectIds(eastl::span<GameObjectID> gameObjectIDs);
+
+		/// <summary>
+		/// Initializes GameObjects created together from the same prefab. Every
+		/// component list they use is grown once, before any object is initialized.
+		/// </summary>
+		/// <param name="prefab">The parsed JSON file containing object data.</param>
+		/// <param name="gameObjects">The objects to initialize.</param>
+		void InitializeGameObjects(const GameObjectPrefab& prefab, const eastl::vector<GameObject*>& gameObjects);
 	};
 }
\ No newline at end of file
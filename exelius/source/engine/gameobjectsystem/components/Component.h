@@ -31,8 +31,17 @@ namespace Exelius
 
 	class GameObject;
 
+	template <class ComponentType>
+	class ComponentList;
+
 	class Component
 	{
+		/// <summary>
+		/// Lists hand recycled components to their new owners.
+		/// </summary>
+		template <class ComponentType>
+		friend class ComponentList;
+
 	public:
 		/// <summary>
 		/// The Component Type. Is a StringIntern.
@@ -2,6 +2,7 @@
 #include "source/utility/generic/Handle.h"
 #include "source/utility/generic/Macros.h"
 #include "source/debug/Log.h"
+#include "source/os/threads/ParallelAlgorithms.h"
 
 #include <EASTL/vector.h>
 #include <EASTL/deque.h>
@@ -36,16 +37,24 @@ namespace Exelius
 		/// </summary>
 		bool m_isRendered;
 
+		/// <summary>
+		/// Are the Components in this ComponentList updated across the JobSystem workers?
+		/// Only valid for components whose Update() touches nothing but their own data.
+		/// </summary>
+		bool m_isUpdatedInParallel;
+
 	public:
 		/// <summary>
 		/// Constructor - Sets the render and update booleans.
 		/// </summary>
 		/// <param name="isUpdated">True if updated, false if not.</param>
 		/// <param name="isRendered">True if rendered, false if not.param>
-		ComponentListBase(bool isUpdated = false, bool isRendered = false)
+		/// <param name="isUpdatedInParallel">True if updates may be split across worker threads, false if not.</param>
+		ComponentListBase(bool isUpdated = false, bool isRendered = false, bool isUpdatedInParallel = false)
 			: m_gameObjectSystemLog("GameObjectSystem")
 			, m_isUpdated(isUpdated)
 			, m_isRendered(isRendered)
+			, m_isUpdatedInParallel(isUpdatedInParallel)
 		{
 			//
 		}
@@ -75,6 +84,13 @@ namespace Exelius
 		/// </summary>
 		/// <param name="handle">The handle of the component to release.</param>
 		virtual void ReleaseComponent(Handle handle) = 0;
+
+		/// <summary>
+		/// Makes room for a number of new components, so creating
+		/// that many grows the list at most once.
+		/// </summary>
+		/// <param name="componentCount">The number of components about to be created.</param>
+		virtual void ReserveComponents(size_t componentCount) = 0;
 	};
 
 	class GameObject;
@@ -104,8 +120,8 @@ namespace Exelius
 
 	public:
 
-		ComponentList(bool isUpdated = false, bool isRendered = false)
-			: ComponentListBase(isUpdated, isRendered)
+		ComponentList(bool isUpdated = false, bool isRendered = false, bool isUpdatedInParallel = false)
+			: ComponentListBase(isUpdated, isRendered, isUpdatedInParallel)
 		{
 			//
 		}
@@ -137,6 +153,9 @@ namespace Exelius
 				m_handles[handle.GetId()] = handle;
 				EXE_ASSERT(IsValidComponent(handle));
 
+				// The pooled component still points at the object that released it.
+				m_components[handle.GetId()].m_pOwner = pOwningObject;
+
 				m_componentLock.unlock();
 				return handle;
 			}
@@ -185,6 +204,23 @@ namespace Exelius
 				return;
 			}
 
+			if (m_isUpdatedInParallel)
+			{
+				// The list is locked for the whole update, so the workers can read it freely.
+				ParallelForRange(0, m_handles.size(), [this](size_t rangeBegin, size_t rangeEnd)
+					{
+						for (size_t i = rangeBegin; i < rangeEnd; ++i)
+						{
+							// Do not update inactive components.
+							if (m_handles[i].IsValid())
+								m_components[i].Update();
+						}
+					});
+
+				m_componentLock.unlock();
+				return;
+			}
+
 			for (size_t i = 0; i < m_handles.size(); ++i)
 			{
 				// Do not update inactive components.
@@ -242,5 +278,20 @@ namespace Exelius
 
 			m_componentLock.unlock();
 		}
+
+		virtual void ReserveComponents(size_t componentCount) final override
+		{
+			m_componentLock.lock();
+
+			// Pooled components are reused first, so only the rest need room.
+			if (componentCount > m_freeHandles.size())
+			{
+				const size_t reservedCount = m_components.size() + componentCount - m_freeHandles.size();
+				m_components.reserve(reservedCount);
+				m_handles.reserve(reservedCount);
+			}
+
+			m_componentLock.unlock();
+		}
 	};
 }
@@ -77,9 +77,7 @@ namespace Exelius
 		// Get the transform component sibling.
 		auto transformComponent = m_pOwner->GetComponent<TransformComponent>();
 
-		ResourceHandle spriteSheet(m_spriteSheetID);
-
-		auto* pSheet = spriteSheet.GetAs<SpritesheetResource>();
+		auto* pSheet = m_spriteSheet.GetAs<SpritesheetResource>();
 
 		if (!pSheet)
 			return;
@@ -100,26 +98,20 @@ namespace Exelius
 
 	void SpriteComponent::Destroy()
 	{
-		ResourceHandle spriteSheet(m_spriteSheetID);
-		spriteSheet.UnlockResource();
+		m_spriteSheet.Release();
 	}
 
 	bool SpriteComponent::ParseSpritesheet(const rapidjson::Value& spritesheetData)
 	{
 		EXE_ASSERT(spritesheetData.IsString());
 
-		m_spriteSheetID = spritesheetData.GetString();
-		EXE_ASSERT(m_spriteSheetID.IsValid());
-
-		ResourceHandle spriteSheet(m_spriteSheetID);
-		//EXE_ASSERT(spriteSheet.IsReferenceHeld());
-
-		//spriteSheet.SetResourceID(m_spriteSheetID);
-
-		spriteSheet.QueueLoad(true);
+		// A reused component may still hold the spritesheet it had before.
+		m_spriteSheet.Release();
+		m_spriteSheet.SetResourceID(spritesheetData.GetString());
+		EXE_ASSERT(m_spriteSheet.GetID().IsValid());
 
-		// We lock here until this component is destroyed.
-		spriteSheet.LockResource();
+		// The handle holds the spritesheet until this component is destroyed.
+		m_spriteSheet.QueueLoad(true);
 
 		return true;
 	}
@@ -1,6 +1,6 @@
 #pragma once
 #include "source/engine/gameobjectsystem/components/Component.h"
-#include "source/resource/ResourceHelpers.h"
+#include "source/resource/ResourceHandle.h"
 
 /// <summary>
 /// Engine namespace. Everything owned by the engine will be inside this namespace.
@@ -11,7 +11,8 @@ namespace Exelius
 	class SpriteComponent
 		: public Component
 	{
-		ResourceID m_spriteSheetID;
+		// Held from initialization until destroyed. Mutable because Get() caches the resource.
+		mutable ResourceHandle m_spriteSheet;
 		StringIntern m_spriteID;
 
 		float m_xOffset;
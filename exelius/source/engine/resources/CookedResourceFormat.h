@@ -0,0 +1,186 @@
+#pragma once
+#include <EASTL/span.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// The binary formats written by the asset cooker (exeliuscooker) for resources
+	/// that are authored as JSON. A cooked file keeps the name of its source file,
+	/// so resource IDs don't change, and resources tell the two apart by the magic
+	/// number at the start of the data.
+	///
+	/// Every cooked file is a CookedHeader followed by the payload. The payload is a
+	/// fixed size description of the resource, its records, then a string table of
+	/// null terminated strings. Records refer to strings by their offset into the
+	/// table, so loading is only validating the sizes and turning offsets into pointers.
+	///
+	/// Every field is little-endian and 4 byte aligned, so cooked data is read in place
+	/// on the platforms the engine targets. The version of a format must be bumped
+	/// whenever its layout changes, and old cooked files are then rejected.
+	/// </summary>
+	namespace CookedFormat
+	{
+		/// <summary>
+		/// "EXCK" when read as a little-endian uint32.
+		/// </summary>
+		static constexpr uint32_t kMagic = 0x4B435845;
+
+		/// <summary>
+		/// What a cooked file contains.
+		/// </summary>
+		enum class Kind : uint16_t
+		{
+			kSpritesheet = 1,
+			kFont = 2
+		};
+
+		static constexpr uint16_t kSpritesheetVersion = 1;
+		static constexpr uint16_t kFontVersion = 1;
+	}
+
+	/// <summary>
+	/// The start of every cooked file.
+	/// </summary>
+	struct CookedHeader
+	{
+		uint32_t m_magic;
+		CookedFormat::Kind m_kind;
+		uint16_t m_version;
+
+		/// <summary>
+		/// The bytes following the header.
+		/// </summary>
+		uint32_t m_payloadSize;
+
+		uint32_t m_reserved;
+	};
+
+	/// <summary>
+	/// A cooked .spsh payload, followed by m_spriteCount CookedSprites and the string table.
+	/// </summary>
+	struct CookedSpritesheet
+	{
+		uint32_t m_textureNameOffset;
+		uint32_t m_spriteCount;
+		uint32_t m_stringTableSize;
+		uint32_t m_reserved;
+	};
+
+	struct CookedSprite
+	{
+		uint32_t m_nameOffset;
+		float m_left;
+		float m_top;
+		float m_width;
+		float m_height;
+	};
+
+	/// <summary>
+	/// A cooked .font payload, followed by m_glyphCount CookedGlyphs and the string table.
+	/// The glyph rects are already laid out, so nothing is computed at load.
+	/// </summary>
+	struct CookedFont
+	{
+		uint32_t m_textureNameOffset;
+		uint32_t m_glyphCount;
+		uint32_t m_stringTableSize;
+		float m_defaultWidth;
+		float m_defaultHeight;
+		uint32_t m_reserved;
+	};
+
+	struct CookedGlyph
+	{
+		uint32_t m_character;
+		float m_left;
+		float m_top;
+		float m_width;
+		float m_height;
+	};
+
+	static_assert(sizeof(CookedHeader) == 16, "The cooked header layout must not change.");
+	static_assert(sizeof(CookedSpritesheet) == 16 && sizeof(CookedSprite) == 20, "The cooked spritesheet layout must not change without a version bump.");
+	static_assert(sizeof(CookedFont) == 24 && sizeof(CookedGlyph) == 20, "The cooked font layout must not change without a version bump.");
+
+	namespace CookedFormat
+	{
+		/// <summary>
+		/// Checks if raw resource data is a cooked file, rather than its JSON source.
+		/// </summary>
+		/// <param name="data">- The raw data of the resource.</param>
+		/// <returns>True if the data starts with the cooked magic number.</returns>
+		inline bool IsCooked(eastl::span<const std::byte> data)
+		{
+			if (data.size() < sizeof(uint32_t))
+				return false;
+
+			uint32_t magic = 0;
+			std::memcpy(&magic, data.data(), sizeof(magic));
+			return magic == kMagic;
+		}
+
+		/// <summary>
+		/// Validates the header of a cooked file, and finds its payload.
+		/// </summary>
+		/// <param name="data">- The raw data of the resource.</param>
+		/// <param name="kind">- What the file should contain.</param>
+		/// <param name="version">- The only version of the format that can be read.</param>
+		/// <returns>The payload, or nullptr if the header is invalid or doesn't match.</returns>
+		inline const std::byte* GetPayload(eastl::span<const std::byte> data, Kind kind, uint16_t version)
+		{
+			// Records are read in place, so the data must be aligned for them.
+			if (data.size() < sizeof(CookedHeader) || reinterpret_cast<uintptr_t>(data.data()) % alignof(CookedHeader) != 0)
+				return nullptr;
+
+			const CookedHeader* pHeader = reinterpret_cast<const CookedHeader*>(data.data());
+			if (pHeader->m_magic != kMagic || pHeader->m_kind != kind || pHeader->m_version != version)
+				return nullptr;
+
+			if (pHeader->m_payloadSize != data.size() - sizeof(CookedHeader))
+				return nullptr;
+
+			return data.data() + sizeof(CookedHeader);
+		}
+
+		/// <summary>
+		/// Checks that a payload is exactly its description, its records and its string table,
+		/// and that the string table ends with a null terminator.
+		/// </summary>
+		/// <param name="data">- The raw data the payload was found in.</param>
+		/// <param name="descriptionSize">- The size of the payload's description.</param>
+		/// <param name="recordCount">- The number of records following the description.</param>
+		/// <param name="recordSize">- The size of each record.</param>
+		/// <param name="stringTableSize">- The size of the string table following the records.</param>
+		/// <returns>True if the sizes add up and the string table is terminated.</returns>
+		inline bool ValidatePayload(eastl::span<const std::byte> data, size_t descriptionSize, uint32_t recordCount, size_t recordSize, uint32_t stringTableSize)
+		{
+			const uint64_t expectedSize = sizeof(CookedHeader) + descriptionSize + static_cast<uint64_t>(recordCount) * recordSize + stringTableSize;
+			if (expectedSize != data.size() || stringTableSize == 0)
+				return false;
+
+			return data[data.size() - 1] == std::byte(0);
+		}
+
+		/// <summary>
+		/// Turns a string table offset into a pointer, checking it is inside the table.
+		/// </summary>
+		/// <param name="pStringTable">- The start of the string table.</param>
+		/// <param name="stringTableSize">- The size of the string table, which ends with a null terminator.</param>
+		/// <param name="offset">- The offset of the string.</param>
+		/// <returns>The string, or nullptr if the offset is outside the table.</returns>
+		inline const char* GetString(const char* pStringTable, uint32_t stringTableSize, uint32_t offset)
+		{
+			if (offset >= stringTableSize)
+				return nullptr;
+
+			return pStringTable + offset;
+		}
+	}
+}
\ No newline at end of file
@@ -19,7 +19,6 @@ namespace Exelius
 
 		virtual Resource* CreateResource(const ResourceID& resourceID) override;
 
-	protected:
 		virtual ResourceType::Type GetResourceType(const ResourceID& resourceID) const override;
 	};
 }
\ No newline at end of file
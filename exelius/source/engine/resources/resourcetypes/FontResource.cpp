@@ -1,6 +1,7 @@
 #include "EXEPCH.h"
 #include "FontResource.h"
-#include "source/resource/ResourceHandle.h"
+#include "source/engine/resources/CookedResourceFormat.h"
+#include "source/resource/ResourceLoader.h"
 
 #include <rapidjson/document.h>
 /// <summary>
@@ -18,17 +19,24 @@ namespace Exelius
 
 	Resource::LoadResult FontResource::Load(eastl::vector<std::byte>&& data)
 	{
-        // Set the raw byte data to a string value.
-        m_text = eastl::string((const char*)data.begin(), (const char*)data.end());
-        if (m_text.empty())
+        return Load(eastl::span<const std::byte>(data.data(), data.size()));
+	}
+
+	Resource::LoadResult FontResource::Load(eastl::span<const std::byte> data)
+	{
+        if (data.empty())
         {
             m_resourceManagerLog.Warn("Failed to read data in Spritesheet Resource.");
             return LoadResult::kFailed;
         }
 
-        // Parse the text as JSON data.
+        // Cooked fonts have their glyphs laid out already.
+        if (CookedFormat::IsCooked(data))
+            return LoadCooked(data);
+
+        // Parse the raw bytes as JSON data. The view isn't null terminated, so pass the length.
         rapidjson::Document jsonDoc;
-        if (jsonDoc.Parse(m_text.c_str()).HasParseError())
+        if (jsonDoc.Parse((const char*)data.data(), data.size()).HasParseError())
         {
             m_resourceManagerLog.Error("Failed to Parse JSON.");
             return LoadResult::kFailed;
@@ -50,15 +58,9 @@ namespace Exelius
         m_textureResourceID = textureMember->value.GetString();
         EXE_ASSERT(m_textureResourceID.IsValid());
 
-        ResourceHandle textureResource(m_textureResourceID);
-        //EXE_ASSERT(textureResource.IsReferenceHeld());
-
-        // TODO:
-        //  This might be more efficient if this is false, so that all loading can be queued together.
-        //  Although, this will need to be nicely managed by the user in some way... otherwise,
-        //  the resource thread will never know if the queue is ready to process. Something to think about...
-        textureResource.QueueLoad(true);
-        textureResource.LockResource();
+        // Our entry holds the texture until we are unloaded. Texture loads are
+        // queued together with ours when the dependency is already known.
+        ResourceLoader::GetInstance()->AcquireDependency(GetResourceID(), m_textureResourceID);
 
         // THis may not exist, which is okay.
         auto monospaced = jsonDoc.FindMember("Monospaced");
@@ -127,12 +129,57 @@ namespace Exelius
 
         }
 
-		return LoadResult::kKeptRawData;
+		return LoadResult::kDiscardRawData;
+	}
+
+	/// <summary>
+	/// Loads a font written by the asset cooker. @see CookedFont
+	/// </summary>
+	/// <param name="data">- The cooked file's contents.</param>
+	/// <returns>The result of the load operation.</returns>
+	Resource::LoadResult FontResource::LoadCooked(eastl::span<const std::byte> data)
+	{
+        const std::byte* pPayload = CookedFormat::GetPayload(data, CookedFormat::Kind::kFont, CookedFormat::kFontVersion);
+        if (!pPayload || data.size() - sizeof(CookedHeader) < sizeof(CookedFont))
+        {
+            m_resourceManagerLog.Warn("Cooked font '{}' is invalid or was cooked for a different version. Cook it again.", GetResourceID().Get().c_str());
+            return LoadResult::kFailed;
+        }
+
+        const CookedFont* pFont = reinterpret_cast<const CookedFont*>(pPayload);
+        if (!CookedFormat::ValidatePayload(data, sizeof(CookedFont), pFont->m_glyphCount, sizeof(CookedGlyph), pFont->m_stringTableSize))
+        {
+            m_resourceManagerLog.Warn("Cooked font '{}' is truncated or corrupt.", GetResourceID().Get().c_str());
+            return LoadResult::kFailed;
+        }
+
+        const CookedGlyph* pGlyphs = reinterpret_cast<const CookedGlyph*>(pPayload + sizeof(CookedFont));
+        const char* pStringTable = reinterpret_cast<const char*>(pGlyphs + pFont->m_glyphCount);
+
+        const char* pTextureName = CookedFormat::GetString(pStringTable, pFont->m_stringTableSize, pFont->m_textureNameOffset);
+        if (!pTextureName)
+        {
+            m_resourceManagerLog.Warn("Cooked font '{}' has no texture.", GetResourceID().Get().c_str());
+            return LoadResult::kFailed;
+        }
+
+        m_fontDefaultWidth = pFont->m_defaultWidth;
+        m_fontDefaultHeight = pFont->m_defaultHeight;
+
+        for (uint32_t glyphIndex = 0; glyphIndex < pFont->m_glyphCount; ++glyphIndex)
+        {
+            const CookedGlyph& glyph = pGlyphs[glyphIndex];
+            m_glyphs.try_emplace(static_cast<char>(glyph.m_character), glyph.m_left, glyph.m_top, glyph.m_width, glyph.m_height);
+        }
+
+        m_textureResourceID = pTextureName;
+        ResourceLoader::GetInstance()->AcquireDependency(GetResourceID(), m_textureResourceID);
+
+		return LoadResult::kDiscardRawData;
 	}
 
 	void FontResource::Unload()
 	{
-		ResourceHandle textureResource(m_textureResourceID);
-		textureResource.UnlockResource();
+		// The texture is released by the ResourceDatabase along with our entry.
 	}
 }
\ No newline at end of file
@@ -12,10 +12,6 @@ namespace Exelius
 	{
 		ResourceID m_textureResourceID;
 
-		// TESTING ONLY
-		eastl::string m_text;
-
-
 		eastl::unordered_map<char, FRectangle> m_glyphs;
 		float m_fontDefaultWidth;
 		float m_fontDefaultHeight;
@@ -28,6 +24,7 @@ namespace Exelius
 		virtual ~FontResource() final override = default;
 
 		virtual LoadResult Load(eastl::vector<std::byte>&& data) final override;
+		virtual LoadResult Load(eastl::span<const std::byte> data) final override;
 		virtual void Unload() final override;
 
 		FRectangle GetGlyphRect(char c)
@@ -46,7 +43,12 @@ namespace Exelius
 		float GetDefaultFontWidth() const { return m_fontDefaultWidth; }
 		float GetDefaultFontHeight() const { return m_fontDefaultHeight; }
 
-		// TESTING ONLY
-		const eastl::string& GetRawText() const { return m_text; }
+	private:
+		/// <summary>
+		/// Loads a font written by the asset cooker. @see CookedFont
+		/// </summary>
+		/// <param name="data">- The cooked file's contents.</param>
+		/// <returns>The result of the load operation.</returns>
+		LoadResult LoadCooked(eastl::span<const std::byte> data);
 	};
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 #include "EXEPCH.h"
 #include "SpritesheetResource.h"
 
-#include "source/resource/ResourceHandle.h"
+#include "source/engine/resources/CookedResourceFormat.h"
+#include "source/resource/ResourceLoader.h"
 
 #include <rapidjson/document.h>
 
@@ -18,17 +19,24 @@ namespace Exelius
 
     Resource::LoadResult SpritesheetResource::Load(eastl::vector<std::byte>&& data)
     {
-        // Set the raw byte data to a string value.
-        m_text = eastl::string((const char*)data.begin(), (const char*)data.end());
-        if (m_text.empty())
+        return Load(eastl::span<const std::byte>(data.data(), data.size()));
+    }
+
+    Resource::LoadResult SpritesheetResource::Load(eastl::span<const std::byte> data)
+    {
+        if (data.empty())
         {
             m_resourceManagerLog.Warn("Failed to read data in Spritesheet Resource.");
             return LoadResult::kFailed;
         }
 
-        // Parse the text as JSON data.
+        // Cooked spritesheets skip the JSON entirely.
+        if (CookedFormat::IsCooked(data))
+            return LoadCooked(data);
+
+        // Parse the raw bytes as JSON data. The view isn't null terminated, so pass the length.
         rapidjson::Document jsonDoc;
-        if (jsonDoc.Parse(m_text.c_str()).HasParseError())
+        if (jsonDoc.Parse((const char*)data.data(), data.size()).HasParseError())
         {
             m_resourceManagerLog.Error("Failed to Parse JSON.");
             return LoadResult::kFailed;
@@ -50,15 +58,9 @@ namespace Exelius
         m_textureResourceID = textureMember->value.GetString();
         EXE_ASSERT(m_textureResourceID.IsValid());
 
-        ResourceHandle textureResource(m_textureResourceID);
-        //EXE_ASSERT(textureResource.IsReferenceHeld());
-
-        // TODO:
-        //  This might be more efficient if this is false, so that all loading can be queued together.
-        //  Although, this will need to be nicely managed by the user in some way... otherwise,
-        //  the resource thread will never know if the queue is ready to process. Something to think about...
-        textureResource.QueueLoad(true);
-        textureResource.LockResource();
+        // Our entry holds the texture until we are unloaded. Texture loads are
+        // queued together with ours when the dependency is already known.
+        ResourceLoader::GetInstance()->AcquireDependency(GetResourceID(), m_textureResourceID);
 
         // Gather the data for all the sprites.
         auto spriteMember = jsonDoc.FindMember("Sprites");
@@ -110,12 +112,61 @@ namespace Exelius
             }
         }
 
-        return LoadResult::kKeptRawData;
+        return LoadResult::kDiscardRawData;
+    }
+
+    /// <summary>
+    /// Loads a spritesheet written by the asset cooker. @see CookedSpritesheet
+    /// </summary>
+    /// <param name="data">- The cooked file's contents.</param>
+    /// <returns>The result of the load operation.</returns>
+    Resource::LoadResult SpritesheetResource::LoadCooked(eastl::span<const std::byte> data)
+    {
+        const std::byte* pPayload = CookedFormat::GetPayload(data, CookedFormat::Kind::kSpritesheet, CookedFormat::kSpritesheetVersion);
+        if (!pPayload || data.size() - sizeof(CookedHeader) < sizeof(CookedSpritesheet))
+        {
+            m_resourceManagerLog.Warn("Cooked spritesheet '{}' is invalid or was cooked for a different version. Cook it again.", GetResourceID().Get().c_str());
+            return LoadResult::kFailed;
+        }
+
+        const CookedSpritesheet* pSpritesheet = reinterpret_cast<const CookedSpritesheet*>(pPayload);
+        if (!CookedFormat::ValidatePayload(data, sizeof(CookedSpritesheet), pSpritesheet->m_spriteCount, sizeof(CookedSprite), pSpritesheet->m_stringTableSize))
+        {
+            m_resourceManagerLog.Warn("Cooked spritesheet '{}' is truncated or corrupt.", GetResourceID().Get().c_str());
+            return LoadResult::kFailed;
+        }
+
+        const CookedSprite* pSprites = reinterpret_cast<const CookedSprite*>(pPayload + sizeof(CookedSpritesheet));
+        const char* pStringTable = reinterpret_cast<const char*>(pSprites + pSpritesheet->m_spriteCount);
+
+        const char* pTextureName = CookedFormat::GetString(pStringTable, pSpritesheet->m_stringTableSize, pSpritesheet->m_textureNameOffset);
+        if (!pTextureName || pSpritesheet->m_spriteCount == 0)
+        {
+            m_resourceManagerLog.Warn("Cooked spritesheet '{}' has no texture or no sprites.", GetResourceID().Get().c_str());
+            return LoadResult::kFailed;
+        }
+
+        for (uint32_t spriteIndex = 0; spriteIndex < pSpritesheet->m_spriteCount; ++spriteIndex)
+        {
+            const CookedSprite& sprite = pSprites[spriteIndex];
+            const char* pSpriteName = CookedFormat::GetString(pStringTable, pSpritesheet->m_stringTableSize, sprite.m_nameOffset);
+            if (!pSpriteName)
+            {
+                m_resourceManagerLog.Warn("Cooked spritesheet '{}' is truncated or corrupt.", GetResourceID().Get().c_str());
+                return LoadResult::kFailed;
+            }
+
+            m_sprites.try_emplace(pSpriteName, sprite.m_left, sprite.m_top, sprite.m_width, sprite.m_height);
+        }
+
+        m_textureResourceID = pTextureName;
+        ResourceLoader::GetInstance()->AcquireDependency(GetResourceID(), m_textureResourceID);
+
+        return LoadResult::kDiscardRawData;
     }
 
     void SpritesheetResource::Unload()
     {
-        ResourceHandle textureResource(m_textureResourceID);
-        textureResource.UnlockResource();
+        // The texture is released by the ResourceDatabase along with our entry.
     }
 }
\ No newline at end of file
@@ -15,8 +15,6 @@ namespace Exelius
 		//TextureResource* m_pTextureResource;
 		ResourceID m_textureResourceID;
 
-		// TESTING ONLY
-		eastl::string m_text;
 		eastl::unordered_map<StringIntern, FRectangle> m_sprites;
 
 	public:
@@ -27,6 +25,7 @@ namespace Exelius
 		virtual ~SpritesheetResource() final override = default;
 
 		virtual LoadResult Load(eastl::vector<std::byte>&& data) final override;
+		virtual LoadResult Load(eastl::span<const std::byte> data) final override;
 		virtual void Unload() final override;
 
 		FRectangle GetSprite(const StringIntern& name)
@@ -44,7 +43,12 @@ namespace Exelius
 
 		const ResourceID& GetTextureResource() const { return m_textureResourceID; }
 
-		// TESTING ONLY
-		const eastl::string& GetRawText() const { return m_text; }
+	private:
+		/// <summary>
+		/// Loads a spritesheet written by the asset cooker. @see CookedSpritesheet
+		/// </summary>
+		/// <param name="data">- The cooked file's contents.</param>
+		/// <returns>The result of the load operation.</returns>
+		LoadResult LoadCooked(eastl::span<const std::byte> data);
 	};
 }
\ No newline at end of file
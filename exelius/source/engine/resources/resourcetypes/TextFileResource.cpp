@@ -14,7 +14,12 @@ namespace Exelius
 
     Resource::LoadResult TextFileResource::Load(eastl::vector<std::byte>&& data)
     {
-        m_text = eastl::string((const char*)data.begin(), (const char*)data.end());
+        return Load(eastl::span<const std::byte>(data.data(), data.size()));
+    }
+
+    Resource::LoadResult TextFileResource::Load(eastl::span<const std::byte> data)
+    {
+        m_text.assign((const char*)data.data(), data.size());
         if (m_text.empty())
         {
             m_resourceManagerLog.Warn("Failed to write data to TextFile Resource.");
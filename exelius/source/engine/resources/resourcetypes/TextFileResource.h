@@ -21,6 +21,7 @@ namespace Exelius
 		virtual ~TextFileResource() = default;
 
 		virtual LoadResult Load(eastl::vector<std::byte>&& data) final override;
+		virtual LoadResult Load(eastl::span<const std::byte> data) final override;
 		virtual void Unload() final override {}
 
 		const eastl::string& GetRawText() const { return m_text; }
@@ -19,12 +19,18 @@ namespace Exelius
     }
 
     Resource::LoadResult TextureResource::Load(eastl::vector<std::byte>&& data)
+    {
+        return Load(eastl::span<const std::byte>(data.data(), data.size()));
+    }
+
+    Resource::LoadResult TextureResource::Load(eastl::span<const std::byte> data)
     {
         delete m_pTexture;
 
+        // The texture decodes into its own pixels, so the raw data isn't needed afterwards.
         m_pTexture = new Texture();
         if (m_pTexture->LoadFromMemory(data.data(), data.size()))
-            return LoadResult::kKeptRawData;
+            return LoadResult::kDiscardRawData;
         return LoadResult::kFailed;
     }
 
@@ -33,4 +39,10 @@ namespace Exelius
         delete m_pTexture;
         m_pTexture = nullptr;
     }
+
+    size_t TextureResource::GetMemorySize() const
+    {
+        // The compressed image is much smaller than the pixels it decodes to.
+        return m_pTexture ? m_pTexture->GetMemorySize() : 0;
+    }
 }
\ No newline at end of file
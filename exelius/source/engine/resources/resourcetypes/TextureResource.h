@@ -21,7 +21,9 @@ namespace Exelius
 		virtual ~TextureResource() final override;
 
 		virtual LoadResult Load(eastl::vector<std::byte>&& data) final override;
+		virtual LoadResult Load(eastl::span<const std::byte> data) final override;
 		virtual void Unload() final override;
+		virtual size_t GetMemorySize() const final override;
 
 		Texture* GetTexture() const { return m_pTexture; }
 	};
@@ -2,6 +2,8 @@
 
 #include "source/engine/settings/ConfigFile.h"
 #include "source/debug/LogManager.h"
+#include "source/os/threads/JobSystem.h"
+#include "source/resource/ResourceLoader.h"
 #include "source/utility/io/File.h"
 
 #include <EASTL/vector.h>
@@ -117,6 +119,204 @@ namespace Exelius
 		return true;
 	}
 
+	bool ConfigFile::PopulateJobSystemData(JobSystemDefinition& jobSystemDefinition) const
+	{
+		if (!m_isOpen)
+		{
+			m_defaultLog.Error("Failed to populate job system data: Config File is not open or parsed correctly.");
+			return false;
+		}
+
+		// Traverse tree to "JobSystem".
+		if (!m_parsedData.HasMember("JobSystem"))
+		{
+			m_defaultLog.Warn("'JobSystem' member not found in config file. Defaulting all job system settings.");
+			return false;
+		}
+		auto jobSystemMember = m_parsedData.FindMember("JobSystem");
+		EXE_ASSERT(jobSystemMember != m_parsedData.MemberEnd());
+		if (!jobSystemMember->value.IsObject())
+		{
+			m_defaultLog.Warn("'JobSystem' member in config file is not an Object. Defaulting all job system settings.");
+			return false;
+		}
+
+		bool successResult = true;
+		if (jobSystemMember->value.HasMember("WorkerCount") && jobSystemMember->value["WorkerCount"].IsUint())
+		{
+			jobSystemDefinition.m_workerCount = jobSystemMember->value["WorkerCount"].GetUint();
+		}
+		else
+		{
+			m_defaultLog.Warn("'WorkerCount' member in 'JobSystem' was not found or is not an unsigned integer type. Defaulting Worker Count to: {}", jobSystemDefinition.m_workerCount);
+			successResult = false;
+		}
+
+		if (jobSystemMember->value.HasMember("MaxBackgroundWorkers") && jobSystemMember->value["MaxBackgroundWorkers"].IsUint())
+		{
+			jobSystemDefinition.m_maxBackgroundWorkers = jobSystemMember->value["MaxBackgroundWorkers"].GetUint();
+		}
+		else
+		{
+			m_defaultLog.Warn("'MaxBackgroundWorkers' member in 'JobSystem' was not found or is not an unsigned integer type. Defaulting Max Background Workers to: {}", jobSystemDefinition.m_maxBackgroundWorkers);
+			successResult = false;
+		}
+
+		if (jobSystemMember->value.HasMember("ThreadNamePrefix") && jobSystemMember->value["ThreadNamePrefix"].IsString())
+		{
+			jobSystemDefinition.m_threadNamePrefix = jobSystemMember->value["ThreadNamePrefix"].GetString();
+		}
+		else
+		{
+			m_defaultLog.Warn("'ThreadNamePrefix' member in 'JobSystem' was not found or is not a string. Defaulting Thread Name Prefix to: {}", jobSystemDefinition.m_threadNamePrefix.c_str());
+			successResult = false;
+		}
+
+		if (jobSystemMember->value.HasMember("PinWorkers") && jobSystemMember->value["PinWorkers"].IsBool())
+		{
+			jobSystemDefinition.m_pinWorkers = jobSystemMember->value["PinWorkers"].GetBool();
+		}
+		else
+		{
+			m_defaultLog.Warn("'PinWorkers' member in 'JobSystem' was not found or is not a boolean type. Defaulting Pin Workers to: {}", jobSystemDefinition.m_pinWorkers);
+			successResult = false;
+		}
+
+		if (jobSystemMember->value.HasMember("GroupByNumaNode") && jobSystemMember->value["GroupByNumaNode"].IsBool())
+		{
+			jobSystemDefinition.m_groupByNumaNode = jobSystemMember->value["GroupByNumaNode"].GetBool();
+		}
+		else
+		{
+			m_defaultLog.Warn("'GroupByNumaNode' member in 'JobSystem' was not found or is not a boolean type. Defaulting Group By NUMA Node to: {}", jobSystemDefinition.m_groupByNumaNode);
+			successResult = false;
+		}
+
+		if (!PopulateReservedCores(jobSystemMember->value, jobSystemDefinition))
+			successResult = false;
+
+		return successResult;
+	}
+
+	bool ConfigFile::PopulateResourceLoaderData(ResourceLoaderDefinition& resourceLoaderDefinition) const
+	{
+		if (!m_isOpen)
+		{
+			m_defaultLog.Error("Failed to populate resource loader data: Config File is not open or parsed correctly.");
+			return false;
+		}
+
+		// Traverse tree to "ResourceLoader".
+		if (!m_parsedData.HasMember("ResourceLoader"))
+		{
+			m_defaultLog.Warn("'ResourceLoader' member not found in config file. Defaulting all resource loader settings.");
+			return false;
+		}
+		auto resourceLoaderMember = m_parsedData.FindMember("ResourceLoader");
+		EXE_ASSERT(resourceLoaderMember != m_parsedData.MemberEnd());
+		if (!resourceLoaderMember->value.IsObject())
+		{
+			m_defaultLog.Warn("'ResourceLoader' member in config file is not an Object. Defaulting all resource loader settings.");
+			return false;
+		}
+
+		bool successResult = true;
+		if (resourceLoaderMember->value.HasMember("IOThreadCount") && resourceLoaderMember->value["IOThreadCount"].IsUint())
+		{
+			resourceLoaderDefinition.m_ioThreadCount = resourceLoaderMember->value["IOThreadCount"].GetUint();
+		}
+		else
+		{
+			m_defaultLog.Warn("'IOThreadCount' member in 'ResourceLoader' was not found or is not an unsigned integer type. Defaulting I/O Thread Count to: {}", resourceLoaderDefinition.m_ioThreadCount);
+			successResult = false;
+		}
+
+		if (resourceLoaderMember->value.HasMember("MaxBytesInFlight") && resourceLoaderMember->value["MaxBytesInFlight"].IsUint64())
+		{
+			resourceLoaderDefinition.m_maxBytesInFlight = static_cast<size_t>(resourceLoaderMember->value["MaxBytesInFlight"].GetUint64());
+		}
+		else
+		{
+			m_defaultLog.Warn("'MaxBytesInFlight' member in 'ResourceLoader' was not found or is not an unsigned integer type. Defaulting Max Bytes In Flight to: {}", resourceLoaderDefinition.m_maxBytesInFlight);
+			successResult = false;
+		}
+
+		if (resourceLoaderMember->value.HasMember("IOBatchSize") && resourceLoaderMember->value["IOBatchSize"].IsUint())
+		{
+			resourceLoaderDefinition.m_ioBatchSize = resourceLoaderMember->value["IOBatchSize"].GetUint();
+		}
+		else
+		{
+			m_defaultLog.Warn("'IOBatchSize' member in 'ResourceLoader' was not found or is not an unsigned integer type. Defaulting I/O Batch Size to: {}", resourceLoaderDefinition.m_ioBatchSize);
+			successResult = false;
+		}
+
+		if (resourceLoaderMember->value.HasMember("UseIOUring") && resourceLoaderMember->value["UseIOUring"].IsBool())
+		{
+			resourceLoaderDefinition.m_useIOUring = resourceLoaderMember->value["UseIOUring"].GetBool();
+		}
+		else
+		{
+			m_defaultLog.Warn("'UseIOUring' member in 'ResourceLoader' was not found or is not a boolean type. Defaulting Use io_uring to: {}", resourceLoaderDefinition.m_useIOUring);
+			successResult = false;
+		}
+
+		if (resourceLoaderMember->value.HasMember("DefaultCacheBudget") && resourceLoaderMember->value["DefaultCacheBudget"].IsUint64())
+		{
+			resourceLoaderDefinition.m_defaultCacheBudget = static_cast<size_t>(resourceLoaderMember->value["DefaultCacheBudget"].GetUint64());
+		}
+		else
+		{
+			m_defaultLog.Warn("'DefaultCacheBudget' member in 'ResourceLoader' was not found or is not an unsigned integer type. Defaulting Default Cache Budget to: {}", resourceLoaderDefinition.m_defaultCacheBudget);
+			successResult = false;
+		}
+
+		if (!PopulateCacheBudgets(resourceLoaderMember->value, resourceLoaderDefinition))
+			successResult = false;
+
+		if (resourceLoaderMember->value.HasMember("CompletionBudgetMicroseconds") && resourceLoaderMember->value["CompletionBudgetMicroseconds"].IsUint())
+		{
+			resourceLoaderDefinition.m_completionBudgetMicroseconds = resourceLoaderMember->value["CompletionBudgetMicroseconds"].GetUint();
+		}
+		else
+		{
+			m_defaultLog.Warn("'CompletionBudgetMicroseconds' member in 'ResourceLoader' was not found or is not an unsigned integer type. Defaulting Completion Budget Microseconds to: {}", resourceLoaderDefinition.m_completionBudgetMicroseconds);
+			successResult = false;
+		}
+
+		if (resourceLoaderMember->value.HasMember("ClientResourcePath") && resourceLoaderMember->value["ClientResourcePath"].IsString())
+		{
+			resourceLoaderDefinition.m_clientResourcePath = resourceLoaderMember->value["ClientResourcePath"].GetString();
+		}
+		else
+		{
+			m_defaultLog.Warn("'ClientResourcePath' member in 'ResourceLoader' was not found or is not a string. Defaulting Client Resource Path to: {}", resourceLoaderDefinition.m_clientResourcePath.c_str());
+			successResult = false;
+		}
+
+		if (resourceLoaderMember->value.HasMember("HotReload") && resourceLoaderMember->value["HotReload"].IsBool())
+		{
+			resourceLoaderDefinition.m_hotReload = resourceLoaderMember->value["HotReload"].GetBool();
+		}
+		else
+		{
+			m_defaultLog.Warn("'HotReload' member in 'ResourceLoader' was not found or is not a boolean type. Defaulting Hot Reload to: {}", resourceLoaderDefinition.m_hotReload);
+			successResult = false;
+		}
+
+		if (resourceLoaderMember->value.HasMember("HotReloadDebounceMilliseconds") && resourceLoaderMember->value["HotReloadDebounceMilliseconds"].IsUint())
+		{
+			resourceLoaderDefinition.m_hotReloadDebounceMilliseconds = resourceLoaderMember->value["HotReloadDebounceMilliseconds"].GetUint();
+		}
+		else
+		{
+			m_defaultLog.Warn("'HotReloadDebounceMilliseconds' member in 'ResourceLoader' was not found or is not an unsigned integer type. Defaulting Hot Reload Debounce Milliseconds to: {}", resourceLoaderDefinition.m_hotReloadDebounceMilliseconds);
+			successResult = false;
+		}
+
+		return successResult;
+	}
+
 	//---------------------------------------------------------------------------------------------------------------
 	// Private
 	//---------------------------------------------------------------------------------------------------------------
@@ -483,4 +683,88 @@ namespace Exelius
 
 		return true;
 	}
+
+	bool ConfigFile::PopulateReservedCores(const rapidjson::Value& jobSystemMember, JobSystemDefinition& jobSystemDefinition) const
+	{
+		// Traverse tree to "ReservedCores".
+		if (!jobSystemMember.HasMember("ReservedCores"))
+		{
+			m_defaultLog.Warn("'ReservedCores' member not found in 'JobSystem'. No cores will be reserved.");
+			return false;
+		}
+		auto reservedCoresMember = jobSystemMember.FindMember("ReservedCores");
+		EXE_ASSERT(reservedCoresMember != jobSystemMember.MemberEnd());
+		if (!reservedCoresMember->value.IsObject())
+		{
+			m_defaultLog.Warn("'ReservedCores' member in 'JobSystem' is not an Object. No cores will be reserved.");
+			return false;
+		}
+
+		static constexpr const char* kReservedThreadNames[] = { "Render", "Socket", "ResourceIO" };
+		static_assert(sizeof(kReservedThreadNames) / sizeof(kReservedThreadNames[0]) == static_cast<size_t>(ReservedThread::kCount), "Every ReservedThread needs a config name.");
+
+		bool successResult = true;
+		for (size_t reservedThreadIndex = 0; reservedThreadIndex < static_cast<size_t>(ReservedThread::kCount); ++reservedThreadIndex)
+		{
+			const char* pThreadName = kReservedThreadNames[reservedThreadIndex];
+			if (reservedCoresMember->value.HasMember(pThreadName) && reservedCoresMember->value[pThreadName].IsInt())
+			{
+				jobSystemDefinition.m_reservedCores[reservedThreadIndex] = reservedCoresMember->value[pThreadName].GetInt();
+			}
+			else
+			{
+				m_defaultLog.Warn("'{}' member in 'ReservedCores' was not found or is not an integer type. No core will be reserved for it.", pThreadName);
+				successResult = false;
+			}
+		}
+
+		return successResult;
+	}
+
+	bool ConfigFile::PopulateCacheBudgets(const rapidjson::Value& resourceLoaderMember, ResourceLoaderDefinition& resourceLoaderDefinition) const
+	{
+		// Traverse tree to "CacheBudgets".
+		if (!resourceLoaderMember.HasMember("CacheBudgets"))
+		{
+			m_defaultLog.Warn("'CacheBudgets' member not found in 'ResourceLoader'. Every resource type will use the default cache budget.");
+			return false;
+		}
+		auto cacheBudgetsMember = resourceLoaderMember.FindMember("CacheBudgets");
+		EXE_ASSERT(cacheBudgetsMember != resourceLoaderMember.MemberEnd());
+		if (!cacheBudgetsMember->value.IsArray())
+		{
+			m_defaultLog.Warn("'CacheBudgets' member in 'ResourceLoader' is not an Array. Every resource type will use the default cache budget.");
+			return false;
+		}
+
+		bool successResult = true;
+		for (rapidjson::SizeType i = 0; i < cacheBudgetsMember->value.Size(); ++i)
+		{
+			const rapidjson::Value& cacheBudget = cacheBudgetsMember->value[i];
+			if (!cacheBudget.IsObject())
+			{
+				m_defaultLog.Warn("Member at index {} in 'CacheBudgets' is not an Object.", static_cast<size_t>(i));
+				successResult = false;
+				continue;
+			}
+
+			if (!cacheBudget.HasMember("Type") || !cacheBudget["Type"].IsUint())
+			{
+				m_defaultLog.Warn("'Type' member of Object at index {} in 'CacheBudgets' was not found or is not an unsigned integer type. Skipping it.", static_cast<size_t>(i));
+				successResult = false;
+				continue;
+			}
+
+			if (!cacheBudget.HasMember("Bytes") || !cacheBudget["Bytes"].IsUint64())
+			{
+				m_defaultLog.Warn("'Bytes' member of Object at index {} in 'CacheBudgets' was not found or is not an unsigned integer type. Skipping it.", static_cast<size_t>(i));
+				successResult = false;
+				continue;
+			}
+
+			resourceLoaderDefinition.m_cacheBudgets[cacheBudget["Type"].GetUint()] = static_cast<size_t>(cacheBudget["Bytes"].GetUint64());
+		}
+
+		return successResult;
+	}
 }
\ No newline at end of file
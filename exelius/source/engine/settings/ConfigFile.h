@@ -14,6 +14,8 @@ namespace Exelius
 	struct FileLogDefinition;
 	struct ConsoleLogDefinition;
 	struct LogData;
+	struct JobSystemDefinition;
+	struct ResourceLoaderDefinition;
 
 	class ConfigFile
 	{
@@ -31,6 +33,10 @@ namespace Exelius
 
 		bool PopulateWindowData(eastl::string& windowTitle, Vector2u& windowSize, bool& isVSyncEnabled) const;
 
+		bool PopulateJobSystemData(JobSystemDefinition& jobSystemDefinition) const;
+
+		bool PopulateResourceLoaderData(ResourceLoaderDefinition& resourceLoaderDefinition) const;
+
 	private:
 		bool PopulateFileLogDefinition(FileLogDefinition& fileLog) const;
 
@@ -43,5 +49,9 @@ namespace Exelius
 		bool PopulateWindowSize(Vector2u& windowSize) const;
 
 		bool PopulateWindowVSync(bool& isVsyncEnabled) const;
+
+		bool PopulateReservedCores(const rapidjson::Value& jobSystemMember, JobSystemDefinition& jobSystemDefinition) const;
+
+		bool PopulateCacheBudgets(const rapidjson::Value& resourceLoaderMember, ResourceLoaderDefinition& resourceLoaderDefinition) const;
 	};
 }
\ No newline at end of file
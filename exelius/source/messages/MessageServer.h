@@ -18,7 +18,7 @@ namespace Exelius
 	{
 		using ReceiverList = eastl::vector<eastl::shared_ptr<MessageReceiver>>;
 		eastl::unordered_map<MessageID, ReceiverList> m_receivers;
-		RingBufferMT<Message*, 4096> m_messages;
+		RingBufferMPMC<Message*, 4096> m_messages;
 	public:
 		~MessageServer();
 
@@ -6,6 +6,7 @@
 
 #include "source/messages/MessageServer.h"
 #include "source/messages/exeliusmessages/networking/ConnectionMessages.h"
+#include "source/os/threads/JobSystem.h"
 
 #ifdef EXE_WINDOWS
 #define _WINSOCK_DEPRECATED_NO_WARNINGS
@@ -128,6 +129,9 @@ namespace Exelius
 
 	void SocketManager::SelectSockets()
 	{
+		if (s_pGlobalJobSystem)
+			s_pGlobalJobSystem->EnterReservedThread(ReservedThread::kSocket);
+
 		MessageServer* pMessageServer = MessageServer::GetInstance();
 		EXE_ASSERT(pMessageServer);
 
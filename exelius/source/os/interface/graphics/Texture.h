@@ -21,6 +21,8 @@ namespace Exelius
 
 		bool LoadFromMemory(const std::byte* pData, size_t dataSize) { return m_impl.LoadFromMemory(pData, dataSize); }
 
+		size_t GetMemorySize() const { return m_impl.GetMemorySize(); }
+
 		const ImplTexture& GetNativeTexture() const { return m_impl; }
 	};
 }
@@ -34,4 +34,13 @@ namespace Exelius
 
 		return true;
 	}
+
+	size_t SFMLTexture::GetMemorySize() const
+	{
+		if (!m_pSFMLTexture)
+			return 0;
+
+		const sf::Vector2u textureSize = m_pSFMLTexture->getSize();
+		return static_cast<size_t>(textureSize.x) * textureSize.y * 4;
+	}
 }
\ No newline at end of file
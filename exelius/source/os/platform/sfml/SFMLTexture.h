@@ -24,6 +24,11 @@ namespace Exelius
 
 		bool LoadFromMemory(const std::byte* pData, size_t dataSize);
 
+		/// <summary>
+		/// The bytes of the decoded pixels, 4 per pixel. 0 if nothing is loaded.
+		/// </summary>
+		size_t GetMemorySize() const;
+
 		sf::Texture* GetSFMLTexture() const { return m_pSFMLTexture; }
 	};
 }
\ No newline at end of file
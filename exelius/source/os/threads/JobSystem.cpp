@@ -1,67 +1,264 @@
 #include "EXEPCH.h"
 #include "JobSystem.h"
 
+#include <EASTL/sort.h>
+#include <cstdio>
+
 /// <summary>
 /// Engine namespace. Everything owned by the engine will be inside this namespace.
 /// </summary>
 namespace Exelius
 {
+    // Which worker queue the current thread owns, if any.
+    static thread_local JobSystem* s_pThreadJobSystem = nullptr;
+    static thread_local uint32_t s_threadWorkerIndex = 0;
+    static thread_local uint32_t s_threadStealSeed = 0;
+
+    // How many background jobs the current thread is inside of. Nested ones share the outermost job's lane.
+    static thread_local uint32_t s_threadBackgroundDepth = 0;
+    static thread_local uint32_t s_threadJobsSinceBackground = 0;
+
     JobSystem::JobSystem()
-        : m_jobCounter(0)
+        : m_pJobs(nullptr)
+        , m_backgroundJobCount(0)
+        , m_activeBackgroundWorkers(0)
+        , m_maxBackgroundWorkers(1)
+        , m_jobCounter(0)
+        , m_wakeEpoch(0)
+        , m_sleepingWorkers(0)
+        , m_quitWorkers(false)
+        , m_isNumaAware(false)
         , m_threadCount(0)
     {
         //
     }
 
-    bool JobSystem::Initialize()
+    JobSystem::~JobSystem()
+    {
+        if (m_workerQueues.empty())
+            return;
+
+        Shutdown();
+
+        for (WorkerQueue* pWorkerQueue : m_workerQueues)
+        {
+            EXELIUS_DELETE(pWorkerQueue);
+        }
+
+        m_workerQueues.clear();
+
+        for (JobPool* pJobPool : m_jobPools)
+        {
+            EXELIUS_DELETE(pJobPool);
+        }
+
+        m_jobPools.clear();
+        EXELIUS_DELETE_ARRAY(m_pJobs);
+
+        if (s_pThreadJobSystem == this)
+            s_pThreadJobSystem = nullptr;
+    }
+
+    bool JobSystem::Initialize(const JobSystemDefinition& definition /* = JobSystemDefinition() */)
     {
-        m_threadCount = static_cast<uint8_t>(std::thread::hardware_concurrency() - 1);
+        if (!m_workerQueues.empty())
+            return false;
+
+        m_definition = definition;
+
+        // Every core that is not set aside for another engine thread, one NUMA node after another if asked.
+        const uint32_t logicalCoreCount = ThreadHelpers::GetLogicalCoreCount();
+        eastl::vector<uint32_t> coreNumaNodes(logicalCoreCount, 0);
+        eastl::vector<uint32_t> availableCores;
+        availableCores.reserve(logicalCoreCount);
+
+        for (uint32_t coreIndex = 0; coreIndex < logicalCoreCount; ++coreIndex)
+        {
+            const int32_t* pReservedCoresBegin = m_definition.m_reservedCores;
+            const int32_t* pReservedCoresEnd = pReservedCoresBegin + static_cast<size_t>(ReservedThread::kCount);
+            if (eastl::find(pReservedCoresBegin, pReservedCoresEnd, static_cast<int32_t>(coreIndex)) != pReservedCoresEnd)
+                continue;
+
+            coreNumaNodes[coreIndex] = ThreadHelpers::GetNumaNode(coreIndex);
+            availableCores.emplace_back(coreIndex);
+        }
+
+        if (m_definition.m_groupByNumaNode)
+        {
+            eastl::stable_sort(availableCores.begin(), availableCores.end(), [&coreNumaNodes](uint32_t left, uint32_t right)
+                {
+                    return coreNumaNodes[left] < coreNumaNodes[right];
+                });
+        }
+
+        // The initializing thread executes jobs while it waits, so leave a core for it.
+        const uint32_t availableCoreCount = static_cast<uint32_t>(availableCores.size());
+        const uint32_t workerThreadCount = (m_definition.m_workerCount != 0) ? m_definition.m_workerCount : eastl::max(availableCoreCount, 2u) - 1;
+        m_threadCount = static_cast<uint8_t>(eastl::min(workerThreadCount, 255u));
+
+        // Queue 0 takes the first core but is never pinned, it belongs to whoever called us.
+        m_isNumaAware = false;
+        m_workerQueues.reserve(m_threadCount + 1);
+        for (uint32_t queueIndex = 0; queueIndex <= m_threadCount; ++queueIndex)
+        {
+            WorkerQueue* pWorkerQueue = EXELIUS_NEW(WorkerQueue());
+
+            if (!availableCores.empty())
+            {
+                const uint32_t coreIndex = availableCores[queueIndex % availableCores.size()];
+                pWorkerQueue->m_numaNode = coreNumaNodes[coreIndex];
+
+                if (m_definition.m_pinWorkers && queueIndex != 0)
+                    pWorkerQueue->m_core = static_cast<int32_t>(coreIndex);
+
+                if (queueIndex != 0 && pWorkerQueue->m_numaNode != m_workerQueues.front()->m_numaNode)
+                    m_isNumaAware = m_definition.m_groupByNumaNode;
+            }
+
+            m_workerQueues.emplace_back(pWorkerQueue);
+        }
+
+        // Every job that will ever exist is allocated up front, each pool threads its own block into a free list.
+        const uint32_t poolCount = static_cast<uint32_t>(m_workerQueues.size()) + 1;
+        m_pJobs = EXELIUS_NEW_ARRAY(Job, poolCount * s_kJobsPerPool);
 
-        for (uint8_t threadID = 0; threadID < m_threadCount; ++threadID)
+        m_jobPools.reserve(poolCount);
+        for (uint32_t poolIndex = 0; poolIndex < poolCount; ++poolIndex)
         {
-            std::thread worker(&JobSystem::ExecuteJob, this);
+            const uint32_t firstJobIndex = poolIndex * s_kJobsPerPool;
+            for (uint32_t jobIndex = firstJobIndex; jobIndex < firstJobIndex + s_kJobsPerPool; ++jobIndex)
+            {
+                m_pJobs[jobIndex].m_unfinishedJobs.store(0, std::memory_order_relaxed);
+                m_pJobs[jobIndex].m_version.store(1, std::memory_order_relaxed);
+                m_pJobs[jobIndex].m_parentIndex = s_kInvalidJobIndex;
+                m_pJobs[jobIndex].m_nextFreeIndex = jobIndex + 1;
+            }
+            m_pJobs[firstJobIndex + s_kJobsPerPool - 1].m_nextFreeIndex = s_kInvalidJobIndex;
+
+            JobPool* pJobPool = EXELIUS_NEW(JobPool());
+            pJobPool->m_freeListHead = firstJobIndex;
+            pJobPool->m_returnedListHead.store(s_kInvalidJobIndex, std::memory_order_relaxed);
+            m_jobPools.emplace_back(pJobPool);
+        }
 
-            // Not super ideal, might be better to create
-            // and size a fixed sized array of threads.
-            worker.detach();
+        // Background work gets half the worker threads by default.
+        SetMaxBackgroundWorkers((m_definition.m_maxBackgroundWorkers != 0) ? m_definition.m_maxBackgroundWorkers : eastl::max<uint32_t>(m_threadCount / 2, 1));
+
+        s_pThreadJobSystem = this;
+        s_threadWorkerIndex = 0;
+        s_threadStealSeed = 1;
+
+        for (uint32_t workerIndex = 1; workerIndex <= m_threadCount; ++workerIndex)
+        {
+            m_workerQueues[workerIndex]->m_thread = std::thread(&JobSystem::WorkerThread, this, workerIndex);
         }
 
         return true;
     }
 
-    const eastl::shared_ptr<Job> JobSystem::PushJob(const eastl::function<void()>& jobToPush, eastl::shared_ptr<Job> pParentJob /* = nullptr */)
+    void JobSystem::Shutdown()
     {
-        eastl::shared_ptr<Job> pNewJob = eastl::make_shared<Job>();
-        pNewJob->m_pParentJob = pParentJob;
-        ++pNewJob->m_jobCounter;
-        pNewJob->m_job = jobToPush;
-        if (pParentJob)
-            ++pParentJob->m_jobCounter;
-        ++m_jobCounter;
+        if (m_quitWorkers.load(std::memory_order_acquire))
+            return;
+
+        WaitForAllJobs();
 
-        while (!m_jobPool.PushBack(pNewJob))
+        m_quitWorkers.store(true, std::memory_order_release);
+        WakeWorkers(true);
+
+        // Join everyone before anything is freed, a worker may still be looking at another worker's queue.
+        for (WorkerQueue* pWorkerQueue : m_workerQueues)
         {
-            CycleThread();
+            if (pWorkerQueue->m_thread.joinable())
+                pWorkerQueue->m_thread.join();
+        }
+    }
+
+    void JobSystem::EnterReservedThread(ReservedThread reservedThread) const
+    {
+        static constexpr const char* kReservedThreadNames[] = { "ExeRender", "ExeSocket", "ExeResourceIO" };
+        static_assert(sizeof(kReservedThreadNames) / sizeof(kReservedThreadNames[0]) == static_cast<size_t>(ReservedThread::kCount), "Every ReservedThread needs a name.");
+
+        const size_t reservedThreadIndex = static_cast<size_t>(reservedThread);
+        EXE_ASSERT(reservedThreadIndex < static_cast<size_t>(ReservedThread::kCount));
+
+        ThreadHelpers::SetCurrentThreadName(kReservedThreadNames[reservedThreadIndex]);
+
+        const int32_t reservedCore = m_definition.m_reservedCores[reservedThreadIndex];
+        if (reservedCore == ThreadHelpers::kAnyCore)
+            return;
+
+        if (!ThreadHelpers::PinCurrentThreadToCore(static_cast<uint32_t>(reservedCore)))
+        {
+            Log log("JobSystem");
+            log.Warn("Failed to pin '{}' to reserved core {}. It will run on any core.", kReservedThreadNames[reservedThreadIndex], reservedCore);
         }
+    }
 
-        m_jobSignal.notify_one();
+    bool JobSystem::IsJobFinished(JobHandle job) const
+    {
+        EXE_ASSERT(m_pJobs);
+        return m_pJobs[job.GetId()].m_version.load(std::memory_order_acquire) != job.GetVersion();
+    }
+
+    uint32_t JobSystem::GetWorkerCount() const
+    {
+        return static_cast<uint32_t>(m_workerQueues.size());
+    }
 
-        return pNewJob;
+    bool JobSystem::IsRunning() const
+    {
+        return !m_workerQueues.empty() && !m_quitWorkers.load(std::memory_order_acquire);
+    }
+
+    uint32_t JobSystem::GetCurrentWorkerIndex() const
+    {
+        if (s_pThreadJobSystem != this)
+            return GetWorkerCount();
+
+        return s_threadWorkerIndex;
+    }
+
+    void JobSystem::SetMaxBackgroundWorkers(uint32_t maxBackgroundWorkers)
+    {
+        // Queue 0 never runs background jobs, so the other workers are the most we can hand out.
+        // With two or more of them, keep one back so frame critical jobs never wait behind background work.
+        const uint32_t workerThreadCount = m_threadCount;
+        const uint32_t upperLimit = (workerThreadCount > 1) ? workerThreadCount - 1 : 1;
+        m_maxBackgroundWorkers.store(eastl::min(eastl::max(maxBackgroundWorkers, 1u), upperLimit), std::memory_order_release);
+    }
+
+    uint32_t JobSystem::GetMaxBackgroundWorkers() const
+    {
+        return m_maxBackgroundWorkers.load(std::memory_order_acquire);
     }
 
     bool JobSystem::JobsAreExecuting()
     {
-        return (m_jobCounter != 0);
+        return (m_jobCounter.load(std::memory_order_acquire) != 0);
     }
 
-    void JobSystem::WaitForJob(uint64_t jobToWaitFor)
+    void JobSystem::WaitForJob(JobHandle jobToWaitFor)
     {
-        while (jobToWaitFor != m_jobCounter)
+        while (!IsJobFinished(jobToWaitFor))
         {
             CycleThread();
         }
     }
 
+    void JobSystem::WaitForCounter(JobCounter& counter)
+    {
+        while (!counter.IsFinished())
+        {
+            CycleThread();
+        }
+
+        // The last decrement happens under the lock, so once we hold it nobody
+        // is still touching the counter and the caller is free to destroy it.
+        counter.LockContinuations();
+        counter.UnlockContinuations();
+    }
+
     void JobSystem::WaitForAllJobs()
     {
         while (JobsAreExecuting())
@@ -70,36 +267,467 @@ namespace Exelius
         }
     }
 
-    void JobSystem::CycleThread()
+    void JobSystem::WorkerThread(uint32_t workerIndex)
     {
-        m_jobSignal.notify_one();
-        std::this_thread::yield();
+        s_pThreadJobSystem = this;
+        s_threadWorkerIndex = workerIndex;
+        s_threadStealSeed = workerIndex + 1;
+
+        char threadName[32];
+        std::snprintf(threadName, sizeof(threadName), "%s %u", m_definition.m_threadNamePrefix.c_str(), workerIndex);
+        ThreadHelpers::SetCurrentThreadName(threadName);
+
+        const int32_t core = m_workerQueues[workerIndex]->m_core;
+        if (core != ThreadHelpers::kAnyCore)
+            ThreadHelpers::PinCurrentThreadToCore(static_cast<uint32_t>(core));
+
+        uint32_t failedAttempts = 0;
+        while (!m_quitWorkers.load(std::memory_order_acquire))
+        {
+            if (TryExecuteJob())
+            {
+                failedAttempts = 0;
+                continue;
+            }
+
+            if (++failedAttempts < s_kSpinCountBeforePark)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            ParkWorker();
+            failedAttempts = 0;
+        }
+
+        s_pThreadJobSystem = nullptr;
     }
 
-    void JobSystem::ExecuteJob()
+    uint32_t JobSystem::AllocateJob(JobHandle parentJob, JobCounter* pCounter, JobPriority priority)
     {
-        eastl::shared_ptr<Job> pJobToExecute;
+        EXE_ASSERT(m_pJobs);
+        EXE_ASSERT(!m_quitWorkers.load(std::memory_order_relaxed));
+
+        // Threads without a worker queue share the last pool.
+        const bool isSharedPool = (s_pThreadJobSystem != this);
+        const uint32_t poolIndex = isSharedPool ? static_cast<uint32_t>(m_jobPools.size()) - 1 : s_threadWorkerIndex;
+        JobPool* pJobPool = m_jobPools[poolIndex];
+
+        std::unique_lock<std::mutex> lock(m_sharedPoolLock, std::defer_lock);
+        if (isSharedPool)
+            lock.lock();
+
+        while (pJobPool->m_freeListHead == s_kInvalidJobIndex)
+        {
+            // Take back everything other threads have finished with.
+            pJobPool->m_freeListHead = pJobPool->m_returnedListHead.exchange(s_kInvalidJobIndex, std::memory_order_acquire);
+            if (pJobPool->m_freeListHead != s_kInvalidJobIndex)
+                break;
+
+            // Pool is exhausted, help finish jobs until some come back.
+            if (isSharedPool)
+                lock.unlock();
+
+            CycleThread();
+
+            if (isSharedPool)
+                lock.lock();
+        }
+
+        const uint32_t jobIndex = pJobPool->m_freeListHead;
+        Job& job = m_pJobs[jobIndex];
+        pJobPool->m_freeListHead = job.m_nextFreeIndex;
+
+        if (isSharedPool)
+            lock.unlock();
+
+        job.m_unfinishedJobs.store(1, std::memory_order_relaxed);
+        job.m_pCounter = pCounter;
+        job.m_parentIndex = s_kInvalidJobIndex;
+        job.m_nextFreeIndex = s_kInvalidJobIndex;
+        job.m_priority = priority;
+
+        if (pCounter)
+            pCounter->m_count.fetch_add(1, std::memory_order_relaxed);
+
+        if (parentJob.IsValid())
+        {
+            EXE_ASSERT(!IsJobFinished(parentJob));
+            job.m_parentIndex = static_cast<uint32_t>(parentJob.GetId());
+            m_pJobs[job.m_parentIndex].m_unfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        m_jobCounter.fetch_add(1, std::memory_order_relaxed);
+
+        return jobIndex;
+    }
+
+    void JobSystem::FreeJob(uint32_t jobIndex)
+    {
+        Job& job = m_pJobs[jobIndex];
+
+        // Bump the version first, this is what marks any outstanding handles as finished.
+        uint32_t nextVersion = job.m_version.load(std::memory_order_relaxed) + 1;
+        if (nextVersion == 0)
+            nextVersion = 1;
+        job.m_version.store(nextVersion, std::memory_order_release);
+
+        // Push onto the owning pool's returned list. Only the owner ever takes from it,
+        // and it takes the whole list at once, so this cannot suffer from ABA.
+        JobPool* pJobPool = m_jobPools[jobIndex / s_kJobsPerPool];
+        uint32_t returnedListHead = pJobPool->m_returnedListHead.load(std::memory_order_relaxed);
+        do
+        {
+            job.m_nextFreeIndex = returnedListHead;
+        } while (!pJobPool->m_returnedListHead.compare_exchange_weak(returnedListHead, jobIndex, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    JobHandle JobSystem::SubmitJob(uint32_t jobIndex)
+    {
+        EXE_ASSERT(!m_workerQueues.empty());
+
+        JobHandle jobHandle(jobIndex);
+        jobHandle.SetVersion(m_pJobs[jobIndex].m_version.load(std::memory_order_relaxed));
+
+        switch (m_pJobs[jobIndex].m_priority)
+        {
+        case JobPriority::kFrameCritical:
+        {
+            while (!m_criticalQueue.PushBack(jobIndex))
+            {
+                CycleThread();
+            }
+            break;
+        }
+
+        case JobPriority::kBackground:
+        {
+            // Count first, so the count is never lower than what is in the queue.
+            m_backgroundJobCount.fetch_add(1, std::memory_order_release);
+            while (!m_backgroundQueue.PushBack(jobIndex))
+            {
+                CycleThread();
+            }
+            break;
+        }
 
-        while (true)
+        default:
         {
-            if (m_jobPool.PopFront(pJobToExecute))
+            // Owners push to the bottom of their own queue, everyone else goes through the injection queue.
+            const bool pushedLocally = (s_pThreadJobSystem == this) && m_workerQueues[s_threadWorkerIndex]->m_jobs.PushBottom(jobIndex);
+
+            if (!pushedLocally)
             {
-                pJobToExecute->m_job();
-                RecurseCounterDecrement(pJobToExecute);
+                while (!m_injectionQueue.PushBack(jobIndex))
+                {
+                    CycleThread();
+                }
             }
-            else
+            break;
+        }
+        }
+
+        WakeWorkers(false);
+
+        return jobHandle;
+    }
+
+    JobHandle JobSystem::SubmitJobToWorker(uint32_t workerIndex, uint32_t jobIndex)
+    {
+        EXE_ASSERT(!m_workerQueues.empty());
+
+        WorkerQueue* pWorkerQueue = m_workerQueues[workerIndex % m_workerQueues.size()];
+        if (!pWorkerQueue->m_mailbox.PushBack(jobIndex))
+            return SubmitJob(jobIndex);
+
+        JobHandle jobHandle(jobIndex);
+        jobHandle.SetVersion(m_pJobs[jobIndex].m_version.load(std::memory_order_relaxed));
+
+        // We can't pick which worker wakes, but whoever does will find the job in the mailbox.
+        WakeWorkers(false);
+
+        return jobHandle;
+    }
+
+    bool JobSystem::PopBackgroundJob(uint32_t& jobIndex)
+    {
+        if (!CanRunBackgroundJobs())
+            return false;
+
+        // Already inside a background job, so we hold a lane. Running its children here is what
+        // keeps a background job that waits on other background jobs from deadlocking at the cap.
+        const bool holdsLane = (s_threadBackgroundDepth > 0);
+
+        if (!holdsLane)
+        {
+            uint32_t activeWorkers = m_activeBackgroundWorkers.load(std::memory_order_relaxed);
+            do
             {
-                std::unique_lock<std::mutex> lock(m_jobLock);
-                m_jobSignal.wait(lock);
+                if (activeWorkers >= m_maxBackgroundWorkers.load(std::memory_order_relaxed))
+                    return false;
+            } while (!m_activeBackgroundWorkers.compare_exchange_weak(activeWorkers, activeWorkers + 1, std::memory_order_acquire, std::memory_order_relaxed));
+        }
+
+        if (!m_backgroundQueue.PopFront(jobIndex))
+        {
+            if (!holdsLane)
+                m_activeBackgroundWorkers.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+
+        m_backgroundJobCount.fetch_sub(1, std::memory_order_relaxed);
+        s_threadJobsSinceBackground = 0;
+        return true;
+    }
+
+    bool JobSystem::CanRunBackgroundJobs()
+    {
+        if (m_backgroundJobCount.load(std::memory_order_acquire) == 0)
+            return false;
+
+        // The thread that called Initialize() runs the frame, it must never get stuck in a long job while helping out.
+        if (s_pThreadJobSystem == this && s_threadWorkerIndex == 0)
+            return false;
+
+        return s_threadBackgroundDepth > 0 || m_activeBackgroundWorkers.load(std::memory_order_acquire) < m_maxBackgroundWorkers.load(std::memory_order_relaxed);
+    }
+
+    JobHandle JobSystem::SubmitJobAfter(JobCounter& dependency, uint32_t jobIndex)
+    {
+        dependency.LockContinuations();
+
+        if (dependency.m_count.load(std::memory_order_acquire) == 0)
+        {
+            dependency.UnlockContinuations();
+            return SubmitJob(jobIndex);
+        }
+
+        JobHandle jobHandle(jobIndex);
+        jobHandle.SetVersion(m_pJobs[jobIndex].m_version.load(std::memory_order_relaxed));
+
+        m_pJobs[jobIndex].m_nextFreeIndex = dependency.m_continuationHead;
+        dependency.m_continuationHead = jobIndex;
+
+        dependency.UnlockContinuations();
+
+        return jobHandle;
+    }
+
+    void JobSystem::DecrementCounter(JobCounter* pCounter)
+    {
+        uint32_t continuationIndex = s_kInvalidJobIndex;
+
+        pCounter->LockContinuations();
+        if (pCounter->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            continuationIndex = pCounter->m_continuationHead;
+            pCounter->m_continuationHead = s_kInvalidJobIndex;
+        }
+        pCounter->UnlockContinuations();
+
+        // The counter may be destroyed from here on, only the detached continuations are touched.
+        while (continuationIndex != s_kInvalidJobIndex)
+        {
+            const uint32_t nextIndex = m_pJobs[continuationIndex].m_nextFreeIndex;
+            m_pJobs[continuationIndex].m_nextFreeIndex = s_kInvalidJobIndex;
+            SubmitJob(continuationIndex);
+            continuationIndex = nextIndex;
+        }
+    }
+
+    bool JobSystem::TryExecuteJob()
+    {
+        bool isBackgroundJob = false;
+        const uint32_t jobIndex = FindJob(isBackgroundJob);
+        if (jobIndex == s_kInvalidJobIndex)
+            return false;
+
+        if (!isBackgroundJob)
+        {
+            ++s_threadJobsSinceBackground;
+            ExecuteJob(jobIndex);
+            return true;
+        }
+
+        ++s_threadBackgroundDepth;
+        ExecuteJob(jobIndex);
+        --s_threadBackgroundDepth;
+
+        // Give the lane back once the outermost background job is done.
+        if (s_threadBackgroundDepth == 0)
+            m_activeBackgroundWorkers.fetch_sub(1, std::memory_order_release);
+
+        return true;
+    }
+
+    uint32_t JobSystem::FindJob(bool& isBackgroundJob)
+    {
+        uint32_t jobIndex = s_kInvalidJobIndex;
+        const bool ownsWorkerQueue = (s_pThreadJobSystem == this);
+
+        // Frame critical work always goes first.
+        if (m_criticalQueue.PopFront(jobIndex))
+            return jobIndex;
+
+        // Starvation protection. Every so often, look at the background lane before the normal queues.
+        if (s_threadJobsSinceBackground >= s_kBackgroundStarvationLimit && PopBackgroundJob(jobIndex))
+        {
+            isBackgroundJob = true;
+            return jobIndex;
+        }
+
+        // Work meant for us first, then the newest local work, as it is most likely to still be in cache.
+        if (ownsWorkerQueue)
+        {
+            WorkerQueue* pWorkerQueue = m_workerQueues[s_threadWorkerIndex];
+            if (pWorkerQueue->m_mailbox.PopFront(jobIndex) || pWorkerQueue->m_jobs.PopBottom(jobIndex))
+                return jobIndex;
+        }
+
+        if (m_injectionQueue.PopFront(jobIndex))
+            return jobIndex;
+
+        // Steal the oldest work from a random victim, visiting every queue once.
+        const uint32_t queueCount = static_cast<uint32_t>(m_workerQueues.size());
+        s_threadStealSeed ^= s_threadStealSeed << 13;
+        s_threadStealSeed ^= s_threadStealSeed >> 17;
+        s_threadStealSeed ^= s_threadStealSeed << 5;
+
+        const uint32_t firstVictim = s_threadStealSeed % queueCount;
+
+        // Across NUMA nodes, try the workers on our own node before going remote.
+        const bool preferLocalNode = m_isNumaAware && ownsWorkerQueue;
+        const uint32_t localNode = ownsWorkerQueue ? m_workerQueues[s_threadWorkerIndex]->m_numaNode : 0;
+
+        for (uint32_t pass = 0; pass < (preferLocalNode ? 2u : 1u); ++pass)
+        {
+            for (uint32_t offset = 0; offset < queueCount; ++offset)
+            {
+                const uint32_t victimIndex = (firstVictim + offset) % queueCount;
+                if (ownsWorkerQueue && victimIndex == s_threadWorkerIndex)
+                    continue;
+
+                if (preferLocalNode && (m_workerQueues[victimIndex]->m_numaNode == localNode) != (pass == 0))
+                    continue;
+
+                if (m_workerQueues[victimIndex]->m_jobs.Steal(jobIndex))
+                    return jobIndex;
             }
         }
+
+        // Nothing else to do, so help with another worker's mail rather than sit idle.
+        for (uint32_t offset = 0; offset < queueCount; ++offset)
+        {
+            const uint32_t victimIndex = (firstVictim + offset) % queueCount;
+            if (m_workerQueues[victimIndex]->m_mailbox.PopFront(jobIndex))
+                return jobIndex;
+        }
+
+        if (PopBackgroundJob(jobIndex))
+        {
+            isBackgroundJob = true;
+            return jobIndex;
+        }
+
+        return s_kInvalidJobIndex;
+    }
+
+    bool JobSystem::HasQueuedJobs()
+    {
+        if (!m_injectionQueue.IsEmpty() || !m_criticalQueue.IsEmpty())
+            return true;
+
+        // Background jobs only count if we would be allowed to take one.
+        if (CanRunBackgroundJobs())
+            return true;
+
+        for (WorkerQueue* pWorkerQueue : m_workerQueues)
+        {
+            if (!pWorkerQueue->m_jobs.IsEmpty() || !pWorkerQueue->m_mailbox.IsEmpty())
+                return true;
+        }
+
+        return false;
     }
 
-    void JobSystem::RecurseCounterDecrement(eastl::shared_ptr<Job> pJob)
+    void JobSystem::ParkWorker()
     {
-        --pJob->m_jobCounter;
-        if (pJob->m_pParentJob)
-            RecurseCounterDecrement(pJob->m_pParentJob);
-        --m_jobCounter;
+        const uint32_t epoch = m_wakeEpoch.load(std::memory_order_acquire);
+
+        // Announce we are going to sleep before the final check, so a pusher either
+        // sees us sleeping or we see its job. Pairs with the fence in WakeWorkers().
+        m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!HasQueuedJobs() && !m_quitWorkers.load(std::memory_order_acquire))
+        {
+            std::unique_lock<std::mutex> lock(m_jobLock);
+            m_jobSignal.wait(lock, [this, epoch]()
+                {
+                    return m_wakeEpoch.load(std::memory_order_relaxed) != epoch || m_quitWorkers.load(std::memory_order_relaxed);
+                });
+        }
+
+        m_sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void JobSystem::WakeWorkers(bool wakeAll)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!wakeAll && m_sleepingWorkers.load(std::memory_order_seq_cst) == 0)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_jobLock);
+            m_wakeEpoch.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (wakeAll)
+            m_jobSignal.notify_all();
+        else
+            m_jobSignal.notify_one();
+    }
+
+    void JobSystem::CycleThread()
+    {
+        // Help out instead of spinning, only yield when there is nothing to take.
+        if (!TryExecuteJob())
+            std::this_thread::yield();
+    }
+
+    void JobSystem::ExecuteJob(uint32_t jobIndex)
+    {
+        Job& job = m_pJobs[jobIndex];
+        job.m_function();
+
+        // Release captured state now rather than whenever the slot is reused.
+        job.m_function.Reset();
+
+        FinishJob(jobIndex);
+    }
+
+    void JobSystem::FinishJob(uint32_t jobIndex)
+    {
+        // A job is only finished once it and all of its children are, at which point it counts towards its parent.
+        uint32_t currentIndex = jobIndex;
+        while (currentIndex != s_kInvalidJobIndex)
+        {
+            Job& job = m_pJobs[currentIndex];
+            const uint32_t parentIndex = job.m_parentIndex;
+            JobCounter* pCounter = job.m_pCounter;
+
+            if (job.m_unfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                break;
+
+            // The slot can be reused as soon as it is freed, so nothing in it may be read after this.
+            FreeJob(currentIndex);
+
+            if (pCounter)
+                DecrementCounter(pCounter);
+
+            currentIndex = parentIndex;
+        }
+
+        m_jobCounter.fetch_sub(1, std::memory_order_release);
     }
 }
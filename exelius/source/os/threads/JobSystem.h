@@ -1,57 +1,425 @@
 #pragma once
 #include "source/utility/containers/RingBuffer.h"
+#include "source/utility/containers/WorkStealingDeque.h"
+#include "source/utility/generic/Handle.h"
+#include "source/utility/generic/InlineFunction.h"
+#include "source/os/threads/ThreadHelpers.h"
 
-#include <EASTL/functional.h>
+#include <EASTL/string.h>
 #include <EASTL/vector.h>
-#include <EASTL/shared_ptr.h>
 #include <condition_variable>
+#include <thread>
 
 /// <summary>
 /// Engine namespace. Everything owned by the engine will be inside this namespace.
 /// </summary>
 namespace Exelius
 {
-	struct Job
+	/// <summary>
+	/// Refers to a pooled Job. The ID is the job's slot in the pool and the version is the
+	/// slot's version at the time it was pushed, so a handle goes stale once the job finishes.
+	/// </summary>
+	using JobHandle = Handle;
+
+	// Sized so a Job fills exactly two cache lines.
+	using JobFunction = InlineFunction<void(), 80>;
+
+	/// <summary>
+	/// Which lane a job is queued in. Workers look for frame critical jobs first, then normal jobs,
+	/// then background jobs.
+	/// </summary>
+	enum class JobPriority : uint8_t
 	{
-		eastl::shared_ptr<Job> m_pParentJob;
-		eastl::function<void()> m_job;
-		std::atomic<uint16_t> m_jobCounter;
+		/// <summary>
+		/// Work the current frame is waiting on. Always taken before anything else, and there is always
+		/// a worker free to take it, as background jobs are never allowed to occupy every worker.
+		/// </summary>
+		kFrameCritical,
+
+		/// <summary>
+		/// Everything else that should finish soon. Pushed to the pushing thread's own queue, so it can be stolen.
+		/// </summary>
+		kNormal,
+
+		/// <summary>
+		/// Long running work that no frame is waiting on (decoding, streaming, compression).
+		/// Only a limited number of workers run these at once, and never the thread that called Initialize().
+		/// </summary>
+		kBackground
+	};
+
+	/// <summary>
+	/// Counts unfinished jobs in a group. Any number of jobs may be pushed against the same counter,
+	/// and it reaches zero once all of them (and their children) have finished.
+	/// 
+	/// Callers can wait on a counter with JobSystem::WaitForCounter(), which executes other jobs
+	/// while it waits, or push a job with JobSystem::PushJobAfter() so that it is only queued once
+	/// the counter reaches zero. The counter must outlive every job pushed against it.
+	/// </summary>
+	class JobCounter
+	{
+		friend class JobSystem;
+
+		std::atomic<uint32_t> m_count;
+		std::atomic_flag m_continuationLock = ATOMIC_FLAG_INIT;
+
+		// Jobs waiting for this counter to reach zero, linked through Job::m_nextFreeIndex.
+		uint32_t m_continuationHead;
+
+	public:
+		JobCounter()
+			: m_count(0)
+			, m_continuationHead(~0u)
+		{
+			//
+		}
+
+		JobCounter(const JobCounter&) = delete;
+		JobCounter(JobCounter&&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+		JobCounter& operator=(JobCounter&&) = delete;
+
+		~JobCounter()
+		{
+			EXE_ASSERT(IsFinished());
+		}
+
+		/// <summary>
+		/// Checks if every job pushed against this counter has finished.
+		/// </summary>
+		/// <returns>True if no jobs are outstanding.</returns>
+		bool IsFinished() const
+		{
+			return m_count.load(std::memory_order_acquire) == 0;
+		}
+
+	private:
+		void LockContinuations()
+		{
+			while (m_continuationLock.test_and_set(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+		}
 
-		Job& operator=(const Job& other)
+		void UnlockContinuations()
 		{
-			m_pParentJob = other.m_pParentJob;
-			m_job = other.m_job;
-			m_jobCounter = other.m_jobCounter.load();
-			return *this;
+			m_continuationLock.clear(std::memory_order_release);
+		}
+	};
+
+	struct alignas(64) Job
+	{
+		JobFunction m_function;
+
+		// Group counter to decrement when this job finishes, if any.
+		JobCounter* m_pCounter;
+
+		// This job plus any children that have not finished yet.
+		std::atomic<uint32_t> m_unfinishedJobs;
+
+		// Incremented each time the slot is recycled. Never 0, so handles to live jobs are always valid.
+		std::atomic<uint32_t> m_version;
+
+		uint32_t m_parentIndex;
+		uint32_t m_nextFreeIndex;
+
+		JobPriority m_priority;
+	};
+
+	static_assert(sizeof(Job) == 128, "Job should fill exactly two cache lines.");
+
+	/// <summary>
+	/// Engine threads that live outside of the JobSystem, but may have a core set aside for them.
+	/// </summary>
+	enum class ReservedThread : uint8_t
+	{
+		kRender,
+		kSocket,
+		kResourceIO,
+		kCount
+	};
+
+	/// <summary>
+	/// The data necessary to set up the worker pool. Read from the "JobSystem" section of the config file.
+	/// </summary>
+	struct JobSystemDefinition
+	{
+		/// <summary>
+		/// The number of worker threads to spawn, not counting the thread that calls Initialize().
+		/// 0 uses every core that is not reserved, minus one for the calling thread.
+		/// </summary>
+		uint32_t m_workerCount;
+
+		/// <summary>
+		/// The number of workers that may run background jobs at once. 0 uses half the workers.
+		/// </summary>
+		uint32_t m_maxBackgroundWorkers;
+
+		/// <summary>
+		/// Worker threads are named this, followed by their index.
+		/// </summary>
+		eastl::string m_threadNamePrefix;
+
+		/// <summary>
+		/// Should each worker be pinned to its own core.
+		/// </summary>
+		bool m_pinWorkers;
+
+		/// <summary>
+		/// Should workers be laid out one NUMA node at a time, and prefer to steal from workers on their own node.
+		/// </summary>
+		bool m_groupByNumaNode;
+
+		/// <summary>
+		/// The core set aside for each ReservedThread, or ThreadHelpers::kAnyCore for none.
+		/// Workers are never pinned to a reserved core, and reserved cores are not counted when choosing the worker count.
+		/// </summary>
+		int32_t m_reservedCores[static_cast<size_t>(ReservedThread::kCount)];
+
+		/// <summary>
+		/// Construct the definition with reasonable default values.
+		/// </summary>
+		JobSystemDefinition()
+			: m_workerCount(0)
+			, m_maxBackgroundWorkers(0)
+			, m_threadNamePrefix("ExeWorker")
+			, m_pinWorkers(false)
+			, m_groupByNumaNode(true)
+			, m_reservedCores{ ThreadHelpers::kAnyCore, ThreadHelpers::kAnyCore, ThreadHelpers::kAnyCore }
+		{
+			//
 		}
 	};
 
 	class JobSystem
 	{
-		RingBufferMT<eastl::shared_ptr<Job>, 256> m_jobPool;
+		static constexpr uint32_t s_kInvalidJobIndex = ~0u;
+		static constexpr uint32_t s_kJobsPerPool = 2048;
+		static constexpr size_t s_kWorkerQueueSize = 4096;
+		static constexpr size_t s_kInjectionQueueSize = 1024;
+		static constexpr size_t s_kMailboxSize = 256;
+		static constexpr size_t s_kCriticalQueueSize = 1024;
+		static constexpr size_t s_kBackgroundQueueSize = 4096;
+		static constexpr uint32_t s_kSpinCountBeforePark = 64;
+
+		// A thread that has executed this many jobs without taking a background job checks the background lane first.
+		static constexpr uint32_t s_kBackgroundStarvationLimit = 32;
+
+		static_assert(s_kJobsPerPool <= s_kWorkerQueueSize, "A worker queue should be able to hold every job in its pool.");
+
+		// Each thread that executes jobs owns one of these. Index 0 belongs to the thread that called Initialize().
+		struct WorkerQueue
+		{
+			WorkStealingDeque<uint32_t, s_kWorkerQueueSize> m_jobs;
+			std::thread m_thread;
+
+			// Jobs pushed for this worker specifically. The owner checks it first, other threads only as a last resort.
+			RingBufferMPMC<uint32_t, s_kMailboxSize> m_mailbox;
+
+			// Where this worker runs. The core is ThreadHelpers::kAnyCore if it is not pinned.
+			int32_t m_core = ThreadHelpers::kAnyCore;
+			uint32_t m_numaNode = 0;
+		};
+
+		// A block of jobs in m_pJobs. Only the owning thread allocates from a pool, any thread may return jobs to it.
+		struct JobPool
+		{
+			uint32_t m_freeListHead;
+			alignas(64) std::atomic<uint32_t> m_returnedListHead;
+		};
+
+		eastl::vector<WorkerQueue*> m_workerQueues;
+
+		// One pool per worker queue, plus a final pool shared by threads that do not own a queue.
+		eastl::vector<JobPool*> m_jobPools;
+		std::mutex m_sharedPoolLock;
+		Job* m_pJobs;
+
+		// Jobs pushed from threads that do not own a worker queue.
+		RingBufferMPMC<uint32_t, s_kInjectionQueueSize> m_injectionQueue;
+
+		// Frame critical jobs, shared by every thread and checked before anything else.
+		RingBufferMPMC<uint32_t, s_kCriticalQueueSize> m_criticalQueue;
+
+		// Background jobs. Each thread running one holds a lane, and there are only m_maxBackgroundWorkers lanes.
+		RingBufferMPMC<uint32_t, s_kBackgroundQueueSize> m_backgroundQueue;
+		std::atomic<uint32_t> m_backgroundJobCount;
+		std::atomic<uint32_t> m_activeBackgroundWorkers;
+		std::atomic<uint32_t> m_maxBackgroundWorkers;
+
 		std::atomic<uint32_t> m_jobCounter;
+
+		// Parking. Sleepers wait for the epoch to change, pushers only take the lock if someone is asleep.
 		std::condition_variable m_jobSignal;
 		std::mutex m_jobLock;
+		std::atomic<uint32_t> m_wakeEpoch;
+		std::atomic<uint32_t> m_sleepingWorkers;
+		std::atomic<bool> m_quitWorkers;
+
+		JobSystemDefinition m_definition;
+
+		// True if the workers span more than one NUMA node, and stealing should prefer the local node.
+		bool m_isNumaAware;
+
 		uint8_t m_threadCount;
 
 	public:
 		JobSystem();
+		JobSystem(const JobSystem&) = delete;
+		JobSystem(JobSystem&&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem& operator=(JobSystem&&) = delete;
+		~JobSystem();
+
+		/// <summary>
+		/// Spawns the worker threads. The calling thread becomes worker 0, and executes jobs whenever it waits.
+		/// </summary>
+		/// <param name="definition">- How to size, pin and name the workers.</param>
+		/// <returns>True on success, false if already initialized.</returns>
+		bool Initialize(const JobSystemDefinition& definition = JobSystemDefinition());
+
+		/// <summary>
+		/// Finishes every outstanding job, then stops and joins every worker thread.
+		/// Nothing may be pushed afterwards. Called by the destructor if it hasn't been already.
+		/// </summary>
+		void Shutdown();
+
+		/// <summary>
+		/// Names the calling thread and pins it to the core reserved for it, if there is one.
+		/// Meant to be the first thing an engine thread does. Logs a warning if the core can't be pinned.
+		/// </summary>
+		/// <param name="reservedThread">- Which engine thread is calling.</param>
+		void EnterReservedThread(ReservedThread reservedThread) const;
+
+		/// <summary>
+		/// Pushes a job onto the calling thread's queue. The callable is moved into the pooled job,
+		/// so pushing never allocates. If a parent is given, it will not finish until this job has.
+		/// </summary>
+		/// <param name="jobToPush">- The callable to execute. Its captures must fit in a JobFunction.</param>
+		/// <param name="parentJob">- Optional parent job, which must not have finished yet.</param>
+		/// <param name="pCounter">- Optional group counter, incremented now and decremented when the job finishes.</param>
+		/// <param name="priority">- The lane to queue the job in.</param>
+		/// <returns>Handle to the pushed job.</returns>
+		template <typename Callable>
+		JobHandle PushJob(Callable&& jobToPush, JobHandle parentJob = JobHandle(), JobCounter* pCounter = nullptr, JobPriority priority = JobPriority::kNormal)
+		{
+			const uint32_t jobIndex = AllocateJob(parentJob, pCounter, priority);
+			m_pJobs[jobIndex].m_function.Assign(eastl::forward<Callable>(jobToPush));
+			return SubmitJob(jobIndex);
+		}
+
+		/// <summary>
+		/// Pushes a job that prefers to run on a specific worker. Pushing the same piece of data to the
+		/// same worker every frame keeps it in that worker's cache. If the worker is busy, idle threads
+		/// will still take the job rather than leave it waiting.
+		/// </summary>
+		/// <param name="workerIndex">- The preferred worker, wrapped to GetWorkerCount().</param>
+		/// <param name="jobToPush">- The callable to execute. Its captures must fit in a JobFunction.</param>
+		/// <param name="pCounter">- Optional group counter, incremented now and decremented when the job finishes.</param>
+		/// <returns>Handle to the pushed job.</returns>
+		template <typename Callable>
+		JobHandle PushJobForWorker(uint32_t workerIndex, Callable&& jobToPush, JobCounter* pCounter = nullptr)
+		{
+			const uint32_t jobIndex = AllocateJob(JobHandle(), pCounter, JobPriority::kNormal);
+			m_pJobs[jobIndex].m_function.Assign(eastl::forward<Callable>(jobToPush));
+			return SubmitJobToWorker(workerIndex, jobIndex);
+		}
+
+		/// <summary>
+		/// Pushes a job that will not be queued until the dependency counter reaches zero.
+		/// Nothing blocks in the meantime, so this is how a job continues once the work it
+		/// fanned out has finished, instead of waiting for it on a worker thread.
+		/// </summary>
+		/// <param name="dependency">- The counter to wait for. Queued immediately if already finished.</param>
+		/// <param name="jobToPush">- The callable to execute. Its captures must fit in a JobFunction.</param>
+		/// <param name="pCounter">- Optional group counter, incremented now and decremented when the job finishes.</param>
+		/// <param name="priority">- The lane to queue the job in once the dependency is met.</param>
+		/// <returns>Handle to the pushed job.</returns>
+		template <typename Callable>
+		JobHandle PushJobAfter(JobCounter& dependency, Callable&& jobToPush, JobCounter* pCounter = nullptr, JobPriority priority = JobPriority::kNormal)
+		{
+			const uint32_t jobIndex = AllocateJob(JobHandle(), pCounter, priority);
+			m_pJobs[jobIndex].m_function.Assign(eastl::forward<Callable>(jobToPush));
+			return SubmitJobAfter(dependency, jobIndex);
+		}
+
+		bool IsJobFinished(JobHandle job) const;
 
-		bool Initialize();
+		/// <summary>
+		/// The number of threads that execute jobs, including the thread that called Initialize().
+		/// </summary>
+		/// <returns>The worker count, or 0 if not initialized.</returns>
+		uint32_t GetWorkerCount() const;
 
-		const eastl::shared_ptr<Job> PushJob(const eastl::function<void()>& jobToPush, eastl::shared_ptr<Job> pParentJob = nullptr);
+		/// <summary>
+		/// Checks if jobs may be pushed. False before Initialize() and after Shutdown().
+		/// </summary>
+		/// <returns>True if the workers are running.</returns>
+		bool IsRunning() const;
+
+		/// <summary>
+		/// The worker queue owned by the calling thread. 0 is the thread that called Initialize().
+		/// </summary>
+		/// <returns>The worker index, or GetWorkerCount() if the calling thread does not own a queue.</returns>
+		uint32_t GetCurrentWorkerIndex() const;
+
+		/// <summary>
+		/// Limits how many threads may run background jobs at once. Clamped so that at least one
+		/// worker is always left free for frame critical and normal jobs.
+		/// </summary>
+		/// <param name="maxBackgroundWorkers">- The number of background lanes.</param>
+		void SetMaxBackgroundWorkers(uint32_t maxBackgroundWorkers);
+
+		/// <summary>
+		/// The number of threads that may run background jobs at once.
+		/// </summary>
+		/// <returns>The number of background lanes.</returns>
+		uint32_t GetMaxBackgroundWorkers() const;
+
+		/// <summary>
+		/// Executes a single pending job on the calling thread, if one can be found.
+		/// For threads that have their own work to wait on, but want to help out while they do.
+		/// </summary>
+		/// <returns>True if a job was executed.</returns>
+		bool TryExecuteJob();
 
 		bool JobsAreExecuting();
 
-		void WaitForJob(uint64_t jobToWaitFor);
+		/// <summary>
+		/// Executes other jobs on the calling thread until the given job and its children have finished.
+		/// </summary>
+		/// <param name="jobToWaitFor">- The job to wait for.</param>
+		void WaitForJob(JobHandle jobToWaitFor);
+
+		/// <summary>
+		/// Executes other jobs on the calling thread until the counter reaches zero.
+		/// Safe to call from inside a job, which is what makes nested parallelism work.
+		/// </summary>
+		/// <param name="counter">- The counter to wait for.</param>
+		void WaitForCounter(JobCounter& counter);
 
 		void WaitForAllJobs();
 
 	private:
+		void WorkerThread(uint32_t workerIndex);
+		uint32_t AllocateJob(JobHandle parentJob, JobCounter* pCounter, JobPriority priority);
+		void FreeJob(uint32_t jobIndex);
+		JobHandle SubmitJob(uint32_t jobIndex);
+		JobHandle SubmitJobToWorker(uint32_t workerIndex, uint32_t jobIndex);
+		JobHandle SubmitJobAfter(JobCounter& dependency, uint32_t jobIndex);
+		bool PopBackgroundJob(uint32_t& jobIndex);
+		bool CanRunBackgroundJobs();
+		void DecrementCounter(JobCounter* pCounter);
+		uint32_t FindJob(bool& isBackgroundJob);
+		bool HasQueuedJobs();
+		void ParkWorker();
+		void WakeWorkers(bool wakeAll);
 		void CycleThread();
-		void ExecuteJob();
-		void RecurseCounterDecrement(eastl::shared_ptr<Job> pJob);
+		void ExecuteJob(uint32_t jobIndex);
+		void FinishJob(uint32_t jobIndex);
 	};
 
-	inline static JobSystem* s_pGlobalJobSystem = nullptr;
+	// Not static, so every translation unit shares the one the Application creates.
+	inline JobSystem* s_pGlobalJobSystem = nullptr;
 }
\ No newline at end of file
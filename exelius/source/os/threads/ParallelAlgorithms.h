@@ -0,0 +1,312 @@
+#pragma once
+#include "source/os/threads/JobSystem.h"
+
+#include <EASTL/algorithm.h>
+#include <EASTL/iterator.h>
+#include <EASTL/sort.h>
+#include <EASTL/vector.h>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// Data parallel helpers built on the global JobSystem.
+	///
+	/// Every function here splits a range into chunks and runs them as jobs, with the calling thread
+	/// executing the first chunk and then helping with the rest until they are done. They are safe to
+	/// call from inside a job. If the job system is not running or the range is too small to be worth
+	/// splitting, the work runs serially on the calling thread instead.
+	///
+	/// Chunks are handed to workers by index, so running the same loop over the same data each frame
+	/// tends to put each chunk on the same worker (and in the same cache) as the frame before.
+	/// </summary>
+	namespace Parallel
+	{
+		/// <summary>
+		/// The smallest number of elements a chunk will hold when the grain size is chosen automatically.
+		/// Ranges smaller than this always run serially.
+		/// </summary>
+		static constexpr size_t kMinimumGrainSize = 64;
+
+		/// <summary>
+		/// How many chunks to aim for per worker when the grain size is chosen automatically.
+		/// More chunks balance uneven work better, fewer chunks have less overhead.
+		/// </summary>
+		static constexpr size_t kChunksPerWorker = 4;
+
+		/// <summary>
+		/// Picks a chunk size for a range, based on how many workers are available.
+		/// </summary>
+		/// <param name="elementCount">- The number of elements in the range.</param>
+		/// <param name="grainSize">- The requested grain size, or 0 to choose one.</param>
+		/// <returns>The number of elements per chunk.</returns>
+		inline size_t GetGrainSize(size_t elementCount, size_t grainSize = 0)
+		{
+			if (grainSize != 0)
+				return grainSize;
+
+			const size_t workerCount = s_pGlobalJobSystem ? s_pGlobalJobSystem->GetWorkerCount() : 1;
+			const size_t targetChunkCount = eastl::max<size_t>(workerCount * kChunksPerWorker, 1);
+			return eastl::max(kMinimumGrainSize, (elementCount + targetChunkCount - 1) / targetChunkCount);
+		}
+	}
+
+	/// <summary>
+	/// Calls rangeFunction(chunkBegin, chunkEnd) for consecutive chunks of [begin, end) in parallel.
+	/// Prefer this over ParallelFor when each chunk can set up shared state once.
+	///
+	/// Example:
+	///		ParallelForRange(0, positions.size(), [&positions, deltaTime](size_t chunkBegin, size_t chunkEnd)
+	///			{
+	///				for (size_t i = chunkBegin; i < chunkEnd; ++i)
+	///					positions[i] += velocity[i] * deltaTime;
+	///			});
+	/// </summary>
+	/// <param name="begin">- The first index.</param>
+	/// <param name="end">- One past the last index.</param>
+	/// <param name="rangeFunction">- Called once per chunk. Must be safe to call from multiple threads at once.</param>
+	/// <param name="grainSize">- Elements per chunk, or 0 to choose based on the worker count.</param>
+	template <typename RangeFunction>
+	void ParallelForRange(size_t begin, size_t end, RangeFunction&& rangeFunction, size_t grainSize = 0)
+	{
+		if (end <= begin)
+			return;
+
+		const size_t elementCount = end - begin;
+		const size_t chunkSize = Parallel::GetGrainSize(elementCount, grainSize);
+
+		if (!s_pGlobalJobSystem || s_pGlobalJobSystem->GetWorkerCount() <= 1 || elementCount <= chunkSize)
+		{
+			rangeFunction(begin, end);
+			return;
+		}
+
+		const size_t chunkCount = (elementCount + chunkSize - 1) / chunkSize;
+		JobCounter chunkCounter;
+
+		// Chunk 0 is ours, so push from 1. Each chunk's index picks its worker, for affinity across frames.
+		for (size_t chunkIndex = 1; chunkIndex < chunkCount; ++chunkIndex)
+		{
+			const size_t chunkBegin = begin + (chunkIndex * chunkSize);
+			const size_t chunkEnd = eastl::min(chunkBegin + chunkSize, end);
+
+			s_pGlobalJobSystem->PushJobForWorker(static_cast<uint32_t>(chunkIndex), [&rangeFunction, chunkBegin, chunkEnd]()
+				{
+					rangeFunction(chunkBegin, chunkEnd);
+				}, &chunkCounter);
+		}
+
+		rangeFunction(begin, begin + chunkSize);
+
+		s_pGlobalJobSystem->WaitForCounter(chunkCounter);
+	}
+
+	/// <summary>
+	/// Calls function(index) for every index in [begin, end) in parallel.
+	/// </summary>
+	/// <param name="begin">- The first index.</param>
+	/// <param name="end">- One past the last index.</param>
+	/// <param name="function">- Called once per index. Must be safe to call from multiple threads at once.</param>
+	/// <param name="grainSize">- Elements per chunk, or 0 to choose based on the worker count.</param>
+	template <typename Function>
+	void ParallelFor(size_t begin, size_t end, Function&& function, size_t grainSize = 0)
+	{
+		ParallelForRange(begin, end, [&function](size_t chunkBegin, size_t chunkEnd)
+			{
+				for (size_t index = chunkBegin; index < chunkEnd; ++index)
+				{
+					function(index);
+				}
+			}, grainSize);
+	}
+
+	/// <summary>
+	/// Reduces [begin, end) in parallel. Each chunk is reduced with rangeFunction(chunkBegin, chunkEnd),
+	/// then the chunk results are combined in chunk order with reduceFunction, so the result is the same
+	/// from run to run even for operations that are not associative (like adding floats).
+	///
+	/// Example:
+	///		float total = ParallelReduce(0, values.size(), 0.0f,
+	///			[&values](size_t chunkBegin, size_t chunkEnd)
+	///			{
+	///				float sum = 0.0f;
+	///				for (size_t i = chunkBegin; i < chunkEnd; ++i)
+	///					sum += values[i];
+	///				return sum;
+	///			},
+	///			[](float left, float right) { return left + right; });
+	/// </summary>
+	/// <param name="begin">- The first index.</param>
+	/// <param name="end">- One past the last index.</param>
+	/// <param name="identity">- The result of reducing an empty range.</param>
+	/// <param name="rangeFunction">- Reduces one chunk to a value. Must be safe to call from multiple threads at once.</param>
+	/// <param name="reduceFunction">- Combines two values. Called on the calling thread only.</param>
+	/// <param name="grainSize">- Elements per chunk, or 0 to choose based on the worker count.</param>
+	/// <returns>The reduced value.</returns>
+	template <typename ValueType, typename RangeFunction, typename ReduceFunction>
+	ValueType ParallelReduce(size_t begin, size_t end, const ValueType& identity, RangeFunction&& rangeFunction, ReduceFunction&& reduceFunction, size_t grainSize = 0)
+	{
+		if (end <= begin)
+			return identity;
+
+		const size_t elementCount = end - begin;
+		const size_t chunkSize = Parallel::GetGrainSize(elementCount, grainSize);
+		const size_t chunkCount = (elementCount + chunkSize - 1) / chunkSize;
+
+		if (chunkCount <= 1)
+			return reduceFunction(identity, rangeFunction(begin, end));
+
+		eastl::vector<ValueType> chunkResults(chunkCount, identity);
+
+		// One chunk per range, so the chunk index can be recovered from the range start.
+		ParallelForRange(0, chunkCount, [begin, end, chunkSize, &chunkResults, &rangeFunction](size_t firstChunk, size_t lastChunk)
+			{
+				for (size_t chunkIndex = firstChunk; chunkIndex < lastChunk; ++chunkIndex)
+				{
+					const size_t chunkBegin = begin + (chunkIndex * chunkSize);
+					const size_t chunkEnd = eastl::min(chunkBegin + chunkSize, end);
+					chunkResults[chunkIndex] = rangeFunction(chunkBegin, chunkEnd);
+				}
+			}, 1);
+
+		ValueType result = identity;
+		for (ValueType& chunkResult : chunkResults)
+		{
+			result = reduceFunction(result, chunkResult);
+		}
+
+		return result;
+	}
+
+	/// <summary>
+	/// Internal helpers for ParallelSort. Not for use outside this file.
+	/// </summary>
+	namespace ParallelInternal
+	{
+		/// <summary>
+		/// Uninitialized storage for one element of the scratch buffer.
+		/// </summary>
+		template <typename ValueType>
+		struct alignas(ValueType) ScratchSlot
+		{
+			unsigned char m_bytes[sizeof(ValueType)];
+		};
+
+		/// <summary>
+		/// Moves a value into the destination, constructing it there if the destination is uninitialized.
+		/// </summary>
+		template <bool kConstructDestination, typename DestinationIterator, typename ValueType>
+		void MoveInto(DestinationIterator destination, ValueType& value)
+		{
+			if constexpr (kConstructDestination)
+				::new (static_cast<void*>(eastl::addressof(*destination))) ValueType(eastl::move(value));
+			else
+				*destination = eastl::move(value);
+		}
+
+		/// <summary>
+		/// Merges each pair of neighbouring sorted runs in source into destination, in parallel.
+		/// Ties are taken from the left run, which keeps the sort stable.
+		/// </summary>
+		template <bool kConstructDestination, typename SourceIterator, typename DestinationIterator, typename Compare>
+		void MergeRuns(SourceIterator source, DestinationIterator destination, size_t elementCount, size_t runSize, Compare& compare)
+		{
+			const size_t pairSize = runSize * 2;
+			const size_t pairCount = (elementCount + pairSize - 1) / pairSize;
+
+			ParallelFor(0, pairCount, [source, destination, elementCount, runSize, pairSize, &compare](size_t pairIndex)
+				{
+					const size_t leftBegin = pairIndex * pairSize;
+					SourceIterator left = source + leftBegin;
+					SourceIterator leftEnd = source + eastl::min(leftBegin + runSize, elementCount);
+					SourceIterator right = leftEnd;
+					SourceIterator rightEnd = source + eastl::min(leftBegin + pairSize, elementCount);
+					DestinationIterator output = destination + leftBegin;
+
+					while (left != leftEnd && right != rightEnd)
+					{
+						if (compare(*right, *left))
+							MoveInto<kConstructDestination>(output++, *right++);
+						else
+							MoveInto<kConstructDestination>(output++, *left++);
+					}
+
+					while (left != leftEnd)
+						MoveInto<kConstructDestination>(output++, *left++);
+
+					while (right != rightEnd)
+						MoveInto<kConstructDestination>(output++, *right++);
+				}, 1);
+		}
+	}
+
+	/// <summary>
+	/// Stable sort of [first, last) in parallel. Chunks are sorted independently, then merged
+	/// pairwise until one run remains. Needs a scratch buffer the size of the range.
+	/// </summary>
+	/// <param name="first">- Random access iterator to the first element.</param>
+	/// <param name="last">- Random access iterator to one past the last element.</param>
+	/// <param name="compare">- Strict weak ordering. Must be safe to call from multiple threads at once.</param>
+	/// <param name="grainSize">- Elements per initial chunk, or 0 to choose based on the worker count.</param>
+	template <typename RandomAccessIterator, typename Compare>
+	void ParallelSort(RandomAccessIterator first, RandomAccessIterator last, Compare compare, size_t grainSize = 0)
+	{
+		using ValueType = typename eastl::iterator_traits<RandomAccessIterator>::value_type;
+		using ScratchSlot = ParallelInternal::ScratchSlot<ValueType>;
+
+		const size_t elementCount = static_cast<size_t>(last - first);
+		const size_t runSize = Parallel::GetGrainSize(elementCount, grainSize);
+
+		if (elementCount <= runSize || !s_pGlobalJobSystem || s_pGlobalJobSystem->GetWorkerCount() <= 1)
+		{
+			eastl::stable_sort(first, last, compare);
+			return;
+		}
+
+		ParallelForRange(0, elementCount, [first, &compare](size_t runBegin, size_t runEnd)
+			{
+				eastl::stable_sort(first + runBegin, first + runEnd, compare);
+			}, runSize);
+
+		// The first pass constructs every element of the scratch buffer. After that, passes
+		// ping-pong between the range and the scratch buffer, doubling the run size each time.
+		ScratchSlot* pScratchSlots = EXELIUS_NEW_ARRAY(ScratchSlot, elementCount);
+		ValueType* pScratch = reinterpret_cast<ValueType*>(pScratchSlots);
+
+		ParallelInternal::MergeRuns<true>(first, pScratch, elementCount, runSize, compare);
+		bool runsAreInScratch = true;
+
+		for (size_t currentRunSize = runSize * 2; currentRunSize < elementCount; currentRunSize *= 2)
+		{
+			if (runsAreInScratch)
+				ParallelInternal::MergeRuns<false>(pScratch, first, elementCount, currentRunSize, compare);
+			else
+				ParallelInternal::MergeRuns<false>(first, pScratch, elementCount, currentRunSize, compare);
+
+			runsAreInScratch = !runsAreInScratch;
+		}
+
+		if (runsAreInScratch)
+			eastl::move(pScratch, pScratch + elementCount, first);
+
+		for (size_t i = 0; i < elementCount; ++i)
+		{
+			pScratch[i].~ValueType();
+		}
+		EXELIUS_DELETE_ARRAY(pScratchSlots);
+	}
+
+	/// <summary>
+	/// Stable sort of [first, last) in parallel, using operator less than.
+	/// </summary>
+	/// <param name="first">- Random access iterator to the first element.</param>
+	/// <param name="last">- Random access iterator to one past the last element.</param>
+	template <typename RandomAccessIterator>
+	void ParallelSort(RandomAccessIterator first, RandomAccessIterator last)
+	{
+		using ValueType = typename eastl::iterator_traits<RandomAccessIterator>::value_type;
+		ParallelSort(first, last, eastl::less<ValueType>());
+	}
+}
\ No newline at end of file
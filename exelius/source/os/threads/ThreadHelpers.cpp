@@ -0,0 +1,93 @@
+#include "EXEPCH.h"
+#include "source/os/threads/ThreadHelpers.h"
+
+#include <EASTL/algorithm.h>
+#include <cstdio>
+#include <thread>
+
+#if defined(EXE_WINDOWS)
+	#include <Windows.h>
+#elif defined(EXE_LINUX)
+	#include <pthread.h>
+	#include <sched.h>
+	#include <unistd.h>
+#endif
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	namespace ThreadHelpers
+	{
+		uint32_t GetLogicalCoreCount()
+		{
+			return eastl::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		uint32_t GetNumaNode([[maybe_unused]] uint32_t coreIndex)
+		{
+			#if defined(EXE_WINDOWS)
+				UCHAR nodeNumber = 0;
+				if (coreIndex > 0xFF || !GetNumaProcessorNode(static_cast<UCHAR>(coreIndex), &nodeNumber) || nodeNumber == 0xFF)
+					return 0;
+
+				return nodeNumber;
+			#elif defined(EXE_LINUX)
+				// Each core's sysfs directory holds a link named after the node it belongs to.
+				static constexpr uint32_t kMaxNumaNodes = 64;
+				char path[96];
+				for (uint32_t nodeIndex = 0; nodeIndex < kMaxNumaNodes; ++nodeIndex)
+				{
+					std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/node%u", coreIndex, nodeIndex);
+					if (access(path, F_OK) == 0)
+						return nodeIndex;
+				}
+
+				return 0;
+			#else
+				return 0;
+			#endif
+		}
+
+		bool SetCurrentThreadName([[maybe_unused]] const char* pName)
+		{
+			EXE_ASSERT(pName);
+
+			#if defined(EXE_WINDOWS)
+				wchar_t wideName[64];
+				if (MultiByteToWideChar(CP_UTF8, 0, pName, -1, wideName, 64) == 0)
+					return false;
+
+				return SUCCEEDED(SetThreadDescription(GetCurrentThread(), wideName));
+			#elif defined(EXE_LINUX)
+				char truncatedName[16];
+				std::snprintf(truncatedName, sizeof(truncatedName), "%s", pName);
+				return pthread_setname_np(pthread_self(), truncatedName) == 0;
+			#else
+				return false;
+			#endif
+		}
+
+		bool PinCurrentThreadToCore([[maybe_unused]] uint32_t coreIndex)
+		{
+			#if defined(EXE_WINDOWS)
+				// Only covers the first processor group, which is up to 64 logical cores.
+				if (coreIndex >= sizeof(DWORD_PTR) * 8)
+					return false;
+
+				return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << coreIndex) != 0;
+			#elif defined(EXE_LINUX)
+				if (coreIndex >= CPU_SETSIZE)
+					return false;
+
+				cpu_set_t coreSet;
+				CPU_ZERO(&coreSet);
+				CPU_SET(coreIndex, &coreSet);
+				return pthread_setaffinity_np(pthread_self(), sizeof(coreSet), &coreSet) == 0;
+			#else
+				return false;
+			#endif
+		}
+	}
+}
\ No newline at end of file
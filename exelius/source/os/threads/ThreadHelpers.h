@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// Thin wrappers around the platform's thread and CPU topology APIs.
+	/// On platforms that are not supported these do nothing and report failure.
+	/// </summary>
+	namespace ThreadHelpers
+	{
+		/// <summary>
+		/// Used in place of a core index to mean the thread may run on any core.
+		/// </summary>
+		static constexpr int32_t kAnyCore = -1;
+
+		/// <summary>
+		/// The number of logical cores (hardware threads) on this machine.
+		/// </summary>
+		/// <returns>The logical core count, never less than 1.</returns>
+		uint32_t GetLogicalCoreCount();
+
+		/// <summary>
+		/// The NUMA node a logical core belongs to.
+		/// </summary>
+		/// <param name="coreIndex">- The logical core.</param>
+		/// <returns>The node index, or 0 if the machine has one node or it can't be determined.</returns>
+		uint32_t GetNumaNode(uint32_t coreIndex);
+
+		/// <summary>
+		/// Names the calling thread, so it shows up in debuggers and profilers.
+		/// Some platforms truncate long names (Linux allows 15 characters).
+		/// </summary>
+		/// <param name="pName">- The name to give the thread.</param>
+		/// <returns>True on success, false otherwise.</returns>
+		bool SetCurrentThreadName(const char* pName);
+
+		/// <summary>
+		/// Restricts the calling thread to a single logical core.
+		/// </summary>
+		/// <param name="coreIndex">- The logical core to run on.</param>
+		/// <returns>True on success, false otherwise.</returns>
+		bool PinCurrentThreadToCore(uint32_t coreIndex);
+	}
+}
\ No newline at end of file
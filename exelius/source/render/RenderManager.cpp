@@ -3,6 +3,7 @@
 #include "source/os/interface/graphics/Window.h"
 
 #include "source/os/interface/graphics/VertexArray.h"
+#include "source/os/threads/ParallelAlgorithms.h"
 
 // TEMP
 #include "source/os/interface/graphics/Sprite.h"
@@ -41,6 +42,7 @@ namespace Exelius
 		, m_framesBehind(0)
 		#endif // !FORCE_SINGLE_THREADED_RENDERER
 		, m_pWindow(nullptr)
+		, m_drawnFrame(0)
 	{
 		//
 	}
@@ -48,6 +50,7 @@ namespace Exelius
 	RenderManager::~RenderManager()
 	{
 		m_advancedBuffer.clear();
+		m_cachedTextures.clear();
 
 		#if !FORCE_SINGLE_THREADED_RENDERER
 			m_intermediateBufferMutex.lock();
@@ -162,6 +165,8 @@ namespace Exelius
 	{
 		#if !FORCE_SINGLE_THREADED_RENDERER
 		m_renderManagerLog.Info("Instantiating Render Thread.");
+		if (s_pGlobalJobSystem)
+			s_pGlobalJobSystem->EnterReservedThread(ReservedThread::kRender);
 		eastl::vector<RenderCommand> backBuffer;
 
 		EXE_ASSERT(m_pWindow);
@@ -208,6 +213,7 @@ namespace Exelius
 			m_viewListLock.unlock();
 
 			backBuffer.clear();
+			ReleaseUndrawnTextures();
 
 			// Render Display
 			m_pWindow->Render();
@@ -236,6 +242,7 @@ namespace Exelius
 			DrawToViews(m_advancedBuffer);
 
 		m_advancedBuffer.clear();
+		ReleaseUndrawnTextures();
 
 		// Render Display
 		m_pWindow->Render();
@@ -265,8 +272,7 @@ namespace Exelius
 			// If rendercommand can't be batched
 			if (command.m_texture != currentTexture)
 			{
-				ResourceHandle texture(currentTexture);
-				auto* pTextureResource = texture.GetAs<TextureResource>();
+				auto* pTextureResource = GetTexture(currentTexture);
 
 				if (pTextureResource)
 				{
@@ -296,8 +302,7 @@ namespace Exelius
 		// If we still have stuff to draw, then draw it.
 		if (vertices.GetVertexCount() > 0)
 		{
-			ResourceHandle texture(currentTexture);
-			auto* pTextureResource = texture.GetAs<TextureResource>();
+			auto* pTextureResource = GetTexture(currentTexture);
 
 			if (pTextureResource)
 			{
@@ -347,8 +352,7 @@ namespace Exelius
 				// If rendercommand can't be batched
 				if (command.m_texture != currentTexture)
 				{
-					ResourceHandle texture(currentTexture);
-					auto* pTextureResource = texture.GetAs<TextureResource>();
+					auto* pTextureResource = GetTexture(currentTexture);
 
 					if (pTextureResource)
 					{
@@ -375,8 +379,7 @@ namespace Exelius
 			// If we still have stuff to draw, then draw it.
 			if (vertices.GetVertexCount() > 0)
 			{
-				ResourceHandle texture(currentTexture);
-				auto* pTextureResource = texture.GetAs<TextureResource>();
+				auto* pTextureResource = GetTexture(currentTexture);
 
 				if (!pTextureResource)
 				{
@@ -406,13 +409,12 @@ namespace Exelius
 
 	void RenderManager::SortRenderCommands(eastl::vector<RenderCommand>& bufferToSort)
 	{
-		// TODO:
-			// Maybe eastl::stable_sort is what I want here?
+		// ParallelSort is stable, and falls back to a serial sort for small buffers.
 		// Sort based on the Z, Y, or X in that order.
-		eastl::sort(bufferToSort.begin(), bufferToSort.end());
+		ParallelSort(bufferToSort.begin(), bufferToSort.end());
 
 		// Without disturbing above sort, sort by texture.
-		eastl::stable_sort(bufferToSort.begin(), bufferToSort.end(), [](const RenderCommand& left, const RenderCommand& right)
+		ParallelSort(bufferToSort.begin(), bufferToSort.end(), [](const RenderCommand& left, const RenderCommand& right)
 			{
 				// Sort By Texture
 				if (left.m_texture != right.m_texture)
@@ -487,6 +489,32 @@ namespace Exelius
 		vertexArray.Append(Vertex(posBottomLeft, command.m_tint, uvBottomLeft));
 	}
 
+	TextureResource* RenderManager::GetTexture(const ResourceID& textureID)
+	{
+		if (!textureID.IsValid())
+			return nullptr;
+
+		CachedTexture& cachedTexture = m_cachedTextures[textureID];
+		if (!cachedTexture.m_handle.GetID().IsValid())
+			cachedTexture.m_handle.SetResourceID(textureID);
+
+		cachedTexture.m_lastDrawnFrame = m_drawnFrame;
+		return cachedTexture.m_handle.GetAs<TextureResource>();
+	}
+
+	void RenderManager::ReleaseUndrawnTextures()
+	{
+		for (auto textureIterator = m_cachedTextures.begin(); textureIterator != m_cachedTextures.end();)
+		{
+			if (textureIterator->second.m_lastDrawnFrame != m_drawnFrame)
+				textureIterator = m_cachedTextures.erase(textureIterator);
+			else
+				++textureIterator;
+		}
+
+		++m_drawnFrame;
+	}
+
 	void RenderManager::SignalAndWaitForRenderThread()
 	{
 		#if !FORCE_SINGLE_THREADED_RENDERER
@@ -29,6 +29,7 @@ namespace Exelius
 {
 	FORWARD_DECLARE(Window);
 	FORWARD_DECLARE(VertexArray);
+	class TextureResource;
 
 	class RenderManager
 		: public Singleton<RenderManager>
@@ -46,6 +47,17 @@ namespace Exelius
 		eastl::vector<RenderCommand> m_intermediateBuffer; // Main loop will swap this buffer with advancedbuffer at the end of a frame. Render Thread will swap with this buffer if it is not processing.
 		eastl::vector<eastl::pair<StringIntern, View>> m_views;
 
+		struct CachedTexture
+		{
+			ResourceHandle m_handle;
+			uint32_t m_lastDrawnFrame;
+		};
+
+		// Handles to the textures drawn recently, so a texture switch doesn't look the texture up again.
+		// Only touched while drawing. A texture that goes a frame without being drawn is released.
+		eastl::unordered_map<ResourceID, CachedTexture> m_cachedTextures;
+		uint32_t m_drawnFrame;
+
 		#if !FORCE_SINGLE_THREADED_RENDERER
 			std::mutex m_intermediateBufferMutex;
 			std::thread m_renderThread;
@@ -96,6 +108,12 @@ namespace Exelius
 
 		void AddVertexToArray(VertexArray& vertexArray, const RenderCommand& command) const;
 
+		// Get a texture through its cached handle, caching a new handle if needed.
+		TextureResource* GetTexture(const ResourceID& textureID);
+
+		// Release the cached textures that weren't drawn this frame.
+		void ReleaseUndrawnTextures();
+
 		// Used when this Manager is destroyed in order to stop the thread.
 		void SignalAndWaitForRenderThread();
 	};
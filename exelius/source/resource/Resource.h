@@ -2,6 +2,7 @@
 #include "source/resource/ResourceHelpers.h"
 #include "source/debug/Log.h"
 
+#include <EASTL/span.h>
 #include <EASTL/vector.h>
 
 /// <summary>
@@ -67,11 +68,39 @@ namespace Exelius
 		/// <returns>The result of the load operation.</returns>
 		virtual LoadResult Load(eastl::vector<std::byte>&& data) = 0;
 
+		/// <summary>
+		/// Load the asset from a read only view of its raw data, usually a memory
+		/// mapped file. The view is only valid until this returns, so anything
+		/// that must outlive the call has to be copied out of it.
+		/// 
+		/// By default the data is copied into a vector and passed to the other
+		/// Load(). Subclasses that only decode the data should override this
+		/// as well, so the data is never copied.
+		/// 
+		/// @note
+		/// This function is typically called from the resource thread
+		/// and thus should be made thread safe.
+		/// </summary>
+		/// <param name="data">- The raw byte data of the loaded asset.</param>
+		/// <returns>The result of the load operation.</returns>
+		virtual LoadResult Load(eastl::span<const std::byte> data)
+		{
+			return Load(eastl::vector<std::byte>(data.begin(), data.end()));
+		}
+
 		/// <summary>
 		/// Unload the asset. This will call the Subclass specific unloading function.
 		/// </summary>
 		virtual void Unload() = 0;
 
+		/// <summary>
+		/// Get the number of bytes this resource keeps in memory once loaded,
+		/// which is counted against its type's cache budget. Returns 0 by
+		/// default, in which case the size of its raw data is counted instead.
+		/// </summary>
+		/// <returns>The resource's size in memory, or 0 if unknown.</returns>
+		virtual size_t GetMemorySize() const { return 0; }
+
 		/// <summary>
 		/// Get the ResourceID referred to by this resource.
 		/// </summary>
@@ -0,0 +1,189 @@
+#include "EXEPCH.h"
+#include "source/resource/ResourceCache.h"
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	ResourceCache::ResourceCache()
+		: m_defaultBudget(0)
+		, m_hits(0)
+		, m_misses(0)
+		, m_evictions(0)
+		, m_cachedBytes(0)
+	{
+		//
+	}
+
+	/// <summary>
+	/// Sets the budget of every type. Types already over their new budget are
+	/// trimmed the next time one of their resources is released.
+	/// </summary>
+	/// <param name="defaultBudget">- The bytes each type not in typeBudgets may keep cached.</param>
+	/// <param name="typeBudgets">- The bytes specific types may keep cached, keyed by type.</param>
+	void ResourceCache::SetBudgets(size_t defaultBudget, const eastl::unordered_map<ResourceType::Type, size_t>& typeBudgets)
+	{
+		std::lock_guard<std::mutex> lock(m_cacheLock);
+
+		m_defaultBudget = defaultBudget;
+		m_typeBudgets = typeBudgets;
+
+		for (auto& typeCachePair : m_typeCaches)
+		{
+			auto found = m_typeBudgets.find(typeCachePair.first);
+			typeCachePair.second.m_budget = (found != m_typeBudgets.end()) ? found->second : m_defaultBudget;
+		}
+	}
+
+	/// <summary>
+	/// Caches a resource that nothing references, evicting the least recently released
+	/// resources of its type until it fits. A resource that is already cached is
+	/// moved to the front.
+	/// </summary>
+	/// <param name="resourceID">- The resource to cache.</param>
+	/// <param name="type">- The resource's type.</param>
+	/// <param name="memorySize">- The bytes the resource counts against its type's budget.</param>
+	/// <param name="evictedIDs">- Receives the resources that were evicted, which must be unloaded.</param>
+	/// <returns>True if the resource was cached, false if its type has no room for it and it must be unloaded.</returns>
+	bool ResourceCache::Insert(const ResourceID& resourceID, ResourceType::Type type, size_t memorySize, eastl::vector<ResourceID>& evictedIDs)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+
+		std::lock_guard<std::mutex> lock(m_cacheLock);
+
+		TypeCache& typeCache = GetTypeCache(type);
+
+		// Released twice without being acquired in between. It only needs to move to the front.
+		auto found = m_cachedResources.find(resourceID);
+		if (found != m_cachedResources.end())
+		{
+			typeCache.m_leastRecentlyUsed.splice(typeCache.m_leastRecentlyUsed.begin(), typeCache.m_leastRecentlyUsed, found->second.m_position);
+			return true;
+		}
+
+		if (memorySize > typeCache.m_budget)
+			return false;
+
+		while (typeCache.m_cachedBytes + memorySize > typeCache.m_budget)
+		{
+			const ResourceID& evictedID = typeCache.m_leastRecentlyUsed.back();
+			auto evicted = m_cachedResources.find(evictedID);
+			EXE_ASSERT(evicted != m_cachedResources.end());
+
+			typeCache.m_cachedBytes -= evicted->second.m_memorySize;
+			m_cachedBytes -= evicted->second.m_memorySize;
+			++m_evictions;
+
+			evictedIDs.emplace_back(evictedID);
+			m_cachedResources.erase(evicted);
+			typeCache.m_leastRecentlyUsed.pop_back();
+		}
+
+		typeCache.m_leastRecentlyUsed.push_front(resourceID);
+		typeCache.m_cachedBytes += memorySize;
+		m_cachedBytes += memorySize;
+
+		CachedResource& cachedResource = m_cachedResources[resourceID];
+		cachedResource.m_type = type;
+		cachedResource.m_memorySize = memorySize;
+		cachedResource.m_position = typeCache.m_leastRecentlyUsed.begin();
+
+		return true;
+	}
+
+	/// <summary>
+	/// Takes a resource out of the cache because it is in use again, counting a hit.
+	/// </summary>
+	/// <param name="resourceID">- The resource to take out.</param>
+	/// <returns>True if the resource was cached.</returns>
+	bool ResourceCache::Remove(const ResourceID& resourceID)
+	{
+		std::lock_guard<std::mutex> lock(m_cacheLock);
+
+		auto found = m_cachedResources.find(resourceID);
+		if (found == m_cachedResources.end())
+			return false;
+
+		TypeCache& typeCache = GetTypeCache(found->second.m_type);
+		typeCache.m_leastRecentlyUsed.erase(found->second.m_position);
+		typeCache.m_cachedBytes -= found->second.m_memorySize;
+		m_cachedBytes -= found->second.m_memorySize;
+		++m_hits;
+
+		m_cachedResources.erase(found);
+		return true;
+	}
+
+	/// <summary>
+	/// Checks if a resource is in the cache.
+	/// </summary>
+	/// <param name="resourceID">- The resource to check.</param>
+	/// <returns>True if the resource is cached.</returns>
+	bool ResourceCache::Contains(const ResourceID& resourceID) const
+	{
+		std::lock_guard<std::mutex> lock(m_cacheLock);
+		return m_cachedResources.find(resourceID) != m_cachedResources.end();
+	}
+
+	/// <summary>
+	/// Counts an acquisition that had to load its resource.
+	/// </summary>
+	void ResourceCache::RecordMiss()
+	{
+		std::lock_guard<std::mutex> lock(m_cacheLock);
+		++m_misses;
+	}
+
+	/// <summary>
+	/// Forgets every cached resource, without evicting them.
+	/// Used when the database unloads everything.
+	/// </summary>
+	void ResourceCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_cacheLock);
+
+		m_cachedResources.clear();
+		m_typeCaches.clear();
+		m_cachedBytes = 0;
+	}
+
+	/// <summary>
+	/// Takes a snapshot of the cache's counters.
+	/// </summary>
+	/// <returns>The current cache stats.</returns>
+	ResourceCacheStats ResourceCache::GetStats() const
+	{
+		std::lock_guard<std::mutex> lock(m_cacheLock);
+
+		ResourceCacheStats stats;
+		stats.m_hits = m_hits;
+		stats.m_misses = m_misses;
+		stats.m_evictions = m_evictions;
+		stats.m_cachedResources = m_cachedResources.size();
+		stats.m_cachedBytes = m_cachedBytes;
+
+		return stats;
+	}
+
+	/// <summary>
+	/// Gets the cache of the given type, creating it with its budget if needed.
+	/// The cache's lock must be held.
+	/// </summary>
+	/// <param name="type">- The type to get the cache of.</param>
+	/// <returns>The type's cache.</returns>
+	ResourceCache::TypeCache& ResourceCache::GetTypeCache(ResourceType::Type type)
+	{
+		auto [typeCacheIterator, isNewTypeCache] = m_typeCaches.try_emplace(type);
+		TypeCache& typeCache = typeCacheIterator->second;
+
+		if (isNewTypeCache)
+		{
+			auto found = m_typeBudgets.find(type);
+			typeCache.m_budget = (found != m_typeBudgets.end()) ? found->second : m_defaultBudget;
+			typeCache.m_cachedBytes = 0;
+		}
+
+		return typeCache;
+	}
+}
\ No newline at end of file
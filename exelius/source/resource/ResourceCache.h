@@ -0,0 +1,182 @@
+#pragma once
+#include "source/resource/ResourceHelpers.h"
+
+#include <EASTL/list.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+#include <mutex>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// A snapshot of the resource cache, from ResourceLoader::GetCacheStats().
+	/// The counters only ever grow.
+	/// </summary>
+	struct ResourceCacheStats
+	{
+		/// <summary>
+		/// Acquisitions of a resource that was still resident in the cache.
+		/// </summary>
+		uint64_t m_hits;
+
+		/// <summary>
+		/// Acquisitions of a resource that had to be loaded.
+		/// </summary>
+		uint64_t m_misses;
+
+		/// <summary>
+		/// Resources unloaded to keep their type within its budget.
+		/// </summary>
+		uint64_t m_evictions;
+
+		/// <summary>
+		/// Resources resident in the cache right now, and the bytes they count against their budgets.
+		/// </summary>
+		size_t m_cachedResources;
+		size_t m_cachedBytes;
+
+		/// <summary>
+		/// The fraction of acquisitions that were hits.
+		/// </summary>
+		double GetHitRate() const { return (m_hits + m_misses) ? static_cast<double>(m_hits) / (m_hits + m_misses) : 0.0; }
+	};
+
+	/// <summary>
+	/// Keeps resources that nothing references any more resident, so objects that
+	/// are destroyed and created again don't read and decode the same data each time.
+	///
+	/// Each resource type has its own budget of bytes. Resources are only evicted,
+	/// least recently released first, when caching another of their type would go
+	/// over its budget. A type with a budget of 0 is never cached, so its resources
+	/// unload as soon as they are released.
+	///
+	/// The cache only tracks IDs. The ResourceDatabase still owns the entries, and
+	/// unloads whatever the cache hands back as evicted.
+	///
+	/// Thread Safe. The cache's lock is always taken after a database shard's lock.
+	/// </summary>
+	class ResourceCache
+	{
+		/// <summary>
+		/// The resources of one type that are in the cache, most recently released first.
+		/// </summary>
+		struct TypeCache
+		{
+			eastl::list<ResourceID> m_leastRecentlyUsed;
+			size_t m_budget;
+			size_t m_cachedBytes;
+		};
+
+		/// <summary>
+		/// Where a cached resource is, and how much it counts against its budget.
+		/// </summary>
+		struct CachedResource
+		{
+			ResourceType::Type m_type;
+			size_t m_memorySize;
+			eastl::list<ResourceID>::iterator m_position;
+		};
+
+		/// <summary>
+		/// The caches of each type that has been released, keyed by type.
+		/// </summary>
+		eastl::unordered_map<ResourceType::Type, TypeCache> m_typeCaches;
+
+		/// <summary>
+		/// Every cached resource, keyed by ID.
+		/// </summary>
+		eastl::unordered_map<ResourceID, CachedResource> m_cachedResources;
+
+		/// <summary>
+		/// The budgets of types that were not given one.
+		/// </summary>
+		size_t m_defaultBudget;
+
+		/// <summary>
+		/// The budgets given to specific types.
+		/// </summary>
+		eastl::unordered_map<ResourceType::Type, size_t> m_typeBudgets;
+
+		uint64_t m_hits;
+		uint64_t m_misses;
+		uint64_t m_evictions;
+		size_t m_cachedBytes;
+
+		/// <summary>
+		/// Guards everything in the cache.
+		/// </summary>
+		mutable std::mutex m_cacheLock;
+
+	public:
+		ResourceCache();
+		ResourceCache(const ResourceCache&) = delete;
+		ResourceCache(ResourceCache&&) = delete;
+		ResourceCache& operator=(const ResourceCache&) = delete;
+		ResourceCache& operator=(ResourceCache&&) = delete;
+		~ResourceCache() = default;
+
+		/// <summary>
+		/// Sets the budget of every type. Types already over their new budget are
+		/// trimmed the next time one of their resources is released.
+		/// </summary>
+		/// <param name="defaultBudget">- The bytes each type not in typeBudgets may keep cached.</param>
+		/// <param name="typeBudgets">- The bytes specific types may keep cached, keyed by type.</param>
+		void SetBudgets(size_t defaultBudget, const eastl::unordered_map<ResourceType::Type, size_t>& typeBudgets);
+
+		/// <summary>
+		/// Caches a resource that nothing references, evicting the least recently released
+		/// resources of its type until it fits. A resource that is already cached is
+		/// moved to the front.
+		/// </summary>
+		/// <param name="resourceID">- The resource to cache.</param>
+		/// <param name="type">- The resource's type.</param>
+		/// <param name="memorySize">- The bytes the resource counts against its type's budget.</param>
+		/// <param name="evictedIDs">- Receives the resources that were evicted, which must be unloaded.</param>
+		/// <returns>True if the resource was cached, false if its type has no room for it and it must be unloaded.</returns>
+		bool Insert(const ResourceID& resourceID, ResourceType::Type type, size_t memorySize, eastl::vector<ResourceID>& evictedIDs);
+
+		/// <summary>
+		/// Takes a resource out of the cache because it is in use again, counting a hit.
+		/// </summary>
+		/// <param name="resourceID">- The resource to take out.</param>
+		/// <returns>True if the resource was cached.</returns>
+		bool Remove(const ResourceID& resourceID);
+
+		/// <summary>
+		/// Checks if a resource is in the cache.
+		/// </summary>
+		/// <param name="resourceID">- The resource to check.</param>
+		/// <returns>True if the resource is cached.</returns>
+		bool Contains(const ResourceID& resourceID) const;
+
+		/// <summary>
+		/// Counts an acquisition that had to load its resource.
+		/// </summary>
+		void RecordMiss();
+
+		/// <summary>
+		/// Forgets every cached resource, without evicting them.
+		/// Used when the database unloads everything.
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Takes a snapshot of the cache's counters.
+		/// </summary>
+		/// <returns>The current cache stats.</returns>
+		ResourceCacheStats GetStats() const;
+
+	private:
+		/// <summary>
+		/// Gets the cache of the given type, creating it with its budget if needed.
+		/// The cache's lock must be held.
+		/// </summary>
+		/// <param name="type">- The type to get the cache of.</param>
+		/// <returns>The type's cache.</returns>
+		TypeCache& GetTypeCache(ResourceType::Type type);
+	};
+}
\ No newline at end of file
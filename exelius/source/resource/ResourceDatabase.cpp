@@ -8,7 +8,9 @@
 namespace Exelius
 {
 	ResourceDatabase::ResourceDatabase()
-		: m_resourceDatabaseLog("ResourceDatabase")
+		: m_slotPages()
+		, m_slotCount(0)
+		, m_resourceDatabaseLog("ResourceDatabase")
 	{
 		//
 	}
@@ -19,9 +21,22 @@ namespace Exelius
 	/// </summary>
 	ResourceDatabase::~ResourceDatabase()
 	{
-		m_mapLock.lock();
+		for (auto& shard : m_shards)
+		{
+			shard.m_mapLock.lock();
+		}
+
 		UnloadAll();
-		m_mapLock.unlock();
+
+		for (auto* pSlotPage : m_slotPages)
+		{
+			delete[] pSlotPage;
+		}
+
+		for (auto& shard : m_shards)
+		{
+			shard.m_mapLock.unlock();
+		}
 	}
 
 	/// <summary>
@@ -32,8 +47,21 @@ namespace Exelius
 	/// </summary>
 	void ResourceDatabase::ProcessUnloadQueue()
 	{
-		while (!m_unloadQueue.empty())
-			InternalProcessUnloadQueue();
+		while (InternalProcessUnloadQueue())
+		{
+			//
+		}
+
+		eastl::vector<Resource*> retiredResources;
+		m_unloaderLock.lock();
+		retiredResources.swap(m_retiredResources);
+		m_unloaderLock.unlock();
+
+		for (Resource* pResource : retiredResources)
+		{
+			pResource->Unload();
+			delete pResource;
+		}
 	}
 
 	/// <summary>
@@ -42,7 +70,8 @@ namespace Exelius
 	/// Resources can unload more resources, so this acts as a
 	/// double buffered queue.
 	/// </summary>
-	void ResourceDatabase::InternalProcessUnloadQueue()
+	/// <returns>True if anything was queued, false if the queue was empty.</returns>
+	bool ResourceDatabase::InternalProcessUnloadQueue()
 	{
 		// Create the second buffer.
 		eastl::vector<ResourceID> m_activeUnloader;
@@ -50,29 +79,60 @@ namespace Exelius
 		m_activeUnloader.swap(m_unloadQueue);
 		m_unloaderLock.unlock();
 
+		if (m_activeUnloader.empty())
+			return false;
+
 		for (auto& resourceID : m_activeUnloader)
 		{
 			m_resourceDatabaseLog.Info("Unloading Resource: {}", resourceID.Get().c_str());
-			if (!IsFound(resourceID))
+
+			Shard& shard = GetShard(resourceID);
+			shard.m_mapLock.lock();
+			ResourceEntry* pResourceEntry = FindEntry(shard, resourceID);
+			if (!pResourceEntry)
+			{
+				shard.m_mapLock.unlock();
+				continue;
+			}
+
+			// The entry may have been acquired again, reloaded, or released back into the cache since it was queued.
+			const ResourceLoadStatus status = pResourceEntry->GetStatus();
+			if (status == ResourceLoadStatus::kLoading || (status == ResourceLoadStatus::kLoaded && (pResourceEntry->IsHeld() || m_resourceCache.Contains(resourceID))))
+			{
+				shard.m_mapLock.unlock();
+				m_resourceDatabaseLog.Info("Skipped unloading resource '{}', it is in use again.", resourceID.Get().c_str());
 				continue;
+			}
 
-			// TODO: Verify that the ResourceEntry is in fact unloadable.
+			Resource* pResource = (status == ResourceLoadStatus::kLoaded) ? pResourceEntry->GetResource() : nullptr;
+			eastl::vector<ResourceID> dependencies = pResourceEntry->TakeDependencies();
+			pResourceEntry->SetStatus(ResourceLoadStatus::kUnloading);
+			FreeSlot(pResourceEntry->GetSlotIndex());
+			pResourceEntry->SetSlotIndex(s_kInvalidSlot);
+			shard.m_mapLock.unlock();
 
-			Resource* pResource = InternalGetEntryResource(resourceID);
-			InternalSetLoadStatus(resourceID, ResourceLoadStatus::kUnloading);
+			// Unloading may release other resources, so the map can't stay locked.
 			if (pResource)
-			{
 				pResource->Unload();
-				InternalSetLoadStatus(resourceID, ResourceLoadStatus::kUnloaded);
+
+			// Dependencies that are no longer held are cached or queued, and unload on a later pass.
+			for (const ResourceID& dependencyID : dependencies)
+			{
+				if (DecrementEntryRefCount(dependencyID))
+					ReleaseEntry(dependencyID);
 			}
 
-			m_mapLock.lock();
-			m_resourceMap.erase(resourceID);
-			m_mapLock.unlock();
+			shard.m_mapLock.lock();
+			shard.m_resourceMap.erase(resourceID);
+			shard.m_mapLock.unlock();
+
+			// Loads that arrived while it was unloading can now start again.
+			shard.m_unloadFinished.notify_all();
 
 			m_resourceDatabaseLog.Info("Unloaded Resource '{}'", resourceID.Get().c_str());
 		}
 		m_activeUnloader.clear();
+		return true;
 	}
 
 	/// <summary>
@@ -84,18 +144,22 @@ namespace Exelius
 	{
 		EXE_ASSERT(resourceID.IsValid());
 
-		m_mapLock.lock();
-		ResourceEntry* pResourceEntry = GetEntry(resourceID);
+		Shard& shard = GetShard(resourceID);
+		shard.m_mapLock.lock();
+		ResourceEntry* pResourceEntry = GetEntry(shard, resourceID);
 		if (!pResourceEntry)
 		{
-			m_mapLock.unlock();
+			shard.m_mapLock.unlock();
 			m_resourceDatabaseLog.Info("Unable to increment reference count on ResourceEntry '{}'", resourceID.Get().c_str());
 			return;
 		}
 
+		if (!pResourceEntry->IsHeld())
+			m_resourceCache.Remove(resourceID);
+
 		// Increment the reference count of this resource.
 		pResourceEntry->IncrementRefCount();
-		m_mapLock.unlock();
+		shard.m_mapLock.unlock();
 	}
 
 	/// <summary>
@@ -108,18 +172,19 @@ namespace Exelius
 	{
 		EXE_ASSERT(resourceID.IsValid());
 
-		m_mapLock.lock();
-		ResourceEntry* pResourceEntry = GetEntry(resourceID);
+		Shard& shard = GetShard(resourceID);
+		shard.m_mapLock.lock();
+		ResourceEntry* pResourceEntry = GetEntry(shard, resourceID);
 		if (!pResourceEntry)
 		{
-			m_mapLock.unlock();
+			shard.m_mapLock.unlock();
 			m_resourceDatabaseLog.Info("Unable to decrement reference count on ResourceEntry '{}'", resourceID.Get().c_str());
 			return true; // Return true because there cannot be refs or locks on a non-existant entry.
 		}
 
 		// Decrement the reference count of this resource.
 		bool entryUnheld = pResourceEntry->DecrementRefCount();
-		m_mapLock.unlock();
+		shard.m_mapLock.unlock();
 
 		return entryUnheld;
 	}
@@ -133,18 +198,22 @@ namespace Exelius
 	{
 		EXE_ASSERT(resourceID.IsValid());
 
-		m_mapLock.lock();
-		ResourceEntry* pResourceEntry = GetEntry(resourceID);
+		Shard& shard = GetShard(resourceID);
+		shard.m_mapLock.lock();
+		ResourceEntry* pResourceEntry = GetEntry(shard, resourceID);
 		if (!pResourceEntry)
 		{
-			m_mapLock.unlock();
+			shard.m_mapLock.unlock();
 			m_resourceDatabaseLog.Info("Unable to increment lock count on ResourceEntry '{}'", resourceID.Get().c_str());
 			return;
 		}
 
+		if (!pResourceEntry->IsHeld())
+			m_resourceCache.Remove(resourceID);
+
 		// Increment the reference count of this resource.
 		pResourceEntry->IncrementLockCount();
-		m_mapLock.unlock();
+		shard.m_mapLock.unlock();
 	}
 
 	/// <summary>
@@ -157,36 +226,141 @@ namespace Exelius
 	{
 		EXE_ASSERT(resourceID.IsValid());
 
-		m_mapLock.lock();
-		ResourceEntry* pResourceEntry = GetEntry(resourceID);
+		Shard& shard = GetShard(resourceID);
+		shard.m_mapLock.lock();
+		ResourceEntry* pResourceEntry = GetEntry(shard, resourceID);
 		if (!pResourceEntry)
 		{
-			m_mapLock.unlock();
+			shard.m_mapLock.unlock();
 			m_resourceDatabaseLog.Info("Unable to decrement lock count on ResourceEntry '{}'", resourceID.Get().c_str());
 			return true; // Return true because there cannot be refs or locks on a non-existant entry.
 		}
 
 		// Decrement the Lock count of this resource.
 		bool entryUnheld = pResourceEntry->DecrementLockCount();
-		m_mapLock.unlock();
+		shard.m_mapLock.unlock();
 
 		return entryUnheld;
 	}
 
+	/// <summary>
+	/// Thread Safe.
+	/// Caches the entry with the given ID if nothing holds it and its type has room,
+	/// evicting the least recently released entries of that type as needed.
+	/// Otherwise the entry is queued to unload, as are any evicted entries.
+	/// </summary>
+	/// <param name="resourceID">- The ID of the resource that was released.</param>
+	void ResourceDatabase::ReleaseEntry(const ResourceID& resourceID)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+
+		eastl::vector<ResourceID> evictedIDs;
+
+		Shard& shard = GetShard(resourceID);
+		shard.m_mapLock.lock();
+		ResourceEntry* pResourceEntry = FindEntry(shard, resourceID);
+
+		// It may have been acquired again since it was released.
+		if (pResourceEntry && pResourceEntry->IsHeld())
+		{
+			shard.m_mapLock.unlock();
+			return;
+		}
+
+		bool isCached = false;
+		if (pResourceEntry && pResourceEntry->GetStatus() == ResourceLoadStatus::kLoaded)
+			isCached = m_resourceCache.Insert(resourceID, pResourceEntry->GetType(), pResourceEntry->GetMemorySize(), evictedIDs);
+		shard.m_mapLock.unlock();
+
+		if (!isCached)
+			UnloadEntry(resourceID);
+
+		for (const ResourceID& evictedID : evictedIDs)
+		{
+			m_resourceDatabaseLog.Trace("Evicting cached resource: {}", evictedID.Get().c_str());
+			UnloadEntry(evictedID);
+		}
+	}
+
 	/// <summary>
 	/// Thread Safe.
 	/// Sets the given resource onto the resource entry.
 	/// </summary>
 	/// <param name="resourceID">- The resource ID to set the resource onto.</param>
 	/// <param name="pResource">- The resource to set.</param>
-	void ResourceDatabase::SetEntryResource(const ResourceID& resourceID, Resource* pResource)
+	/// <param name="type">- The type of the resource, which picks its cache budget.</param>
+	/// <param name="memorySize">- The bytes the resource counts against its cache budget.</param>
+	void ResourceDatabase::SetEntryResource(const ResourceID& resourceID, Resource* pResource, ResourceType::Type type, size_t memorySize)
 	{
 		EXE_ASSERT(resourceID.IsValid());
 		EXE_ASSERT(pResource);
 
-		m_mapLock.lock();
-		GetEntry(resourceID)->SetResource(pResource);
-		m_mapLock.unlock();
+		Shard& shard = GetShard(resourceID);
+		shard.m_mapLock.lock();
+		ResourceEntry* pResourceEntry = GetEntry(shard, resourceID);
+		pResourceEntry->SetResource(pResource);
+		pResourceEntry->SetCacheInfo(type, memorySize);
+		AdvanceSlotGeneration(pResourceEntry->GetSlotIndex());
+		shard.m_mapLock.unlock();
+	}
+
+	/// <summary>
+	/// Thread Safe.
+	/// Replaces the resource of a loaded entry with a newly loaded version, and advances
+	/// the entry's slot generation so handles pick up the new version.
+	/// </summary>
+	/// <param name="resourceID">- The resource ID to set the resource onto.</param>
+	/// <param name="pResource">- The new version of the resource.</param>
+	/// <param name="memorySize">- The bytes the new version counts against its cache budget.</param>
+	/// <param name="dependencies">- The dependencies the new version holds references to. Receives the ones the old version held, or is left alone if the entry is no longer loaded. Either way the caller releases what it ends up holding.</param>
+	/// <returns>
+	/// The resource the caller now owns: the old version if it was replaced, or pResource
+	/// if the entry is no longer loaded. Either way it should be passed to RetireResource().
+	/// </returns>
+	Resource* ResourceDatabase::SwapEntryResource(const ResourceID& resourceID, Resource* pResource, size_t memorySize, eastl::vector<ResourceID>& dependencies)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+		EXE_ASSERT(pResource);
+
+		Shard& shard = GetShard(resourceID);
+		shard.m_mapLock.lock();
+		ResourceEntry* pResourceEntry = FindEntry(shard, resourceID);
+		if (!pResourceEntry || pResourceEntry->GetStatus() != ResourceLoadStatus::kLoaded)
+		{
+			shard.m_mapLock.unlock();
+			return pResource;
+		}
+
+		Resource* pOldResource = pResourceEntry->GetResource();
+		pResourceEntry->SetResource(pResource);
+		pResourceEntry->SetCacheInfo(pResourceEntry->GetType(), memorySize);
+
+		eastl::vector<ResourceID> oldDependencies = pResourceEntry->TakeDependencies();
+		for (const ResourceID& dependencyID : dependencies)
+		{
+			pResourceEntry->AddDependency(dependencyID);
+		}
+		dependencies.swap(oldDependencies);
+		AdvanceSlotGeneration(pResourceEntry->GetSlotIndex());
+		shard.m_mapLock.unlock();
+
+		return pOldResource;
+	}
+
+	/// <summary>
+	/// Thread Safe.
+	/// Queues a resource no entry holds anymore to be unloaded and deleted
+	/// the next time the unload queue is processed.
+	/// </summary>
+	/// <param name="pResource">- The resource to destroy.</param>
+	void ResourceDatabase::RetireResource(Resource* pResource)
+	{
+		if (!pResource)
+			return;
+
+		m_unloaderLock.lock();
+		m_retiredResources.push_back(pResource);
+		m_unloaderLock.unlock();
 	}
 
 	/// <summary>
@@ -199,15 +373,42 @@ namespace Exelius
 	{
 		EXE_ASSERT(resourceID.IsValid());
 
-		m_mapLock.lock();
-		auto pResource = InternalGetEntryResource(resourceID);
+		Shard& shard = GetShard(resourceID);
+		shard.m_mapLock.lock();
+		auto pResource = InternalGetEntryResource(shard, resourceID);
 		if (!pResource)
 		{
-			m_mapLock.unlock();
+			shard.m_mapLock.unlock();
 			return nullptr;
 		}
 
-		m_mapLock.unlock();
+		shard.m_mapLock.unlock();
+		return pResource;
+	}
+
+	/// <summary>
+	/// Thread Safe.
+	/// Gets the resource from a resource entry if it exists, along with the slot
+	/// and generation that stay current for as long as that resource is.
+	/// </summary>
+	/// <param name="resourceID">- The resource ID to get a resource from.</param>
+	/// <param name="slotIndex">- Receives the entry's slot index.</param>
+	/// <param name="generation">- Receives the slot's current generation.</param>
+	/// <returns>The resource from the given ID, nullptr if it did not exist.</returns>
+	Resource* ResourceDatabase::GetEntryResource(const ResourceID& resourceID, uint32_t& slotIndex, uint32_t& generation)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+
+		Shard& shard = GetShard(resourceID);
+		std::lock_guard<std::mutex> lock(shard.m_mapLock);
+		Resource* pResource = InternalGetEntryResource(shard, resourceID);
+		if (!pResource)
+			return nullptr;
+
+		slotIndex = FindEntry(shard, resourceID)->GetSlotIndex();
+		if (slotIndex != s_kInvalidSlot)
+			generation = m_slotPages[slotIndex / s_kSlotsPerPage][slotIndex % s_kSlotsPerPage].load(std::memory_order_relaxed);
+
 		return pResource;
 	}
 
@@ -221,9 +422,10 @@ namespace Exelius
 	{
 		EXE_ASSERT(resourceID.IsValid());
 
-		m_mapLock.lock();
-		auto status = InternalGetLoadStatus(resourceID);
-		m_mapLock.unlock();
+		Shard& shard = GetShard(resourceID);
+		shard.m_mapLock.lock();
+		auto status = InternalGetLoadStatus(shard, resourceID);
+		shard.m_mapLock.unlock();
 		return status;
 	}
 
@@ -237,9 +439,10 @@ namespace Exelius
 	{
 		EXE_ASSERT(resourceID.IsValid());
 
-		m_mapLock.lock();
-		InternalSetLoadStatus(resourceID, newStatus);
-		m_mapLock.unlock();
+		Shard& shard = GetShard(resourceID);
+		shard.m_mapLock.lock();
+		InternalSetLoadStatus(shard, resourceID, newStatus);
+		shard.m_mapLock.unlock();
 	}
 
 	/// <summary>
@@ -252,20 +455,141 @@ namespace Exelius
 	{
 		EXE_ASSERT(resourceID.IsValid());
 
-		m_mapLock.lock();
-		if (IsFound(resourceID))
+		Shard& shard = GetShard(resourceID);
+		shard.m_mapLock.lock();
+		if (FindEntry(shard, resourceID))
 		{
-			m_mapLock.unlock();
+			shard.m_mapLock.unlock();
 			m_resourceDatabaseLog.Info("Resource Entry for {} already exists.", resourceID.Get().c_str());
 			return false;
 		}
 
-		m_resourceMap.try_emplace(resourceID);
-		m_mapLock.unlock();
+		shard.m_resourceMap.try_emplace(resourceID).first->second.SetSlotIndex(AllocateSlot());
+		shard.m_mapLock.unlock();
 
 		return true;
 	}
 
+	/// <summary>
+	/// Thread Safe.
+	/// Takes a reference to the entry with the given ID, creating it if it
+	/// doesn't exist, and claims the load if nobody else has. Only one caller
+	/// is ever told to load a given resource, so requests are deduplicated.
+	/// 
+	/// An entry that is unloading is left alone and no reference is taken.
+	/// Wait for it with WaitForEntryUnload(), then acquire it again.
+	/// </summary>
+	/// <param name="resourceID">- The resource to acquire.</param>
+	/// <returns>
+	/// The status of the entry before this call. ResourceLoadStatus::kInvalid means
+	/// the caller claimed the load: the entry is now kLoading and the caller must load it.
+	/// </returns>
+	ResourceLoadStatus ResourceDatabase::AcquireEntryForLoad(const ResourceID& resourceID)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+
+		Shard& shard = GetShard(resourceID);
+		std::lock_guard<std::mutex> lock(shard.m_mapLock);
+
+		// A new entry starts with the caller's reference.
+		auto [entryIterator, isNewEntry] = shard.m_resourceMap.try_emplace(resourceID);
+		ResourceEntry& resourceEntry = entryIterator->second;
+
+		if (isNewEntry)
+		{
+			resourceEntry.SetSlotIndex(AllocateSlot());
+			resourceEntry.SetStatus(ResourceLoadStatus::kLoading);
+			m_resourceCache.RecordMiss();
+			return ResourceLoadStatus::kInvalid;
+		}
+
+		const ResourceLoadStatus status = resourceEntry.GetStatus();
+		switch (status)
+		{
+			case ResourceLoadStatus::kLoading:
+			{
+				resourceEntry.IncrementRefCount();
+				return status;
+			}
+			case ResourceLoadStatus::kLoaded:
+			{
+				// Nothing else holds it, so it may be waiting in the cache.
+				if (!resourceEntry.IsHeld())
+					m_resourceCache.Remove(resourceID);
+
+				resourceEntry.IncrementRefCount();
+				return status;
+			}
+			case ResourceLoadStatus::kUnloading:
+			{
+				return status;
+			}
+			default:
+			{
+				// A failed load that hasn't been removed yet. Try again.
+				resourceEntry.IncrementRefCount();
+				resourceEntry.SetStatus(ResourceLoadStatus::kLoading);
+				m_resourceCache.RecordMiss();
+				return ResourceLoadStatus::kInvalid;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Thread Safe.
+	/// Blocks until the entry with the given ID is no longer unloading.
+	/// Returns right away if it isn't unloading. Must not be called while
+	/// holding anything the unloading thread may need.
+	/// </summary>
+	/// <param name="resourceID">- The resource to wait for.</param>
+	void ResourceDatabase::WaitForEntryUnload(const ResourceID& resourceID)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+
+		Shard& shard = GetShard(resourceID);
+		std::unique_lock<std::mutex> lock(shard.m_mapLock);
+		shard.m_unloadFinished.wait(lock, [this, &shard, &resourceID]()
+			{
+				const ResourceEntry* pResourceEntry = FindEntry(shard, resourceID);
+				return !pResourceEntry || pResourceEntry->GetStatus() != ResourceLoadStatus::kUnloading;
+			});
+	}
+
+	/// <summary>
+	/// Thread Safe.
+	/// Records that the entry with the given ID holds a reference to another
+	/// resource. The reference is released when the entry is unloaded.
+	/// </summary>
+	/// <param name="resourceID">- The ID of the dependent resource.</param>
+	/// <param name="dependencyID">- The ID of the resource it depends on.</param>
+	/// <returns>True if the dependency was recorded, false if it already was or the entry doesn't exist.</returns>
+	bool ResourceDatabase::AddEntryDependency(const ResourceID& resourceID, const ResourceID& dependencyID)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+		EXE_ASSERT(dependencyID.IsValid());
+
+		Shard& shard = GetShard(resourceID);
+		std::lock_guard<std::mutex> lock(shard.m_mapLock);
+		ResourceEntry* pResourceEntry = GetEntry(shard, resourceID);
+		return pResourceEntry && pResourceEntry->AddDependency(dependencyID);
+	}
+
+	/// <summary>
+	/// Thread Safe.
+	/// Checks if the entry with the given ID has any references or locks.
+	/// </summary>
+	/// <param name="resourceID">- The resource ID for the ResourceEntry to check.</param>
+	/// <returns>True if the entry exists and is held, false otherwise.</returns>
+	bool ResourceDatabase::IsEntryHeld(const ResourceID& resourceID)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+
+		Shard& shard = GetShard(resourceID);
+		std::lock_guard<std::mutex> lock(shard.m_mapLock);
+		ResourceEntry* pResourceEntry = FindEntry(shard, resourceID);
+		return pResourceEntry && pResourceEntry->IsHeld();
+	}
+
 	/// <summary>
 	/// Thread Safe.
 	/// Unloads a resource with the given ID.
@@ -289,44 +613,62 @@ namespace Exelius
 	}
 
 	/// <summary>
-	/// Non-Thread-Safe.
+	/// Gets the shard that holds the entry with the given ID. Interned IDs
+	/// are compared by address, so the address is hashed instead of the string.
+	/// </summary>
+	/// <param name="resourceID">- The resource ID to find the shard for.</param>
+	/// <returns>The shard for the given ID.</returns>
+	ResourceDatabase::Shard& ResourceDatabase::GetShard(const ResourceID& resourceID)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+
+		// The low bits of the address are always 0 because of alignment, so skip them.
+		const uintptr_t stringAddress = reinterpret_cast<uintptr_t>(&resourceID.Get());
+		return m_shards[(stringAddress / alignof(eastl::string)) % s_kShardCount];
+	}
+
+	/// <summary>
+	/// Non-Thread-Safe. The shard's lock must be held.
 	/// Gets the current load status of the resource entry with the given ID.
 	/// </summary>
+	/// <param name="shard">- The shard holding the entry.</param>
 	/// <param name="resourceID">- The resource ID for the ResourceEntry to check.</param>
 	/// <returns>The current load status of the resource entry. Returns ResourceLoadStatus::kInvalid if the ResourceEntry does not exist.</returns>
-	ResourceLoadStatus ResourceDatabase::InternalGetLoadStatus(const ResourceID& resourceID)
+	ResourceLoadStatus ResourceDatabase::InternalGetLoadStatus(Shard& shard, const ResourceID& resourceID)
 	{
-		if (IsFound(resourceID))
-		{
-			auto status = m_resourceMap.at(resourceID).GetStatus();
-			return status;
-		}
+		ResourceEntry* pResourceEntry = FindEntry(shard, resourceID);
+		if (pResourceEntry)
+			return pResourceEntry->GetStatus();
+
 		return ResourceLoadStatus::kInvalid;
 	}
 
 	/// <summary>
-	/// Non-Thread-Safe.
+	/// Non-Thread-Safe. The shard's lock must be held.
 	/// Sets the current load status of the resource entry with the given ID.
 	/// </summary>
+	/// <param name="shard">- The shard holding the entry.</param>
 	/// <param name="resourceID">- The resource ID for the ResourceEntry to set.</param>
 	/// <param name="newStatus">- The load status to set.</param>
-	void ResourceDatabase::InternalSetLoadStatus(const ResourceID& resourceID, ResourceLoadStatus newStatus)
+	void ResourceDatabase::InternalSetLoadStatus(Shard& shard, const ResourceID& resourceID, ResourceLoadStatus newStatus)
 	{
-		if (IsFound(resourceID))
-			m_resourceMap.at(resourceID).SetStatus(newStatus);
+		ResourceEntry* pResourceEntry = FindEntry(shard, resourceID);
+		if (pResourceEntry)
+			pResourceEntry->SetStatus(newStatus);
 	}
 
 	/// <summary>
-	/// Non-Thread-Safe.
+	/// Non-Thread-Safe. The shard's lock must be held.
 	/// Gets the resource from a resource entry if it exists.
 	/// </summary>
+	/// <param name="shard">- The shard holding the entry.</param>
 	/// <param name="resourceID">- The resource ID to get a resource from.</param>
 	/// <returns>The resource from the given ID, nullptr if it did not exist.</returns>
-	Resource* ResourceDatabase::InternalGetEntryResource(const ResourceID& resourceID)
+	Resource* ResourceDatabase::InternalGetEntryResource(Shard& shard, const ResourceID& resourceID)
 	{
 		EXE_ASSERT(resourceID.IsValid());
 
-		ResourceEntry* pResourceEntry = GetEntry(resourceID);
+		ResourceEntry* pResourceEntry = GetEntry(shard, resourceID);
 		if (!pResourceEntry)
 		{
 			m_resourceDatabaseLog.Warn("Unable to get Resource from ResourceEntry '{}'", resourceID.Get().c_str());
@@ -344,41 +686,102 @@ namespace Exelius
 	}
 
 	/// <summary>
-	/// Non-Thread-Safe.
-	/// Checks if a ResourceEntry with the given ID exists in the database.
+	/// Non-Thread-Safe. The shard's lock must be held.
+	/// Gets a resource entry with the given ID if it exists.
 	/// </summary>
-	/// <param name="resourceID">- The resource ID for the ResourceEntry to check.</param>
-	/// <returns>True if found, false otherwise.</returns>
-	bool ResourceDatabase::IsFound(const ResourceID& resourceID)
+	/// <param name="shard">- The shard holding the entry.</param>
+	/// <param name="resourceID">- The resource ID for the ResourceEntry to get.</param>
+	/// <returns>The resource entry with the given ID, nullptr if not found.</returns>
+	ResourceEntry* ResourceDatabase::FindEntry(Shard& shard, const ResourceID& resourceID)
 	{
 		EXE_ASSERT(resourceID.IsValid());
 
-		auto found = m_resourceMap.find(resourceID);
-		if (found == m_resourceMap.end())
-			return false;
+		auto found = shard.m_resourceMap.find(resourceID);
+		if (found == shard.m_resourceMap.end())
+			return nullptr;
 
-		return true;
+		return &found->second;
 	}
 
 	/// <summary>
-	/// Non-Thread-Safe.
-	/// Gets a resource entry with the given ID if it exists.
+	/// Non-Thread-Safe. The shard's lock must be held.
+	/// Gets a resource entry with the given ID if it exists, warning if it doesn't.
 	/// </summary>
+	/// <param name="shard">- The shard holding the entry.</param>
 	/// <param name="resourceID">- The resource ID for the ResourceEntry to get.</param>
 	/// <returns>The resource entry with the given ID, nullptr if not found.</returns>
-	ResourceEntry* ResourceDatabase::GetEntry(const ResourceID& resourceID)
+	ResourceEntry* ResourceDatabase::GetEntry(Shard& shard, const ResourceID& resourceID)
 	{
-		EXE_ASSERT(resourceID.IsValid());
-
-		if (IsFound(resourceID))
-			return &m_resourceMap.at(resourceID);
+		ResourceEntry* pResourceEntry = FindEntry(shard, resourceID);
+		if (pResourceEntry)
+			return pResourceEntry;
 
 		m_resourceDatabaseLog.Warn("Resource Entry '{}' does not exist in database.", resourceID.Get().c_str());
 		return nullptr;
 	}
 
 	/// <summary>
-	/// Non-Thread-Safe.
+	/// Thread Safe.
+	/// Hands out a free slot for a new entry, adding a page of slots if needed.
+	/// </summary>
+	/// <returns>The slot index, or s_kInvalidSlot if every slot is taken.</returns>
+	uint32_t ResourceDatabase::AllocateSlot()
+	{
+		std::lock_guard<std::mutex> lock(m_slotLock);
+
+		if (!m_freeSlots.empty())
+		{
+			const uint32_t slotIndex = m_freeSlots.back();
+			m_freeSlots.pop_back();
+			return slotIndex;
+		}
+
+		if (m_slotCount == s_kSlotsPerPage * s_kMaxSlotPages)
+		{
+			m_resourceDatabaseLog.Warn("Out of resource slots. Handles to new resources will not cache them.");
+			return s_kInvalidSlot;
+		}
+
+		// The first slot of a page allocates the page. Its generations start at 0.
+		const uint32_t slotIndex = m_slotCount++;
+		if (slotIndex % s_kSlotsPerPage == 0)
+			m_slotPages[slotIndex / s_kSlotsPerPage] = new std::atomic<uint32_t>[s_kSlotsPerPage]();
+
+		return slotIndex;
+	}
+
+	/// <summary>
+	/// Thread Safe.
+	/// Advances the generation of a slot, so handles stop trusting their cached resource.
+	/// </summary>
+	/// <param name="slotIndex">- The slot to advance.</param>
+	void ResourceDatabase::AdvanceSlotGeneration(uint32_t slotIndex)
+	{
+		if (slotIndex == s_kInvalidSlot)
+			return;
+
+		m_slotPages[slotIndex / s_kSlotsPerPage][slotIndex % s_kSlotsPerPage].fetch_add(1, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Thread Safe.
+	/// Advances the generation of a slot and puts it back on the free list.
+	/// </summary>
+	/// <param name="slotIndex">- The slot to free.</param>
+	void ResourceDatabase::FreeSlot(uint32_t slotIndex)
+	{
+		if (slotIndex == s_kInvalidSlot)
+			return;
+
+		AdvanceSlotGeneration(slotIndex);
+
+		m_slotLock.lock();
+		m_freeSlots.push_back(slotIndex);
+		m_slotLock.unlock();
+	}
+
+	/// <summary>
+	/// Non-Thread-Safe. Every shard's lock must be held.
 	/// Unloads all the resources in the resource database.
 	/// </summary>
 	void ResourceDatabase::UnloadAll()
@@ -390,19 +793,32 @@ namespace Exelius
 			m_resourceDatabaseLog.Trace("The unloading queue was not empty and should be.");
 		}
 
-		for (auto& resourcePair : m_resourceMap)
+		for (auto& shard : m_shards)
 		{
-			m_resourceDatabaseLog.Trace("Unloading Resource: {}", resourcePair.first.Get().c_str());
-			Resource* pResource = resourcePair.second.GetResource();
-			resourcePair.second.SetStatus(ResourceLoadStatus::kUnloading);
-			if (pResource)
+			for (auto& resourcePair : shard.m_resourceMap)
 			{
-				pResource->Unload();
-				resourcePair.second.SetStatus(ResourceLoadStatus::kUnloaded);
+				m_resourceDatabaseLog.Trace("Unloading Resource: {}", resourcePair.first.Get().c_str());
+				Resource* pResource = resourcePair.second.GetResource();
+				resourcePair.second.SetStatus(ResourceLoadStatus::kUnloading);
+				if (pResource)
+				{
+					pResource->Unload();
+					resourcePair.second.SetStatus(ResourceLoadStatus::kUnloaded);
+				}
 			}
+
+			shard.m_resourceMap.clear();
+			shard.m_unloadFinished.notify_all();
 		}
 
-		m_resourceMap.clear();
+		m_resourceCache.Clear();
+
+		for (Resource* pResource : m_retiredResources)
+		{
+			pResource->Unload();
+			delete pResource;
+		}
+		m_retiredResources.clear();
 
 		m_resourceDatabaseLog.Info("Completed Unload All Resources.");
 	}
@@ -1,11 +1,15 @@
 #pragma once
 #include "source/resource/ResourceHelpers.h"
 #include "source/resource/ResourceEntry.h"
+#include "source/resource/ResourceCache.h"
 #include "source/debug/Log.h"
 
+#include <EASTL/array.h>
 #include <EASTL/unordered_map.h>
 #include <EASTL/vector.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 
 /// <summary>
@@ -21,13 +25,81 @@ namespace Exelius
 	/// These interactions between the resource manager and the database should
 	/// be thread safe, as the manipulation of the resource entries happens on
 	/// nearly all threads.
+	/// 
+	/// The entries are split across shards by resource ID, each with its own map
+	/// and lock, so threads working on different resources rarely wait on each
+	/// other. Handles that already hold their resource don't touch the shards at
+	/// all. They only check the entry's slot. @see IsSlotCurrent
+	/// 
+	/// Entries that are released by everyone stay loaded in the cache while their
+	/// type is within its budget, and are only unloaded once evicted. @see ResourceCache
 	/// </summary>
 	class ResourceDatabase
 	{
+	public:
+		/// <summary>
+		/// The slot index given to an entry when every slot is taken.
+		/// It is never current, so handles to that entry always look it up.
+		/// </summary>
+		static constexpr uint32_t s_kInvalidSlot = UINT32_MAX;
+
+	private:
+		static constexpr uint32_t s_kSlotsPerPage = 1024;
+		static constexpr uint32_t s_kMaxSlotPages = 256;
+		static constexpr size_t s_kShardCount = 16;
+
+		/// <summary>
+		/// A share of the resource entries, guarded by its own lock.
+		/// </summary>
+		struct Shard
+		{
+			/// <summary>
+			/// The map of the resource entries keyed by the resource ID.
+			/// </summary>
+			eastl::unordered_map<ResourceID, ResourceEntry> m_resourceMap;
+
+			/// <summary>
+			/// The mutex that guards the map from data race conditions.
+			/// </summary>
+			std::mutex m_mapLock;
+
+			/// <summary>
+			/// Signaled whenever an entry in this shard finishes unloading. @see WaitForEntryUnload
+			/// </summary>
+			std::condition_variable m_unloadFinished;
+		};
+
+		/// <summary>
+		/// The shards holding the resource entries. @see GetShard
+		/// </summary>
+		eastl::array<Shard, s_kShardCount> m_shards;
+
+		/// <summary>
+		/// Every entry owns a slot holding a generation count. The generation changes
+		/// whenever the entry's resource is set, and when the entry is unloaded and
+		/// the slot is freed. ResourceHandle caches the resource pointer along with the
+		/// slot and generation, and only needs to check the generation to trust it.
+		/// 
+		/// The slots are allocated a page at a time and never move, so they can be read
+		/// without any lock. Pages are only added under the slot lock.
+		/// </summary>
+		eastl::array<std::atomic<uint32_t>*, s_kMaxSlotPages> m_slotPages;
+
+		/// <summary>
+		/// The number of slots that have ever been handed out. Guarded by the slot lock.
+		/// </summary>
+		uint32_t m_slotCount;
+
+		/// <summary>
+		/// Slots freed by unloaded entries, to be handed out again. Guarded by the slot lock.
+		/// </summary>
+		eastl::vector<uint32_t> m_freeSlots;
+
 		/// <summary>
-		/// The map of the resource entries keyed by the resource ID.
+		/// The mutex that guards handing out and freeing slots. It is only
+		/// taken when entries are created or removed, and always after a shard's lock.
 		/// </summary>
-		eastl::unordered_map<ResourceID, ResourceEntry> m_resourceMap;
+		std::mutex m_slotLock;
 
 		/// <summary>
 		/// Queue of resources to be unloaded.
@@ -38,14 +110,20 @@ namespace Exelius
 		eastl::vector<ResourceID> m_unloadQueue;
 
 		/// <summary>
-		/// The mutex that guards the map from data race conditions.
+		/// The mutex that guards the unload queue from data race conditions.
 		/// </summary>
-		std::mutex m_mapLock;
+		std::mutex m_unloaderLock;
 
 		/// <summary>
-		/// The mutex that guards the unload queue from data race conditions.
+		/// Resources replaced by a reload, destroyed along with the unload queue so
+		/// nothing still using them this frame is left dangling. Guarded by the unloader lock.
 		/// </summary>
-		std::mutex m_unloaderLock;
+		eastl::vector<Resource*> m_retiredResources;
+
+		/// <summary>
+		/// The loaded entries that nothing holds, kept until their type goes over its budget.
+		/// </summary>
+		ResourceCache m_resourceCache;
 
 		/// <summary>
 		/// ResourceDatabase Log.
@@ -103,13 +181,47 @@ namespace Exelius
 		/// <returns>True if the ref count + lock count == 0, otherwise false.</returns>
 		bool DecrementEntryLockCount(const ResourceID& resourceID);
 
+		/// <summary>
+		/// Thread Safe.
+		/// Caches the entry with the given ID if nothing holds it and its type has room,
+		/// evicting the least recently released entries of that type as needed.
+		/// Otherwise the entry is queued to unload, as are any evicted entries.
+		/// </summary>
+		/// <param name="resourceID">- The ID of the resource that was released.</param>
+		void ReleaseEntry(const ResourceID& resourceID);
+
 		/// <summary>
 		/// Thread Safe.
 		/// Sets the given resource onto the resource entry.
 		/// </summary>
 		/// <param name="resourceID">- The resource ID to set the resource onto.</param>
 		/// <param name="pResource">- The resource to set.</param>
-		void SetEntryResource(const ResourceID& resourceID, Resource* pResource);
+		/// <param name="type">- The type of the resource, which picks its cache budget.</param>
+		/// <param name="memorySize">- The bytes the resource counts against its cache budget.</param>
+		void SetEntryResource(const ResourceID& resourceID, Resource* pResource, ResourceType::Type type, size_t memorySize);
+
+		/// <summary>
+		/// Thread Safe.
+		/// Replaces the resource of a loaded entry with a newly loaded version, and advances
+		/// the entry's slot generation so handles pick up the new version.
+		/// </summary>
+		/// <param name="resourceID">- The resource ID to set the resource onto.</param>
+		/// <param name="pResource">- The new version of the resource.</param>
+		/// <param name="memorySize">- The bytes the new version counts against its cache budget.</param>
+		/// <param name="dependencies">- The dependencies the new version holds references to. Receives the ones the old version held, or is left alone if the entry is no longer loaded. Either way the caller releases what it ends up holding.</param>
+		/// <returns>
+		/// The resource the caller now owns: the old version if it was replaced, or pResource
+		/// if the entry is no longer loaded. Either way it should be passed to RetireResource().
+		/// </returns>
+		Resource* SwapEntryResource(const ResourceID& resourceID, Resource* pResource, size_t memorySize, eastl::vector<ResourceID>& dependencies);
+
+		/// <summary>
+		/// Thread Safe.
+		/// Queues a resource no entry holds anymore to be unloaded and deleted
+		/// the next time the unload queue is processed.
+		/// </summary>
+		/// <param name="pResource">- The resource to destroy.</param>
+		void RetireResource(Resource* pResource);
 
 		/// <summary>
 		/// Thread Safe.
@@ -119,6 +231,34 @@ namespace Exelius
 		/// <returns>The resource from the given ID, nullptr if it did not exist.</returns>
 		Resource* GetEntryResource(const ResourceID& resourceID);
 
+		/// <summary>
+		/// Thread Safe.
+		/// Gets the resource from a resource entry if it exists, along with the slot
+		/// and generation that stay current for as long as that resource is.
+		/// </summary>
+		/// <param name="resourceID">- The resource ID to get a resource from.</param>
+		/// <param name="slotIndex">- Receives the entry's slot index.</param>
+		/// <param name="generation">- Receives the slot's current generation.</param>
+		/// <returns>The resource from the given ID, nullptr if it did not exist.</returns>
+		Resource* GetEntryResource(const ResourceID& resourceID, uint32_t& slotIndex, uint32_t& generation);
+
+		/// <summary>
+		/// Lock Free.
+		/// Checks if a slot is still at the given generation, meaning the resource
+		/// read along with it is still the entry's resource.
+		/// </summary>
+		/// <param name="slotIndex">- The slot to check.</param>
+		/// <param name="generation">- The generation read with the resource.</param>
+		/// <returns>True if the generation has not changed, false otherwise.</returns>
+		bool IsSlotCurrent(uint32_t slotIndex, uint32_t generation) const
+		{
+			if (slotIndex == s_kInvalidSlot)
+				return false;
+
+			EXE_ASSERT(m_slotPages[slotIndex / s_kSlotsPerPage]);
+			return m_slotPages[slotIndex / s_kSlotsPerPage][slotIndex % s_kSlotsPerPage].load(std::memory_order_acquire) == generation;
+		}
+
 		/// <summary>
 		/// Thread Safe.
 		/// Gets the current load status of the resource entry with the given ID.
@@ -143,6 +283,49 @@ namespace Exelius
 		/// <returns>True if the ResourceEntry was created, false if it already existed.</returns>
 		bool CreateEntry(const ResourceID& resourceID);
 
+		/// <summary>
+		/// Thread Safe.
+		/// Takes a reference to the entry with the given ID, creating it if it
+		/// doesn't exist, and claims the load if nobody else has. Only one caller
+		/// is ever told to load a given resource, so requests are deduplicated.
+		/// 
+		/// An entry that is unloading is left alone and no reference is taken.
+		/// Wait for it with WaitForEntryUnload(), then acquire it again.
+		/// </summary>
+		/// <param name="resourceID">- The resource to acquire.</param>
+		/// <returns>
+		/// The status of the entry before this call. ResourceLoadStatus::kInvalid means
+		/// the caller claimed the load: the entry is now kLoading and the caller must load it.
+		/// </returns>
+		ResourceLoadStatus AcquireEntryForLoad(const ResourceID& resourceID);
+
+		/// <summary>
+		/// Thread Safe.
+		/// Blocks until the entry with the given ID is no longer unloading.
+		/// Returns right away if it isn't unloading. Must not be called while
+		/// holding anything the unloading thread may need.
+		/// </summary>
+		/// <param name="resourceID">- The resource to wait for.</param>
+		void WaitForEntryUnload(const ResourceID& resourceID);
+
+		/// <summary>
+		/// Thread Safe.
+		/// Records that the entry with the given ID holds a reference to another
+		/// resource. The reference is released when the entry is unloaded.
+		/// </summary>
+		/// <param name="resourceID">- The ID of the dependent resource.</param>
+		/// <param name="dependencyID">- The ID of the resource it depends on.</param>
+		/// <returns>True if the dependency was recorded, false if it already was or the entry doesn't exist.</returns>
+		bool AddEntryDependency(const ResourceID& resourceID, const ResourceID& dependencyID);
+
+		/// <summary>
+		/// Thread Safe.
+		/// Checks if the entry with the given ID has any references or locks.
+		/// </summary>
+		/// <param name="resourceID">- The resource ID for the ResourceEntry to check.</param>
+		/// <returns>True if the entry exists and is held, false otherwise.</returns>
+		bool IsEntryHeld(const ResourceID& resourceID);
+
 		/// <summary>
 		/// Thread Safe.
 		/// Unloads a resource with the given ID.
@@ -150,6 +333,21 @@ namespace Exelius
 		/// <param name="resourceID">- The resource to unload.</param>
 		void UnloadEntry(const ResourceID& resourceID);
 
+		/// <summary>
+		/// Thread Safe.
+		/// Sets how many bytes of released resources each type may keep loaded.
+		/// </summary>
+		/// <param name="defaultBudget">- The budget of each type not in typeBudgets. 0 unloads them as soon as they are released.</param>
+		/// <param name="typeBudgets">- The budgets of specific types, keyed by type.</param>
+		void SetCacheBudgets(size_t defaultBudget, const eastl::unordered_map<ResourceType::Type, size_t>& typeBudgets) { m_resourceCache.SetBudgets(defaultBudget, typeBudgets); }
+
+		/// <summary>
+		/// Thread Safe.
+		/// Takes a snapshot of the cache's counters.
+		/// </summary>
+		/// <returns>The current cache stats.</returns>
+		ResourceCacheStats GetCacheStats() const { return m_resourceCache.GetStats(); }
+
 	private:
 		/// <summary>
 		/// Deallocate any resourced currently in the unload queue.
@@ -157,50 +355,85 @@ namespace Exelius
 		/// Resources can unload more resources, so this acts as a
 		/// double buffered queue.
 		/// </summary>
-		void InternalProcessUnloadQueue();
+		/// <returns>True if anything was queued, false if the queue was empty.</returns>
+		bool InternalProcessUnloadQueue();
 
 		/// <summary>
-		/// Non-Thread-Safe.
+		/// Gets the shard that holds the entry with the given ID. Interned IDs
+		/// are compared by address, so the address is hashed instead of the string.
+		/// </summary>
+		/// <param name="resourceID">- The resource ID to find the shard for.</param>
+		/// <returns>The shard for the given ID.</returns>
+		Shard& GetShard(const ResourceID& resourceID);
+
+		/// <summary>
+		/// Non-Thread-Safe. The shard's lock must be held.
 		/// Gets the current load status of the resource entry with the given ID.
 		/// </summary>
+		/// <param name="shard">- The shard holding the entry.</param>
 		/// <param name="resourceID">- The resource ID for the ResourceEntry to check.</param>
 		/// <returns>The current load status of the resource entry. Returns ResourceLoadStatus::kInvalid if the ResourceEntry does not exist.</returns>
-		ResourceLoadStatus InternalGetLoadStatus(const ResourceID& resourceID);
+		ResourceLoadStatus InternalGetLoadStatus(Shard& shard, const ResourceID& resourceID);
 
 		/// <summary>
-		/// Non-Thread-Safe.
+		/// Non-Thread-Safe. The shard's lock must be held.
 		/// Sets the current load status of the resource entry with the given ID.
 		/// </summary>
+		/// <param name="shard">- The shard holding the entry.</param>
 		/// <param name="resourceID">- The resource ID for the ResourceEntry to set.</param>
 		/// <param name="newStatus">- The load status to set.</param>
-		void InternalSetLoadStatus(const ResourceID& resourceID, ResourceLoadStatus newStatus);
+		void InternalSetLoadStatus(Shard& shard, const ResourceID& resourceID, ResourceLoadStatus newStatus);
 
 		/// <summary>
-		/// Non-Thread-Safe.
+		/// Non-Thread-Safe. The shard's lock must be held.
 		/// Gets the resource from a resource entry if it exists.
 		/// </summary>
+		/// <param name="shard">- The shard holding the entry.</param>
 		/// <param name="resourceID">- The resource ID to get a resource from.</param>
 		/// <returns>The resource from the given ID, nullptr if it did not exist.</returns>
-		Resource* InternalGetEntryResource(const ResourceID& resourceID);
+		Resource* InternalGetEntryResource(Shard& shard, const ResourceID& resourceID);
 
 		/// <summary>
-		/// Non-Thread-Safe.
-		/// Checks if a ResourceEntry with the given ID exists in the database.
+		/// Non-Thread-Safe. The shard's lock must be held.
+		/// Gets a resource entry with the given ID if it exists.
 		/// </summary>
-		/// <param name="resourceID">- The resource ID for the ResourceEntry to check.</param>
-		/// <returns>True if found, false otherwise.</returns>
-		bool IsFound(const ResourceID& resourceID);
+		/// <param name="shard">- The shard holding the entry.</param>
+		/// <param name="resourceID">- The resource ID for the ResourceEntry to get.</param>
+		/// <returns>The resource entry with the given ID, nullptr if not found.</returns>
+		ResourceEntry* FindEntry(Shard& shard, const ResourceID& resourceID);
 
 		/// <summary>
-		/// Non-Thread-Safe.
-		/// Gets a resource entry with the given ID if it exists.
+		/// Non-Thread-Safe. The shard's lock must be held.
+		/// Gets a resource entry with the given ID if it exists, warning if it doesn't.
 		/// </summary>
+		/// <param name="shard">- The shard holding the entry.</param>
 		/// <param name="resourceID">- The resource ID for the ResourceEntry to get.</param>
 		/// <returns>The resource entry with the given ID, nullptr if not found.</returns>
-		ResourceEntry* GetEntry(const ResourceID& resourceID);
+		ResourceEntry* GetEntry(Shard& shard, const ResourceID& resourceID);
+
+		/// <summary>
+		/// Thread Safe.
+		/// Hands out a free slot for a new entry, adding a page of slots if needed.
+		/// </summary>
+		/// <returns>The slot index, or s_kInvalidSlot if every slot is taken.</returns>
+		uint32_t AllocateSlot();
+
+		/// <summary>
+		/// Thread Safe.
+		/// Advances the generation of a slot, so handles stop trusting their cached resource.
+		/// </summary>
+		/// <param name="slotIndex">- The slot to advance.</param>
+		void AdvanceSlotGeneration(uint32_t slotIndex);
+
+		/// <summary>
+		/// Thread Safe.
+		/// Advances the generation of a slot and puts it back on the free list.
+		/// </summary>
+		/// <param name="slotIndex">- The slot to free.</param>
+		void FreeSlot(uint32_t slotIndex);
 
 		/// <summary>
-		/// Non-Thread-Safe.
+		/// Non-Thread-Safe. Every shard's lock must be held.
 		/// Unloads all the resources in the resource database.
 		/// </summary>
 		void UnloadAll();
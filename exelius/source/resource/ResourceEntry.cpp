@@ -3,6 +3,8 @@
 #include "source/resource/ResourceEntry.h"
 #include "source/resource/Resource.h"
 
+#include <EASTL/algorithm.h>
+
 /// <summary>
 /// Engine namespace. Everything owned by the engine will be inside this namespace.
 /// </summary>
@@ -19,6 +21,9 @@ namespace Exelius
 		, m_status(ResourceLoadStatus::kInvalid)
 		, m_refCount(1)
 		, m_lockCount(0)
+		, m_slotIndex(0)
+		, m_type(ResourceType::kInvalid)
+		, m_memorySize(0)
 		, m_resourceDatabaseLog("ResourceDatabase")
 	{
 		//
@@ -175,6 +180,22 @@ namespace Exelius
 		m_status = status;
 	}
 
+	/// <summary>
+	/// Records a dependency this entry holds a reference to.
+	/// </summary>
+	/// <param name="dependencyID">- The resource depended on.</param>
+	/// <returns>True if it was added, false if it was already a dependency.</returns>
+	bool ResourceEntry::AddDependency(const ResourceID& dependencyID)
+	{
+		EXE_ASSERT(dependencyID.IsValid());
+
+		if (eastl::find(m_dependencies.begin(), m_dependencies.end(), dependencyID) != m_dependencies.end())
+			return false;
+
+		m_dependencies.emplace_back(dependencyID);
+		return true;
+	}
+
 	/// <summary>
 	/// Check if this entry is referenced or locked.
 	/// </summary>
@@ -2,6 +2,8 @@
 #include "source/resource/ResourceHelpers.h"
 #include "source/debug/Log.h"
 
+#include <EASTL/vector.h>
+
 /// <summary>
 /// Engine namespace. Everything owned by the engine will be inside this namespace.
 /// </summary>
@@ -38,6 +40,26 @@ namespace Exelius
 		/// </summary>
 		int m_lockCount;
 
+		/// <summary>
+		/// The index of the slot in the ResourceDatabase that publishes this entry's resource.
+		/// </summary>
+		uint32_t m_slotIndex;
+
+		/// <summary>
+		/// The type of the resource, which picks the cache budget it counts against.
+		/// </summary>
+		ResourceType::Type m_type;
+
+		/// <summary>
+		/// The bytes the resource counts against its type's cache budget.
+		/// </summary>
+		size_t m_memorySize;
+
+		/// <summary>
+		/// The resources this entry holds a reference to, released when it is unloaded.
+		/// </summary>
+		eastl::vector<ResourceID> m_dependencies;
+
 		/// <summary>
 		/// ResourceDatabase Log.
 		/// </summary>
@@ -117,6 +139,12 @@ namespace Exelius
 		/// <returns>True if there are locks, false otherwise.</returns>
 		bool IsLocked() const { return m_lockCount > 0; }
 
+		/// <summary>
+		/// Check to see if this entry has any references or locks.
+		/// </summary>
+		/// <returns>True if referenced or locked, false otherwise.</returns>
+		bool IsHeld() const { return m_refCount + m_lockCount > 0; }
+
 		/// <summary>
 		/// Get the current loading status of this resource.
 		/// </summary>
@@ -131,6 +159,32 @@ namespace Exelius
 		/// <param name="status">- The status to set on this entry.</param>
 		void SetStatus(ResourceLoadStatus status);
 
+		uint32_t GetSlotIndex() const { return m_slotIndex; }
+		void SetSlotIndex(uint32_t slotIndex) { m_slotIndex = slotIndex; }
+
+		ResourceType::Type GetType() const { return m_type; }
+		size_t GetMemorySize() const { return m_memorySize; }
+
+		/// <summary>
+		/// Sets what the resource counts against the cache.
+		/// </summary>
+		/// <param name="type">- The type of the resource.</param>
+		/// <param name="memorySize">- The bytes the resource keeps in memory.</param>
+		void SetCacheInfo(ResourceType::Type type, size_t memorySize) { m_type = type; m_memorySize = memorySize; }
+
+		/// <summary>
+		/// Records a dependency this entry holds a reference to.
+		/// </summary>
+		/// <param name="dependencyID">- The resource depended on.</param>
+		/// <returns>True if it was added, false if it was already a dependency.</returns>
+		bool AddDependency(const ResourceID& dependencyID);
+
+		/// <summary>
+		/// Takes the dependencies out of this entry, so their references can be released.
+		/// </summary>
+		/// <returns>The dependencies that were held.</returns>
+		eastl::vector<ResourceID> TakeDependencies() { return eastl::move(m_dependencies); }
+
 	private:
 		/// <summary>
 		/// Check if this entry is referenced or locked.
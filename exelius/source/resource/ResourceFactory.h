@@ -57,11 +57,11 @@ namespace Exelius
 		/// <returns>The created resource on success, or nullptr otherwise.</returns>
 		virtual Resource* CreateResource(const ResourceID& resourceID) = 0;
 
-	protected:
 		/// <summary>
 		/// A function that can be called from within the CreateResource
 		/// function. It is used to convert the ResourceID to a ResourceType
-		/// as necessary.
+		/// as necessary. The resource loader also uses it to pick the
+		/// cache budget a resource counts against.
 		/// </summary>
 		/// <param name="resourceID"></param>
 		/// <returns></returns>
@@ -14,7 +14,10 @@ namespace Exelius
 	/// This needs to be done manually.
 	/// </summary>
 	ResourceHandle::ResourceHandle()
-		: m_resourceHeld(false)
+		: m_pResource(nullptr)
+		, m_slotIndex(0)
+		, m_slotGeneration(0)
+		, m_resourceHeld(false)
 	{
 		//
 	}
@@ -34,16 +37,90 @@ namespace Exelius
 	/// <param name="loadResource">- If the resource should be loaded. Default is false.</param>
 	ResourceHandle::ResourceHandle(const ResourceID& resourceID, bool loadResource)
 		: m_resourceID(resourceID)
+		, m_pResource(nullptr)
+		, m_slotIndex(0)
+		, m_slotGeneration(0)
 		, m_resourceHeld(false)
-		, m_resourceLoaderLog("ResourceLoader")
 	{
 		// Check if the resource is already loaded.
 		if (!TryToAcquireResource() && loadResource)
 		{
-			ResourceLoader::GetInstance()->LoadNow(resourceID);
+			// Loading takes the reference for us.
+			m_resourceHeld = ResourceLoader::GetInstance()->LoadNow(resourceID);
+		}
+	}
+
+	/// <summary>
+	/// Copies refer to the same ID. If the other handle holds a reference,
+	/// the copy takes a reference of its own.
+	/// </summary>
+	ResourceHandle::ResourceHandle(const ResourceHandle& other)
+		: m_resourceID(other.m_resourceID)
+		, m_pResource(other.m_pResource)
+		, m_slotIndex(other.m_slotIndex)
+		, m_slotGeneration(other.m_slotGeneration)
+		, m_resourceHeld(false)
+	{
+		if (other.m_resourceHeld)
+		{
+			ResourceLoader::GetInstance()->AcquireResource(m_resourceID);
+			m_resourceHeld = true;
 		}
 	}
 
+	/// <summary>
+	/// Moving a handle hands its reference over, without touching the resource.
+	/// </summary>
+	ResourceHandle::ResourceHandle(ResourceHandle&& other) noexcept
+		: m_resourceID(other.m_resourceID)
+		, m_pResource(other.m_pResource)
+		, m_slotIndex(other.m_slotIndex)
+		, m_slotGeneration(other.m_slotGeneration)
+		, m_resourceHeld(other.m_resourceHeld)
+	{
+		other.m_pResource = nullptr;
+		other.m_resourceHeld = false;
+	}
+
+	ResourceHandle& ResourceHandle::operator=(const ResourceHandle& other)
+	{
+		if (this == &other)
+			return *this;
+
+		Release();
+
+		m_resourceID = other.m_resourceID;
+		m_pResource = other.m_pResource;
+		m_slotIndex = other.m_slotIndex;
+		m_slotGeneration = other.m_slotGeneration;
+
+		if (other.m_resourceHeld)
+		{
+			ResourceLoader::GetInstance()->AcquireResource(m_resourceID);
+			m_resourceHeld = true;
+		}
+
+		return *this;
+	}
+
+	ResourceHandle& ResourceHandle::operator=(ResourceHandle&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		Release();
+
+		m_resourceID = other.m_resourceID;
+		m_pResource = other.m_pResource;
+		m_slotIndex = other.m_slotIndex;
+		m_slotGeneration = other.m_slotGeneration;
+		m_resourceHeld = other.m_resourceHeld;
+
+		other.m_pResource = nullptr;
+		other.m_resourceHeld = false;
+		return *this;
+	}
+
 	/// <summary>
 	/// Destroying the ResourceHandle will automatically release the
 	/// resource if it has not already been done manually.
@@ -61,6 +138,12 @@ namespace Exelius
 	/// <returns>The resource with the ID held by this ResourceHandle, or nullptr if the resource could not be retrieved.</returns>
 	Resource* ResourceHandle::Get(bool forceLoad)
 	{
+		// The cached resource is still the entry's resource, so there is nothing to look up.
+		if (m_pResource && ResourceLoader::GetInstance()->IsResourceSlotCurrent(m_slotIndex, m_slotGeneration))
+			return m_pResource;
+
+		m_pResource = nullptr;
+
 		if (!m_resourceHeld)
 		{
 			TryToAcquireResource();
@@ -69,11 +152,15 @@ namespace Exelius
 		if (!m_resourceID.IsValid())
 			return nullptr;
 
-		Resource* pResource = ResourceLoader::GetInstance()->GetResource(m_resourceID, forceLoad);
+		Resource* pResource = ResourceLoader::GetInstance()->GetResource(m_resourceID, forceLoad, m_slotIndex, m_slotGeneration);
 
 		if (pResource && !m_resourceHeld)
 			m_resourceHeld = true; // Prevents double acquisition.
 
+		// Only cache a resource we hold, as nothing else stops it from being unloaded.
+		if (m_resourceHeld)
+			m_pResource = pResource;
+
 		return pResource;
 	}
 
@@ -88,13 +175,15 @@ namespace Exelius
 	{
 		if (m_resourceHeld)
 		{
-			m_resourceLoaderLog.Info("Resource with id '{}' cannot be loaded, this ResourceHandle already holds a resource.", m_resourceID.Get().c_str());
+			Log log("ResourceLoader");
+			log.Info("Resource with id '{}' cannot be loaded, this ResourceHandle already holds a resource.", m_resourceID.Get().c_str());
 			return;
 		}
 
 		if (!m_resourceID.IsValid())
 		{
-			m_resourceLoaderLog.Info("Resource cannot be Queued for load, resource ID is invalid or not set.");
+			Log log("ResourceLoader");
+			log.Info("Resource cannot be Queued for load, resource ID is invalid or not set.");
 			return;
 		}
 
@@ -104,8 +193,7 @@ namespace Exelius
 				return; // Return because we don't need to load.
 		}
 
-		ResourceLoader::GetInstance()->QueueLoad(m_resourceID, signalLoaderThread, pListener);
-		m_resourceHeld = true;
+		m_resourceHeld = ResourceLoader::GetInstance()->QueueLoad(m_resourceID, signalLoaderThread, pListener);
 	}
 
 	/// <summary>
@@ -118,13 +206,15 @@ namespace Exelius
 	{
 		if (m_resourceHeld)
 		{
-			m_resourceLoaderLog.Info("Resource with id '{}' cannot be loaded, this ResourceHandle already holds a resource.", m_resourceID.Get().c_str());
+			Log log("ResourceLoader");
+			log.Info("Resource with id '{}' cannot be loaded, this ResourceHandle already holds a resource.", m_resourceID.Get().c_str());
 			return;
 		}
 
 		if (!m_resourceID.IsValid())
 		{
-			m_resourceLoaderLog.Info("Resource cannot be loaded, resource ID is invalid or not set.");
+			Log log("ResourceLoader");
+			log.Info("Resource cannot be loaded, resource ID is invalid or not set.");
 			return;
 		}
 
@@ -134,8 +224,7 @@ namespace Exelius
 				return; // Return because we don't need to load.
 		}
 
-		ResourceLoader::GetInstance()->LoadNow(m_resourceID);
-		m_resourceHeld = true;
+		m_resourceHeld = ResourceLoader::GetInstance()->LoadNow(m_resourceID);
 	}
 
 	/// <summary>
@@ -153,6 +242,7 @@ namespace Exelius
 
 		ResourceLoader::GetInstance()->ReleaseResource(m_resourceID);
 		m_resourceHeld = false;
+		m_pResource = nullptr;
 	}
 
 	/// <summary>
@@ -211,7 +301,8 @@ namespace Exelius
 	{
 		if (m_resourceHeld)
 		{
-			m_resourceLoaderLog.Info("Resource with id '{}' cannot be acquired, this ResourceHandle already holds a resource.", m_resourceID.Get().c_str());
+			Log log("ResourceLoader");
+			log.Info("Resource with id '{}' cannot be acquired, this ResourceHandle already holds a resource.", m_resourceID.Get().c_str());
 			return false;
 		}
 
@@ -222,7 +313,8 @@ namespace Exelius
 
 		if (!ResourceLoader::GetInstance()->IsResourceAcquirable(m_resourceID))
 		{
-			m_resourceLoaderLog.Trace("Resource cannot be acquired, resource not available.");
+			Log log("ResourceLoader");
+			log.Trace("Resource cannot be acquired, resource not available.");
 			return false;
 		}
 
@@ -1,6 +1,5 @@
 #pragma once
 #include "source/resource/ResourceHelpers.h"
-#include "source/debug/Log.h"
 
 /// <summary>
 /// Engine namespace. Everything owned by the engine will be inside this namespace.
@@ -15,6 +14,11 @@ namespace Exelius
 	/// ResourceHandle acts as the interface for acquiring and manipulating resources.
 	/// Resources are volatile and may not exist at any one point of execution. So,
 	/// the use of this handle class is a requirement.
+	/// 
+	/// Once a held resource has been retrieved, the handle caches it along with
+	/// the generation of its slot in the ResourceDatabase. Later calls to Get only
+	/// check that generation, which changes if the resource is reloaded or unloaded,
+	/// so a handle kept around between frames costs no locks or lookups.
 	/// </summary>
 	class ResourceHandle
 	{
@@ -23,6 +27,22 @@ namespace Exelius
 		/// </summary>
 		ResourceID m_resourceID;
 
+		/// <summary>
+		/// The resource last retrieved while held, or nullptr.
+		/// Only trusted while its slot is still at m_slotGeneration.
+		/// </summary>
+		Resource* m_pResource;
+
+		/// <summary>
+		/// The slot of the cached resource's entry in the ResourceDatabase.
+		/// </summary>
+		uint32_t m_slotIndex;
+
+		/// <summary>
+		/// The generation of the slot when the resource was cached.
+		/// </summary>
+		uint32_t m_slotGeneration;
+
 		/// <summary>
 		/// Does this resource handle currently "refer" to a resource.
 		/// By refer, it is meant to say "Has this handle incremented
@@ -30,10 +50,6 @@ namespace Exelius
 		/// </summary>
 		bool m_resourceHeld;
 
-		/// <summary>
-		/// ResourceLoader Log.
-		/// </summary>
-		Log m_resourceLoaderLog;
 	public:
 		/// <summary>
 		/// Default construct a resource handle. The default construction
@@ -56,10 +72,19 @@ namespace Exelius
 		/// <param name="resourceID">- The resource ID the handle is meant to refer to.</param>
 		/// <param name="loadResource">- If the resource should be loaded. Default is false.</param>
 		ResourceHandle(const ResourceID& resourceID, bool loadResource = false);
-		ResourceHandle(const ResourceHandle&) = default;
-		ResourceHandle(ResourceHandle&&) = delete;
-		ResourceHandle& operator=(const ResourceHandle&) = default;
-		ResourceHandle& operator=(ResourceHandle&&) = delete;
+
+		/// <summary>
+		/// Copies refer to the same ID. If the other handle holds a reference,
+		/// the copy takes a reference of its own.
+		/// </summary>
+		ResourceHandle(const ResourceHandle& other);
+
+		/// <summary>
+		/// Moving a handle hands its reference over, without touching the resource.
+		/// </summary>
+		ResourceHandle(ResourceHandle&& other) noexcept;
+		ResourceHandle& operator=(const ResourceHandle& other);
+		ResourceHandle& operator=(ResourceHandle&& other) noexcept;
 
 		/// <summary>
 		/// Destroying the ResourceHandle will automatically release the
@@ -30,12 +30,21 @@ namespace Exelius
 		/// operations on/with the loaded resource.
 		/// 
 		/// @note
-		/// This function is typically called from the resource thread
-		/// and thus should be made thread safe.
+		/// This function is called on the main thread, unless IsThreadSafe()
+		/// is overridden to return true.
+		/// @see ResourceLoader::ProcessCompletions
         /// </summary>
         /// <param name="resourceID">- The ID of the loaded resource.</param>
         /// <returns>True if the resource was flushed here, false if not.</returns>
 		virtual bool OnResourceLoaded(const ResourceID& resourceID) = 0;
+
+		/// <summary>
+		/// Listeners that can be notified on any thread return true, so they
+		/// are notified as soon as the load finishes instead of waiting for
+		/// the main thread to drain the completion queue.
+		/// </summary>
+		/// <returns>True if OnResourceLoaded() may be called from any thread.</returns>
+		virtual bool IsThreadSafe() const { return false; }
 	};
 
 	/// <summary>
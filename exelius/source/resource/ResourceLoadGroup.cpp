@@ -0,0 +1,151 @@
+#include "EXEPCH.h"
+#include "source/resource/ResourceLoadGroup.h"
+#include "source/resource/ResourceLoader.h"
+#include "source/os/threads/JobSystem.h"
+
+#include <thread>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// Create an empty group. It can't complete until FinishAdding() is called.
+	/// </summary>
+	/// <param name="groupID">- The ID passed to the listener on completion.</param>
+	/// <param name="pListener">- Notified once every resource has finished loading.</param>
+	ResourceLoadGroup::ResourceLoadGroup(const ResourceID& groupID, ResourceListenerPtr pListener)
+		: m_groupID(groupID)
+		, m_pListener(pListener)
+		, m_resourceCount(0)
+		, m_finishedCount(0)
+		, m_failedCount(0)
+		, m_remainingCount(1)
+	{
+		//
+	}
+
+	/// <summary>
+	/// Releases the references the group still holds.
+	/// </summary>
+	ResourceLoadGroup::~ResourceLoadGroup()
+	{
+		Release();
+	}
+
+	/// <summary>
+	/// Counts one of the group's resources as finished. Listeners are notified
+	/// of failed loads too, so it is counted as failed unless it actually loaded.
+	/// </summary>
+	/// <param name="resourceID">- The resource that finished loading.</param>
+	/// <returns>True.</returns>
+	bool ResourceLoadGroup::OnResourceLoaded(const ResourceID& resourceID)
+	{
+		// The status is published before listeners are notified, and the group's reference keeps a loaded resource loaded.
+		ResourceLoader* pResourceLoader = ResourceLoader::GetInstance();
+		if (!pResourceLoader || pResourceLoader->GetResourceLoadStatus(resourceID) != ResourceLoadStatus::kLoaded)
+		{
+			OnResourceFailed(resourceID);
+			return true;
+		}
+
+		m_finishedCount.fetch_add(1, std::memory_order_release);
+		CountDown();
+		return true;
+	}
+
+	/// <summary>
+	/// Counts one of the group's resources as finished and failed, such as
+	/// one that could not be requested at all.
+	/// </summary>
+	/// <param name="resourceID">- The resource that failed to load.</param>
+	void ResourceLoadGroup::OnResourceFailed(const ResourceID&)
+	{
+		// Counted before it finishes, so the listener never sees a complete group without its failures.
+		m_failedCount.fetch_add(1, std::memory_order_release);
+		m_finishedCount.fetch_add(1, std::memory_order_release);
+		CountDown();
+	}
+
+	/// <summary>
+	/// Counts a resource that is about to be requested. Must be called before the request,
+	/// since the request may finish right away.
+	/// </summary>
+	void ResourceLoadGroup::AddPending()
+	{
+		m_resourceCount.fetch_add(1, std::memory_order_release);
+		m_remainingCount.fetch_add(1, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Marks the group as fully built. If every resource has already finished,
+	/// the listener is notified now.
+	/// </summary>
+	void ResourceLoadGroup::FinishAdding()
+	{
+		// Drops the count that kept the group from completing while it was built.
+		CountDown();
+	}
+
+	/// <summary>
+	/// Releases the references the group holds. The resources unload, or move
+	/// into the cache, once nothing else holds them either.
+	/// </summary>
+	void ResourceLoadGroup::Release()
+	{
+		if (m_heldResources.empty())
+			return;
+
+		ResourceLoader* pResourceLoader = ResourceLoader::GetInstance();
+		if (pResourceLoader)
+		{
+			for (const ResourceID& resourceID : m_heldResources)
+			{
+				pResourceLoader->ReleaseResource(resourceID);
+			}
+		}
+
+		m_heldResources.clear();
+	}
+
+	/// <summary>
+	/// Get how much of the group has finished loading.
+	/// </summary>
+	/// <returns>The finished fraction, from 0 to 1.</returns>
+	float ResourceLoadGroup::GetProgress() const
+	{
+		const uint32_t resourceCount = GetResourceCount();
+		if (resourceCount == 0)
+			return IsComplete() ? 1.0f : 0.0f;
+
+		return static_cast<float>(GetFinishedCount()) / resourceCount;
+	}
+
+	/// <summary>
+	/// Blocks until every resource has finished loading, helping with
+	/// other jobs in the meantime.
+	/// </summary>
+	void ResourceLoadGroup::Wait() const
+	{
+		while (!IsComplete())
+		{
+			if (!s_pGlobalJobSystem || !s_pGlobalJobSystem->IsRunning() || !s_pGlobalJobSystem->TryExecuteJob())
+				std::this_thread::yield();
+		}
+	}
+
+	/// <summary>
+	/// Drops the remaining count, notifying the listener if it reaches 0.
+	/// </summary>
+	void ResourceLoadGroup::CountDown()
+	{
+		// Only the last one to finish sees the count reach 0.
+		if (m_remainingCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+
+		ResourceLoader* pResourceLoader = ResourceLoader::GetInstance();
+		if (pResourceLoader)
+			pResourceLoader->NotifyListener(m_groupID, m_pListener);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma once
+#include "source/resource/ResourceListener.h"
+
+#include <EASTL/vector.h>
+
+#include <atomic>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// Tracks many resources loading together, such as a batch or the contents of a manifest.
+	/// The group listens for each of its resources, and notifies its own listener
+	/// exactly once when every one of them has finished loading. A resource has
+	/// finished once it has either loaded or failed to, so the listener should
+	/// check HasFailures() before using the group's resources.
+	///
+	/// The group holds a reference to each of its resources until it is released
+	/// or destroyed, so they stay loaded for as long as the group is kept.
+	///
+	/// Groups are created by the ResourceLoader, and must be held in a shared_ptr
+	/// since they are handed to the loader as a listener. Instead of listening,
+	/// the group can be polled with IsComplete(), or waited on with Wait().
+	/// @see ResourceLoader::LoadMany
+	/// @see ResourceLoader::LoadManifest
+	/// </summary>
+	class ResourceLoadGroup
+		: public ResourceListener
+	{
+		/// <summary>
+		/// The ID passed to the listener on completion, such as the manifest's ID.
+		/// </summary>
+		ResourceID m_groupID;
+
+		/// <summary>
+		/// Notified once every resource has finished loading.
+		/// </summary>
+		ResourceListenerPtr m_pListener;
+
+		/// <summary>
+		/// The resources the group holds a reference to.
+		/// Only touched by the thread that builds and releases the group.
+		/// </summary>
+		eastl::vector<ResourceID> m_heldResources;
+
+		/// <summary>
+		/// The number of resources added to the group.
+		/// </summary>
+		std::atomic<uint32_t> m_resourceCount;
+
+		/// <summary>
+		/// The number of resources that have finished loading, including the ones that failed.
+		/// </summary>
+		std::atomic<uint32_t> m_finishedCount;
+
+		/// <summary>
+		/// The number of resources that failed to load.
+		/// </summary>
+		std::atomic<uint32_t> m_failedCount;
+
+		/// <summary>
+		/// The number of resources that have not finished loading, plus one while
+		/// the group is still being built so it can't complete early.
+		/// </summary>
+		std::atomic<uint32_t> m_remainingCount;
+
+	public:
+		/// <summary>
+		/// Create an empty group. It can't complete until FinishAdding() is called.
+		/// </summary>
+		/// <param name="groupID">- The ID passed to the listener on completion.</param>
+		/// <param name="pListener">- Notified once every resource has finished loading.</param>
+		ResourceLoadGroup(const ResourceID& groupID, ResourceListenerPtr pListener);
+		ResourceLoadGroup(const ResourceLoadGroup&) = delete;
+		ResourceLoadGroup(ResourceLoadGroup&&) = delete;
+		ResourceLoadGroup& operator=(const ResourceLoadGroup&) = delete;
+		ResourceLoadGroup& operator=(ResourceLoadGroup&&) = delete;
+
+		/// <summary>
+		/// Releases the references the group still holds.
+		/// </summary>
+		virtual ~ResourceLoadGroup();
+
+		/// <summary>
+		/// Counts one of the group's resources as finished. Listeners are notified
+		/// of failed loads too, so it is counted as failed unless it actually loaded.
+		/// </summary>
+		/// <param name="resourceID">- The resource that finished loading.</param>
+		/// <returns>True.</returns>
+		virtual bool OnResourceLoaded(const ResourceID& resourceID) override;
+
+		/// <summary>
+		/// Counts one of the group's resources as finished and failed, such as
+		/// one that could not be requested at all.
+		/// </summary>
+		/// <param name="resourceID">- The resource that failed to load.</param>
+		void OnResourceFailed(const ResourceID& resourceID);
+
+		/// <summary>
+		/// The group only counts, so it is notified on whichever thread finishes
+		/// a load. Its own listener is still notified on the main thread.
+		/// </summary>
+		/// <returns>True.</returns>
+		virtual bool IsThreadSafe() const override { return true; }
+
+		/// <summary>
+		/// Counts a resource that is about to be requested. Must be called before the request,
+		/// since the request may finish right away.
+		/// </summary>
+		void AddPending();
+
+		/// <summary>
+		/// Records a reference taken by a request, to be released with the group.
+		/// </summary>
+		/// <param name="resourceID">- The resource that was acquired.</param>
+		void AddHeldResource(const ResourceID& resourceID) { m_heldResources.emplace_back(resourceID); }
+
+		/// <summary>
+		/// Marks the group as fully built. If every resource has already finished,
+		/// the listener is notified now.
+		/// </summary>
+		void FinishAdding();
+
+		/// <summary>
+		/// Releases the references the group holds. The resources unload, or move
+		/// into the cache, once nothing else holds them either.
+		/// </summary>
+		void Release();
+
+		const ResourceID& GetGroupID() const { return m_groupID; }
+
+		/// <summary>
+		/// Get the number of resources in the group.
+		/// </summary>
+		/// <returns>The number of resources.</returns>
+		uint32_t GetResourceCount() const { return m_resourceCount.load(std::memory_order_acquire); }
+
+		/// <summary>
+		/// Get the number of resources that have finished loading, including the ones that failed.
+		/// </summary>
+		/// <returns>The number of finished resources.</returns>
+		uint32_t GetFinishedCount() const { return m_finishedCount.load(std::memory_order_acquire); }
+
+		/// <summary>
+		/// Get the number of resources that failed to load.
+		/// </summary>
+		/// <returns>The number of failed resources.</returns>
+		uint32_t GetFailedCount() const { return m_failedCount.load(std::memory_order_acquire); }
+
+		/// <summary>
+		/// Checks if any resource in the group failed to load.
+		/// </summary>
+		/// <returns>True if at least one resource failed.</returns>
+		bool HasFailures() const { return GetFailedCount() > 0; }
+
+		/// <summary>
+		/// Get how much of the group has finished loading.
+		/// </summary>
+		/// <returns>The finished fraction, from 0 to 1.</returns>
+		float GetProgress() const;
+
+		/// <summary>
+		/// Checks if every resource has finished loading.
+		/// </summary>
+		/// <returns>True if the group is complete.</returns>
+		bool IsComplete() const { return m_remainingCount.load(std::memory_order_acquire) == 0; }
+
+		/// <summary>
+		/// Blocks until every resource has finished loading, helping with
+		/// other jobs in the meantime.
+		/// </summary>
+		void Wait() const;
+
+	private:
+		/// <summary>
+		/// Drops the remaining count, notifying the listener if it reaches 0.
+		/// </summary>
+		void CountDown();
+	};
+}
\ No newline at end of file
@@ -3,67 +3,106 @@
 #include "source/resource/ResourceListener.h"
 #include "source/resource/ResourceFactory.h"
 #include "source/resource/Resource.h"
-#include "source/utility/io/File.h"
-#include "source/utility/io/ZLIBStructs.h"
-
-#include <zlib.h>
+#include "source/resource/ResourceLoadGroup.h"
+#include "source/resource/ResourceManifest.h"
+#include "source/utility/io/AsyncFileReader.h"
+#include "source/utility/io/DirectoryArchive.h"
+#include "source/utility/io/MappedFile.h"
+#include "source/utility/io/PakArchive.h"
+#include "source/utility/io/ZipArchive.h"
+#include "source/utility/string/StringTransformation.h"
+
+#include <EASTL/algorithm.h>
+#include <EASTL/chrono.h>
+#include <EASTL/sort.h>
+#include <EASTL/unordered_set.h>
+#include <filesystem>
+#include <system_error>
+#include <thread>
 
 /// <summary>
 /// Engine namespace. Everything owned by the engine will be inside this namespace.
 /// </summary>
 namespace Exelius
 {
+	// The reload being decoded on the current thread, if any. Dependencies its new version acquires are collected here.
+	static thread_local const ResourceID* s_pThreadReloadID = nullptr;
+	static thread_local eastl::vector<ResourceID>* s_pThreadReloadDependencies = nullptr;
+
 	/// <summary>
 	/// Constructor default initializes member data.
 	/// </summary>
 	ResourceLoader::ResourceLoader()
 		: m_resourceLoaderLog("ResourceLoader")
+		, m_completionQueueDepth(0)
 		, m_pResourceFactory(nullptr)
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-		, m_quitThread(false)
-		, m_successfulThreadShutdown(false)
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
+		, m_quitIOThreads(false)
+		, m_bytesInFlight(0)
+		, m_decodeQueueDepth(0)
+		, m_totalBytesRead(0)
+		, m_totalResourcesRead(0)
+		, m_totalResourcesDecoded(0)
+		, m_totalReadNanoseconds(0)
+		, m_totalDecodeNanoseconds(0)
 		, m_engineResourcePath("Invalid Engine Resource Path.")
 		, m_useRawAssets(false)
+		, m_pRawAssetDirectory(nullptr)
 	{
 		//
 	}
 
 	/// <summary>
 	/// Destructor handles the safe shutdown and destruction of
-	/// resources and the resource thread.
+	/// resources and waits for any loads still running.
 	/// </summary>
 	ResourceLoader::~ResourceLoader()
 	{
-		// Remove resources to be loaded.
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
+		m_fileWatcher.Stop();
+
+		// Remove resources that were never dispatched. Their entries are cleaned up with the database.
 		m_deferredQueueLock.lock();
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 		m_deferredQueue.clear();
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 		m_deferredQueueLock.unlock();
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 
-		// Remove listeners waiting on resources.
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
+		// Should already be stopped by the Application, before the JobSystem was shut down.
+		StopIOThreads();
+
+		// Wait for loads that are already running, they are using the factory and the database.
+		if (s_pGlobalJobSystem && !m_loadCounter.IsFinished())
+			s_pGlobalJobSystem->WaitForCounter(m_loadCounter);
+
+		// Drop reloads that were never swapped in. Their references are cleaned up with the database.
+		m_reloadLock.lock();
+		for (FinishedReload& finishedReload : m_finishedReloads)
+		{
+			m_resourceDatabase.RetireResource(finishedReload.m_pResource);
+		}
+		m_finishedReloads.clear();
+		m_reloadSequences.clear();
+		m_reloadLock.unlock();
+
+		// Remove listeners waiting on resources, and notifications that were never delivered.
 		m_listenerMapLock.lock();
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-		m_deferredResourceListenersMap.clear();
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
+		m_pendingListenersMap.clear();
 		m_listenerMapLock.unlock();
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 
-		// Tell the thread we are done.
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-		m_quitThread = true;
-		SignalAndWaitForLoaderThread();
-		m_loaderThread.join();
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
+		ResourceCompletion completion;
+		while (m_completionQueue.PopFront(completion))
+		{
+			//
+		}
+		m_completionOverflowLock.lock();
+		m_completionOverflow.clear();
+		m_completionOverflowLock.unlock();
+		m_completionQueueDepth = 0;
 
 		// Unload any assets that were added to this queue during
 		// engine shutdown processes.
 		ProcessUnloadQueue();
 
+		m_fileSystem.UnmountAll();
+		m_pRawAssetDirectory = nullptr;
+
 		// Don't delete, this lives on the Application/Engine.
 		// I have decided that the destruction of the factory
 		// makes more sense to happen in the same class that
@@ -74,7 +113,7 @@ namespace Exelius
 	/// <summary>
 	/// Initialization sets the resource factory given by the application,
 	/// sets the path to the engine and client resources, determines the
-	/// way resources are retrieved and spins up the resource thread.
+	/// way resources are retrieved and clears any queued loads.
 	/// The data provided for this function is retrieved from the config
 	/// file in, and this function is called from, the Application.
 	/// @see Application
@@ -85,8 +124,9 @@ namespace Exelius
 	/// <param name="pResourceFactory">- The desired resource factory to be used when creating resources.</param>
 	/// <param name="pEngineResourcePath">- The path that the resource loader will look to load engine assets.</param>
 	/// <param name="useRawAssets">- Whether or not the engine will be loading assets from a compressed file.</param>
+	/// <param name="definition">- The I/O thread count and byte budget of the loading pipeline.</param>
 	/// <returns>True if initialization was successful, false otherwise.</returns>
-	bool ResourceLoader::Initialize(ResourceFactory* pResourceFactory, const char* pEngineResourcePath, bool useRawAssets)
+	bool ResourceLoader::Initialize(ResourceFactory* pResourceFactory, const char* pEngineResourcePath, bool useRawAssets, const ResourceLoaderDefinition& definition)
 	{
 		// Default resource factory MUST exist.
 		EXE_ASSERT(pResourceFactory);
@@ -95,33 +135,81 @@ namespace Exelius
 		if (pEngineResourcePath)
 			m_engineResourcePath = pEngineResourcePath;
 
-		m_useRawAssets = useRawAssets;
+		SetUsingRawAssets(useRawAssets);
+
+		// Listeners are only notified on this thread.
+		m_mainThreadID = std::this_thread::get_id();
 
 		// Should not contain data, but just in case.
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 		m_deferredQueueLock.lock();
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 		m_deferredQueue.clear();
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 		m_deferredQueueLock.unlock();
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 		m_listenerMapLock.lock();
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-		m_deferredResourceListenersMap.clear();
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
+		m_pendingListenersMap.clear();
 		m_listenerMapLock.unlock();
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-		// Spin up the loader thread.
-		m_loaderThread = std::thread(&ResourceLoader::ProcessResourceQueue, this);
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
+		EXE_ASSERT(m_ioThreads.empty());
+		m_definition = definition;
+		m_quitIOThreads = false;
+
+		m_resourceDatabase.SetCacheBudgets(m_definition.m_defaultCacheBudget, m_definition.m_cacheBudgets);
+
+		if (!m_definition.m_clientResourcePath.empty())
+			m_clientResourcePath = m_definition.m_clientResourcePath;
+
+		if (m_definition.m_hotReload)
+		{
+			// Archives are only read when they are mounted, so only raw assets can change underneath us.
+			if (!m_useRawAssets)
+				m_resourceLoaderLog.Info("Hot reload is only available when using raw assets.");
+			else if (m_clientResourcePath.empty())
+				m_resourceLoaderLog.Warn("Hot reload needs a client resource path to watch.");
+			else
+				m_fileWatcher.Start(m_clientResourcePath.c_str(), m_definition.m_hotReloadDebounceMilliseconds);
+		}
+
+		m_resourceLoaderLog.Info("Starting {} resource I/O threads with a budget of {} bytes in flight.", m_definition.m_ioThreadCount, m_definition.m_maxBytesInFlight);
+		for (uint32_t ioThreadIndex = 0; ioThreadIndex < m_definition.m_ioThreadCount; ++ioThreadIndex)
+		{
+			m_ioThreads.emplace_back(&ResourceLoader::IOThread, this);
+		}
+
+		// Say where decoding happens, since without a JobSystem every load quietly moves to the calling thread.
+		if (CanLoadOnJobSystem())
+			m_resourceLoaderLog.Info("Resources will be decoded as background jobs on {} workers.", s_pGlobalJobSystem->GetWorkerCount());
+		else if (m_ioThreads.empty())
+			m_resourceLoaderLog.Warn("There are no I/O threads or JobSystem workers. Resources will load on the thread that requests them.");
+		else
+			m_resourceLoaderLog.Info("Resources will be decoded on the I/O threads.");
 
 		return true;
 	}
 
+	/// <summary>
+	/// Stops and joins the I/O threads, dropping any resources they have not started reading.
+	/// Must be called before the JobSystem shuts down, since the I/O threads push decode jobs.
+	/// Called by the destructor if it hasn't been already.
+	/// </summary>
+	void ResourceLoader::StopIOThreads()
+	{
+		if (m_ioThreads.empty())
+			return;
+
+		m_ioQueueLock.lock();
+		m_quitIOThreads = true;
+		m_ioQueue.clear();
+		m_ioQueueLock.unlock();
+		m_ioSignal.notify_all();
+
+		for (std::thread& ioThread : m_ioThreads)
+		{
+			if (ioThread.joinable())
+				ioThread.join();
+		}
+		m_ioThreads.clear();
+	}
+
 	/// <summary>
 	/// Process any resources that have been marked for removal.
 	/// This happens once per frame and should not be called by
@@ -136,15 +224,158 @@ namespace Exelius
 	}
 
 	/// <summary>
-	/// Queue the resource to be loaded. This will defer the load to
-	/// the resource thread if running in multithreaded mode. If a
-	/// resource is already being loaded then the resource listener
-	/// will be added to the list of listeners to be notified and
-	/// nothing further will happen. If the resource is loaded already
-	/// then the listener will be notified immediately.
-	/// @todo
-	/// Potential data race here, if the listener is added just after
-	/// the loader thread proccesses the listener queue.
+	/// Notifies listeners of loads that finished on other threads, oldest first,
+	/// until the frame's completion budget runs out. At least
+	/// one is notified each call, so the queue always makes progress. This
+	/// happens once per frame and should not be called by the client.
+	/// </summary>
+	void ResourceLoader::ProcessCompletions()
+	{
+		EXE_ASSERT(std::this_thread::get_id() == m_mainThreadID);
+
+		ApplyFinishedReloads();
+
+		if (m_completionQueueDepth.load(std::memory_order_acquire) == 0)
+			return;
+
+		const auto startTime = eastl::chrono::steady_clock::now();
+		const auto budget = eastl::chrono::microseconds(m_definition.m_completionBudgetMicroseconds);
+		size_t completionCount = 0;
+
+		ResourceCompletion completion;
+		for (;;)
+		{
+			if (!m_completionQueue.PopFront(completion))
+			{
+				// These were posted while the queue was full.
+				std::lock_guard<std::mutex> lock(m_completionOverflowLock);
+				if (m_completionOverflow.empty())
+					break;
+
+				completion = eastl::move(m_completionOverflow.front());
+				m_completionOverflow.pop_front();
+			}
+
+			m_completionQueueDepth.fetch_sub(1, std::memory_order_release);
+			++completionCount;
+
+			if (!completion.m_pListener.expired())
+				completion.m_pListener.lock()->OnResourceLoaded(completion.m_resourceID);
+
+			if (budget.count() > 0 && eastl::chrono::steady_clock::now() - startTime >= budget)
+				break;
+		}
+
+		m_resourceLoaderLog.Trace("Notified {} listeners, {} left for the next frame.", completionCount, m_completionQueueDepth.load(std::memory_order_relaxed));
+	}
+
+	/// <summary>
+	/// Reloads the resources whose files the FileWatcher reports as changed, along with
+	/// every loaded resource that depends on them. Only loaded resources are reloaded.
+	/// This happens once per frame when hot reloading, and should not be called by the client.
+	/// </summary>
+	void ResourceLoader::ProcessFileChanges()
+	{
+		EXE_ASSERT(std::this_thread::get_id() == m_mainThreadID);
+
+		if (!m_fileWatcher.IsRunning())
+			return;
+
+		eastl::vector<eastl::string> changedPaths;
+		m_fileWatcher.CollectChanges(changedPaths);
+		if (changedPaths.empty())
+			return;
+
+		// The changed files that are loaded, followed by the loaded resources that depend on them.
+		eastl::vector<ResourceID> reloadIDs;
+		eastl::unordered_set<ResourceID> visitedIDs;
+		for (const eastl::string& changedPath : changedPaths)
+		{
+			ResourceID resourceID(changedPath);
+
+			// Created or deleted files may now resolve to a different mount.
+			m_fileSystem.InvalidatePath(resourceID.Get());
+			if (m_resourceDatabase.GetEntryLoadStatus(resourceID) == ResourceLoadStatus::kLoaded && visitedIDs.insert(resourceID).second)
+				reloadIDs.emplace_back(resourceID);
+		}
+
+		if (reloadIDs.empty())
+			return;
+
+		// Reverse the graph's edges, so each resource leads to the resources that use it.
+		eastl::unordered_map<ResourceID, eastl::vector<ResourceID>> dependentsMap;
+		m_dependencyGraphLock.lock();
+		for (const auto& dependenciesPair : m_dependencyGraph)
+		{
+			for (const ResourceID& dependencyID : dependenciesPair.second)
+			{
+				dependentsMap[dependencyID].emplace_back(dependenciesPair.first);
+			}
+		}
+		m_dependencyGraphLock.unlock();
+
+		// Grows as dependents are found, so dependents of dependents are reached too.
+		for (size_t i = 0; i < reloadIDs.size(); ++i)
+		{
+			auto found = dependentsMap.find(reloadIDs[i]);
+			if (found == dependentsMap.end())
+				continue;
+
+			for (const ResourceID& dependentID : found->second)
+			{
+				if (m_resourceDatabase.GetEntryLoadStatus(dependentID) == ResourceLoadStatus::kLoaded && visitedIDs.insert(dependentID).second)
+					reloadIDs.emplace_back(dependentID);
+			}
+		}
+
+		m_resourceLoaderLog.Info("{} files changed, reloading {} resources.", changedPaths.size(), reloadIDs.size());
+		for (const ResourceID& resourceID : reloadIDs)
+		{
+			ReloadResource(resourceID);
+		}
+	}
+
+	/// <summary>
+	/// Notifies a listener that a resource has loaded. On the main thread, or if
+	/// the listener is thread safe, it is notified now. Otherwise the notification
+	/// is posted to the completion queue for ProcessCompletions().
+	/// Thread Safe.
+	/// </summary>
+	/// <param name="resourceID">- The resource that finished loading.</param>
+	/// <param name="pListener">- The listener to notify.</param>
+	void ResourceLoader::NotifyListener(const ResourceID& resourceID, ResourceListenerPtr pListener)
+	{
+		auto pLockedListener = pListener.lock();
+		if (!pLockedListener)
+			return;
+
+		if (std::this_thread::get_id() == m_mainThreadID || pLockedListener->IsThreadSafe())
+		{
+			pLockedListener->OnResourceLoaded(resourceID);
+			return;
+		}
+
+		// Counted first, so the main thread never sees the depth drop below 0.
+		m_completionQueueDepth.fetch_add(1, std::memory_order_release);
+
+		ResourceCompletion completion;
+		completion.m_resourceID = resourceID;
+		completion.m_pListener = pListener;
+		if (!m_completionQueue.PushBack(eastl::move(completion)))
+		{
+			std::lock_guard<std::mutex> lock(m_completionOverflowLock);
+			m_completionOverflow.emplace_back(eastl::move(completion));
+		}
+	}
+
+	/// <summary>
+	/// Acquire a reference to the resource and queue it to be loaded
+	/// as a background job. If a resource is already being loaded then
+	/// the resource listener will be added to the list of listeners to
+	/// be notified and nothing further will happen. If the resource is
+	/// loaded already then the listener will be notified immediately.
+	/// If it is still unloading on another thread, this waits for the
+	/// unload to finish and then queues it again.
 	/// 
 	/// The loading time of a resource is not predictable, and thus
 	/// the use of the ResourceListener class is highly reccomended
@@ -156,90 +387,143 @@ namespace Exelius
 	/// so that multiple listeners can be notified of a resource being loaded.
 	/// </summary>
 	/// <param name="resourceID">- The filepath of the resource to load. This is a StringIntern for optimization.</param>
-	/// <param name="signalLoaderThread">- True if the loader thread should be signaled to begin loading. Does nothing in single threaded mode.</param>
+	/// <param name="signalLoaderThread">- True to start loading right away. Otherwise the load waits for the next DispatchQueuedLoads().</param>
 	/// <param name="pListener">- The listener to be notified when a resource has completed the load process.</param>
-	void ResourceLoader::QueueLoad(const ResourceID& resourceID, [[maybe_unused]] bool signalLoaderThread, ResourceListenerPtr pListener)
+	/// <returns>True once a reference was taken and the listener will be notified.</returns>
+	bool ResourceLoader::QueueLoad(const ResourceID& resourceID, bool signalLoaderThread, ResourceListenerPtr pListener)
 	{
 		EXE_ASSERT(resourceID.IsValid());
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-		EXE_ASSERT(m_loaderThread.joinable());
-
 		m_resourceLoaderLog.Trace("Queueing Resource: {}", resourceID.Get().c_str());
 
-		// Attempt to create a resource entry.
-		if (m_resourceDatabase.CreateEntry(resourceID))
-		{
-			m_resourceLoaderLog.Trace("Created new resource entry.");
+		const ResourceLoadStatus previousStatus = AcquireForLoad(resourceID, pListener);
 
-			m_listenerMapLock.lock();
-			m_deferredResourceListenersMap[resourceID].emplace_back(pListener);
-			m_listenerMapLock.unlock();
-		}
-		else if (m_resourceDatabase.GetEntryLoadStatus(resourceID) == ResourceLoadStatus::kLoaded)
+		if (previousStatus == ResourceLoadStatus::kLoaded)
 		{
 			m_resourceLoaderLog.Trace("Resource already loaded.");
 
 			// This may seem unnecessary, but it is a catch in case no listener was passed in.
-			if (!pListener.expired())
-				pListener.lock()->OnResourceLoaded(resourceID);
+			NotifyListener(resourceID, pListener);
 
-			return; // Bail here. We do NOT want to change the status of the resource.
+			return true;
 		}
-		else if (m_resourceDatabase.GetEntryLoadStatus(resourceID) == ResourceLoadStatus::kLoading)
+		else if (previousStatus == ResourceLoadStatus::kLoading)
 		{
-			m_resourceLoaderLog.Trace("Resource already queued.");
-			m_resourceDatabase.IncrementEntryRefCount(resourceID);
-			return; // Bail here. We do NOT want to change the status of the resource.
+			m_resourceLoaderLog.Trace("Resource already loading.");
+			return true;
 		}
-		else
+
+		// If we get here, then we claimed the load.
+		PrefetchDependencies(resourceID);
+
+		if (m_ioThreads.empty() && !CanLoadOnJobSystem())
 		{
-			m_resourceLoaderLog.Warn("Resource was unloaded or unloading. SEE TODO in ResourceLoader.cpp.");
-			/// TODO:
-			///		It is possible that neither of the 2 branches were entered.
-			///		This means that the Resource exists in the database && its
-			///		LoadStatus is neither Loaded or Loading, possibly Unloading
-			///		or Unloaded. This could cause an issue in the future if not
-			///		carefully protected against. For example: The pListener will
-			///		not be called in this case, which is already a bug. Hack fix
-			///		is as follows.
-			///	EDIT:
-			///		I *think* that the resource would have it's ref count incremented
-			///		already, but that may be something to think about here.
-			m_listenerMapLock.lock();
-			m_deferredResourceListenersMap[resourceID].emplace_back(pListener);
-			m_listenerMapLock.unlock();
+			LoadResource(resourceID);
+			return true;
 		}
 
-		// If we get here, then the resource is now loading.
-		m_resourceDatabase.SetEntryLoadStatus(resourceID, ResourceLoadStatus::kLoading);
-		
 		m_deferredQueueLock.lock();
 		m_deferredQueue.emplace_back(resourceID);
 		m_deferredQueueLock.unlock();
 
 		if (signalLoaderThread)
-			SignalLoaderThread();
+			DispatchQueuedLoads();
 
 		m_resourceLoaderLog.Trace("QueueLoad Complete.");
-		#else
-		LoadNow(resourceID, pListener);
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
+		return true;
 	}
 
 	/// <summary>
-	/// Load the given resource immediately. This will happen on the
-	/// calling thread and will be blocking on that thread until the
-	/// resource has completed the load process. If a resource is
-	/// already being loaded then the resource listener will be added
-	/// to the list of listeners to be notified and nothing further
-	/// will happen. If the resource is loaded already then the
-	/// listener will be notified immediately.
-	/// @todo
-	/// Potential data race here, if the listener is added just after
-	/// the loader thread proccesses the listener queue.
-	/// @todo
-	/// A resource that is already queued should be removed from the
-	/// queue and forceloaded here.
+	/// Takes a reference to a resource and claims its load if nobody else has,
+	/// adding the listener in the same step so a load finishing on another thread
+	/// can't miss it. A resource that is still unloading on another thread is
+	/// waited for and then acquired again, so a load never fails for timing alone.
+	/// </summary>
+	/// <param name="resourceID">- The resource to acquire.</param>
+	/// <param name="pListener">- The listener to add if the resource isn't loaded yet.</param>
+	/// <returns>The status of the entry before it was acquired. ResourceLoadStatus::kInvalid means the caller must load it.</returns>
+	ResourceLoadStatus ResourceLoader::AcquireForLoad(const ResourceID& resourceID, const ResourceListenerPtr& pListener)
+	{
+		for (;;)
+		{
+			m_listenerMapLock.lock();
+			const ResourceLoadStatus previousStatus = m_resourceDatabase.AcquireEntryForLoad(resourceID);
+			if ((previousStatus == ResourceLoadStatus::kInvalid || previousStatus == ResourceLoadStatus::kLoading) && !pListener.expired())
+				m_pendingListenersMap[resourceID].emplace_back(pListener);
+			m_listenerMapLock.unlock();
+
+			if (previousStatus != ResourceLoadStatus::kUnloading)
+				return previousStatus;
+
+			// The unload may release other resources, so wait without holding the listener lock.
+			m_resourceLoaderLog.Trace("Resource '{}' is unloading, waiting to load it again.", resourceID.Get().c_str());
+			m_resourceDatabase.WaitForEntryUnload(resourceID);
+		}
+	}
+
+	/// <summary>
+	/// Start loading every resource that was queued without signaling.
+	/// This happens once per frame, and can be called any time to start early.
+	/// </summary>
+	void ResourceLoader::DispatchQueuedLoads()
+	{
+		eastl::vector<ResourceID> dispatchQueue;
+
+		m_deferredQueueLock.lock();
+		dispatchQueue.swap(m_deferredQueue);
+		m_deferredQueueLock.unlock();
+
+		for (const ResourceID& resourceID : dispatchQueue)
+		{
+			DispatchLoad(resourceID);
+		}
+	}
+
+	/// <summary>
+	/// Takes a snapshot of the loading pipeline's queue depths and totals.
+	/// The values are read one at a time, so they may be slightly out of step with each other.
+	/// </summary>
+	/// <returns>The current pipeline stats.</returns>
+	ResourcePipelineStats ResourceLoader::GetPipelineStats()
+	{
+		ResourcePipelineStats stats;
+
+		m_ioQueueLock.lock();
+		stats.m_ioQueueDepth = m_ioQueue.size();
+		m_ioQueueLock.unlock();
+
+		stats.m_decodeQueueDepth = m_decodeQueueDepth.load(std::memory_order_relaxed);
+		stats.m_bytesInFlight = m_bytesInFlight.load(std::memory_order_relaxed);
+		stats.m_completionQueueDepth = m_completionQueueDepth.load(std::memory_order_relaxed);
+		stats.m_totalBytesRead = m_totalBytesRead.load(std::memory_order_relaxed);
+		stats.m_totalResourcesRead = m_totalResourcesRead.load(std::memory_order_relaxed);
+		stats.m_totalResourcesDecoded = m_totalResourcesDecoded.load(std::memory_order_relaxed);
+		stats.m_totalReadNanoseconds = m_totalReadNanoseconds.load(std::memory_order_relaxed);
+		stats.m_totalDecodeNanoseconds = m_totalDecodeNanoseconds.load(std::memory_order_relaxed);
+
+		return stats;
+	}
+
+	/// <summary>
+	/// Takes a snapshot of the resource cache's hit, miss and eviction counters.
+	/// </summary>
+	/// <returns>The current cache stats.</returns>
+	ResourceCacheStats ResourceLoader::GetCacheStats() const
+	{
+		return m_resourceDatabase.GetCacheStats();
+	}
+
+	/// <summary>
+	/// Acquire a reference to the resource and load it immediately.
+	/// This will happen on the calling thread and will be blocking on
+	/// that thread until the resource has completed the load process.
+	/// A resource that was queued but not yet dispatched is taken out
+	/// of the queue and loaded here. If the resource is already being
+	/// loaded by a job, this waits for that job, helping with other
+	/// jobs in the meantime. The listener is notified before returning,
+	/// unless another thread finished the load, in which case it is notified
+	/// by ProcessCompletions().
+	/// If it is still unloading on another thread, this waits for the
+	/// unload to finish and then loads it again.
 	/// 
 	/// The loading time of a resource is not predictable, and thus
 	/// the use of the ResourceListener class is highly recomended
@@ -252,49 +536,247 @@ namespace Exelius
 	/// </summary>
 	/// <param name="resourceID">- The filepath of the resource to load. This is a StringIntern for optimization</param>
 	/// <param name="pListener">- The listener to be notified when a resource has completed the load process.</param>
-	void ResourceLoader::LoadNow(const ResourceID& resourceID, ResourceListenerPtr pListener)
+	/// <returns>True once a reference was taken and the listener was notified.</returns>
+	bool ResourceLoader::LoadNow(const ResourceID& resourceID, ResourceListenerPtr pListener)
 	{
 		EXE_ASSERT(resourceID.IsValid());
-		m_resourceLoaderLog.Trace("Loading Resource On Main Thread: {}", resourceID.Get().c_str());
+		m_resourceLoaderLog.Trace("Loading Resource On Calling Thread: {}", resourceID.Get().c_str());
 
-		// Check if the resource is already in the resource database.
-		if (m_resourceDatabase.CreateEntry(resourceID))
-		{
-			m_resourceLoaderLog.Trace("Created new resource entry.");
+		const ResourceLoadStatus previousStatus = AcquireForLoad(resourceID, pListener);
 
-			#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-			m_listenerMapLock.lock();
-			#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-			m_deferredResourceListenersMap[resourceID].emplace_back(pListener);
-			#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-			m_listenerMapLock.unlock();
-			#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-		}
-		else if (m_resourceDatabase.GetEntryLoadStatus(resourceID) == ResourceLoadStatus::kLoaded)
+		if (previousStatus == ResourceLoadStatus::kLoaded)
 		{
 			m_resourceLoaderLog.Trace("Resource already loaded.");
 
 			// This may seem unnecessary, but it is a catch in case no listener was passed in.
-			if (!pListener.expired())
-				pListener.lock()->OnResourceLoaded(resourceID);
+			NotifyListener(resourceID, pListener);
 
-			return;
+			return true;
 		}
-		else if (m_resourceDatabase.GetEntryLoadStatus(resourceID) == ResourceLoadStatus::kLoading)
+		else if (previousStatus == ResourceLoadStatus::kInvalid)
 		{
-			m_resourceLoaderLog.Trace("Resource already queued.");
-			// TODO: We may want to consider removing the queued load
-			//		 then forcing the load here.
-			return; // Bail here. We do NOT want to change the status of the resource.
+			// The dependencies are read in the background while this one loads here.
+			PrefetchDependencies(resourceID);
+			DispatchQueuedLoads();
+
+			LoadResource(resourceID);
+			m_resourceLoaderLog.Trace("Load Complete.");
+			return true;
 		}
 
-		m_resourceDatabase.SetEntryLoadStatus(resourceID, ResourceLoadStatus::kLoading);
-		LoadResource(resourceID);
+		m_resourceLoaderLog.Trace("Resource already loading, waiting for it.");
 
-		if (!pListener.expired()) // This may seem unnecessary, but it is a catch in case no listener was passed in.
-			pListener.lock()->OnResourceLoaded(resourceID);
+		// Someone else claimed the load. Take it over if it hasn't been dispatched yet, otherwise wait for it.
+		while (m_resourceDatabase.GetEntryLoadStatus(resourceID) == ResourceLoadStatus::kLoading)
+		{
+			if (RemoveFromQueuedLoads(resourceID))
+			{
+				LoadResource(resourceID);
+				break;
+			}
+
+			if (!s_pGlobalJobSystem || !s_pGlobalJobSystem->IsRunning() || !s_pGlobalJobSystem->TryExecuteJob())
+				std::this_thread::yield();
+		}
 
 		m_resourceLoaderLog.Trace("Load Complete.");
+		return true;
+	}
+
+	/// <summary>
+	/// Queues many resources to load together as background jobs, in the
+	/// order they sit on disk so reads stay close together. Duplicate IDs
+	/// are only loaded once.
+	/// 
+	/// The returned group holds a reference to each resource until it is
+	/// released or destroyed, and reports how many have finished or failed. The listener
+	/// is notified once, with the group's ID, when all of them have. The group
+	/// can also be polled, or waited on.
+	/// @see ResourceLoadGroup
+	/// </summary>
+	/// <param name="resourceIDs">- The filepaths of the resources to load.</param>
+	/// <param name="pListener">- The listener to be notified when every resource has completed the load process.</param>
+	/// <param name="groupID">- The ID passed to the listener, to tell groups apart.</param>
+	/// <returns>The group tracking the resources.</returns>
+	eastl::shared_ptr<ResourceLoadGroup> ResourceLoader::LoadMany(const eastl::vector<ResourceID>& resourceIDs, ResourceListenerPtr pListener, const ResourceID& groupID)
+	{
+		m_resourceLoaderLog.Trace("Loading {} resources as a group.", resourceIDs.size());
+
+		eastl::vector<ResourceID> sortedIDs;
+		sortedIDs.reserve(resourceIDs.size());
+		for (const ResourceID& resourceID : resourceIDs)
+		{
+			if (!resourceID.IsValid())
+			{
+				m_resourceLoaderLog.Warn("Skipped an invalid resource ID in a group load.");
+				continue;
+			}
+
+			sortedIDs.emplace_back(resourceID);
+		}
+		SortForLocality(sortedIDs);
+
+		auto pLoadGroup = eastl::make_shared<ResourceLoadGroup>(groupID, pListener);
+		for (const ResourceID& resourceID : sortedIDs)
+		{
+			pLoadGroup->AddPending();
+			if (QueueLoad(resourceID, false, pLoadGroup))
+				pLoadGroup->AddHeldResource(resourceID);
+			else
+				pLoadGroup->OnResourceFailed(resourceID);
+		}
+		pLoadGroup->FinishAdding();
+
+		// Everything starts at once, so the I/O threads can read it all in as few batches as possible.
+		DispatchQueuedLoads();
+
+		return pLoadGroup;
+	}
+
+	/// <summary>
+	/// Reads a manifest and queues every resource it lists, along with every
+	/// dependency known for them, to load together as background jobs. The
+	/// dependency edges in the manifest are added to the dependency graph.
+	/// 
+	/// The returned group holds a reference to each resource until it is
+	/// released or destroyed, and reports how many have finished or failed. The listener
+	/// is notified once, with the manifest's ID, when all of them have.
+	/// </summary>
+	/// <param name="manifestID">- The filepath of the manifest.</param>
+	/// <param name="pListener">- The listener to be notified when every resource has completed the load process.</param>
+	/// <returns>The group tracking the resources, or nullptr if the manifest could not be read.</returns>
+	eastl::shared_ptr<ResourceLoadGroup> ResourceLoader::LoadManifest(const ResourceID& manifestID, ResourceListenerPtr pListener)
+	{
+		EXE_ASSERT(manifestID.IsValid());
+		m_resourceLoaderLog.Trace("Loading Manifest: {}", manifestID.Get().c_str());
+
+		// Manifests are small and needed before anything else can start, so read it here.
+		RawResourceData rawData = LoadRawData(manifestID);
+		const eastl::span<const std::byte> data = rawData.GetBytes();
+
+		ResourceManifest manifest;
+		if (data.empty() || !manifest.Parse(data))
+		{
+			m_resourceLoaderLog.Warn("Failed to read resource manifest '{}'.", manifestID.Get().c_str());
+			return nullptr;
+		}
+
+		for (const auto& dependenciesPair : manifest.GetDependencies())
+		{
+			for (const ResourceID& dependencyID : dependenciesPair.second)
+			{
+				RegisterDependency(dependenciesPair.first, dependencyID);
+			}
+		}
+
+		// Gather everything the manifest's resources depend on, including edges learned from earlier loads.
+		eastl::vector<ResourceID> resourceIDs = manifest.GetResources();
+		eastl::unordered_set<ResourceID> gatheredIDs(resourceIDs.begin(), resourceIDs.end());
+		m_dependencyGraphLock.lock();
+		for (size_t i = 0; i < resourceIDs.size(); ++i)
+		{
+			auto found = m_dependencyGraph.find(resourceIDs[i]);
+			if (found == m_dependencyGraph.end())
+				continue;
+
+			for (const ResourceID& dependencyID : found->second)
+			{
+				if (gatheredIDs.insert(dependencyID).second)
+					resourceIDs.emplace_back(dependencyID);
+			}
+		}
+		m_dependencyGraphLock.unlock();
+
+		eastl::shared_ptr<ResourceLoadGroup> pLoadGroup = LoadMany(resourceIDs, pListener, manifestID);
+
+		m_resourceLoaderLog.Info("Queued {} resources from manifest '{}'.", pLoadGroup->GetResourceCount(), manifestID.Get().c_str());
+		return pLoadGroup;
+	}
+
+	/// <summary>
+	/// Adds an edge to the dependency graph, so whenever the resource is loaded
+	/// the dependency is loaded alongside it. Dependencies must not form a cycle,
+	/// or the resources in it will keep each other loaded.
+	/// </summary>
+	/// <param name="resourceID">- The dependent resource.</param>
+	/// <param name="dependencyID">- The resource it depends on.</param>
+	void ResourceLoader::RegisterDependency(const ResourceID& resourceID, const ResourceID& dependencyID)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+		EXE_ASSERT(dependencyID.IsValid());
+
+		if (resourceID == dependencyID)
+		{
+			m_resourceLoaderLog.Warn("Resource '{}' cannot depend on itself.", resourceID.Get().c_str());
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_dependencyGraphLock);
+		eastl::vector<ResourceID>& dependencies = m_dependencyGraph[resourceID];
+		if (eastl::find(dependencies.begin(), dependencies.end(), dependencyID) == dependencies.end())
+			dependencies.emplace_back(dependencyID);
+	}
+
+	/// <summary>
+	/// Called by a resource while it loads, for another resource it uses.
+	/// Records the edge, and queues the dependency if it wasn't already loaded
+	/// alongside. The dependent resource holds a reference to the dependency
+	/// until it is unloaded, or reloaded into a version that no longer uses it.
+	/// </summary>
+	/// <param name="resourceID">- The dependent resource, which must be loading.</param>
+	/// <param name="dependencyID">- The resource it depends on.</param>
+	void ResourceLoader::AcquireDependency(const ResourceID& resourceID, const ResourceID& dependencyID)
+	{
+		// A new version being reloaded holds its own references, and they only replace the entry's once it is swapped in.
+		if (s_pThreadReloadDependencies && *s_pThreadReloadID == resourceID)
+		{
+			if (resourceID == dependencyID)
+			{
+				m_resourceLoaderLog.Warn("Resource '{}' cannot depend on itself.", resourceID.Get().c_str());
+				return;
+			}
+
+			eastl::vector<ResourceID>& dependencies = *s_pThreadReloadDependencies;
+			if (eastl::find(dependencies.begin(), dependencies.end(), dependencyID) == dependencies.end() && QueueLoad(dependencyID, true))
+				dependencies.emplace_back(dependencyID);
+			return;
+		}
+
+		RegisterDependency(resourceID, dependencyID);
+
+		if (resourceID == dependencyID || !QueueLoad(dependencyID, true))
+			return;
+
+		// If it was prefetched, the entry already holds a reference to it.
+		if (!m_resourceDatabase.AddEntryDependency(resourceID, dependencyID))
+			ReleaseResource(dependencyID);
+	}
+
+	/// <summary>
+	/// Get the known dependencies of a resource.
+	/// </summary>
+	/// <param name="resourceID">- The dependent resource.</param>
+	/// <returns>The resources it depends on.</returns>
+	eastl::vector<ResourceID> ResourceLoader::GetDependencies(const ResourceID& resourceID)
+	{
+		std::lock_guard<std::mutex> lock(m_dependencyGraphLock);
+
+		auto found = m_dependencyGraph.find(resourceID);
+		if (found == m_dependencyGraph.end())
+			return {};
+
+		return found->second;
+	}
+
+	/// <summary>
+	/// Get the current load status of a resource.
+	/// Thread Safe.
+	/// </summary>
+	/// <param name="resourceID">- The resource to check.</param>
+	/// <returns>The resource's load status, or kInvalid if it has no entry.</returns>
+	ResourceLoadStatus ResourceLoader::GetResourceLoadStatus(const ResourceID& resourceID)
+	{
+		return m_resourceDatabase.GetEntryLoadStatus(resourceID);
 	}
 
 	/// <summary>
@@ -327,7 +809,8 @@ namespace Exelius
 	/// <summary>
 	/// Decrements the reference count on the given resource.
 	/// If there are no longer any references or locks on the
-	/// given resource it will be unloaded when the unload queue
+	/// given resource it is kept in the cache if its type has
+	/// room, otherwise it will be unloaded when the unload queue
 	/// is processed next.
 	/// </summary>
 	/// <param name="resourceID">- The resource to release.</param>
@@ -336,21 +819,21 @@ namespace Exelius
 		EXE_ASSERT(resourceID.IsValid());
 
 		// Decrement the reference count of this resource.
-		// If there is no longer any references to this resource, then unload it.
+		// If there is no longer any references to this resource, then cache or unload it.
 		if (m_resourceDatabase.DecrementEntryRefCount(resourceID))
-			m_resourceDatabase.UnloadEntry(resourceID);
+			m_resourceDatabase.ReleaseEntry(resourceID);
 	}
 
 	/// <summary>
-	/// If a resource is already loaded it will be unloaded and
-	/// loaded again. Otherwise it will be loaded as normal.
-	/// 
-	/// @todo
-	/// This function probably won't work and needs a bit of TLC.
+	/// If a resource is already loaded, a new version of it is loaded
+	/// while the old one stays in use. The new version replaces it on the
+	/// main thread once it has been decoded, and the old one is unloaded
+	/// with the unload queue. If the new version fails to load, the old one
+	/// is kept. Otherwise the resource will be loaded as normal.
 	/// </summary>
 	/// <param name="resourceID">- The resource to reload.</param>
-	/// <param name="forceLoad">- If true, the resource will load immediately on the calling thread. Otherwise it will load when the loader thread does so.</param>
-	/// <param name="pListener">- The listener to be notified of load completion.</param>
+	/// <param name="forceLoad">- If true, the resource will load immediately on the calling thread. Otherwise it will load as a background job.</param>
+	/// <param name="pListener">- The listener to be notified once the new version is in use.</param>
 	void ResourceLoader::ReloadResource(const ResourceID& resourceID, bool forceLoad, ResourceListenerPtr pListener)
 	{
 		EXE_ASSERT(resourceID.IsValid());
@@ -368,17 +851,27 @@ namespace Exelius
 			return;
 		}
 
-		// TODO:
-		//	This may be unnecesary and could potentially lead to bugs.
-		//	This will heavily depend on the handling of resource lifetimes/accessors.
-		m_resourceDatabase.UnloadEntry(resourceID);
+		// The reload holds a reference, so the old version stays loaded until the new one replaces it.
+		m_resourceDatabase.IncrementEntryRefCount(resourceID);
 
-		if (forceLoad)
-			LoadNow(resourceID, pListener);
-		else
-			QueueLoad(resourceID, true, pListener);
+		m_reloadLock.lock();
+		const uint32_t sequence = ++m_reloadSequences[resourceID];
+		m_reloadLock.unlock();
 
-		m_resourceLoaderLog.Trace("Reload Complete.");
+		if (forceLoad || !CanLoadOnJobSystem())
+		{
+			DecodeReload(resourceID, sequence, pListener);
+
+			// Otherwise it is swapped in by the next ProcessCompletions().
+			if (std::this_thread::get_id() == m_mainThreadID)
+				ApplyFinishedReloads();
+			return;
+		}
+
+		s_pGlobalJobSystem->PushJob([this, resourceID, sequence, pListener]()
+			{
+				DecodeReload(resourceID, sequence, pListener);
+			}, JobHandle(), &m_loadCounter, JobPriority::kBackground);
 	}
 
 	/// <summary>
@@ -390,6 +883,22 @@ namespace Exelius
 	/// <param name="forceLoad">- If true, the resource will be loaded on the calling thread if not already loaded.</param>
 	/// <returns>The resource with the given ResourceID. nullptr if not found and forceload == false, or if resource is still loading.</returns>
 	Resource* ResourceLoader::GetResource(const ResourceID& resourceID, bool forceLoad)
+	{
+		uint32_t slotIndex = 0;
+		uint32_t generation = 0;
+		return GetResource(resourceID, forceLoad, slotIndex, generation);
+	}
+
+	/// <summary>
+	/// Retrieve the given resource like GetResource(), along with the slot and
+	/// generation that ResourceHandle caches it by.
+	/// </summary>
+	/// <param name="resourceID">- The resource to retrieve.</param>
+	/// <param name="forceLoad">- If true, the resource will be loaded on the calling thread if not already loaded.</param>
+	/// <param name="slotIndex">- Receives the slot index of the resource's entry.</param>
+	/// <param name="generation">- Receives the slot's current generation.</param>
+	/// <returns>The resource with the given ResourceID. nullptr if not found and forceload == false, or if resource is still loading.</returns>
+	Resource* ResourceLoader::GetResource(const ResourceID& resourceID, bool forceLoad, uint32_t& slotIndex, uint32_t& generation)
 	{
 		EXE_ASSERT(resourceID.IsValid());
 
@@ -399,13 +908,13 @@ namespace Exelius
 			return nullptr;
 		}
 
-		Resource* pResource = m_resourceDatabase.GetEntryResource(resourceID);
+		Resource* pResource = m_resourceDatabase.GetEntryResource(resourceID, slotIndex, generation);
 
 		if (!pResource && forceLoad)
 		{
 			m_resourceLoaderLog.Info("Forcing Resource Creation and Retrieving.");
 			LoadNow(resourceID);
-			return GetResource(resourceID, false); // Should be guaranteed, but false will prevent infinite recursion.
+			return GetResource(resourceID, false, slotIndex, generation); // Should be guaranteed, but false will prevent infinite recursion.
 		}
 		else if (!pResource)
 		{
@@ -448,270 +957,701 @@ namespace Exelius
 		m_resourceLoaderLog.Trace("Unlocking Resource: {}", resourceID.Get().c_str());
 
 		// Decrement the reference count of this resource.
-		// If there is no longer any references to this resource, then unload it.
+		// If there is no longer any references to this resource, then cache or unload it.
 		if (m_resourceDatabase.DecrementEntryLockCount(resourceID))
-			m_resourceDatabase.UnloadEntry(resourceID);
+			m_resourceDatabase.ReleaseEntry(resourceID);
+	}
+
+	/// <summary>
+	/// Allows the resource system to switch between using raw and pack resources.
+	/// Raw assets are read from the working directory, which is mounted above
+	/// archives with the default priority. Must not be called while resources are loading.
+	/// </summary>
+	/// <param name="useRawAssets">- If true, the system will use raw assets, false will use packed resources.</param>
+	void ResourceLoader::SetUsingRawAssets(bool useRawAssets)
+	{
+		m_useRawAssets = useRawAssets;
+
+		if (!m_useRawAssets)
+		{
+			if (m_pRawAssetDirectory)
+				m_fileSystem.Unmount(m_pRawAssetDirectory);
+			m_pRawAssetDirectory = nullptr;
+			return;
+		}
+
+		if (m_pRawAssetDirectory)
+			return;
+
+		DirectoryArchive* pRawAssetDirectory = EXELIUS_NEW(DirectoryArchive());
+		pRawAssetDirectory->Open(".");
+		if (m_fileSystem.Mount(pRawAssetDirectory, "", s_kRawAssetPriority))
+			m_pRawAssetDirectory = pRawAssetDirectory;
+	}
+
+	/// <summary>
+	/// Opens an archive and mounts it, so resources can be loaded from it.
+	/// Directories are mounted as loose files, files ending in ".pak" are
+	/// opened as paks, and anything else as a zip. Of the archives with the
+	/// same priority, the most recently mounted is searched first.
+	/// </summary>
+	/// <param name="pArchivePath">- The path to the directory, pak or zip archive.</param>
+	/// <param name="pMountPoint">- The path prefix the archive's entries appear under. Empty for the root.</param>
+	/// <param name="priority">- Archives with higher priorities are searched first.</param>
+	/// <returns>True if the archive was opened and mounted, false otherwise.</returns>
+	bool ResourceLoader::MountArchive(const char* pArchivePath, const char* pMountPoint, int priority)
+	{
+		EXE_ASSERT(pArchivePath);
+		EXE_ASSERT(pMountPoint);
+		m_resourceLoaderLog.Info("Mounting Archive: {}", pArchivePath);
+
+		const eastl::string archivePath = pArchivePath;
+		Archive* pArchive = nullptr;
+		std::error_code errorCode;
+		if (std::filesystem::is_directory(pArchivePath, errorCode))
+			pArchive = EXELIUS_NEW(DirectoryArchive());
+		else if (archivePath.size() >= 4 && archivePath.compare(archivePath.size() - 4, 4, ".pak") == 0)
+			pArchive = EXELIUS_NEW(PakArchive());
+		else
+			pArchive = EXELIUS_NEW(ZipArchive());
+
+		if (!pArchive->Open(pArchivePath))
+		{
+			m_resourceLoaderLog.Warn("Failed to mount archive: {}", pArchivePath);
+			EXELIUS_DELETE(pArchive);
+			return false;
+		}
+
+		return m_fileSystem.Mount(pArchive, pMountPoint, priority);
 	}
 
 	/// <summary>
-	/// Signal the resource loader thread to wake up and begin
-	/// loading resources.
+	/// Closes every mounted archive, except raw assets. Must not be called while resources are loading.
 	/// </summary>
-	void ResourceLoader::SignalLoaderThread()
+	void ResourceLoader::UnmountArchives()
 	{
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-		EXE_ASSERT(m_loaderThread.joinable());
-		m_resourceLoaderLog.Trace("Signaling Loader Thread.");
+		m_fileSystem.UnmountAll();
+		m_pRawAssetDirectory = nullptr;
 
-		m_signalThread.notify_one();
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
+		// Raw assets are a setting rather than a mount, so they stay.
+		SetUsingRawAssets(m_useRawAssets);
 	}
 
 	/// <summary>
-	/// Signal the resource loader thread to wake up and begin
-	/// loading resources. Sleeps the calling thread until the
-	/// loader thread signals upon completion.
+	/// Checks if loads can run as jobs. Otherwise they run on the calling thread.
+	/// The thread that runs the frame never runs background jobs, so this needs
+	/// at least one other worker.
 	/// </summary>
-	void ResourceLoader::SignalAndWaitForLoaderThread()
+	/// <returns>True if loads should be pushed to the JobSystem.</returns>
+	bool ResourceLoader::CanLoadOnJobSystem() const
 	{
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-		SignalLoaderThread();
+		return s_pGlobalJobSystem && s_pGlobalJobSystem->IsRunning() && s_pGlobalJobSystem->GetWorkerCount() > 1;
+	}
 
-		std::mutex waitMutex;
-		std::unique_lock<std::mutex> waitLock(waitMutex);
+	/// <summary>
+	/// Start the load of a resource whose load has already been claimed.
+	/// It is handed to the I/O threads, or to a single background job that
+	/// reads and decodes it if there are none.
+	/// </summary>
+	/// <param name="resourceID">- The resource to load.</param>
+	void ResourceLoader::DispatchLoad(const ResourceID& resourceID)
+	{
+		m_resourceLoaderLog.Trace("Dispatching Load: {}", resourceID.Get().c_str());
 
-		m_resourceLoaderLog.Info("Waiting for response from LoaderThread.");
-		m_signalThread.wait(waitLock, [this]()
+		if (!m_ioThreads.empty())
 		{
-			return !m_quitThread || m_successfulThreadShutdown;
-		});
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
+			m_ioQueueLock.lock();
+			m_ioQueue.emplace_back(resourceID);
+			m_ioQueueLock.unlock();
+
+			m_ioSignal.notify_one();
+			return;
+		}
+
+		if (!CanLoadOnJobSystem())
+		{
+			LoadResource(resourceID);
+			return;
+		}
+
+		s_pGlobalJobSystem->PushJob([this, resourceID]()
+			{
+				LoadResource(resourceID);
+			}, JobHandle(), &m_loadCounter, JobPriority::kBackground);
 	}
 
 	/// <summary>
-	/// This is the instantiation function for the loader thread.
-	/// 
-	/// Double Buffered Resource Loading System:
-	/// 
-	/// The main thread will add resources and listners to a 
-	/// couple of queues to be loaded and called, respectively.
-	/// 
-	/// When signaled, the loader thread will swap the deferred
-	/// queues to be processed, allowing the main thread to continue
-	/// to queue resources and listeners.
-	/// 
-	/// After the swap, the loader thread will load any queued
-	/// resources from either raw asset files or a compressed
-	/// asset package. Once a resource is loaded, the listeners
-	/// attached to that resource will be called.
-	/// 
-	/// Once the loader thread has completed this process, it will
-	/// signal to the main thread that it has completed, and sleep
-	/// until the next signal to begin processing.
-	/// 
-	/// This thread will then have access to the following functions
-	/// and thus these functions should be used with this in mind:
-	///		ResourceLoader::LoadResource()
-	/// 	ResourceLoader::LoadRawData()
-	/// 	ResourceLoader::LoadFromDisk()
-	/// 	ResourceLoader::LoadFromZip()
-	/// 	ResourceDatabase::SetEntryLoadStatus()
-	///		ResourceDatabase::SetEntryResource()
-	///		ResourceDatabase::UnloadEntry()
-	///		ResourceEntry::SetResource()
-	/// 	ResourceEntry::SetStatus()
-	/// 	ResourceFactory::CreateResource()*
-	/// 	ResourceFactory::GetResourceType()*
-	/// 	ResourceListener::OnResourceLoaded()*
-	/// 	Resource::Load()*
-	/// 
-	/// *These can be inhereted from within client applications so
-	/// special care needs to be made here.
+	/// Queue every known dependency of a resource whose load has just been claimed,
+	/// so they are read alongside it. The resource's entry holds the references.
 	/// </summary>
-	void ResourceLoader::ProcessResourceQueue()
+	/// <param name="resourceID">- The resource being loaded.</param>
+	void ResourceLoader::PrefetchDependencies(const ResourceID& resourceID)
 	{
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-		m_resourceLoaderLog.Info("Instantiating Resource Loader Thread.");
-		std::mutex waitMutex;
+		const eastl::vector<ResourceID> dependencies = GetDependencies(resourceID);
+		for (const ResourceID& dependencyID : dependencies)
+		{
+			if (!QueueLoad(dependencyID, false))
+				continue;
 
-		// TODO: Consider if this is the best container to use here.
-		eastl::deque<ResourceID> processingQueue;
-		ListenersMap processingResourceListenersMap;
-		std::unique_lock<std::mutex> waitLock(waitMutex);
+			if (!m_resourceDatabase.AddEntryDependency(resourceID, dependencyID))
+				ReleaseResource(dependencyID);
+		}
+	}
 
-		// While the thread is still active (Not shut down)
-		while (!m_quitThread)
+	/// <summary>
+	/// Hand the raw data read by the I/O stage to a background decode job,
+	/// or decode it on the calling thread if there is no JobSystem to run it.
+	/// </summary>
+	/// <param name="resourceID">- The resource that was read.</param>
+	/// <param name="rawData">- The resource's raw data.</param>
+	void ResourceLoader::DispatchDecode(const ResourceID& resourceID, RawResourceData&& rawData)
+	{
+		if (!CanLoadOnJobSystem())
 		{
-			// Wait until we are signaled to work.
-			m_signalThread.wait(waitLock, [this]()
+			DecodeResource(resourceID, std::move(rawData));
+			return;
+		}
+
+		m_decodeQueueDepth.fetch_add(1, std::memory_order_relaxed);
+		s_pGlobalJobSystem->PushJob([this, resourceID, rawData = std::move(rawData)]() mutable
 			{
-				bool empty = true;
+				m_decodeQueueDepth.fetch_sub(1, std::memory_order_relaxed);
+				DecodeResource(resourceID, std::move(rawData));
+			}, JobHandle(), &m_loadCounter, JobPriority::kBackground);
+	}
 
-				m_deferredQueueLock.lock();
-				empty = m_deferredQueue.empty();
-				m_deferredQueueLock.unlock();
+	/// <summary>
+	/// Removes a resource from the deferred queue or the I/O queue, if it is waiting in either.
+	/// </summary>
+	/// <param name="resourceID">- The resource to remove.</param>
+	/// <returns>True if the resource was queued and has been removed.</returns>
+	bool ResourceLoader::RemoveFromQueuedLoads(const ResourceID& resourceID)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_deferredQueueLock);
 
-				return m_quitThread || !empty;
-			});
+			auto found = eastl::find(m_deferredQueue.begin(), m_deferredQueue.end(), resourceID);
+			if (found != m_deferredQueue.end())
+			{
+				m_deferredQueue.erase(found);
+				return true;
+			}
+		}
 
-			m_resourceLoaderLog.Trace("Loader Thread Received Signal");
+		std::lock_guard<std::mutex> lock(m_ioQueueLock);
 
-			// Don't do any work if we're exiting.
-			if (m_quitThread)
-				break;
+		auto found = eastl::find(m_ioQueue.begin(), m_ioQueue.end(), resourceID);
+		if (found == m_ioQueue.end())
+			return false;
 
-			/// Capture the deferred queue into the processing queue (swap buffers)
-			m_deferredQueueLock.lock();
-			processingQueue.swap(m_deferredQueue);
-			m_deferredQueueLock.unlock();
+		m_ioQueue.erase(found);
+		return true;
+	}
 
-			m_listenerMapLock.lock();
-			processingResourceListenersMap.swap(m_deferredResourceListenersMap);
-			m_listenerMapLock.unlock();
+	/// <summary>
+	/// Runs on each I/O thread. Reads batches of queued resources while the
+	/// byte budget allows, and hands each one to the decode stage.
+	/// </summary>
+	void ResourceLoader::IOThread()
+	{
+		if (s_pGlobalJobSystem)
+			s_pGlobalJobSystem->EnterReservedThread(ReservedThread::kResourceIO);
 
-			// Process the queue
-			while (!processingQueue.empty())
-			{
-				m_resourceLoaderLog.Trace("Loader Thread Loading: {}", processingQueue.front().Get().c_str());
-				LoadResource(processingQueue.front());
+		AsyncFileReader fileReader;
+		if (m_definition.m_useIOUring && fileReader.Initialize(m_definition.m_ioBatchSize))
+			m_resourceLoaderLog.Info("Resource I/O thread is reading with io_uring.");
 
-				// Notify all the listeners that we are done loading.
-				for (auto& listener : processingResourceListenersMap[processingQueue.front()])
+		const size_t maxBatchSize = eastl::max(m_definition.m_ioBatchSize, 1u);
+		eastl::vector<ResourceID> batch;
+		eastl::vector<RawResourceData> rawData;
+
+		std::unique_lock<std::mutex> lock(m_ioQueueLock);
+		while (true)
+		{
+			// Don't start another batch until the decode stage has made room in the budget.
+			// Only the batches already being read can take the bytes in flight past it.
+			m_ioSignal.wait(lock, [this]()
 				{
-					if (listener.expired())
-						continue;
+					if (m_quitIOThreads)
+						return true;
 
-					listener.lock()->OnResourceLoaded(processingQueue.front());
-				}
-				processingResourceListenersMap[processingQueue.front()].clear();
+					if (m_ioQueue.empty())
+						return false;
+
+					return m_definition.m_maxBytesInFlight == 0 || m_bytesInFlight.load(std::memory_order_acquire) < m_definition.m_maxBytesInFlight;
+				});
+
+			if (m_quitIOThreads)
+				break;
+
+			while (!m_ioQueue.empty() && batch.size() < maxBatchSize)
+			{
+				batch.push_back(m_ioQueue.front());
+				m_ioQueue.pop_front();
+			}
+			lock.unlock();
 
-				m_resourceLoaderLog.Trace("Loader Thread Loading Complete.");
-				processingQueue.pop_front();
+			ReadResources(fileReader, batch, rawData);
+			for (size_t i = 0; i < batch.size(); ++i)
+			{
+				DispatchDecode(batch[i], std::move(rawData[i]));
 			}
 
-			// Done loading this pass, so signal the main thread in case it is waiting.
-			m_signalThread.notify_one();
-			m_resourceLoaderLog.Trace("Signaled Main Thread: Queue Finished");
+			batch.clear();
+			rawData.clear();
+
+			lock.lock();
+		}
+	}
+
+	/// <summary>
+	/// Publish the result of a load and notify everyone waiting on it.
+	/// </summary>
+	/// <param name="resourceID">- The resource that finished loading.</param>
+	/// <param name="status">- kLoaded on success, kUnloaded on failure.</param>
+	void ResourceLoader::FinishLoad(const ResourceID& resourceID, ResourceLoadStatus status)
+	{
+		ResourceListeners listeners;
+
+		m_listenerMapLock.lock();
+		m_resourceDatabase.SetEntryLoadStatus(resourceID, status);
+		auto found = m_pendingListenersMap.find(resourceID);
+		if (found != m_pendingListenersMap.end())
+		{
+			listeners.swap(found->second);
+			m_pendingListenersMap.erase(found);
 		}
+		m_listenerMapLock.unlock();
 
-		// Let the main thread know we are fully exiting in case they are waiting.
-		m_successfulThreadShutdown = true;
-		m_resourceLoaderLog.Info("Signaled Main Thread: Thread Terminating.");
-		m_signalThread.notify_one();
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
+		// Notify all the listeners that we are done loading. Off the main thread, this only posts them.
+		for (auto& listener : listeners)
+		{
+			NotifyListener(resourceID, listener);
+		}
 	}
 
 	/// <summary>
-	/// Load the given resource. Upon failure, ResourceDatabase::UnloadEntry
-	/// will be called, removing the entry from the database.
+	/// Read and decode the given resource on the calling thread.
 	/// </summary>
 	/// <param name="resourceID">- The resource to load.</param>
 	void ResourceLoader::LoadResource(const ResourceID& resourceID)
 	{
-		EXE_ASSERT(resourceID.IsValid());
-		m_resourceLoaderLog.Trace("Loading Resource Internally: {}", resourceID.Get().c_str());
+		DecodeResource(resourceID, ReadResource(resourceID));
+	}
 
-		// TODO:
-		//	Remove use of vector maybe?
-		eastl::vector<std::byte> rawData = LoadRawData(resourceID);
+	/// <summary>
+	/// The I/O stage. Reads the raw data of a resource and counts it against the byte budget.
+	/// </summary>
+	/// <param name="resourceID">- The resource to read.</param>
+	/// <returns>The loaded raw data. It will be empty on failure.</returns>
+	ResourceLoader::RawResourceData ResourceLoader::ReadResource(const ResourceID& resourceID)
+	{
+		const auto readStartTime = eastl::chrono::steady_clock::now();
 
-		if (rawData.empty())
-		{
-			m_resourceLoaderLog.Warn("Raw file data was empty.");
+		RawResourceData rawData = LoadRawData(resourceID);
 
-			// TODO:
-			//	This may present an issue with this resource having references to it.
+		const auto readTime = eastl::chrono::duration_cast<eastl::chrono::nanoseconds>(eastl::chrono::steady_clock::now() - readStartTime);
 
-			m_resourceDatabase.UnloadEntry(resourceID);
-			return;
-		}
+		const size_t rawDataSize = rawData.GetSize();
+		m_bytesInFlight.fetch_add(rawDataSize, std::memory_order_acq_rel);
+		m_totalBytesRead.fetch_add(rawDataSize, std::memory_order_relaxed);
+		m_totalResourcesRead.fetch_add(1, std::memory_order_relaxed);
+		m_totalReadNanoseconds.fetch_add(static_cast<uint64_t>(readTime.count()), std::memory_order_relaxed);
 
-		Resource* pResource = m_pResourceFactory->CreateResource(resourceID);
-		if (!pResource)
+		return rawData;
+	}
+
+	/// <summary>
+	/// The I/O stage for a batch. Reads the raw data of every resource together and counts it against the byte budget.
+	/// </summary>
+	/// <param name="fileReader">- The calling I/O thread's reader.</param>
+	/// <param name="resourceIDs">- The resources to read.</param>
+	/// <param name="rawData">- Receives the raw data of each resource, in the same order. Empty on failure.</param>
+	void ResourceLoader::ReadResources(AsyncFileReader& fileReader, const eastl::vector<ResourceID>& resourceIDs, eastl::vector<RawResourceData>& rawData)
+	{
+		const auto readStartTime = eastl::chrono::steady_clock::now();
+
+		LoadRawDataBatch(fileReader, resourceIDs, rawData);
+
+		const auto readTime = eastl::chrono::duration_cast<eastl::chrono::nanoseconds>(eastl::chrono::steady_clock::now() - readStartTime);
+
+		size_t rawDataSize = 0;
+		for (const auto& data : rawData)
 		{
-			m_resourceLoaderLog.Warn("Failed to create resource from resource factory.");
-			m_resourceDatabase.UnloadEntry(resourceID);
-			return;
+			rawDataSize += data.GetSize();
 		}
 
-		if (pResource->Load(std::move(rawData)) != Resource::LoadResult::kFailed)
+		m_bytesInFlight.fetch_add(rawDataSize, std::memory_order_acq_rel);
+		m_totalBytesRead.fetch_add(rawDataSize, std::memory_order_relaxed);
+		m_totalResourcesRead.fetch_add(resourceIDs.size(), std::memory_order_relaxed);
+		m_totalReadNanoseconds.fetch_add(static_cast<uint64_t>(readTime.count()), std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// Creates a resource through the factory and loads it from its raw data.
+	/// Mapped data is handed to the resource as a view, and unmapped once it has loaded.
+	/// </summary>
+	/// <param name="resourceID">- The resource to create.</param>
+	/// <param name="rawData">- The raw data to load it from. Its buffer is moved into the resource if it isn't mapped.</param>
+	/// <returns>The loaded resource, or nullptr if it could not be created or loaded.</returns>
+	Resource* ResourceLoader::CreateResourceFromRawData(const ResourceID& resourceID, RawResourceData& rawData)
+	{
+		Resource* pResource = nullptr;
+		if (rawData.GetSize() == 0)
 		{
-			m_resourceDatabase.SetEntryResource(resourceID, pResource);
+			m_resourceLoaderLog.Warn("Raw file data was empty.");
 		}
 		else
 		{
-			m_resourceLoaderLog.Warn("Failed to load resource from raw data.");
+			pResource = m_pResourceFactory->CreateResource(resourceID);
+			if (!pResource)
+			{
+				m_resourceLoaderLog.Warn("Failed to create resource from resource factory.");
+			}
+			else if ((rawData.IsMapped() ? pResource->Load(rawData.GetBytes()) : pResource->Load(std::move(rawData.m_buffer))) == Resource::LoadResult::kFailed)
+			{
+				m_resourceLoaderLog.Warn("Failed to load resource from raw data.");
+				delete pResource;
+				pResource = nullptr;
+			}
+		}
+
+		rawData.m_mappedFile.Close();
+		return pResource;
+	}
+
+	/// <summary>
+	/// The decode stage. Creates the resource from its raw data, releases the data's bytes from
+	/// the budget, then notifies its listeners. Mapped data is handed to the resource as a view.
+	/// Upon failure, ResourceDatabase::UnloadEntry will be called, removing the entry from the database.
+	/// </summary>
+	/// <param name="resourceID">- The resource to decode.</param>
+	/// <param name="rawData">- The raw data read by ReadResource().</param>
+	void ResourceLoader::DecodeResource(const ResourceID& resourceID, RawResourceData&& rawData)
+	{
+		EXE_ASSERT(resourceID.IsValid());
+		m_resourceLoaderLog.Trace("Loading Resource Internally: {}", resourceID.Get().c_str());
+
+		const auto decodeStartTime = eastl::chrono::steady_clock::now();
+		const size_t rawDataSize = rawData.GetSize();
+
+		// The resource has copied anything it needs, so the file is unmapped before its bytes are released.
+		Resource* pResource = CreateResourceFromRawData(resourceID, rawData);
+
+		const auto decodeTime = eastl::chrono::duration_cast<eastl::chrono::nanoseconds>(eastl::chrono::steady_clock::now() - decodeStartTime);
+		m_totalResourcesDecoded.fetch_add(1, std::memory_order_relaxed);
+		m_totalDecodeNanoseconds.fetch_add(static_cast<uint64_t>(decodeTime.count()), std::memory_order_relaxed);
+
+		// Release the bytes, taking the lock so an I/O thread can't check the budget and then miss the wake up.
+		m_ioQueueLock.lock();
+		m_bytesInFlight.fetch_sub(rawDataSize, std::memory_order_acq_rel);
+		m_ioQueueLock.unlock();
+		m_ioSignal.notify_all();
+
+		if (!pResource)
+		{
+			// TODO:
+			//	This may present an issue with this resource having references to it.
+			FinishLoad(resourceID, ResourceLoadStatus::kUnloaded);
 			m_resourceDatabase.UnloadEntry(resourceID);
 			return;
 		}
 
-		m_resourceDatabase.SetEntryLoadStatus(resourceID, ResourceLoadStatus::kLoaded);
+		// Resources that don't report their size count the size of their raw data against the cache.
+		const size_t memorySize = pResource->GetMemorySize() ? pResource->GetMemorySize() : rawDataSize;
+		m_resourceDatabase.SetEntryResource(resourceID, pResource, m_pResourceFactory->GetResourceType(resourceID), memorySize);
+		FinishLoad(resourceID, ResourceLoadStatus::kLoaded);
+
+		// Everyone may have let go while we were loading.
+		if (!m_resourceDatabase.IsEntryHeld(resourceID))
+			m_resourceDatabase.ReleaseEntry(resourceID);
 
 		m_resourceLoaderLog.Trace("Completed Loading Internally.");
 	}
 
 	/// <summary>
-	/// Selector that chooses to load the raw data of an asset
-	/// from the filesystem or from a compressed package.
+	/// Loads a new version of a loaded resource, and queues it to be swapped in by the
+	/// main thread. Releases the references the reload holds if the new version fails to load.
 	/// </summary>
-	/// <param name="resourceID">- The resource to load.</param>
-	/// <returns>The loaded raw data in a vector of bytes. The vector will be empty on failure.</returns>
-	eastl::vector<std::byte> ResourceLoader::LoadRawData(const ResourceID& resourceID)
+	/// <param name="resourceID">- The resource to reload.</param>
+	/// <param name="sequence">- Which reload of the resource this is.</param>
+	/// <param name="pListener">- The listener to be notified once the new version is in use.</param>
+	void ResourceLoader::DecodeReload(const ResourceID& resourceID, uint32_t sequence, ResourceListenerPtr pListener)
 	{
-		EXE_ASSERT(resourceID.IsValid());
-		m_resourceLoaderLog.Trace("Loading Resource Raw Data: {}", resourceID.Get().c_str());
+		m_resourceLoaderLog.Trace("Reloading Resource Internally: {}", resourceID.Get().c_str());
+
+		RawResourceData rawData = LoadRawData(resourceID);
+		const size_t rawDataSize = rawData.GetSize();
+
+		// Collect the dependencies the new version acquires while it loads. Restored after, in case this runs nested in another reload.
+		eastl::vector<ResourceID> dependencies;
+		const ResourceID* pPreviousReloadID = s_pThreadReloadID;
+		eastl::vector<ResourceID>* pPreviousReloadDependencies = s_pThreadReloadDependencies;
+		s_pThreadReloadID = &resourceID;
+		s_pThreadReloadDependencies = &dependencies;
 
-		if (m_useRawAssets)
+		Resource* pResource = CreateResourceFromRawData(resourceID, rawData);
+
+		s_pThreadReloadID = pPreviousReloadID;
+		s_pThreadReloadDependencies = pPreviousReloadDependencies;
+
+		if (!pResource)
 		{
-			return LoadFromDisk(resourceID);
+			m_resourceLoaderLog.Warn("Failed to reload resource '{}', keeping the old version.", resourceID.Get().c_str());
+			for (const ResourceID& dependencyID : dependencies)
+			{
+				ReleaseResource(dependencyID);
+			}
+			ReleaseResource(resourceID);
+			return;
 		}
-		else
+
+		FinishedReload finishedReload;
+		finishedReload.m_resourceID = resourceID;
+		finishedReload.m_sequence = sequence;
+		finishedReload.m_pResource = pResource;
+		finishedReload.m_memorySize = pResource->GetMemorySize() ? pResource->GetMemorySize() : rawDataSize;
+		finishedReload.m_pListener = pListener;
+		finishedReload.m_dependencies = eastl::move(dependencies);
+
+		std::lock_guard<std::mutex> lock(m_reloadLock);
+		m_finishedReloads.emplace_back(eastl::move(finishedReload));
+	}
+
+	/// <summary>
+	/// Swaps the decoded reloads into their entries, retiring the old versions,
+	/// and releases the references the reloads held. The new version's dependencies
+	/// replace the old version's, so the ones it no longer uses are released and
+	/// dropped from the dependency graph. Main thread only.
+	/// </summary>
+	void ResourceLoader::ApplyFinishedReloads()
+	{
+		eastl::vector<FinishedReload> finishedReloads;
+		m_reloadLock.lock();
+		finishedReloads.swap(m_finishedReloads);
+		m_reloadLock.unlock();
+
+		for (FinishedReload& finishedReload : finishedReloads)
 		{
-			return LoadFromZip(resourceID);
+			const ResourceID& resourceID = finishedReload.m_resourceID;
+
+			m_reloadLock.lock();
+			const bool isLatest = (m_reloadSequences[resourceID] == finishedReload.m_sequence);
+			m_reloadLock.unlock();
+
+			if (!isLatest)
+			{
+				// A newer reload was started while this one was decoding.
+				m_resourceLoaderLog.Trace("Dropping outdated reload of '{}'.", resourceID.Get().c_str());
+				m_resourceDatabase.RetireResource(finishedReload.m_pResource);
+			}
+			else
+			{
+				const eastl::vector<ResourceID> newDependencies = finishedReload.m_dependencies;
+				Resource* pRetiredResource = m_resourceDatabase.SwapEntryResource(resourceID, finishedReload.m_pResource, finishedReload.m_memorySize, finishedReload.m_dependencies);
+				m_resourceDatabase.RetireResource(pRetiredResource);
+
+				if (pRetiredResource != finishedReload.m_pResource)
+				{
+					// The swap handed back the old version's dependencies, so the graph follows the new version.
+					m_dependencyGraphLock.lock();
+					eastl::vector<ResourceID>& graphDependencies = m_dependencyGraph[resourceID];
+					for (const ResourceID& dependencyID : finishedReload.m_dependencies)
+					{
+						if (eastl::find(newDependencies.begin(), newDependencies.end(), dependencyID) == newDependencies.end())
+						{
+							m_resourceLoaderLog.Trace("'{}' no longer depends on '{}'.", resourceID.Get().c_str(), dependencyID.Get().c_str());
+							graphDependencies.erase(eastl::remove(graphDependencies.begin(), graphDependencies.end(), dependencyID), graphDependencies.end());
+						}
+					}
+					for (const ResourceID& dependencyID : newDependencies)
+					{
+						if (eastl::find(graphDependencies.begin(), graphDependencies.end(), dependencyID) == graphDependencies.end())
+							graphDependencies.emplace_back(dependencyID);
+					}
+					if (graphDependencies.empty())
+						m_dependencyGraph.erase(resourceID);
+					m_dependencyGraphLock.unlock();
+
+					m_resourceLoaderLog.Info("Reloaded Resource '{}'", resourceID.Get().c_str());
+					NotifyListener(resourceID, finishedReload.m_pListener);
+				}
+			}
+
+			// Either the old version's dependencies, or ones the new version never got to hold.
+			for (const ResourceID& dependencyID : finishedReload.m_dependencies)
+			{
+				ReleaseResource(dependencyID);
+			}
+			ReleaseResource(resourceID);
 		}
 	}
 
 	/// <summary>
-	/// Load the given resource directly from the filesystem.
+	/// Finds the mount with the highest priority that has the resource,
+	/// and loads the raw data of the resource from it.
 	/// </summary>
 	/// <param name="resourceID">- The resource to load.</param>
-	/// <returns>The loaded raw data in a vector of bytes. The vector will be empty on failure.</returns>
-	eastl::vector<std::byte> ResourceLoader::LoadFromDisk(const ResourceID& resourceID)
+	/// <returns>The loaded raw data. It will be empty on failure.</returns>
+	ResourceLoader::RawResourceData ResourceLoader::LoadRawData(const ResourceID& resourceID)
 	{
 		EXE_ASSERT(resourceID.IsValid());
-		eastl::string strPath = resourceID.Get();
+		m_resourceLoaderLog.Trace("Loading Resource Raw Data: {}", resourceID.Get().c_str());
 
-		File resourceFile;
-		if (!resourceFile.Open(strPath, File::AccessPermission::kReadOnly, File::CreationType::kOpenFile))
+		VirtualFileSystem::FileLocation location;
+		if (!m_fileSystem.FindFile(resourceID.Get(), location))
 		{
-			m_resourceLoaderLog.Warn("Failed to open file: {}", strPath.c_str());
-			return eastl::vector<std::byte>();
+			m_resourceLoaderLog.Warn("Resource not found in any mount: {}", resourceID.Get().c_str());
+			return RawResourceData();
 		}
 
-		eastl::vector<std::byte> resourceData(resourceFile.GetSize());
-		size_t readBytes = resourceFile.Read(resourceData);
+		return LoadFromArchive(location);
+	}
 
-		if (readBytes != resourceFile.GetSize())
+	/// <summary>
+	/// Like LoadRawData(), for a batch. Small loose files are read together with the
+	/// reader, and large ones are mapped. Archive entries are read one at a time.
+	/// </summary>
+	/// <param name="fileReader">- The calling I/O thread's reader.</param>
+	/// <param name="resourceIDs">- The resources to load.</param>
+	/// <param name="rawData">- Receives the raw data of each resource, in the same order. Empty on failure.</param>
+	void ResourceLoader::LoadRawDataBatch(AsyncFileReader& fileReader, const eastl::vector<ResourceID>& resourceIDs, eastl::vector<RawResourceData>& rawData)
+	{
+		rawData.clear();
+		rawData.resize(resourceIDs.size());
+
+		// Loose files are read by the reader. The request's index in the batch is kept alongside it.
+		eastl::vector<VirtualFileSystem::FileLocation> locations(resourceIDs.size());
+		eastl::vector<AsyncFileReader::ReadRequest> requests;
+		eastl::vector<size_t> requestIndices;
+		for (size_t i = 0; i < resourceIDs.size(); ++i)
 		{
-			m_resourceLoaderLog.Warn("Failed to read '{}'. Read {} of {} bytes.", strPath.c_str(), readBytes, resourceFile.GetSize());
-			return eastl::vector<std::byte>();
+			EXE_ASSERT(resourceIDs[i].IsValid());
+			m_resourceLoaderLog.Trace("Loading Resource Raw Data: {}", resourceIDs[i].Get().c_str());
+
+			if (!m_fileSystem.FindFile(resourceIDs[i].Get(), locations[i]))
+			{
+				m_resourceLoaderLog.Warn("Resource not found in any mount: {}", resourceIDs[i].Get().c_str());
+				continue;
+			}
+
+			AsyncFileReader::ReadRequest request;
+			if (!locations[i].m_pArchive->GetFilePath(locations[i].m_entryPath, request.m_filePath))
+			{
+				rawData[i] = LoadFromArchive(locations[i]);
+				continue;
+			}
+
+			String::ToFilepath(request.m_filePath);
+			requests.emplace_back(std::move(request));
+			requestIndices.emplace_back(i);
 		}
 
+		if (requests.empty())
+			return;
+
+		// Copying a large file costs more than mapping it, so those are only sized here.
+		fileReader.ReadFiles(requests.data(), requests.size(), s_kMinMappedFileSize - 1);
+
+		for (size_t requestIndex = 0; requestIndex < requests.size(); ++requestIndex)
+		{
+			const size_t i = requestIndices[requestIndex];
+			switch (requests[requestIndex].m_result)
+			{
+				case AsyncFileReader::ReadResult::kRead:
+				{
+					rawData[i].m_buffer = std::move(requests[requestIndex].m_data);
+					break;
+				}
+				case AsyncFileReader::ReadResult::kTooLarge:
+				{
+					if (!locations[i].m_pArchive->MapEntry(locations[i].m_entryPath, rawData[i].m_mappedFile))
+						m_resourceLoaderLog.Warn("Failed to map file: {}", requests[requestIndex].m_filePath.c_str());
+					break;
+				}
+				case AsyncFileReader::ReadResult::kFailed:
+				{
+					m_resourceLoaderLog.Warn("Failed to read file: {}", requests[requestIndex].m_filePath.c_str());
+					break;
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// Load a resource from the archive it was found in. Loose files are mapped, and
+	/// uncompressed entries are viewed in place when the archive is mapped. Anything
+	/// else is read into a buffer. Safe to call from multiple threads at once.
+	/// </summary>
+	/// <param name="location">- Where the resource was found.</param>
+	/// <returns>The loaded raw data. It will be empty on failure.</returns>
+	ResourceLoader::RawResourceData ResourceLoader::LoadFromArchive(const VirtualFileSystem::FileLocation& location)
+	{
+		EXE_ASSERT(location.m_pArchive);
+
+		RawResourceData resourceData;
+		if (location.m_pArchive->MapEntry(location.m_entryPath, resourceData.m_mappedFile))
+			return resourceData;
+
+		if (location.m_pArchive->GetEntryView(location.m_entryPath, resourceData.m_archiveView))
+			return resourceData;
+
+		if (!location.m_pArchive->ReadEntry(location.m_entryPath, resourceData.m_buffer))
+			m_resourceLoaderLog.Warn("Failed to read '{}' from archive: {}", location.m_entryPath.c_str(), location.m_pArchive->GetArchivePath().c_str());
+
 		return resourceData;
 	}
 
 	/// <summary>
-	/// Load the given resource directly from a compressed file.
-	/// @todo
-	/// Currently unused.
+	/// Orders resources by where they will be read from: by mount and offset
+	/// within it, then by path. Duplicates are removed.
 	/// </summary>
-	/// <param name="resourceID">- The resource to load.</param>
-	/// <returns>The loaded raw data in a vector of bytes. The vector will be empty on failure.</returns>
-	eastl::vector<std::byte> ResourceLoader::LoadFromZip(const ResourceID& resourceID)
+	/// <param name="resourceIDs">- The resources to sort.</param>
+	void ResourceLoader::SortForLocality(eastl::vector<ResourceID>& resourceIDs) const
 	{
-		eastl::string strPath = resourceID.Get();
-		// TODO: Do this.
+		struct ReadLocation
+		{
+			size_t m_archiveIndex;
+			uint64_t m_offset;
+			ResourceID m_resourceID;
+		};
+
+		// Anything no mount has sorts after the rest by path alone.
+		eastl::vector<ReadLocation> readLocations;
+		readLocations.reserve(resourceIDs.size());
+		VirtualFileSystem::FileLocation location;
+		for (const ResourceID& resourceID : resourceIDs)
+		{
+			ReadLocation readLocation;
+			readLocation.m_archiveIndex = static_cast<size_t>(-1);
+			readLocation.m_offset = 0;
+			readLocation.m_resourceID = resourceID;
+
+			// The same lookup as LoadRawData(), which caches it for the load.
+			if (m_fileSystem.FindFile(resourceID.Get(), location))
+			{
+				readLocation.m_archiveIndex = location.m_mountIndex;
+				location.m_pArchive->GetEntryOffset(location.m_entryPath, readLocation.m_offset);
+			}
 
-		return eastl::vector<std::byte>();
+			readLocations.emplace_back(readLocation);
+		}
+
+		eastl::sort(readLocations.begin(), readLocations.end(), [](const ReadLocation& left, const ReadLocation& right)
+			{
+				if (left.m_archiveIndex != right.m_archiveIndex)
+					return left.m_archiveIndex < right.m_archiveIndex;
+				if (left.m_offset != right.m_offset)
+					return left.m_offset < right.m_offset;
+				return left.m_resourceID.Get() < right.m_resourceID.Get();
+			});
+
+		// Equal IDs sort next to each other, so only the first of each is kept.
+		resourceIDs.clear();
+		for (const ReadLocation& readLocation : readLocations)
+		{
+			if (resourceIDs.empty() || resourceIDs.back() != readLocation.m_resourceID)
+				resourceIDs.emplace_back(readLocation.m_resourceID);
+		}
 	}
 }
\ No newline at end of file
@@ -2,34 +2,188 @@
 #include "source/utility/generic/Singleton.h"
 #include "source/resource/ResourceDatabase.h"
 #include "source/debug/Log.h"
+#include "source/os/threads/JobSystem.h"
+#include "source/utility/io/FileWatcher.h"
+#include "source/utility/io/MappedFile.h"
+#include "source/utility/io/VirtualFileSystem.h"
+#include "source/utility/containers/RingBuffer.h"
 
 #include <EASTL/deque.h>
+#include <EASTL/shared_ptr.h>
 #include <EASTL/vector.h>
 
-#define FORCE_SINGLE_THREADED_RESOURCE_LOADER 1
-
-#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-	#include <thread>
-	#include <condition_variable>
-	#include <atomic>
-	#include <mutex>
-#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
-
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 /// <summary>
 /// Engine namespace. Everything owned by the engine will be inside this namespace.
 /// </summary>
 namespace Exelius
 {
+	class AsyncFileReader;
 	class ResourceFactory;
 	class ResourceListener;
+	class ResourceLoadGroup;
 	using ResourceListenerPtr = eastl::weak_ptr<ResourceListener>; // "Forward Declaring" ResourceListenerPtr from ResourceListener.h
 
+	/// <summary>
+	/// The data necessary to set up the loading pipeline. Read from the "ResourceLoader" section of the config file.
+	/// </summary>
+	struct ResourceLoaderDefinition
+	{
+		/// <summary>
+		/// The number of threads that read resources for the decode jobs.
+		/// 0 reads and decodes each resource in a single job instead.
+		/// </summary>
+		uint32_t m_ioThreadCount;
+
+		/// <summary>
+		/// The number of bytes that may be read but not yet decoded. The I/O threads stop
+		/// starting reads while the budget is used up, so it can only be passed by the reads
+		/// already in progress. 0 means no limit.
+		/// </summary>
+		size_t m_maxBytesInFlight;
+
+		/// <summary>
+		/// The most queued resources an I/O thread takes at once. Raw assets in a batch are
+		/// opened and read together.
+		/// </summary>
+		uint32_t m_ioBatchSize;
+
+		/// <summary>
+		/// Should batches be read with io_uring, where the platform and kernel support it.
+		/// Otherwise each file in a batch is read in turn with positional reads.
+		/// </summary>
+		bool m_useIOUring;
+
+		/// <summary>
+		/// The bytes of released resources each type may keep loaded, unless it
+		/// has its own budget in m_cacheBudgets. 0 unloads them as soon as they are released.
+		/// </summary>
+		size_t m_defaultCacheBudget;
+
+		/// <summary>
+		/// The cache budgets of specific resource types, keyed by type.
+		/// </summary>
+		eastl::unordered_map<ResourceType::Type, size_t> m_cacheBudgets;
+
+		/// <summary>
+		/// The time the main thread may spend each frame notifying listeners of loads that
+		/// finished on other threads. The rest wait for the next frame. 0 means no limit.
+		/// </summary>
+		uint32_t m_completionBudgetMicroseconds;
+
+		/// <summary>
+		/// The path containing the client app specific resources, watched for changes when hot reloading.
+		/// </summary>
+		eastl::string m_clientResourcePath;
+
+		/// <summary>
+		/// Should changed raw assets under the client resource path be reloaded while running.
+		/// </summary>
+		bool m_hotReload;
+
+		/// <summary>
+		/// How long a changed file must be left alone before it is reloaded, so a file
+		/// written in several steps is only reloaded once.
+		/// </summary>
+		uint32_t m_hotReloadDebounceMilliseconds;
+
+		/// <summary>
+		/// Construct the definition with reasonable default values.
+		/// </summary>
+		ResourceLoaderDefinition()
+			: m_ioThreadCount(2)
+			, m_maxBytesInFlight(64 * 1024 * 1024)
+			, m_ioBatchSize(32)
+			, m_useIOUring(true)
+			, m_defaultCacheBudget(16 * 1024 * 1024)
+			, m_completionBudgetMicroseconds(2000)
+			, m_hotReload(false)
+			, m_hotReloadDebounceMilliseconds(100)
+		{
+			//
+		}
+	};
+
+	/// <summary>
+	/// A snapshot of the loading pipeline, from ResourceLoader::GetPipelineStats().
+	/// The totals only ever grow, so the difference between two snapshots
+	/// gives the throughput over that time.
+	/// </summary>
+	struct ResourcePipelineStats
+	{
+		/// <summary>
+		/// Resources waiting for an I/O thread.
+		/// </summary>
+		size_t m_ioQueueDepth;
+
+		/// <summary>
+		/// Resources that have been read, waiting for a decode job to start.
+		/// </summary>
+		size_t m_decodeQueueDepth;
+
+		/// <summary>
+		/// Bytes that have been read but not yet decoded.
+		/// </summary>
+		size_t m_bytesInFlight;
+
+		/// <summary>
+		/// Listener notifications waiting for the main thread.
+		/// </summary>
+		size_t m_completionQueueDepth;
+
+		uint64_t m_totalBytesRead;
+		uint64_t m_totalResourcesRead;
+		uint64_t m_totalResourcesDecoded;
+
+		/// <summary>
+		/// Time spent reading and decoding, summed over every thread.
+		/// </summary>
+		uint64_t m_totalReadNanoseconds;
+		uint64_t m_totalDecodeNanoseconds;
+
+		/// <summary>
+		/// Bytes read per second of time spent reading.
+		/// </summary>
+		double GetReadThroughput() const { return m_totalReadNanoseconds ? (m_totalBytesRead * 1e9) / m_totalReadNanoseconds : 0.0; }
+
+		/// <summary>
+		/// Resources decoded per second of time spent decoding.
+		/// </summary>
+		double GetDecodeThroughput() const { return m_totalDecodeNanoseconds ? (m_totalResourcesDecoded * 1e9) / m_totalDecodeNanoseconds : 0.0; }
+	};
+
 	/// <summary>
 	/// Loading of resources is managed by this class. Resources can
-	/// be loaded in the main thread or on a separate dedicated thread.
+	/// be loaded on the calling thread, or queued to load in the background,
+	/// so many resources load at once. Without a running JobSystem or I/O
+	/// threads every load happens on the calling thread.
+	/// 
+	/// Queued loads run as a two stage pipeline. A few dedicated I/O threads
+	/// read the raw data, then hand it to a background job on the JobSystem
+	/// that decodes it, so the disk keeps reading while the workers decode.
+	/// The bytes waiting between the stages are capped by a budget, and
+	/// GetPipelineStats() reports the depth and throughput of each stage.
+	/// 
+	/// Resources that are no longer referenced stay loaded in a cache while
+	/// their type is within its budget, so acquiring them again is free.
+	/// GetCacheStats() reports how often that happens.
+	/// 
+	/// Resources that use other resources record them as dependencies, which
+	/// keeps them loaded for as long as the dependent resource is. The edges
+	/// are remembered, so the next load of a resource reads its dependencies
+	/// at the same time instead of after it has been decoded. Manifests list
+	/// those edges up front, and LoadManifest() loads a whole set at once.
+	/// LoadMany() does the same for any list of resources, reading them in
+	/// the order they sit on disk, behind a single ResourceLoadGroup.
+	/// @see ResourceManifest
 	/// 
-	/// The threaded loading is implemented via a Double Buffered System.
+	/// The first request for a resource claims its load in the
+	/// ResourceDatabase. Any request that arrives while it is loading
+	/// only adds its listener, so each resource is loaded exactly once.
 	/// 
 	/// The resource loader then calls on the resource factory to
 	/// create the specific type of resources based on criteria defined
@@ -50,23 +204,36 @@ namespace Exelius
 	/// lifetime.
 	/// @see ResourceHandle
 	/// 
+	/// Listeners are only ever notified on the main thread, since most of
+	/// them touch state that isn't thread safe. Loads that finish on other
+	/// threads post their notifications to a lock free completion queue,
+	/// which ProcessCompletions() drains once per frame within a time budget,
+	/// so a burst of expensive completions is spread over several frames.
+	/// Listeners that are thread safe opt out with IsThreadSafe().
+	/// 
+	/// Resources are read through a VirtualFileSystem. Loose directories,
+	/// zips and paks are mounted with MountArchive(), and searched by
+	/// priority so patches and mods override what they replace. When
+	/// using raw assets, the working directory is mounted as well. Loose
+	/// files and uncompressed pak entries are mapped, and decoded in
+	/// place without being copied.
+	/// @see VirtualFileSystem
+	/// 
+	/// Reloading a resource decodes a new version while the old one stays
+	/// in use. The new version replaces it on the main thread, and handles
+	/// pick it up through the slot generation. With hot reload enabled, a
+	/// FileWatcher reports changed raw assets, and each one is reloaded
+	/// along with every loaded resource that depends on it.
+	/// @see FileWatcher
+	/// 
 	/// @todo
 	/// The resource loader needs some additional functionality:
-	/// 1) The ability to load assets from a compressed file
-	/// is not functional.
-	/// 2) The use of engine and client resources is not in
+	/// 1) The use of engine and client resources is not in
 	/// use.
-	/// 3) The engine should be able to determine whether or
+	/// 2) The engine should be able to determine whether or
 	/// not to load from a zip automatically via the data provided
 	/// by the config file.
-	/// 4) The resource loader does not make use of the
-	/// config file currently.
-	/// 5) The resource loader should be capable of being
-	/// forced into single threaded mode.
-	/// 6) The resource loader should allow for hot-reloading
-	/// of assets in some form, whether that is automatic or manual.
-	/// This could also be a user setting as well.
-	/// 7) The loader should allow multiple listeners of a resource
+	/// 3) The loader should allow multiple listeners of a resource
 	/// to be passed in to a single resource load call.
 	/// </summary>
 	class ResourceLoader
@@ -83,66 +250,145 @@ namespace Exelius
 		/// </summary>
 		using ListenersMap = eastl::unordered_map<ResourceID, ResourceListeners>;
 
+		/// <summary>
+		/// The raw data of a resource, passed from the I/O stage to the decode stage.
+		/// Raw assets are memory mapped, so their bytes are never copied. Uncompressed
+		/// pak entries are viewed in the pak's mapping, which stays mapped until the
+		/// archives are unmounted. Other archive entries have to be inflated, so they
+		/// are read into the buffer instead.
+		/// </summary>
+		struct RawResourceData
+		{
+			MappedFile m_mappedFile;
+			eastl::span<const std::byte> m_archiveView;
+			eastl::vector<std::byte> m_buffer;
+
+			/// <summary>
+			/// True if the bytes belong to a mapping, and have to be loaded from a view.
+			/// </summary>
+			bool IsMapped() const { return m_mappedFile.IsOpen() || !m_archiveView.empty(); }
+
+			eastl::span<const std::byte> GetBytes() const
+			{
+				if (m_mappedFile.IsOpen())
+					return m_mappedFile.GetBytes();
+				if (!m_archiveView.empty())
+					return m_archiveView;
+				return eastl::span<const std::byte>(m_buffer.data(), m_buffer.size());
+			}
+
+			size_t GetSize() const { return GetBytes().size(); }
+		};
+
+		/// <summary>
+		/// A listener notification waiting for the main thread.
+		/// </summary>
+		struct ResourceCompletion
+		{
+			ResourceID m_resourceID;
+			ResourceListenerPtr m_pListener;
+		};
+
+		/// <summary>
+		/// A new version of a resource that has been decoded, waiting for the main thread to swap it in.
+		/// </summary>
+		struct FinishedReload
+		{
+			ResourceID m_resourceID;
+
+			/// <summary>
+			/// Which reload of the resource this is. Only the latest one is swapped in.
+			/// </summary>
+			uint32_t m_sequence;
+
+			Resource* m_pResource;
+			size_t m_memorySize;
+			ResourceListenerPtr m_pListener;
+
+			/// <summary>
+			/// The dependencies the new version acquired. The reload holds a reference to each.
+			/// </summary>
+			eastl::vector<ResourceID> m_dependencies;
+		};
+
+		/// <summary>
+		/// Raw assets in a batch at least this large are mapped instead of read into a buffer.
+		/// </summary>
+		static constexpr size_t s_kMinMappedFileSize = 256 * 1024;
+
+		/// <summary>
+		/// Notifications that fit in the lock free completion queue. More than this spill
+		/// into the overflow queue until the main thread catches up.
+		/// </summary>
+		static constexpr size_t s_kCompletionQueueSize = 1024;
+
 		/// <summary>
 		/// ResourceLoader Log.
 		/// </summary>
 		Log m_resourceLoaderLog;
 
 		/// <summary>
-		/// A map of listeners keyed by resource ID, allowing multiple listeners
-		/// to listen for a single resource being loaded.
+		/// The listeners waiting on resources that are currently loading,
+		/// keyed by resource ID.
 		/// </summary>
-		ListenersMap m_deferredResourceListenersMap;
+		ListenersMap m_pendingListenersMap;
 
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 		/// <summary>
-		/// A mutex used to protect the listeners from data race conditions.
-		/// This allows the main thread and resource thread to swap maps
-		/// safely.
+		/// Guards the pending listeners. Also held while a load finishes, so a
+		/// listener is never added to a load that has already notified.
 		/// </summary>
 		std::mutex m_listenerMapLock;
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 
 		/// <summary>
-		/// The resource factory as defined by either the Engine or the Client.
-		/// @see Application
+		/// Listener notifications posted by other threads, drained by ProcessCompletions().
 		/// </summary>
-		ResourceFactory* m_pResourceFactory;
+		RingBufferMPMC<ResourceCompletion, s_kCompletionQueueSize> m_completionQueue;
 
-		#if !FORCE_SINGLE_THREADED_RESOURCE_LOADER
 		/// <summary>
-		/// The dedicated resource loading thread.
+		/// Notifications posted while the completion queue was full.
 		/// </summary>
-		std::thread m_loaderThread;
+		eastl::deque<ResourceCompletion> m_completionOverflow;
 
 		/// <summary>
-		/// To shutdown the loader thread or continue operations.
-		/// The thread will shutdown if this is true.
+		/// Guards the completion overflow.
 		/// </summary>
-		std::atomic_bool m_quitThread;
+		std::mutex m_completionOverflowLock;
 
 		/// <summary>
-		/// The loader thread will set this to true on successfully
-		/// shutting down. This prevents a deadlock in the case
-		/// that the thread shuts down prior to the main thread
-		/// signaling and waiting for the shutdown to complete.
+		/// Notifications in the completion queue and its overflow.
 		/// </summary>
-		std::atomic_bool m_successfulThreadShutdown;
+		std::atomic<size_t> m_completionQueueDepth;
 
 		/// <summary>
-		/// Signal for when the resource queue needs to be processed
-		/// or to signal the main thread that the resource thread has
-		/// completed processing.
+		/// The thread that called Initialize(), and the only one listeners are notified on.
 		/// </summary>
-		std::condition_variable m_signalThread;
+		std::thread::id m_mainThreadID;
 
 		/// <summary>
-		/// A mutex used to protect the queue from data race conditions.
-		/// This allows the main thread and resource thread to swap queues
-		/// safely.
+		/// The latest reload started of each resource, so a slow reload can't replace a newer one.
 		/// </summary>
-		std::mutex m_deferredQueueLock;
-		#endif // !FORCE_SINGLE_THREADED_RESOURCE_LOADER
+		eastl::unordered_map<ResourceID, uint32_t> m_reloadSequences;
+
+		/// <summary>
+		/// Reloads that have been decoded, swapped in by ProcessCompletions().
+		/// </summary>
+		eastl::vector<FinishedReload> m_finishedReloads;
+
+		/// <summary>
+		/// Guards the reload sequences and the finished reloads.
+		/// </summary>
+		std::mutex m_reloadLock;
+
+		/// <summary>
+		/// Watches the client resource path when hot reloading.
+		/// </summary>
+		FileWatcher m_fileWatcher;
+
+		/// <summary>
+		/// The resource factory as defined by either the Engine or the Client.
+		/// @see Application
+		/// </summary>
+		ResourceFactory* m_pResourceFactory;
 
 		/// <summary>
 		/// The resource database containing all the managed resources.
@@ -154,14 +400,70 @@ namespace Exelius
 		ResourceDatabase m_resourceDatabase;
 
 		/// <summary>
-		/// The queue containing the resources to be loaded.
-		/// This will be swapped safely onto the resource
-		/// thread.
-		/// @todo
-		/// Consider whether or not this is the best container
-		/// to use here.
+		/// The resources each resource is known to depend on, keyed by the dependent resource.
+		/// Filled by manifests and by resources acquiring their dependencies as they load.
+		/// </summary>
+		eastl::unordered_map<ResourceID, eastl::vector<ResourceID>> m_dependencyGraph;
+
+		/// <summary>
+		/// A mutex used to protect the dependency graph from data race conditions.
+		/// </summary>
+		std::mutex m_dependencyGraphLock;
+
+		/// <summary>
+		/// Resources whose loads have been claimed, but that were queued
+		/// without being dispatched yet. Dispatched by DispatchQueuedLoads().
 		/// </summary>
-		eastl::deque<ResourceID> m_deferredQueue;
+		eastl::vector<ResourceID> m_deferredQueue;
+
+		/// <summary>
+		/// A mutex used to protect the deferred queue from data race conditions.
+		/// </summary>
+		std::mutex m_deferredQueueLock;
+
+		/// <summary>
+		/// Counts the load jobs that have not finished.
+		/// </summary>
+		JobCounter m_loadCounter;
+
+		/// <summary>
+		/// The I/O thread count and byte budget.
+		/// </summary>
+		ResourceLoaderDefinition m_definition;
+
+		/// <summary>
+		/// Resources that have been dispatched, waiting for an I/O thread to read them.
+		/// </summary>
+		eastl::deque<ResourceID> m_ioQueue;
+
+		/// <summary>
+		/// Guards the I/O queue and m_quitIOThreads.
+		/// </summary>
+		std::mutex m_ioQueueLock;
+
+		/// <summary>
+		/// Wakes the I/O threads when a resource is queued, bytes are released or they should quit.
+		/// </summary>
+		std::condition_variable m_ioSignal;
+
+		eastl::vector<std::thread> m_ioThreads;
+		bool m_quitIOThreads;
+
+		/// <summary>
+		/// Bytes read by the I/O stage that the decode stage has not released yet.
+		/// </summary>
+		std::atomic<size_t> m_bytesInFlight;
+
+		/// <summary>
+		/// Decode jobs that have been pushed but have not started.
+		/// </summary>
+		std::atomic<size_t> m_decodeQueueDepth;
+
+		std::atomic<uint64_t> m_totalBytesRead;
+		std::atomic<uint64_t> m_totalResourcesRead;
+		std::atomic<uint64_t> m_totalResourcesDecoded;
+		std::atomic<uint64_t> m_totalReadNanoseconds;
+		std::atomic<uint64_t> m_totalDecodeNanoseconds;
 
 		/// <summary>
 		/// The path containing the engine specific resources,
@@ -173,9 +475,8 @@ namespace Exelius
 
 		/// <summary>
 		/// The path containing the client app specific resources,
-		/// for example: A tilemap for a game.
-		/// @todo
-		/// Currently unused.
+		/// for example: A tilemap for a game. Watched for changes
+		/// when hot reloading.
 		/// </summary>
 		eastl::string m_clientResourcePath;
 
@@ -185,6 +486,23 @@ namespace Exelius
 		/// </summary>
 		bool m_useRawAssets;
 
+		/// <summary>
+		/// Every archive resources are loaded from, and the working
+		/// directory when using raw assets.
+		/// </summary>
+		VirtualFileSystem m_fileSystem;
+
+		/// <summary>
+		/// The working directory's mount, while using raw assets. Owned by the file system.
+		/// </summary>
+		Archive* m_pRawAssetDirectory;
+
+		/// <summary>
+		/// The priority raw assets are mounted with. Above archives mounted with the
+		/// default priority, so loose files being worked on win over packed copies.
+		/// </summary>
+		static constexpr int s_kRawAssetPriority = 100;
+
 	public:
 		/// <summary>
 		/// Constructor default initializes member data.
@@ -197,14 +515,14 @@ namespace Exelius
 
 		/// <summary>
 		/// Destructor handles the safe shutdown and destruction of
-		/// resources and the resource thread.
+		/// resources and waits for any loads still running.
 		/// </summary>
 		~ResourceLoader();
 
 		/// <summary>
 		/// Initialization sets the resource factory given by the application,
 		/// sets the path to the engine and client resources, determines the
-		/// way resources are retrieved and spins up the resource thread.
+		/// way resources are retrieved and clears any queued loads.
 		/// The data provided for this function is retrieved from the config
 		/// file in, and this function is called from, the Application.
 		/// @see Application
@@ -215,8 +533,16 @@ namespace Exelius
 		/// <param name="pResourceFactory">- The desired resource factory to be used when creating resources.</param>
 		/// <param name="pEngineResourcePath">- The path that the resource loader will look to load engine assets.</param>
 		/// <param name="useRawAssets">- Whether or not the engine will be loading assets from a compressed file.</param>
+		/// <param name="definition">- The I/O thread count and byte budget of the loading pipeline.</param>
 		/// <returns>True if initialization was successful, false otherwise.</returns>
-		bool Initialize(ResourceFactory* pResourceFactory, const char* pEngineResourcePath = nullptr, bool useRawAssets = false);
+		bool Initialize(ResourceFactory* pResourceFactory, const char* pEngineResourcePath = nullptr, bool useRawAssets = false, const ResourceLoaderDefinition& definition = ResourceLoaderDefinition());
+
+		/// <summary>
+		/// Stops and joins the I/O threads, dropping any resources they have not started reading.
+		/// Must be called before the JobSystem shuts down, since the I/O threads push decode jobs.
+		/// Called by the destructor if it hasn't been already.
+		/// </summary>
+		void StopIOThreads();
 
 		/// <summary>
 		/// Process any resources that have been marked for removal.
@@ -229,15 +555,44 @@ namespace Exelius
 		void ProcessUnloadQueue();
 
 		/// <summary>
-		/// Queue the resource to be loaded. This will defer the load to
-		/// the resource thread if running in multithreaded mode. If a
-		/// resource is already being loaded then the resource listener
-		/// will be added to the list of listeners to be notified and
-		/// nothing further will happen. If the resource is loaded already
-		/// then the listener will be notified immediately.
+		/// Notifies listeners of loads that finished on other threads, oldest first,
+		/// until the frame's completion budget runs out. At least
+		/// one is notified each call, so the queue always makes progress. This
+		/// happens once per frame and should not be called by the client.
+		/// 
 		/// @todo
-		/// Potential data race here, if the listener is added just after
-		/// the loader thread proccesses the listener queue.
+		/// See if there is a way to limit accessibility to this function.
+		/// </summary>
+		void ProcessCompletions();
+
+		/// <summary>
+		/// Reloads the resources whose files the FileWatcher reports as changed, along with
+		/// every loaded resource that depends on them. Only loaded resources are reloaded.
+		/// This happens once per frame when hot reloading, and should not be called by the client.
+		/// 
+		/// @todo
+		/// See if there is a way to limit accessibility to this function.
+		/// </summary>
+		void ProcessFileChanges();
+
+		/// <summary>
+		/// Notifies a listener that a resource has loaded. On the main thread, or if
+		/// the listener is thread safe, it is notified now. Otherwise the notification
+		/// is posted to the completion queue for ProcessCompletions().
+		/// Thread Safe.
+		/// </summary>
+		/// <param name="resourceID">- The resource that finished loading.</param>
+		/// <param name="pListener">- The listener to notify.</param>
+		void NotifyListener(const ResourceID& resourceID, ResourceListenerPtr pListener);
+
+		/// <summary>
+		/// Acquire a reference to the resource and queue it to be loaded
+		/// as a background job. If a resource is already being loaded then
+		/// the resource listener will be added to the list of listeners to
+		/// be notified and nothing further will happen. If the resource is
+		/// loaded already then the listener will be notified immediately.
+		/// If it is still unloading on another thread, this waits for the
+		/// unload to finish and then queues it again.
 		/// 
 		/// The loading time of a resource is not predictable, and thus
 		/// the use of the ResourceListener class is highly reccomended
@@ -249,24 +604,42 @@ namespace Exelius
 		/// so that multiple listeners can be notified of a resource being loaded.
 		/// </summary>
 		/// <param name="resourceID">- The filepath of the resource to load. This is a StringIntern for optimization.</param>
-		/// <param name="signalLoaderThread">- True if the loader thread should be signaled to begin loading. Does nothing in single threaded mode.</param>
+		/// <param name="signalLoaderThread">- True to start loading right away. Otherwise the load waits for the next DispatchQueuedLoads().</param>
 		/// <param name="pListener">- The listener to be notified when a resource has completed the load process.</param>
-		void QueueLoad(const ResourceID& resourceID, bool signalLoaderThread = false, ResourceListenerPtr pListener = ResourceListenerPtr());
+		/// <returns>True once a reference was taken and the listener will be notified.</returns>
+		bool QueueLoad(const ResourceID& resourceID, bool signalLoaderThread = false, ResourceListenerPtr pListener = ResourceListenerPtr());
 
 		/// <summary>
-		/// Load the given resource immediately. This will happen on the
-		/// calling thread and will be blocking on that thread until the
-		/// resource has completed the load process. If a resource is
-		/// already being loaded then the resource listener will be added
-		/// to the list of listeners to be notified and nothing further
-		/// will happen. If the resource is loaded already then the
-		/// listener will be notified immediately.
-		/// @todo
-		/// Potential data race here, if the listener is added just after
-		/// the loader thread proccesses the listener queue.
-		/// @todo
-		/// A resource that is already queued should be removed from the
-		/// queue and forceloaded here.
+		/// Start loading every resource that was queued without signaling.
+		/// This happens once per frame, and can be called any time to start early.
+		/// </summary>
+		void DispatchQueuedLoads();
+
+		/// <summary>
+		/// Takes a snapshot of the loading pipeline's queue depths and totals.
+		/// The values are read one at a time, so they may be slightly out of step with each other.
+		/// </summary>
+		/// <returns>The current pipeline stats.</returns>
+		ResourcePipelineStats GetPipelineStats();
+
+		/// <summary>
+		/// Takes a snapshot of the resource cache's hit, miss and eviction counters.
+		/// </summary>
+		/// <returns>The current cache stats.</returns>
+		ResourceCacheStats GetCacheStats() const;
+
+		/// <summary>
+		/// Acquire a reference to the resource and load it immediately.
+		/// This will happen on the calling thread and will be blocking on
+		/// that thread until the resource has completed the load process.
+		/// A resource that was queued but not yet dispatched is taken out
+		/// of the queue and loaded here. If the resource is already being
+		/// loaded by a job, this waits for that job, helping with other
+		/// jobs in the meantime. The listener is notified before returning,
+		/// unless another thread finished the load, in which case it is notified
+		/// by ProcessCompletions().
+		/// If it is still unloading on another thread, this waits for the
+		/// unload to finish and then loads it again.
 		/// 
 		/// The loading time of a resource is not predictable, and thus
 		/// the use of the ResourceListener class is highly recomended
@@ -279,7 +652,73 @@ namespace Exelius
 		/// </summary>
 		/// <param name="resourceID">- The filepath of the resource to load. This is a StringIntern for optimization</param>
 		/// <param name="pListener">- The listener to be notified when a resource has completed the load process.</param>
-		void LoadNow(const ResourceID& resourceID, ResourceListenerPtr pListener = ResourceListenerPtr());
+		/// <returns>True once a reference was taken and the listener was notified.</returns>
+		bool LoadNow(const ResourceID& resourceID, ResourceListenerPtr pListener = ResourceListenerPtr());
+
+		/// <summary>
+		/// Queues many resources to load together as background jobs, in the
+		/// order they sit on disk so reads stay close together. Duplicate IDs
+		/// are only loaded once.
+		/// 
+		/// The returned group holds a reference to each resource until it is
+		/// released or destroyed, and reports how many have finished or failed. The listener
+		/// is notified once, with the group's ID, when all of them have. The group
+		/// can also be polled, or waited on.
+		/// @see ResourceLoadGroup
+		/// </summary>
+		/// <param name="resourceIDs">- The filepaths of the resources to load.</param>
+		/// <param name="pListener">- The listener to be notified when every resource has completed the load process.</param>
+		/// <param name="groupID">- The ID passed to the listener, to tell groups apart.</param>
+		/// <returns>The group tracking the resources.</returns>
+		eastl::shared_ptr<ResourceLoadGroup> LoadMany(const eastl::vector<ResourceID>& resourceIDs, ResourceListenerPtr pListener = ResourceListenerPtr(), const ResourceID& groupID = ResourceID());
+
+		/// <summary>
+		/// Reads a manifest and queues every resource it lists, along with every
+		/// dependency known for them, to load together as background jobs. The
+		/// dependency edges in the manifest are added to the dependency graph.
+		/// 
+		/// The returned group holds a reference to each resource until it is
+		/// released or destroyed, and reports how many have finished or failed. The listener
+		/// is notified once, with the manifest's ID, when all of them have.
+		/// </summary>
+		/// <param name="manifestID">- The filepath of the manifest.</param>
+		/// <param name="pListener">- The listener to be notified when every resource has completed the load process.</param>
+		/// <returns>The group tracking the resources, or nullptr if the manifest could not be read.</returns>
+		eastl::shared_ptr<ResourceLoadGroup> LoadManifest(const ResourceID& manifestID, ResourceListenerPtr pListener = ResourceListenerPtr());
+
+		/// <summary>
+		/// Adds an edge to the dependency graph, so whenever the resource is loaded
+		/// the dependency is loaded alongside it. Dependencies must not form a cycle,
+		/// or the resources in it will keep each other loaded.
+		/// </summary>
+		/// <param name="resourceID">- The dependent resource.</param>
+		/// <param name="dependencyID">- The resource it depends on.</param>
+		void RegisterDependency(const ResourceID& resourceID, const ResourceID& dependencyID);
+
+		/// <summary>
+		/// Called by a resource while it loads, for another resource it uses.
+		/// Records the edge, and queues the dependency if it wasn't already loaded
+		/// alongside. The dependent resource holds a reference to the dependency
+		/// until it is unloaded, or reloaded into a version that no longer uses it.
+		/// </summary>
+		/// <param name="resourceID">- The dependent resource, which must be loading.</param>
+		/// <param name="dependencyID">- The resource it depends on.</param>
+		void AcquireDependency(const ResourceID& resourceID, const ResourceID& dependencyID);
+
+		/// <summary>
+		/// Get the known dependencies of a resource.
+		/// </summary>
+		/// <param name="resourceID">- The dependent resource.</param>
+		/// <returns>The resources it depends on.</returns>
+		eastl::vector<ResourceID> GetDependencies(const ResourceID& resourceID);
+
+		/// <summary>
+		/// Get the current load status of a resource.
+		/// Thread Safe.
+		/// </summary>
+		/// <param name="resourceID">- The resource to check.</param>
+		/// <returns>The resource's load status, or kInvalid if it has no entry.</returns>
+		ResourceLoadStatus GetResourceLoadStatus(const ResourceID& resourceID);
 
 		/// <summary>
 		/// Checks the load status of a resource. If it is loading or loaded
@@ -298,22 +737,23 @@ namespace Exelius
 		/// <summary>
 		/// Decrements the reference count on the given resource.
 		/// If there are no longer any references or locks on the
-		/// given resource it will be unloaded when the unload queue
+		/// given resource it is kept in the cache if its type has
+		/// room, otherwise it will be unloaded when the unload queue
 		/// is processed next.
 		/// </summary>
 		/// <param name="resourceID">- The resource to release.</param>
 		void ReleaseResource(const ResourceID& resourceID);
 
 		/// <summary>
-		/// If a resource is already loaded it will be unloaded and
-		/// loaded again. Otherwise it will be loaded as normal.
-		/// 
-		/// @todo
-		/// This function probably won't work and needs a bit of TLC.
+		/// If a resource is already loaded, a new version of it is loaded
+		/// while the old one stays in use. The new version replaces it on the
+		/// main thread once it has been decoded, and the old one is unloaded
+		/// with the unload queue. If the new version fails to load, the old one
+		/// is kept. Otherwise the resource will be loaded as normal.
 		/// </summary>
 		/// <param name="resourceID">- The resource to reload.</param>
-		/// <param name="forceLoad">- If true, the resource will load immediately on the calling thread. Otherwise it will load when the loader thread does so.</param>
-		/// <param name="pListener">- The listener to be notified of load completion.</param>
+		/// <param name="forceLoad">- If true, the resource will load immediately on the calling thread. Otherwise it will load as a background job.</param>
+		/// <param name="pListener">- The listener to be notified once the new version is in use.</param>
 		void ReloadResource(const ResourceID& resourceID, bool forceLoad = false, ResourceListenerPtr pListener = ResourceListenerPtr());
 
 		/// <summary>
@@ -326,6 +766,27 @@ namespace Exelius
 		/// <returns>The resource with the given ResourceID. nullptr if not found and forceload == false, or if resource is still loading.</returns>
 		Resource* GetResource(const ResourceID& resourceID, bool forceLoad = false);
 
+		/// <summary>
+		/// Retrieve the given resource like GetResource(), along with the slot and
+		/// generation that ResourceHandle caches it by.
+		/// @see ResourceDatabase::IsSlotCurrent
+		/// </summary>
+		/// <param name="resourceID">- The resource to retrieve.</param>
+		/// <param name="forceLoad">- If true, the resource will be loaded on the calling thread if not already loaded.</param>
+		/// <param name="slotIndex">- Receives the slot index of the resource's entry.</param>
+		/// <param name="generation">- Receives the slot's current generation.</param>
+		/// <returns>The resource with the given ResourceID. nullptr if not found and forceload == false, or if resource is still loading.</returns>
+		Resource* GetResource(const ResourceID& resourceID, bool forceLoad, uint32_t& slotIndex, uint32_t& generation);
+
+		/// <summary>
+		/// Lock Free.
+		/// Checks if a resource read by GetResource() is still current.
+		/// </summary>
+		/// <param name="slotIndex">- The slot index read with the resource.</param>
+		/// <param name="generation">- The generation read with the resource.</param>
+		/// <returns>True if the resource is still current, false otherwise.</returns>
+		bool IsResourceSlotCurrent(uint32_t slotIndex, uint32_t generation) const { return m_resourceDatabase.IsSlotCurrent(slotIndex, generation); }
+
 		/// <summary>
 		/// Increments the lock count of the given resource.
 		/// This prevents a resource from being unloaded automatically.
@@ -351,9 +812,34 @@ namespace Exelius
 
 		/// <summary>
 		/// Allows the resource system to switch between using raw and pack resources.
+		/// Raw assets are read from the working directory, which is mounted above
+		/// archives with the default priority. Must not be called while resources are loading.
 		/// </summary>
 		/// <param name="useRawAssets">- If true, the system will use raw assets, false will use packed resources.</param>
-		void SetUsingRawAssets(bool useRawAssets) { m_useRawAssets = useRawAssets; }
+		void SetUsingRawAssets(bool useRawAssets);
+
+		/// <summary>
+		/// Opens an archive and mounts it, so resources can be loaded from it.
+		/// Directories are mounted as loose files, files ending in ".pak" are
+		/// opened as paks, and anything else as a zip. Of the archives with the
+		/// same priority, the most recently mounted is searched first.
+		/// </summary>
+		/// <param name="pArchivePath">- The path to the directory, pak or zip archive.</param>
+		/// <param name="pMountPoint">- The path prefix the archive's entries appear under. Empty for the root.</param>
+		/// <param name="priority">- Archives with higher priorities are searched first.</param>
+		/// <returns>True if the archive was opened and mounted, false otherwise.</returns>
+		bool MountArchive(const char* pArchivePath, const char* pMountPoint = "", int priority = 0);
+
+		/// <summary>
+		/// Closes every mounted archive, except raw assets. Must not be called while resources are loading.
+		/// </summary>
+		void UnmountArchives();
+
+		/// <summary>
+		/// The file system resources are read from, for mounting other archives
+		/// and listing the files that can be loaded.
+		/// </summary>
+		VirtualFileSystem& GetFileSystem() { return m_fileSystem; }
 
 		/// <summary>
 		/// Retrieve the path the system is using to load engine specific resources.
@@ -375,89 +861,154 @@ namespace Exelius
 
 	private:
 		/// <summary>
-		/// Signal the resource loader thread to wake up and begin
-		/// loading resources.
+		/// Checks if loads can run as jobs. Otherwise they run on the calling thread.
+		/// The thread that runs the frame never runs background jobs, so this needs
+		/// at least one other worker.
 		/// </summary>
-		void SignalLoaderThread();
+		/// <returns>True if loads should be pushed to the JobSystem.</returns>
+		bool CanLoadOnJobSystem() const;
 
 		/// <summary>
-		/// Signal the resource loader thread to wake up and begin
-		/// loading resources. Sleeps the calling thread until the
-		/// loader thread signals upon completion.
+		/// Takes a reference to a resource and claims its load if nobody else has,
+		/// adding the listener in the same step so a load finishing on another thread
+		/// can't miss it. A resource that is still unloading on another thread is
+		/// waited for and then acquired again, so a load never fails for timing alone.
 		/// </summary>
-		void SignalAndWaitForLoaderThread();
+		/// <param name="resourceID">- The resource to acquire.</param>
+		/// <param name="pListener">- The listener to add if the resource isn't loaded yet.</param>
+		/// <returns>The status of the entry before it was acquired. ResourceLoadStatus::kInvalid means the caller must load it.</returns>
+		ResourceLoadStatus AcquireForLoad(const ResourceID& resourceID, const ResourceListenerPtr& pListener);
 
 		/// <summary>
-		/// This is the instantiation function for the loader thread.
-		/// 
-		/// Double Buffered Resource Loading System:
-		/// 
-		/// The main thread will add resources and listners to a 
-		/// couple of queues to be loaded and called, respectively.
-		/// 
-		/// When signaled, the loader thread will swap the deferred
-		/// queues to be processed, allowing the main thread to continue
-		/// to queue resources and listeners.
-		/// 
-		/// After the swap, the loader thread will load any queued
-		/// resources from either raw asset files or a compressed
-		/// asset package. Once a resource is loaded, the listeners
-		/// attached to that resource will be called.
-		/// 
-		/// Once the loader thread has completed this process, it will
-		/// signal to the main thread that it has completed, and sleep
-		/// until the next signal to begin processing.
-		/// 
-		/// This thread will then have access to the following functions
-		/// and thus these functions should be used with this in mind:
-		///		ResourceLoader::LoadResource()
-		/// 	ResourceLoader::LoadRawData()
-		/// 	ResourceLoader::LoadFromDisk()
-		/// 	ResourceLoader::LoadFromZip()
-		/// 	ResourceDatabase::SetEntryLoadStatus()
-		///		ResourceDatabase::SetEntryResource()
-		///		ResourceDatabase::UnloadEntry()
-		///		ResourceEntry::SetResource()
-		/// 	ResourceEntry::SetStatus()
-		/// 	ResourceFactory::CreateResource()*
-		/// 	ResourceFactory::GetResourceType()*
-		/// 	ResourceListener::OnResourceLoaded()*
-		/// 	Resource::Load()*
-		/// 
-		/// *These can be inhereted from within client applications so
-		/// special care needs to be made here.
+		/// Start the load of a resource whose load has already been claimed.
+		/// It is handed to the I/O threads, or to a single background job that
+		/// reads and decodes it if there are none.
+		/// </summary>
+		/// <param name="resourceID">- The resource to load.</param>
+		void DispatchLoad(const ResourceID& resourceID);
+
+		/// <summary>
+		/// Queue every known dependency of a resource whose load has just been claimed,
+		/// so they are read alongside it. The resource's entry holds the references.
+		/// </summary>
+		/// <param name="resourceID">- The resource being loaded.</param>
+		void PrefetchDependencies(const ResourceID& resourceID);
+
+		/// <summary>
+		/// Hand the raw data read by the I/O stage to a background decode job,
+		/// or decode it on the calling thread if there is no JobSystem to run it.
+		/// </summary>
+		/// <param name="resourceID">- The resource that was read.</param>
+		/// <param name="rawData">- The resource's raw data.</param>
+		void DispatchDecode(const ResourceID& resourceID, RawResourceData&& rawData);
+
+		/// <summary>
+		/// Removes a resource from the deferred queue or the I/O queue, if it is waiting in either.
+		/// </summary>
+		/// <param name="resourceID">- The resource to remove.</param>
+		/// <returns>True if the resource was queued and has been removed.</returns>
+		bool RemoveFromQueuedLoads(const ResourceID& resourceID);
+
+		/// <summary>
+		/// Runs on each I/O thread. Reads batches of queued resources while the
+		/// byte budget allows, and hands each one to the decode stage.
 		/// </summary>
-		void ProcessResourceQueue();
+		void IOThread();
 
 		/// <summary>
-		/// Load the given resource. Upon failure, ResourceDatabase::UnloadEntry
-		/// will be called, removing the entry from the database.
+		/// Publish the result of a load and notify everyone waiting on it.
+		/// </summary>
+		/// <param name="resourceID">- The resource that finished loading.</param>
+		/// <param name="status">- kLoaded on success, kUnloaded on failure.</param>
+		void FinishLoad(const ResourceID& resourceID, ResourceLoadStatus status);
+
+		/// <summary>
+		/// Read and decode the given resource on the calling thread.
 		/// </summary>
 		/// <param name="resourceID">- The resource to load.</param>
 		void LoadResource(const ResourceID& resourceID);
 
 		/// <summary>
-		/// Selector that chooses to load the raw data of an asset
-		/// from the filesystem or from a compressed package.
+		/// The I/O stage. Reads the raw data of a resource and counts it against the byte budget.
 		/// </summary>
-		/// <param name="resourceID">- The resource to load.</param>
-		/// <returns>The loaded raw data in a vector of bytes. The vector will be empty on failure.</returns>
-		eastl::vector<std::byte> LoadRawData(const ResourceID& resourceID);
+		/// <param name="resourceID">- The resource to read.</param>
+		/// <returns>The loaded raw data. It will be empty on failure.</returns>
+		RawResourceData ReadResource(const ResourceID& resourceID);
 
 		/// <summary>
-		/// Load the given resource directly from the filesystem.
+		/// The I/O stage for a batch. Reads the raw data of every resource together and counts it against the byte budget.
 		/// </summary>
-		/// <param name="resourceID">- The resource to load.</param>
-		/// <returns>The loaded raw data in a vector of bytes. The vector will be empty on failure.</returns>
-		eastl::vector<std::byte> LoadFromDisk(const ResourceID& resourceID);
+		/// <param name="fileReader">- The calling I/O thread's reader.</param>
+		/// <param name="resourceIDs">- The resources to read.</param>
+		/// <param name="rawData">- Receives the raw data of each resource, in the same order. Empty on failure.</param>
+		void ReadResources(AsyncFileReader& fileReader, const eastl::vector<ResourceID>& resourceIDs, eastl::vector<RawResourceData>& rawData);
 
 		/// <summary>
-		/// Load the given resource directly from a compressed file.
-		/// @todo
-		/// Currently unused.
+		/// Creates a resource through the factory and loads it from its raw data.
+		/// Mapped data is handed to the resource as a view, and unmapped once it has loaded.
+		/// </summary>
+		/// <param name="resourceID">- The resource to create.</param>
+		/// <param name="rawData">- The raw data to load it from. Its buffer is moved into the resource if it isn't mapped.</param>
+		/// <returns>The loaded resource, or nullptr if it could not be created or loaded.</returns>
+		Resource* CreateResourceFromRawData(const ResourceID& resourceID, RawResourceData& rawData);
+
+		/// <summary>
+		/// The decode stage. Creates the resource from its raw data, releases the data's bytes from
+		/// the budget, then notifies its listeners. Mapped data is handed to the resource as a view.
+		/// Upon failure, ResourceDatabase::UnloadEntry will be called, removing the entry from the database.
+		/// </summary>
+		/// <param name="resourceID">- The resource to decode.</param>
+		/// <param name="rawData">- The raw data read by ReadResource().</param>
+		void DecodeResource(const ResourceID& resourceID, RawResourceData&& rawData);
+
+		/// <summary>
+		/// Loads a new version of a loaded resource, and queues it to be swapped in by the
+		/// main thread. Releases the references the reload holds if the new version fails to load.
+		/// </summary>
+		/// <param name="resourceID">- The resource to reload.</param>
+		/// <param name="sequence">- Which reload of the resource this is.</param>
+		/// <param name="pListener">- The listener to be notified once the new version is in use.</param>
+		void DecodeReload(const ResourceID& resourceID, uint32_t sequence, ResourceListenerPtr pListener);
+
+		/// <summary>
+		/// Swaps the decoded reloads into their entries, retiring the old versions,
+		/// and releases the references the reloads held. The new version's dependencies
+		/// replace the old version's, so the ones it no longer uses are released and
+		/// dropped from the dependency graph. Main thread only.
+		/// </summary>
+		void ApplyFinishedReloads();
+
+		/// <summary>
+		/// Finds the mount with the highest priority that has the resource,
+		/// and loads the raw data of the resource from it.
 		/// </summary>
 		/// <param name="resourceID">- The resource to load.</param>
-		/// <returns>The loaded raw data in a vector of bytes. The vector will be empty on failure.</returns>
-		eastl::vector<std::byte> LoadFromZip(const ResourceID& resourceID);
+		/// <returns>The loaded raw data. It will be empty on failure.</returns>
+		RawResourceData LoadRawData(const ResourceID& resourceID);
+
+		/// <summary>
+		/// Like LoadRawData(), for a batch. Small loose files are read together with the
+		/// reader, and large ones are mapped. Archive entries are read one at a time.
+		/// </summary>
+		/// <param name="fileReader">- The calling I/O thread's reader.</param>
+		/// <param name="resourceIDs">- The resources to load.</param>
+		/// <param name="rawData">- Receives the raw data of each resource, in the same order. Empty on failure.</param>
+		void LoadRawDataBatch(AsyncFileReader& fileReader, const eastl::vector<ResourceID>& resourceIDs, eastl::vector<RawResourceData>& rawData);
+
+		/// <summary>
+		/// Load a resource from the archive it was found in. Loose files are mapped, and
+		/// uncompressed entries are viewed in place when the archive is mapped. Anything
+		/// else is read into a buffer. Safe to call from multiple threads at once.
+		/// </summary>
+		/// <param name="location">- Where the resource was found.</param>
+		/// <returns>The loaded raw data. It will be empty on failure.</returns>
+		RawResourceData LoadFromArchive(const VirtualFileSystem::FileLocation& location);
+
+		/// <summary>
+		/// Orders resources by where they will be read from: by archive and offset
+		/// within it, or by path for raw assets. Duplicates are removed.
+		/// </summary>
+		/// <param name="resourceIDs">- The resources to sort.</param>
+		void SortForLocality(eastl::vector<ResourceID>& resourceIDs) const;
 	};
 }
\ No newline at end of file
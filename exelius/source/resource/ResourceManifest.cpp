@@ -0,0 +1,112 @@
+#include "EXEPCH.h"
+#include "source/resource/ResourceManifest.h"
+
+#include <EASTL/unordered_set.h>
+#include <rapidjson/document.h>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	ResourceManifest::ResourceManifest()
+		: m_resourceManagerLog("ResourceManager")
+	{
+		//
+	}
+
+	/// <summary>
+	/// Parses the raw bytes of a manifest file.
+	/// </summary>
+	/// <param name="data">- The manifest file's contents.</param>
+	/// <returns>True if the manifest was parsed, false if it is malformed.</returns>
+	bool ResourceManifest::Parse(eastl::span<const std::byte> data)
+	{
+		m_resources.clear();
+		m_dependencies.clear();
+
+		// The data isn't null terminated, so pass the length.
+		rapidjson::Document jsonDoc;
+		if (jsonDoc.Parse((const char*)data.data(), data.size()).HasParseError() || !jsonDoc.IsObject())
+		{
+			m_resourceManagerLog.Warn("Failed to parse resource manifest. Manifests must be a JSON Object.");
+			return false;
+		}
+
+		// A resource may be named many times, but is only listed once.
+		eastl::unordered_set<ResourceID> listedResources;
+		auto addResource = [this, &listedResources](const ResourceID& resourceID)
+		{
+			if (listedResources.insert(resourceID).second)
+				m_resources.emplace_back(resourceID);
+		};
+
+		auto resourcesMember = jsonDoc.FindMember("Resources");
+		if (resourcesMember != jsonDoc.MemberEnd())
+		{
+			if (!resourcesMember->value.IsArray())
+			{
+				m_resourceManagerLog.Warn("'Resources' member in resource manifest is not an Array.");
+				return false;
+			}
+
+			for (const auto& resource : resourcesMember->value.GetArray())
+			{
+				if (!resource.IsString())
+				{
+					m_resourceManagerLog.Warn("Member of 'Resources' in resource manifest is not a string.");
+					return false;
+				}
+
+				addResource(resource.GetString());
+			}
+		}
+
+		auto dependenciesMember = jsonDoc.FindMember("Dependencies");
+		if (dependenciesMember != jsonDoc.MemberEnd())
+		{
+			if (!dependenciesMember->value.IsObject())
+			{
+				m_resourceManagerLog.Warn("'Dependencies' member in resource manifest is not an Object.");
+				return false;
+			}
+
+			for (auto dependentItr = dependenciesMember->value.MemberBegin(); dependentItr != dependenciesMember->value.MemberEnd(); ++dependentItr)
+			{
+				if (!dependentItr->value.IsArray())
+				{
+					m_resourceManagerLog.Warn("Dependencies of '{}' in resource manifest are not an Array.", dependentItr->name.GetString());
+					return false;
+				}
+
+				const ResourceID dependentID = dependentItr->name.GetString();
+				addResource(dependentID);
+
+				eastl::vector<ResourceID>& dependencies = m_dependencies[dependentID];
+				for (const auto& dependency : dependentItr->value.GetArray())
+				{
+					if (!dependency.IsString())
+					{
+						m_resourceManagerLog.Warn("Dependency of '{}' in resource manifest is not a string.", dependentItr->name.GetString());
+						return false;
+					}
+
+					const ResourceID dependencyID = dependency.GetString();
+					if (dependencyID == dependentID)
+					{
+						m_resourceManagerLog.Warn("Resource '{}' in resource manifest depends on itself. Ignoring it.", dependentID.Get().c_str());
+						continue;
+					}
+
+					addResource(dependencyID);
+					dependencies.emplace_back(dependencyID);
+				}
+			}
+		}
+
+		if (m_resources.empty())
+			m_resourceManagerLog.Warn("Resource manifest does not list any resources.");
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include "source/resource/ResourceHelpers.h"
+#include "source/debug/Log.h"
+
+#include <EASTL/span.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// A list of resources to load together, such as everything a level needs,
+	/// along with the dependencies between them. Manifests are JSON files:
+	///
+	/// @code{.json}
+	///	{
+	///		"Resources" : [ "level1/tiles.spsh", "level1/music.ogg" ],
+	///		"Dependencies" :
+	///		{
+	///			"level1/tiles.spsh" : [ "level1/tiles.png" ]
+	///		}
+	///	}
+	/// @endcode
+	///
+	/// Every resource named in either member is part of the manifest. Knowing the
+	/// dependencies up front lets the loader read them alongside the resources that
+	/// use them, instead of only once those have been decoded.
+	/// @see ResourceLoader::LoadManifest
+	/// </summary>
+	class ResourceManifest
+	{
+		/// <summary>
+		/// Every resource in the manifest, in the order they were listed.
+		/// </summary>
+		eastl::vector<ResourceID> m_resources;
+
+		/// <summary>
+		/// The resources each resource depends on, keyed by the dependent resource.
+		/// </summary>
+		eastl::unordered_map<ResourceID, eastl::vector<ResourceID>> m_dependencies;
+
+		/// <summary>
+		/// Log for the ResourceManager.
+		/// </summary>
+		Log m_resourceManagerLog;
+
+	public:
+		ResourceManifest();
+		ResourceManifest(const ResourceManifest&) = delete;
+		ResourceManifest(ResourceManifest&&) = delete;
+		ResourceManifest& operator=(const ResourceManifest&) = delete;
+		ResourceManifest& operator=(ResourceManifest&&) = delete;
+		~ResourceManifest() = default;
+
+		/// <summary>
+		/// Parses the raw bytes of a manifest file.
+		/// </summary>
+		/// <param name="data">- The manifest file's contents.</param>
+		/// <returns>True if the manifest was parsed, false if it is malformed.</returns>
+		bool Parse(eastl::span<const std::byte> data);
+
+		const eastl::vector<ResourceID>& GetResources() const { return m_resources; }
+		const eastl::unordered_map<ResourceID, eastl::vector<ResourceID>>& GetDependencies() const { return m_dependencies; }
+	};
+}
\ No newline at end of file
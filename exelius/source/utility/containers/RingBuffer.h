@@ -1,4 +1,8 @@
 #pragma once
+#include <EASTL/utility.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
 
 /// <summary>
@@ -46,6 +50,14 @@ namespace Exelius
             m_bufferLock.unlock();
             return result;
         }
+
+        inline bool IsEmpty()
+        {
+            m_bufferLock.lock();
+            bool result = (m_tail == m_head);
+            m_bufferLock.unlock();
+            return result;
+        }
     };
 
     template <typename T, size_t size>
@@ -81,4 +93,228 @@ namespace Exelius
             return result;
         }
     };
+
+    /// <summary>
+    /// Lock free ring buffer for exactly one producer thread and exactly one consumer thread.
+    /// Elements are moved in and out, and every slot is usable.
+    /// 
+    /// Each side keeps its own index and a cached copy of the other side's index on its own cache line,
+    /// so the two threads only touch each other's line when the buffer looks full or empty.
+    /// </summary>
+    template <typename T, size_t size>
+    class RingBufferSPSC
+    {
+        static_assert(size >= 2 && (size & (size - 1)) == 0, "RingBufferSPSC size must be a power of two.");
+
+        static constexpr size_t s_kMask = size - 1;
+        static constexpr size_t s_kCacheLineSize = 64;
+
+        // Producer side. The indices count up forever and are masked on use.
+        alignas(s_kCacheLineSize) std::atomic<size_t> m_head = 0;
+        size_t m_cachedTail = 0;
+
+        // Consumer side.
+        alignas(s_kCacheLineSize) std::atomic<size_t> m_tail = 0;
+        size_t m_cachedHead = 0;
+
+        alignas(s_kCacheLineSize) T m_buffer[size];
+
+    public:
+        /// <summary>
+        /// Producer only.
+        /// </summary>
+        /// <returns>False if the buffer is full.</returns>
+        inline bool PushBack(const T& elementToPush)
+        {
+            return Push(elementToPush);
+        }
+
+        /// <summary>
+        /// Producer only.
+        /// </summary>
+        /// <returns>False if the buffer is full, in which case the element is not moved from.</returns>
+        inline bool PushBack(T&& elementToPush)
+        {
+            return Push(eastl::move(elementToPush));
+        }
+
+        /// <summary>
+        /// Consumer only.
+        /// </summary>
+        /// <returns>False if the buffer is empty.</returns>
+        inline bool PopFront(T& elementToPop)
+        {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_cachedHead)
+            {
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                if (tail == m_cachedHead)
+                    return false;
+            }
+
+            elementToPop = eastl::move(m_buffer[tail & s_kMask]);
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// <summary>
+        /// Safe from any thread, but only a snapshot.
+        /// </summary>
+        inline bool IsEmpty() const
+        {
+            return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+        }
+
+    private:
+        template <typename Element>
+        inline bool Push(Element&& elementToPush)
+        {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            if (head - m_cachedTail == size)
+            {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                if (head - m_cachedTail == size)
+                    return false;
+            }
+
+            m_buffer[head & s_kMask] = eastl::forward<Element>(elementToPush);
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+    };
+
+    /// <summary>
+    /// Bounded lock free ring buffer for any number of producer and consumer threads.
+    /// Elements are moved in and out, and every slot is usable.
+    /// 
+    /// Based on Dmitry Vyukov's bounded MPMC queue: each slot carries a sequence number that says
+    /// whether it is ready to be written or read for the current lap, so producers and consumers
+    /// only contend on their own position counter, and never on a lock.
+    /// </summary>
+    template <typename T, size_t size>
+    class RingBufferMPMC
+    {
+        static_assert(size >= 2 && (size & (size - 1)) == 0, "RingBufferMPMC size must be a power of two.");
+
+        static constexpr size_t s_kMask = size - 1;
+        static constexpr size_t s_kCacheLineSize = 64;
+
+        struct Cell
+        {
+            std::atomic<size_t> m_sequence;
+            T m_data;
+        };
+
+        alignas(s_kCacheLineSize) Cell m_buffer[size];
+        alignas(s_kCacheLineSize) std::atomic<size_t> m_enqueuePosition;
+        alignas(s_kCacheLineSize) std::atomic<size_t> m_dequeuePosition;
+
+    public:
+        RingBufferMPMC()
+            : m_enqueuePosition(0)
+            , m_dequeuePosition(0)
+        {
+            for (size_t cellIndex = 0; cellIndex < size; ++cellIndex)
+            {
+                m_buffer[cellIndex].m_sequence.store(cellIndex, std::memory_order_relaxed);
+            }
+        }
+
+        RingBufferMPMC(const RingBufferMPMC&) = delete;
+        RingBufferMPMC(RingBufferMPMC&&) = delete;
+        RingBufferMPMC& operator=(const RingBufferMPMC&) = delete;
+        RingBufferMPMC& operator=(RingBufferMPMC&&) = delete;
+
+        /// <returns>False if the buffer is full.</returns>
+        inline bool PushBack(const T& elementToPush)
+        {
+            return Push(elementToPush);
+        }
+
+        /// <returns>False if the buffer is full, in which case the element is not moved from.</returns>
+        inline bool PushBack(T&& elementToPush)
+        {
+            return Push(eastl::move(elementToPush));
+        }
+
+        /// <returns>False if the buffer is empty.</returns>
+        inline bool PopFront(T& elementToPop)
+        {
+            size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+            Cell* pCell = nullptr;
+
+            for (;;)
+            {
+                pCell = &m_buffer[position & s_kMask];
+                const size_t sequence = pCell->m_sequence.load(std::memory_order_acquire);
+                const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+                if (difference == 0)
+                {
+                    if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                {
+                    // Nothing has been published to this slot for this lap yet.
+                    return false;
+                }
+                else
+                {
+                    position = m_dequeuePosition.load(std::memory_order_relaxed);
+                }
+            }
+
+            elementToPop = eastl::move(pCell->m_data);
+
+            // Hand the slot to the producer of the next lap.
+            pCell->m_sequence.store(position + s_kMask + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// <summary>
+        /// Safe from any thread, but only a snapshot. May report a slot that is still
+        /// being written as not empty, but never reports a finished push as empty.
+        /// </summary>
+        inline bool IsEmpty() const
+        {
+            return m_dequeuePosition.load(std::memory_order_acquire) == m_enqueuePosition.load(std::memory_order_acquire);
+        }
+
+    private:
+        template <typename Element>
+        inline bool Push(Element&& elementToPush)
+        {
+            size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+            Cell* pCell = nullptr;
+
+            for (;;)
+            {
+                pCell = &m_buffer[position & s_kMask];
+                const size_t sequence = pCell->m_sequence.load(std::memory_order_acquire);
+                const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+                if (difference == 0)
+                {
+                    if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                {
+                    // The consumer from the last lap hasn't emptied the slot, so we are full.
+                    return false;
+                }
+                else
+                {
+                    position = m_enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+
+            pCell->m_data = eastl::forward<Element>(elementToPush);
+
+            // Publish the slot to the consumer of this lap.
+            pCell->m_sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+    };
 }
\ No newline at end of file
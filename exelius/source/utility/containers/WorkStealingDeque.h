@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+    // Bounded Chase-Lev work stealing deque, using the memory orderings from:
+    // "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Zappa Nardelli - 2013)
+    //
+    // Only the owning thread may call PushBottom and PopBottom (LIFO). Any thread may call Steal (FIFO).
+    // Elements are stored in atomics, so T must be trivially copyable (pointers or indices).
+
+    template <typename T, size_t size>
+    class WorkStealingDeque
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque elements must be trivially copyable.");
+        static_assert(size > 1 && (size & (size - 1)) == 0, "WorkStealingDeque size must be a power of two.");
+
+        static constexpr int64_t s_kMask = static_cast<int64_t>(size) - 1;
+        static constexpr size_t s_kCacheLineSize = 64;
+
+        alignas(s_kCacheLineSize) std::atomic<int64_t> m_top = 0;
+        alignas(s_kCacheLineSize) std::atomic<int64_t> m_bottom = 0;
+        alignas(s_kCacheLineSize) std::atomic<T> m_buffer[size];
+
+    public:
+        WorkStealingDeque() = default;
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque(WorkStealingDeque&&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+        ~WorkStealingDeque() = default;
+
+        /// Owner only. Returns false if the deque is full.
+        inline bool PushBottom(T elementToPush)
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            const int64_t top = m_top.load(std::memory_order_acquire);
+
+            if (bottom - top > s_kMask)
+                return false;
+
+            m_buffer[bottom & s_kMask].store(elementToPush, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /// Owner only. Pops the most recently pushed element.
+        inline bool PopBottom(T& elementToPop)
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = m_top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                // Deque was already empty, restore it.
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            elementToPop = m_buffer[bottom & s_kMask].load(std::memory_order_relaxed);
+            if (top != bottom)
+                return true;
+
+            // Last element, race any thieves for it.
+            const bool result = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return result;
+        }
+
+        /// Any thread. Takes the oldest element. May fail spuriously when racing another thief.
+        inline bool Steal(T& elementToSteal)
+        {
+            int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+                return false;
+
+            const T element = m_buffer[top & s_kMask].load(std::memory_order_relaxed);
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return false;
+
+            elementToSteal = element;
+            return true;
+        }
+
+        /// Any thread. Only a snapshot, the result may be stale by the time it is used.
+        inline bool IsEmpty() const
+        {
+            const int64_t top = m_top.load(std::memory_order_acquire);
+            const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+            return top >= bottom;
+        }
+    };
+}
\ No newline at end of file
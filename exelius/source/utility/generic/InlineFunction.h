@@ -0,0 +1,153 @@
+#pragma once
+#include "source/utility/generic/Macros.h"
+
+#include <EASTL/utility.h>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	template <typename Signature, size_t StorageSize>
+	class InlineFunction;
+
+	/// <summary>
+	/// Move only callable wrapper that stores the callable inside of itself and never allocates.
+	/// Callables that do not fit into StorageSize bytes are rejected at compile time.
+	///
+	/// Unlike eastl::function, captured state is moved rather than copied, so it may hold
+	/// move only types and is safe to use in places that must not touch the heap (like jobs).
+	/// </summary>
+	template <typename Return, typename... Args, size_t StorageSize>
+	class InlineFunction<Return(Args...), StorageSize>
+	{
+		/// <summary>
+		/// Calls the stored callable.
+		/// </summary>
+		using InvokeFunction = Return(*)(void* pStorage, Args&&... args);
+
+		/// <summary>
+		/// Move constructs the callable in pSource into pDestination (if not null), then destroys pSource.
+		/// </summary>
+		using RelocateFunction = void(*)(void* pDestination, void* pSource);
+
+		alignas(std::max_align_t) std::byte m_storage[StorageSize];
+		InvokeFunction m_pInvoke;
+		RelocateFunction m_pRelocate;
+
+	public:
+		InlineFunction()
+			: m_pInvoke(nullptr)
+			, m_pRelocate(nullptr)
+		{
+			//
+		}
+
+		/// <summary>
+		/// Constructs the callable directly inside the internal storage.
+		/// </summary>
+		/// <param name="callable">- The callable to store. Must fit in StorageSize.</param>
+		template <typename Callable, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, InlineFunction>>>
+		InlineFunction(Callable&& callable)
+			: m_pInvoke(nullptr)
+			, m_pRelocate(nullptr)
+		{
+			Assign(eastl::forward<Callable>(callable));
+		}
+
+		InlineFunction(const InlineFunction&) = delete;
+		InlineFunction& operator=(const InlineFunction&) = delete;
+
+		InlineFunction(InlineFunction&& other)
+			: m_pInvoke(nullptr)
+			, m_pRelocate(nullptr)
+		{
+			MoveFrom(other);
+		}
+
+		InlineFunction& operator=(InlineFunction&& other)
+		{
+			if (this != &other)
+			{
+				Reset();
+				MoveFrom(other);
+			}
+
+			return *this;
+		}
+
+		~InlineFunction()
+		{
+			Reset();
+		}
+
+		/// <summary>
+		/// Replaces the stored callable.
+		/// </summary>
+		/// <param name="callable">- The callable to store. Must fit in StorageSize.</param>
+		template <typename Callable>
+		void Assign(Callable&& callable)
+		{
+			using StoredType = std::decay_t<Callable>;
+			static_assert(sizeof(StoredType) <= StorageSize, "Callable is too large for this InlineFunction, reduce the captured state.");
+			static_assert(alignof(StoredType) <= alignof(std::max_align_t), "Callable is over aligned for this InlineFunction.");
+			static_assert(std::is_invocable_r_v<Return, StoredType&, Args...>, "Callable does not match the InlineFunction signature.");
+
+			Reset();
+
+			new (m_storage) StoredType(eastl::forward<Callable>(callable));
+
+			m_pInvoke = [](void* pStorage, Args&&... args) -> Return
+			{
+				return (*static_cast<StoredType*>(pStorage))(eastl::forward<Args>(args)...);
+			};
+
+			m_pRelocate = [](void* pDestination, void* pSource)
+			{
+				StoredType* pSourceCallable = static_cast<StoredType*>(pSource);
+				if (pDestination)
+					new (pDestination) StoredType(eastl::move(*pSourceCallable));
+				pSourceCallable->~StoredType();
+			};
+		}
+
+		/// <summary>
+		/// Destroys the stored callable, if any.
+		/// </summary>
+		void Reset()
+		{
+			if (m_pRelocate)
+				m_pRelocate(nullptr, m_storage);
+
+			m_pInvoke = nullptr;
+			m_pRelocate = nullptr;
+		}
+
+		Return operator()(Args... args)
+		{
+			EXE_ASSERT(m_pInvoke);
+			return m_pInvoke(m_storage, eastl::forward<Args>(args)...);
+		}
+
+		explicit operator bool() const
+		{
+			return m_pInvoke != nullptr;
+		}
+
+	private:
+		void MoveFrom(InlineFunction& other)
+		{
+			if (!other.m_pRelocate)
+				return;
+
+			other.m_pRelocate(m_storage, other.m_storage);
+			m_pInvoke = other.m_pInvoke;
+			m_pRelocate = other.m_pRelocate;
+			other.m_pInvoke = nullptr;
+			other.m_pRelocate = nullptr;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+#include <EASTL/span.h>
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	class MappedFile;
+
+	/// <summary>
+	/// A read only source of files that can be mounted in the VirtualFileSystem, so loose
+	/// directories, zip archives, the engine's own paks and in memory stores can be used
+	/// side by side. Entry paths are relative to the archive and use forward slashes.
+	///
+	/// Every read must be safe to call from multiple threads at once. Open() and Close()
+	/// must not be called while other threads are reading.
+	/// @see DirectoryArchive
+	/// @see ZipArchive
+	/// @see PakArchive
+	/// @see MemoryArchive
+	/// </summary>
+	class Archive
+	{
+	public:
+		virtual ~Archive() = default;
+
+		/// <summary>
+		/// Opens the archive and indexes its entries.
+		/// </summary>
+		/// <param name="pArchivePath">- Path to the archive.</param>
+		/// <returns>True if the archive was opened and indexed.</returns>
+		virtual bool Open(const char* pArchivePath) = 0;
+
+		/// <summary>
+		/// Closes the archive and drops the index.
+		/// </summary>
+		virtual void Close() = 0;
+
+		virtual bool IsOpen() const = 0;
+		virtual const eastl::string& GetArchivePath() const = 0;
+		virtual size_t GetEntryCount() const = 0;
+
+		/// <summary>
+		/// Checks the index for an entry. Never touches the disk.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the archive.</param>
+		/// <returns>True if the archive holds the entry.</returns>
+		virtual bool Contains(const eastl::string& entryPath) const = 0;
+
+		/// <summary>
+		/// Finds where an entry starts in the archive, for ordering reads. Never touches the disk.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the archive.</param>
+		/// <param name="offset">- Receives the offset of the entry.</param>
+		/// <returns>True if the archive holds the entry.</returns>
+		virtual bool GetEntryOffset(const eastl::string& entryPath, uint64_t& offset) const = 0;
+
+		/// <summary>
+		/// Reads and, if needed, decompresses an entry into a buffer.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the archive.</param>
+		/// <param name="data">- Receives the uncompressed entry.</param>
+		/// <returns>True if the entry was found and read intact.</returns>
+		virtual bool ReadEntry(const eastl::string& entryPath, eastl::vector<std::byte>& data) const = 0;
+
+		/// <summary>
+		/// Finds an entry that is stored uncompressed in memory the archive has mapped,
+		/// so it can be used without being copied. The view is valid until the archive is closed.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the archive.</param>
+		/// <param name="view">- Receives the entry's bytes.</param>
+		/// <returns>True if the entry was found intact and can be viewed in place. Otherwise use ReadEntry().</returns>
+		virtual bool GetEntryView([[maybe_unused]] const eastl::string& entryPath, [[maybe_unused]] eastl::span<const std::byte>& view) const { return false; }
+
+		/// <summary>
+		/// Maps an entry that is a file of its own on disk, so it can be used without being copied.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the archive.</param>
+		/// <param name="mappedFile">- Receives the mapped entry.</param>
+		/// <returns>True if the entry was mapped. Otherwise use GetEntryView() or ReadEntry().</returns>
+		virtual bool MapEntry([[maybe_unused]] const eastl::string& entryPath, [[maybe_unused]] MappedFile& mappedFile) const { return false; }
+
+		/// <summary>
+		/// Finds the file on disk that holds an entry by itself, so callers can read it with their own file I/O.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the archive.</param>
+		/// <param name="filePath">- Receives the path of the file.</param>
+		/// <returns>True if the entry is a file of its own.</returns>
+		virtual bool GetFilePath([[maybe_unused]] const eastl::string& entryPath, [[maybe_unused]] eastl::string& filePath) const { return false; }
+
+		/// <summary>
+		/// Lists the entries under a directory of the archive.
+		/// </summary>
+		/// <param name="directoryPath">- The directory, empty or ending with a slash.</param>
+		/// <param name="recursive">- True to include entries in every directory below it.</param>
+		/// <param name="entryPaths">- Receives the full path of each entry, in no particular order.</param>
+		virtual void ListEntries(const eastl::string& directoryPath, bool recursive, eastl::vector<eastl::string>& entryPaths) const = 0;
+
+	protected:
+		/// <summary>
+		/// Checks if an entry path is under a directory, for ListEntries().
+		/// </summary>
+		/// <param name="pEntryPath">- Path of the entry inside the archive.</param>
+		/// <param name="entryPathLength">- Length of the entry's path.</param>
+		/// <param name="directoryPath">- The directory, empty or ending with a slash.</param>
+		/// <param name="recursive">- True if entries in directories below it count.</param>
+		/// <returns>True if the entry is listed under the directory.</returns>
+		static bool IsUnderDirectory(const char* pEntryPath, size_t entryPathLength, const eastl::string& directoryPath, bool recursive)
+		{
+			if (entryPathLength <= directoryPath.size() || std::memcmp(pEntryPath, directoryPath.data(), directoryPath.size()) != 0)
+				return false;
+
+			if (recursive)
+				return true;
+
+			// Entries in directories below have another slash after the directory.
+			for (size_t i = directoryPath.size(); i < entryPathLength; ++i)
+			{
+				if (pEntryPath[i] == '/')
+					return false;
+			}
+			return true;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,545 @@
+#include "EXEPCH.h"
+#include "source/utility/io/AsyncFileReader.h"
+
+#include <EASTL/algorithm.h>
+#include <cstring>
+
+#if defined(EXE_WINDOWS)
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#if defined(EXE_LINUX) && __has_include(<linux/io_uring.h>)
+	#define EXE_IO_URING 1
+	#include <cerrno>
+	#include <linux/io_uring.h>
+	#include <sys/mman.h>
+	#include <sys/syscall.h>
+#else
+	#define EXE_IO_URING 0
+#endif
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	#if EXE_IO_URING
+	/// <summary>
+	/// The shared memory rings of an io_uring instance. Only the thread that owns the
+	/// reader touches the submission side, the kernel only touches the completion side.
+	/// </summary>
+	struct AsyncFileReader::Ring
+	{
+		int m_ringHandle;
+
+		void* m_pSubmissionRing;
+		size_t m_submissionRingSize;
+		void* m_pCompletionRing;
+		size_t m_completionRingSize;
+		io_uring_sqe* m_pSubmissionEntries;
+		size_t m_submissionEntriesSize;
+
+		uint32_t m_submissionEntryCount;
+		uint32_t m_submissionMask;
+		uint32_t* m_pSubmissionTail;
+		uint32_t* m_pSubmissionArray;
+
+		uint32_t m_completionMask;
+		uint32_t* m_pCompletionHead;
+		uint32_t* m_pCompletionTail;
+		io_uring_cqe* m_pCompletions;
+
+		/// <summary>
+		/// Entries filled in since the last submit.
+		/// </summary>
+		uint32_t m_pendingCount;
+	};
+
+	// User data is the request index, with the operation in the low bit so opens and sizes can share a submission.
+	static constexpr uint64_t kOpenOperation = 0;
+	static constexpr uint64_t kStatOperation = 1;
+
+	static void DestroyRing(AsyncFileReader::Ring* pRing);
+
+	/// <summary>
+	/// Takes the next submission entry, cleared. The ring must have room for it.
+	/// </summary>
+	static io_uring_sqe* GetSubmissionEntry(AsyncFileReader::Ring* pRing)
+	{
+		EXE_ASSERT(pRing->m_pendingCount < pRing->m_submissionEntryCount);
+
+		const uint32_t tail = *pRing->m_pSubmissionTail + pRing->m_pendingCount;
+		const uint32_t index = tail & pRing->m_submissionMask;
+		pRing->m_pSubmissionArray[index] = index;
+		++pRing->m_pendingCount;
+
+		io_uring_sqe* pEntry = &pRing->m_pSubmissionEntries[index];
+		std::memset(pEntry, 0, sizeof(io_uring_sqe));
+		return pEntry;
+	}
+
+	/// <summary>
+	/// Submits every pending entry and waits for all of them to complete, then passes each completion to the callback.
+	/// </summary>
+	/// <returns>
+	/// True if every entry was submitted. On false, the entries the kernel did take have still been reaped and passed
+	/// to the callback, so nothing is left in flight, but the rest never ran and the ring should not be used again.
+	/// </returns>
+	template <typename Callback>
+	static bool SubmitAndReap(AsyncFileReader::Ring* pRing, Callback&& onCompletion)
+	{
+		const uint32_t submitCount = pRing->m_pendingCount;
+		if (submitCount == 0)
+			return true;
+
+		// Publish the entries before telling the kernel about them.
+		__atomic_store_n(pRing->m_pSubmissionTail, *pRing->m_pSubmissionTail + submitCount, __ATOMIC_RELEASE);
+		pRing->m_pendingCount = 0;
+
+		uint32_t submitted = 0;
+		bool isSubmitted = true;
+		while (submitted < submitCount)
+		{
+			const long result = syscall(__NR_io_uring_enter, pRing->m_ringHandle, submitCount - submitted, submitCount - submitted, IORING_ENTER_GETEVENTS, nullptr, 0);
+			if (result < 0)
+			{
+				if (errno == EINTR)
+					continue;
+
+				// Whatever was taken before the failure still writes into the caller's buffers. Wait for it below.
+				isSubmitted = false;
+				break;
+			}
+
+			submitted += static_cast<uint32_t>(result);
+		}
+
+		uint32_t reaped = 0;
+		while (reaped < submitted)
+		{
+			uint32_t head = *pRing->m_pCompletionHead;
+			const uint32_t tail = __atomic_load_n(pRing->m_pCompletionTail, __ATOMIC_ACQUIRE);
+
+			if (head == tail)
+			{
+				// Woken early (by a signal), wait for the rest.
+				syscall(__NR_io_uring_enter, pRing->m_ringHandle, 0, submitted - reaped, IORING_ENTER_GETEVENTS, nullptr, 0);
+				continue;
+			}
+
+			for (; head != tail; ++head, ++reaped)
+			{
+				const io_uring_cqe& completion = pRing->m_pCompletions[head & pRing->m_completionMask];
+				onCompletion(completion.user_data, completion.res);
+			}
+
+			__atomic_store_n(pRing->m_pCompletionHead, head, __ATOMIC_RELEASE);
+		}
+
+		return isSubmitted;
+	}
+
+	/// <summary>
+	/// Sets up a ring, if the kernel supports every operation we need.
+	/// </summary>
+	static AsyncFileReader::Ring* CreateRing(uint32_t entryCount)
+	{
+		io_uring_params parameters;
+		std::memset(&parameters, 0, sizeof(parameters));
+
+		const int ringHandle = static_cast<int>(syscall(__NR_io_uring_setup, entryCount, &parameters));
+		if (ringHandle < 0)
+			return nullptr;
+
+		AsyncFileReader::Ring* pRing = EXELIUS_NEW(AsyncFileReader::Ring());
+		std::memset(pRing, 0, sizeof(AsyncFileReader::Ring));
+		pRing->m_ringHandle = ringHandle;
+
+		// Opening and sizing files through the ring needs Linux 5.6.
+		static constexpr uint32_t kProbeOperationCount = 256;
+		eastl::vector<std::byte> probeBuffer(sizeof(io_uring_probe) + kProbeOperationCount * sizeof(io_uring_probe_op), std::byte(0));
+		io_uring_probe* pProbe = reinterpret_cast<io_uring_probe*>(probeBuffer.data());
+		if (syscall(__NR_io_uring_register, ringHandle, IORING_REGISTER_PROBE, pProbe, kProbeOperationCount) < 0)
+		{
+			DestroyRing(pRing);
+			return nullptr;
+		}
+
+		for (uint8_t operation : { IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_CLOSE })
+		{
+			if (operation >= pProbe->ops_len || !(pProbe->ops[operation].flags & IO_URING_OP_SUPPORTED))
+			{
+				DestroyRing(pRing);
+				return nullptr;
+			}
+		}
+
+		pRing->m_submissionRingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(uint32_t);
+		pRing->m_completionRingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+
+		// Newer kernels map both rings with one call.
+		const bool isSingleMapping = (parameters.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (isSingleMapping)
+		{
+			pRing->m_submissionRingSize = eastl::max(pRing->m_submissionRingSize, pRing->m_completionRingSize);
+			pRing->m_completionRingSize = pRing->m_submissionRingSize;
+		}
+
+		pRing->m_pSubmissionRing = mmap(nullptr, pRing->m_submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringHandle, IORING_OFF_SQ_RING);
+		if (pRing->m_pSubmissionRing == MAP_FAILED)
+		{
+			pRing->m_pSubmissionRing = nullptr;
+			DestroyRing(pRing);
+			return nullptr;
+		}
+
+		if (isSingleMapping)
+		{
+			pRing->m_pCompletionRing = pRing->m_pSubmissionRing;
+		}
+		else
+		{
+			pRing->m_pCompletionRing = mmap(nullptr, pRing->m_completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringHandle, IORING_OFF_CQ_RING);
+			if (pRing->m_pCompletionRing == MAP_FAILED)
+			{
+				pRing->m_pCompletionRing = nullptr;
+				DestroyRing(pRing);
+				return nullptr;
+			}
+		}
+
+		pRing->m_submissionEntriesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+		void* pSubmissionEntries = mmap(nullptr, pRing->m_submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringHandle, IORING_OFF_SQES);
+		if (pSubmissionEntries == MAP_FAILED)
+		{
+			DestroyRing(pRing);
+			return nullptr;
+		}
+		pRing->m_pSubmissionEntries = static_cast<io_uring_sqe*>(pSubmissionEntries);
+
+		std::byte* pSubmissionRing = static_cast<std::byte*>(pRing->m_pSubmissionRing);
+		pRing->m_submissionEntryCount = parameters.sq_entries;
+		pRing->m_submissionMask = *reinterpret_cast<uint32_t*>(pSubmissionRing + parameters.sq_off.ring_mask);
+		pRing->m_pSubmissionTail = reinterpret_cast<uint32_t*>(pSubmissionRing + parameters.sq_off.tail);
+		pRing->m_pSubmissionArray = reinterpret_cast<uint32_t*>(pSubmissionRing + parameters.sq_off.array);
+
+		std::byte* pCompletionRing = static_cast<std::byte*>(pRing->m_pCompletionRing);
+		pRing->m_completionMask = *reinterpret_cast<uint32_t*>(pCompletionRing + parameters.cq_off.ring_mask);
+		pRing->m_pCompletionHead = reinterpret_cast<uint32_t*>(pCompletionRing + parameters.cq_off.head);
+		pRing->m_pCompletionTail = reinterpret_cast<uint32_t*>(pCompletionRing + parameters.cq_off.tail);
+		pRing->m_pCompletions = reinterpret_cast<io_uring_cqe*>(pCompletionRing + parameters.cq_off.cqes);
+
+		return pRing;
+	}
+
+	static void DestroyRing(AsyncFileReader::Ring* pRing)
+	{
+		if (pRing->m_pSubmissionEntries)
+			munmap(pRing->m_pSubmissionEntries, pRing->m_submissionEntriesSize);
+
+		if (pRing->m_pCompletionRing && pRing->m_pCompletionRing != pRing->m_pSubmissionRing)
+			munmap(pRing->m_pCompletionRing, pRing->m_completionRingSize);
+
+		if (pRing->m_pSubmissionRing)
+			munmap(pRing->m_pSubmissionRing, pRing->m_submissionRingSize);
+
+		close(pRing->m_ringHandle);
+		EXELIUS_DELETE(pRing);
+	}
+	#else
+	struct AsyncFileReader::Ring
+	{
+		//
+	};
+	#endif
+
+	AsyncFileReader::AsyncFileReader()
+		: m_pRing(nullptr)
+	{
+		//
+	}
+
+	AsyncFileReader::~AsyncFileReader()
+	{
+		Shutdown();
+	}
+
+	bool AsyncFileReader::Initialize(uint32_t batchSize)
+	{
+		Shutdown();
+
+		#if EXE_IO_URING
+		// Each file needs two entries when it is opened and sized.
+		m_pRing = CreateRing(eastl::max(batchSize, 1u) * 2);
+		#else
+		(void)batchSize;
+		#endif
+
+		return IsUsingIOUring();
+	}
+
+	void AsyncFileReader::Shutdown()
+	{
+		if (!m_pRing)
+			return;
+
+		#if EXE_IO_URING
+		DestroyRing(m_pRing);
+		#endif
+		m_pRing = nullptr;
+	}
+
+	void AsyncFileReader::ReadFiles(ReadRequest* pRequests, size_t requestCount, size_t maxReadSize)
+	{
+		size_t requestIndex = 0;
+
+		#if EXE_IO_URING
+		// The ring may shut itself down part way through, leaving the rest for positional reads.
+		while (m_pRing && requestIndex < requestCount)
+		{
+			const size_t ringBatchSize = eastl::min<size_t>(m_pRing->m_submissionEntryCount / 2, requestCount - requestIndex);
+			ReadFilesWithRing(pRequests + requestIndex, ringBatchSize, maxReadSize);
+			requestIndex += ringBatchSize;
+		}
+		#endif
+
+		for (; requestIndex < requestCount; ++requestIndex)
+		{
+			ReadFileDirectly(pRequests[requestIndex], maxReadSize);
+		}
+	}
+
+	void AsyncFileReader::ReadFilesWithRing([[maybe_unused]] ReadRequest* pRequests, [[maybe_unused]] size_t requestCount, [[maybe_unused]] size_t maxReadSize)
+	{
+		#if EXE_IO_URING
+		EXE_ASSERT(m_pRing && requestCount * 2 <= m_pRing->m_submissionEntryCount);
+
+		for (size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex)
+		{
+			pRequests[requestIndex].m_data.clear();
+			pRequests[requestIndex].m_fileSize = 0;
+			pRequests[requestIndex].m_result = ReadResult::kFailed;
+		}
+
+		eastl::vector<int> fileHandles(requestCount, -1);
+		eastl::vector<struct statx> fileStatuses(requestCount);
+		eastl::vector<size_t> bytesRead(requestCount, 0);
+		eastl::vector<bool> isSized(requestCount, false);
+
+		// Open and size every file in one submission. Sizing goes by path, so it doesn't have to wait for the open.
+		for (size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex)
+		{
+			io_uring_sqe* pOpen = GetSubmissionEntry(m_pRing);
+			pOpen->opcode = IORING_OP_OPENAT;
+			pOpen->fd = AT_FDCWD;
+			pOpen->addr = reinterpret_cast<uint64_t>(pRequests[requestIndex].m_filePath.c_str());
+			pOpen->open_flags = O_RDONLY | O_CLOEXEC;
+			pOpen->user_data = (requestIndex << 1) | kOpenOperation;
+
+			io_uring_sqe* pStat = GetSubmissionEntry(m_pRing);
+			pStat->opcode = IORING_OP_STATX;
+			pStat->fd = AT_FDCWD;
+			pStat->addr = reinterpret_cast<uint64_t>(pRequests[requestIndex].m_filePath.c_str());
+			pStat->len = STATX_SIZE;
+			pStat->off = reinterpret_cast<uint64_t>(&fileStatuses[requestIndex]);
+			pStat->user_data = (requestIndex << 1) | kStatOperation;
+		}
+
+		bool isRingHealthy = SubmitAndReap(m_pRing, [&](uint64_t userData, int32_t result)
+			{
+				const size_t requestIndex = static_cast<size_t>(userData >> 1);
+				if ((userData & 1) == kOpenOperation)
+					fileHandles[requestIndex] = result;
+				else
+					isSized[requestIndex] = (result == 0);
+			});
+
+		// Read every open file that fits, resubmitting short reads until each is done.
+		eastl::vector<size_t> readIndices;
+		if (isRingHealthy)
+		{
+			for (size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex)
+			{
+				ReadRequest& request = pRequests[requestIndex];
+				if (fileHandles[requestIndex] < 0 || !isSized[requestIndex])
+					continue;
+
+				request.m_fileSize = static_cast<size_t>(fileStatuses[requestIndex].stx_size);
+				if (request.m_fileSize > maxReadSize)
+				{
+					request.m_result = ReadResult::kTooLarge;
+					continue;
+				}
+
+				request.m_data.resize(request.m_fileSize);
+				request.m_result = ReadResult::kRead;
+				if (request.m_fileSize > 0)
+					readIndices.push_back(requestIndex);
+			}
+		}
+
+		while (isRingHealthy && !readIndices.empty())
+		{
+			for (size_t requestIndex : readIndices)
+			{
+				ReadRequest& request = pRequests[requestIndex];
+
+				io_uring_sqe* pRead = GetSubmissionEntry(m_pRing);
+				pRead->opcode = IORING_OP_READ;
+				pRead->fd = fileHandles[requestIndex];
+				pRead->addr = reinterpret_cast<uint64_t>(request.m_data.data() + bytesRead[requestIndex]);
+				pRead->len = static_cast<uint32_t>(eastl::min<size_t>(request.m_fileSize - bytesRead[requestIndex], 0x7FFFF000));
+				pRead->off = bytesRead[requestIndex];
+				pRead->user_data = requestIndex;
+			}
+
+			isRingHealthy = SubmitAndReap(m_pRing, [&](uint64_t userData, int32_t result)
+				{
+					const size_t requestIndex = static_cast<size_t>(userData);
+					ReadRequest& request = pRequests[requestIndex];
+
+					if (result < 0)
+					{
+						request.m_data.clear();
+						request.m_result = ReadResult::kFailed;
+					}
+					else if (result == 0)
+					{
+						// The file shrank after it was sized. Keep what was there.
+						request.m_fileSize = bytesRead[requestIndex];
+						request.m_data.resize(request.m_fileSize);
+					}
+					else
+					{
+						bytesRead[requestIndex] += static_cast<size_t>(result);
+					}
+				});
+
+			readIndices.erase(eastl::remove_if(readIndices.begin(), readIndices.end(), [&](size_t requestIndex)
+				{
+					return pRequests[requestIndex].m_result != ReadResult::kRead || bytesRead[requestIndex] >= pRequests[requestIndex].m_fileSize;
+				}), readIndices.end());
+		}
+
+		// Close everything that was opened, in one more submission.
+		uint32_t closeCount = 0;
+		for (size_t requestIndex = 0; requestIndex < requestCount && isRingHealthy; ++requestIndex)
+		{
+			if (fileHandles[requestIndex] < 0)
+				continue;
+
+			io_uring_sqe* pClose = GetSubmissionEntry(m_pRing);
+			pClose->opcode = IORING_OP_CLOSE;
+			pClose->fd = fileHandles[requestIndex];
+			pClose->user_data = requestIndex;
+			++closeCount;
+		}
+
+		// Handles are only forgotten once their close is reaped. Any the ring didn't take are closed below.
+		if (closeCount > 0)
+		{
+			isRingHealthy = SubmitAndReap(m_pRing, [&](uint64_t userData, int32_t)
+				{
+					fileHandles[static_cast<size_t>(userData)] = -1;
+				});
+		}
+
+		if (isRingHealthy)
+			return;
+
+		// The ring stopped accepting work. Finish this batch with positional reads, and stop using it.
+		Shutdown();
+		for (size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex)
+		{
+			if (fileHandles[requestIndex] >= 0)
+				close(fileHandles[requestIndex]);
+
+			ReadFileDirectly(pRequests[requestIndex], maxReadSize);
+		}
+		#endif
+	}
+
+	void AsyncFileReader::ReadFileDirectly(ReadRequest& request, size_t maxReadSize)
+	{
+		request.m_data.clear();
+		request.m_fileSize = 0;
+		request.m_result = ReadResult::kFailed;
+
+		#if defined(EXE_WINDOWS)
+		void* fileHandle = CreateFileA(request.m_filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+			return;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize))
+		{
+			CloseHandle(fileHandle);
+			return;
+		}
+
+		request.m_fileSize = static_cast<size_t>(fileSize.QuadPart);
+		if (request.m_fileSize > maxReadSize)
+		{
+			request.m_result = ReadResult::kTooLarge;
+			CloseHandle(fileHandle);
+			return;
+		}
+
+		request.m_data.resize(request.m_fileSize);
+		size_t totalBytesRead = 0;
+		while (totalBytesRead < request.m_fileSize)
+		{
+			DWORD bytesRead = 0;
+			const DWORD bytesToRead = static_cast<DWORD>(eastl::min<size_t>(request.m_fileSize - totalBytesRead, 0x7FFFF000));
+			if (!ReadFile(fileHandle, request.m_data.data() + totalBytesRead, bytesToRead, &bytesRead, nullptr) || bytesRead == 0)
+				break;
+
+			totalBytesRead += bytesRead;
+		}
+		CloseHandle(fileHandle);
+		#else
+		const int fileHandle = open(request.m_filePath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fileHandle == -1)
+			return;
+
+		struct stat fileStatus;
+		if (fstat(fileHandle, &fileStatus) != 0)
+		{
+			close(fileHandle);
+			return;
+		}
+
+		request.m_fileSize = static_cast<size_t>(fileStatus.st_size);
+		if (request.m_fileSize > maxReadSize)
+		{
+			request.m_result = ReadResult::kTooLarge;
+			close(fileHandle);
+			return;
+		}
+
+		request.m_data.resize(request.m_fileSize);
+		size_t totalBytesRead = 0;
+		while (totalBytesRead < request.m_fileSize)
+		{
+			const ssize_t bytesRead = pread(fileHandle, request.m_data.data() + totalBytesRead, request.m_fileSize - totalBytesRead, static_cast<off_t>(totalBytesRead));
+			if (bytesRead <= 0)
+				break;
+
+			totalBytesRead += static_cast<size_t>(bytesRead);
+		}
+		close(fileHandle);
+		#endif
+
+		if (totalBytesRead != request.m_fileSize)
+		{
+			request.m_data.clear();
+			return;
+		}
+
+		request.m_result = ReadResult::kRead;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// Reads many whole files at once. On Linux the opens, reads and closes of a batch
+	/// are each submitted together through io_uring, so a batch of small files costs a
+	/// handful of system calls instead of several per file.
+	///
+	/// Where io_uring is unavailable (other platforms, older kernels, or sandboxes that
+	/// block it) each file is opened and read in turn with positional reads. Callers that
+	/// need those reads to overlap should give a reader to each of several threads.
+	///
+	/// A reader may only be used by one thread at a time.
+	/// </summary>
+	class AsyncFileReader
+	{
+	public:
+		enum class ReadResult : uint8_t
+		{
+			kRead,		/// The whole file was read into m_data.
+			kTooLarge,	/// The file is larger than the limit given to ReadFiles(), and was not read.
+			kFailed		/// The file could not be opened or read.
+		};
+
+		/// <summary>
+		/// One file to read. Only m_filePath needs to be filled in, the rest is the result.
+		/// </summary>
+		struct ReadRequest
+		{
+			eastl::string m_filePath;
+			eastl::vector<std::byte> m_data;
+			size_t m_fileSize;
+			ReadResult m_result;
+		};
+
+		/// <summary>
+		/// The io_uring instance, defined in the .cpp so the kernel headers stay out of here.
+		/// </summary>
+		struct Ring;
+
+	private:
+		/// <summary>
+		/// Null when using positional reads.
+		/// </summary>
+		Ring* m_pRing;
+
+	public:
+		AsyncFileReader();
+		AsyncFileReader(const AsyncFileReader&) = delete;
+		AsyncFileReader(AsyncFileReader&&) = delete;
+		AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+		AsyncFileReader& operator=(AsyncFileReader&&) = delete;
+		~AsyncFileReader();
+
+		/// <summary>
+		/// Sets up io_uring if this platform and kernel support it. Otherwise the reader
+		/// falls back to positional reads, which always works.
+		/// </summary>
+		/// <param name="batchSize">- The most files to have in flight in the ring at once.</param>
+		/// <returns>True if io_uring is being used.</returns>
+		bool Initialize(uint32_t batchSize);
+
+		/// <summary>
+		/// Tears down the ring, if there is one.
+		/// </summary>
+		void Shutdown();
+
+		bool IsUsingIOUring() const { return m_pRing != nullptr; }
+
+		/// <summary>
+		/// Reads every requested file, blocking until they are all done.
+		/// </summary>
+		/// <param name="pRequests">- The files to read.</param>
+		/// <param name="requestCount">- The number of requests.</param>
+		/// <param name="maxReadSize">- Files larger than this are only sized, not read.</param>
+		void ReadFiles(ReadRequest* pRequests, size_t requestCount, size_t maxReadSize);
+
+	private:
+		/// <summary>
+		/// Reads up to a ring's worth of files: one submission opens and sizes them all, the
+		/// next reads them all (repeated for any short reads), and the last closes them all.
+		/// </summary>
+		void ReadFilesWithRing(ReadRequest* pRequests, size_t requestCount, size_t maxReadSize);
+
+		/// <summary>
+		/// Opens, sizes, reads and closes a single file on the calling thread.
+		/// </summary>
+		static void ReadFileDirectly(ReadRequest& request, size_t maxReadSize);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// Appends little-endian fields to a buffer, whatever the host's byte order.
+	/// Used by the offline tools to write the formats in CookedResourceFormat.h and PakFormat.h.
+	/// </summary>
+	class BlobWriter
+	{
+		std::vector<uint8_t> m_bytes;
+
+	public:
+		void WriteU16(uint16_t value)
+		{
+			m_bytes.push_back(static_cast<uint8_t>(value));
+			m_bytes.push_back(static_cast<uint8_t>(value >> 8));
+		}
+
+		void WriteU32(uint32_t value)
+		{
+			for (int shift = 0; shift < 32; shift += 8)
+				m_bytes.push_back(static_cast<uint8_t>(value >> shift));
+		}
+
+		void WriteU64(uint64_t value)
+		{
+			for (int shift = 0; shift < 64; shift += 8)
+				m_bytes.push_back(static_cast<uint8_t>(value >> shift));
+		}
+
+		void WriteF32(float value)
+		{
+			uint32_t bits = 0;
+			std::memcpy(&bits, &value, sizeof(bits));
+			WriteU32(bits);
+		}
+
+		void WriteBytes(const std::vector<uint8_t>& bytes) { m_bytes.insert(m_bytes.end(), bytes.begin(), bytes.end()); }
+		void WriteChars(const std::vector<char>& chars) { m_bytes.insert(m_bytes.end(), chars.begin(), chars.end()); }
+
+		size_t GetSize() const { return m_bytes.size(); }
+		const std::vector<uint8_t>& GetBytes() const { return m_bytes; }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "EXEPCH.h"
+#include "source/utility/io/DirectoryArchive.h"
+#include "source/utility/io/MappedFile.h"
+#include "source/utility/string/StringTransformation.h"
+
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	DirectoryArchive::DirectoryArchive()
+		: m_archiveLog("ResourceLoader")
+		, m_isOpen(false)
+	{
+		//
+	}
+
+	bool DirectoryArchive::Open(const char* pArchivePath)
+	{
+		EXE_ASSERT(pArchivePath);
+
+		std::error_code errorCode;
+		if (!std::filesystem::is_directory(pArchivePath, errorCode))
+		{
+			m_archiveLog.Warn("Failed to open directory archive, it is not a directory: {}", pArchivePath);
+			return false;
+		}
+
+		m_archivePath = pArchivePath;
+
+		// Entry paths are already relative to the working directory, so they are used as they are.
+		m_rootPath = pArchivePath;
+		String::ToFilepath(m_rootPath);
+		if (m_rootPath == "." || m_rootPath == "./")
+			m_rootPath.clear();
+		else if (m_rootPath.back() != '/')
+			m_rootPath.push_back('/');
+
+		m_isOpen = true;
+		return true;
+	}
+
+	void DirectoryArchive::Close()
+	{
+		m_archivePath.clear();
+		m_rootPath.clear();
+		m_isOpen = false;
+	}
+
+	bool DirectoryArchive::Contains(const eastl::string& entryPath) const
+	{
+		eastl::string filePath;
+		GetFilePath(entryPath, filePath);
+
+		std::error_code errorCode;
+		return std::filesystem::is_regular_file(filePath.c_str(), errorCode);
+	}
+
+	bool DirectoryArchive::GetEntryOffset(const eastl::string& entryPath, uint64_t& offset) const
+	{
+		offset = 0;
+		return Contains(entryPath);
+	}
+
+	bool DirectoryArchive::ReadEntry(const eastl::string& entryPath, eastl::vector<std::byte>& data) const
+	{
+		MappedFile mappedFile;
+		if (!MapEntry(entryPath, mappedFile))
+			return false;
+
+		const eastl::span<const std::byte> bytes = mappedFile.GetBytes();
+		data.resize(bytes.size());
+		std::memcpy(data.data(), bytes.data(), bytes.size());
+		return true;
+	}
+
+	bool DirectoryArchive::MapEntry(const eastl::string& entryPath, MappedFile& mappedFile) const
+	{
+		eastl::string filePath;
+		GetFilePath(entryPath, filePath);
+		return mappedFile.Open(filePath.c_str());
+	}
+
+	bool DirectoryArchive::GetFilePath(const eastl::string& entryPath, eastl::string& filePath) const
+	{
+		filePath = m_rootPath + entryPath;
+		String::ToFilepath(filePath);
+		return true;
+	}
+
+	void DirectoryArchive::ListEntries(const eastl::string& directoryPath, bool recursive, eastl::vector<eastl::string>& entryPaths) const
+	{
+		eastl::string listedPath;
+		GetFilePath(directoryPath, listedPath);
+		if (listedPath.empty())
+			listedPath = ".";
+
+		const std::filesystem::path listedDirectory(listedPath.c_str());
+		auto addEntry = [&](const std::filesystem::directory_entry& directoryEntry)
+			{
+				std::error_code errorCode;
+				if (!directoryEntry.is_regular_file(errorCode))
+					return;
+
+				const std::string relativePath = directoryEntry.path().lexically_relative(listedDirectory).generic_string();
+				entryPaths.emplace_back(directoryPath + relativePath.c_str());
+			};
+
+		std::error_code errorCode;
+		if (recursive)
+		{
+			for (const auto& directoryEntry : std::filesystem::recursive_directory_iterator(listedDirectory, errorCode))
+			{
+				addEntry(directoryEntry);
+			}
+		}
+		else
+		{
+			for (const auto& directoryEntry : std::filesystem::directory_iterator(listedDirectory, errorCode))
+			{
+				addEntry(directoryEntry);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+#include "source/debug/Log.h"
+#include "source/utility/io/Archive.h"
+
+#include <EASTL/span.h>
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// A directory of loose files on disk, mounted like an archive. Entry paths are the
+	/// paths of the files inside the directory, and every entry is a file of its own,
+	/// so it can be mapped or handed to other file I/O instead of being copied.
+	///
+	/// Nothing is indexed, so files added to the directory later are found, but every
+	/// lookup asks the OS. The VirtualFileSystem caches lookups so this happens once per path.
+	///
+	/// Nothing is shared between reads, so any number of threads may read at once.
+	/// </summary>
+	class DirectoryArchive
+		: public Archive
+	{
+		Log m_archiveLog;
+
+		eastl::string m_archivePath;
+
+		/// <summary>
+		/// Prepended to entry paths to find their files. Ends with a slash, or is
+		/// empty when the directory is the working directory.
+		/// </summary>
+		eastl::string m_rootPath;
+
+		bool m_isOpen;
+
+	public:
+		DirectoryArchive();
+		DirectoryArchive(const DirectoryArchive&) = delete;
+		DirectoryArchive(DirectoryArchive&&) = delete;
+		DirectoryArchive& operator=(const DirectoryArchive&) = delete;
+		DirectoryArchive& operator=(DirectoryArchive&&) = delete;
+		virtual ~DirectoryArchive() final override = default;
+
+		/// <summary>
+		/// Checks the directory exists. Nothing is read until entries are looked up.
+		/// </summary>
+		/// <param name="pArchivePath">- Path to the directory. "." is the working directory.</param>
+		/// <returns>True if the directory exists.</returns>
+		virtual bool Open(const char* pArchivePath) final override;
+
+		virtual void Close() final override;
+
+		virtual bool IsOpen() const final override { return m_isOpen; }
+		virtual const eastl::string& GetArchivePath() const final override { return m_archivePath; }
+
+		/// <summary>
+		/// Loose directories aren't indexed, so this is always 0.
+		/// </summary>
+		virtual size_t GetEntryCount() const final override { return 0; }
+
+		/// <summary>
+		/// Checks the entry is a regular file in the directory.
+		/// </summary>
+		/// <param name="entryPath">- Path of the file inside the directory.</param>
+		/// <returns>True if the file exists.</returns>
+		virtual bool Contains(const eastl::string& entryPath) const final override;
+
+		/// <summary>
+		/// Loose files each start at the beginning of a file of their own,
+		/// so the offset is always 0 and reads are ordered by path.
+		/// </summary>
+		/// <param name="entryPath">- Path of the file inside the directory.</param>
+		/// <param name="offset">- Receives 0.</param>
+		/// <returns>True if the file exists.</returns>
+		virtual bool GetEntryOffset(const eastl::string& entryPath, uint64_t& offset) const final override;
+
+		/// <summary>
+		/// Reads a whole file into a buffer.
+		/// </summary>
+		/// <param name="entryPath">- Path of the file inside the directory.</param>
+		/// <param name="data">- Receives the file.</param>
+		/// <returns>True if the file was read.</returns>
+		virtual bool ReadEntry(const eastl::string& entryPath, eastl::vector<std::byte>& data) const final override;
+
+		/// <summary>
+		/// Maps a whole file.
+		/// </summary>
+		/// <param name="entryPath">- Path of the file inside the directory.</param>
+		/// <param name="mappedFile">- Receives the mapped file.</param>
+		/// <returns>True if the file was mapped.</returns>
+		virtual bool MapEntry(const eastl::string& entryPath, MappedFile& mappedFile) const final override;
+
+		/// <summary>
+		/// Finds the path of a file, for reading it with other file I/O.
+		/// </summary>
+		/// <param name="entryPath">- Path of the file inside the directory.</param>
+		/// <param name="filePath">- Receives the path of the file.</param>
+		/// <returns>Always true.</returns>
+		virtual bool GetFilePath(const eastl::string& entryPath, eastl::string& filePath) const final override;
+
+		/// <summary>
+		/// Lists the files under a directory inside this one.
+		/// </summary>
+		/// <param name="directoryPath">- The directory, empty or ending with a slash.</param>
+		/// <param name="recursive">- True to include files in every directory below it.</param>
+		/// <param name="entryPaths">- Receives the path of each file inside this directory, in no particular order.</param>
+		virtual void ListEntries(const eastl::string& directoryPath, bool recursive, eastl::vector<eastl::string>& entryPaths) const final override;
+	};
+}
\ No newline at end of file
@@ -176,7 +176,8 @@ namespace Exelius
 			}
 			case CreationType::kOpenFile:
 			{
-				if (!FileExists(filePath))
+				// Opening for reading fails by itself when the file is missing, so only writes need the check.
+				if (!(mode & std::ios::in) && !FileExists(filePath))
 				{
 					log.Error("File Not Found: '{}'", filePath.c_str());
 					return false;
@@ -203,7 +204,10 @@ namespace Exelius
 
 		if (!IsValid())
 		{
-			log.Warn("Failed File: {}", filePath.c_str());
+			if (create == CreationType::kOpenFile)
+				log.Error("File Not Found: '{}'", filePath.c_str());
+			else
+				log.Warn("Failed File: {}", filePath.c_str());
 			return false;
 		}
 
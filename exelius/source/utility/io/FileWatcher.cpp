@@ -0,0 +1,299 @@
+#include "EXEPCH.h"
+#include "source/utility/io/FileWatcher.h"
+
+#include <filesystem>
+#include <system_error>
+
+#if defined(EXE_LINUX)
+	#include <cerrno>
+	#include <poll.h>
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	#if defined(EXE_LINUX)
+	/// <summary>
+	/// The inotify events that mean a file may have new contents, or a directory appeared.
+	/// Editors that save by writing a temporary file and renaming it show up as IN_MOVED_TO.
+	/// </summary>
+	static constexpr uint32_t s_kInotifyEventMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+	#endif
+
+	FileWatcher::FileWatcher()
+		: m_fileWatcherLog("ResourceLoader")
+		, m_debounceTime(0)
+		, m_pollIntervalMilliseconds(500)
+		, m_quitWatchThread(false)
+		, m_inotifyHandle(-1)
+	{
+		//
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		Stop();
+	}
+
+	/// <summary>
+	/// Starts watching every file under a directory.
+	/// </summary>
+	/// <param name="pRootPath">- The directory to watch.</param>
+	/// <param name="debounceMilliseconds">- How long a file must be quiet before it is reported.</param>
+	/// <param name="pollIntervalMilliseconds">- How often to scan the directory, if inotify is unavailable.</param>
+	/// <returns>True if the directory is being watched.</returns>
+	bool FileWatcher::Start(const char* pRootPath, uint32_t debounceMilliseconds, uint32_t pollIntervalMilliseconds)
+	{
+		EXE_ASSERT(pRootPath);
+		EXE_ASSERT(!IsRunning());
+
+		std::error_code errorCode;
+		if (!std::filesystem::is_directory(pRootPath, errorCode))
+		{
+			m_fileWatcherLog.Warn("Cannot watch '{}' for changes, it is not a directory.", pRootPath);
+			return false;
+		}
+
+		m_rootPath = pRootPath;
+		if (m_rootPath.back() != '/' && m_rootPath.back() != '\\')
+			m_rootPath.push_back('/');
+
+		m_debounceTime = eastl::chrono::milliseconds(debounceMilliseconds);
+		m_pollIntervalMilliseconds = pollIntervalMilliseconds > 0 ? pollIntervalMilliseconds : 1;
+		m_quitWatchThread = false;
+
+		#if defined(EXE_LINUX)
+		m_inotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_inotifyHandle != -1)
+			AddWatches(m_rootPath);
+		else
+			m_fileWatcherLog.Info("inotify is unavailable (errno {}), polling '{}' for changes instead.", errno, m_rootPath.c_str());
+		#endif
+
+		// The first scan only learns the times, so existing files aren't reported as changed.
+		if (!IsUsingInotify())
+			PollFiles(false);
+
+		m_watchThread = std::thread(&FileWatcher::WatchThread, this);
+
+		m_fileWatcherLog.Info("Watching '{}' for changes{}.", m_rootPath.c_str(), IsUsingInotify() ? " with inotify" : "");
+		return true;
+	}
+
+	/// <summary>
+	/// Stops and joins the watch thread, dropping any changes not yet reported.
+	/// </summary>
+	void FileWatcher::Stop()
+	{
+		if (!IsRunning())
+			return;
+
+		m_quitWatchThread = true;
+		m_watchThread.join();
+
+		#if defined(EXE_LINUX)
+		if (m_inotifyHandle != -1)
+			close(m_inotifyHandle);
+		#endif
+		m_inotifyHandle = -1;
+
+		m_watchedDirectories.clear();
+		m_fileWriteTimes.clear();
+
+		std::lock_guard<std::mutex> lock(m_changeLock);
+		m_pendingChanges.clear();
+	}
+
+	/// <summary>
+	/// Takes the files that changed and have been quiet for the debounce time.
+	/// Files still changing are left for a later call.
+	/// </summary>
+	/// <param name="changedPaths">- Receives the paths of the changed files.</param>
+	void FileWatcher::CollectChanges(eastl::vector<eastl::string>& changedPaths)
+	{
+		const Clock::time_point now = Clock::now();
+
+		std::lock_guard<std::mutex> lock(m_changeLock);
+		for (auto changeIterator = m_pendingChanges.begin(); changeIterator != m_pendingChanges.end();)
+		{
+			if (now - changeIterator->second < m_debounceTime)
+			{
+				++changeIterator;
+				continue;
+			}
+
+			changedPaths.emplace_back(changeIterator->first);
+			changeIterator = m_pendingChanges.erase(changeIterator);
+		}
+	}
+
+	/// <summary>
+	/// Runs on the watch thread, until Stop() is called.
+	/// </summary>
+	void FileWatcher::WatchThread()
+	{
+		while (!m_quitWatchThread)
+		{
+			#if defined(EXE_LINUX)
+			if (IsUsingInotify())
+			{
+				// Wake up now and then to check if we should quit.
+				pollfd inotifyPoll = { m_inotifyHandle, POLLIN, 0 };
+				if (poll(&inotifyPoll, 1, static_cast<int>(m_pollIntervalMilliseconds)) > 0)
+					ReadInotifyEvents();
+				continue;
+			}
+			#endif
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(m_pollIntervalMilliseconds));
+			PollFiles(true);
+		}
+	}
+
+	/// <summary>
+	/// Adds an inotify watch to a directory and every directory under it.
+	/// </summary>
+	/// <param name="directoryPath">- The directory to watch, ending with a slash.</param>
+	void FileWatcher::AddWatches(const eastl::string& directoryPath)
+	{
+		#if defined(EXE_LINUX)
+		const int watchDescriptor = inotify_add_watch(m_inotifyHandle, directoryPath.c_str(), s_kInotifyEventMask | IN_ONLYDIR);
+		if (watchDescriptor == -1)
+		{
+			m_fileWatcherLog.Warn("Failed to watch directory '{}' for changes (errno {}).", directoryPath.c_str(), errno);
+			return;
+		}
+		m_watchedDirectories[watchDescriptor] = directoryPath;
+
+		// Incremented explicitly, since a range-for throws if the directory changes mid-scan.
+		std::error_code errorCode;
+		std::filesystem::directory_iterator directoryIterator(directoryPath.c_str(), errorCode);
+		for (; !errorCode && directoryIterator != std::filesystem::directory_iterator(); directoryIterator.increment(errorCode))
+		{
+			std::error_code entryErrorCode;
+			if (directoryIterator->is_directory(entryErrorCode))
+				AddWatches(directoryPath + directoryIterator->path().filename().generic_string().c_str() + "/");
+		}
+		#else
+		(void)directoryPath;
+		#endif
+	}
+
+	/// <summary>
+	/// Reads the events waiting on the inotify instance and records the changed files.
+	/// </summary>
+	void FileWatcher::ReadInotifyEvents()
+	{
+		#if defined(EXE_LINUX)
+		alignas(inotify_event) char eventBuffer[4096];
+
+		for (;;)
+		{
+			const ssize_t bytesRead = read(m_inotifyHandle, eventBuffer, sizeof(eventBuffer));
+			if (bytesRead <= 0)
+				return;
+
+			for (ssize_t offset = 0; offset < bytesRead;)
+			{
+				const inotify_event* pEvent = reinterpret_cast<const inotify_event*>(eventBuffer + offset);
+				offset += sizeof(inotify_event) + pEvent->len;
+
+				if (pEvent->mask & IN_Q_OVERFLOW)
+				{
+					m_fileWatcherLog.Warn("Too many changes under '{}' at once, some were missed.", m_rootPath.c_str());
+					continue;
+				}
+
+				auto found = m_watchedDirectories.find(pEvent->wd);
+				if (found == m_watchedDirectories.end())
+					continue;
+
+				// The directory was deleted or moved away, and its watch removed with it.
+				if (pEvent->mask & IN_IGNORED)
+				{
+					m_watchedDirectories.erase(found);
+					continue;
+				}
+
+				if (pEvent->len == 0)
+					continue;
+
+				eastl::string changedPath = found->second + pEvent->name;
+				if (pEvent->mask & IN_ISDIR)
+				{
+					// Files may have been written into the new directory before it was watched.
+					if (pEvent->mask & (IN_CREATE | IN_MOVED_TO))
+					{
+						changedPath.push_back('/');
+						AddWatches(changedPath);
+
+						// Incremented explicitly, since a range-for throws if the directory changes mid-scan.
+						std::error_code errorCode;
+						std::filesystem::recursive_directory_iterator directoryIterator(changedPath.c_str(), errorCode);
+						for (; !errorCode && directoryIterator != std::filesystem::recursive_directory_iterator(); directoryIterator.increment(errorCode))
+						{
+							std::error_code entryErrorCode;
+							if (directoryIterator->is_regular_file(entryErrorCode))
+								RecordChange(directoryIterator->path().generic_string().c_str());
+						}
+					}
+					continue;
+				}
+
+				// New files are reported once they have been written and closed.
+				if (pEvent->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+					RecordChange(changedPath);
+			}
+		}
+		#endif
+	}
+
+	/// <summary>
+	/// Scans the directory, recording every file whose modification time changed.
+	/// </summary>
+	/// <param name="recordChanges">- False for the first scan, which only learns the times.</param>
+	void FileWatcher::PollFiles(bool recordChanges)
+	{
+		// Incremented explicitly, since a range-for throws if a file is deleted mid-scan. The
+		// scan then stops early, and the files it missed are picked up by the next one.
+		std::error_code errorCode;
+		std::filesystem::recursive_directory_iterator directoryIterator(m_rootPath.c_str(), errorCode);
+		for (; !errorCode && directoryIterator != std::filesystem::recursive_directory_iterator(); directoryIterator.increment(errorCode))
+		{
+			std::error_code entryErrorCode;
+			if (!directoryIterator->is_regular_file(entryErrorCode))
+				continue;
+
+			const auto writeTime = directoryIterator->last_write_time(entryErrorCode);
+			if (entryErrorCode)
+				continue;
+
+			const eastl::string filePath = directoryIterator->path().generic_string().c_str();
+			const int64_t writeTimeCount = static_cast<int64_t>(writeTime.time_since_epoch().count());
+
+			auto [writeTimeIterator, isNewFile] = m_fileWriteTimes.try_emplace(filePath, writeTimeCount);
+			if (!isNewFile && writeTimeIterator->second == writeTimeCount)
+				continue;
+
+			writeTimeIterator->second = writeTimeCount;
+			if (recordChanges)
+				RecordChange(filePath);
+		}
+	}
+
+	/// <summary>
+	/// Records that a file changed just now, restarting its debounce time.
+	/// </summary>
+	/// <param name="filePath">- The file that changed.</param>
+	void FileWatcher::RecordChange(const eastl::string& filePath)
+	{
+		m_fileWatcherLog.Trace("File changed: {}", filePath.c_str());
+
+		std::lock_guard<std::mutex> lock(m_changeLock);
+		m_pendingChanges[filePath] = Clock::now();
+	}
+}
\ No newline at end of file
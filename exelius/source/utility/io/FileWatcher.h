@@ -0,0 +1,145 @@
+#pragma once
+#include "source/debug/Log.h"
+
+#include <EASTL/chrono.h>
+#include <EASTL/string.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// Watches every file under a directory on a background thread, and reports the ones
+	/// that changed. On Linux the kernel reports changes through inotify, with a watch on
+	/// each directory. Where inotify is unavailable, the thread scans the directory for
+	/// new modification times instead.
+	///
+	/// Saving a file usually takes several writes, or a write and a rename, so a file is
+	/// only reported once it has been quiet for the debounce time. Each burst of changes
+	/// to a file is reported once.
+	///
+	/// Changed paths are the watched directory's path followed by the file's path inside
+	/// it, with forward slashes. CollectChanges() may be called from any thread.
+	/// </summary>
+	class FileWatcher
+	{
+		using Clock = eastl::chrono::steady_clock;
+
+		Log m_fileWatcherLog;
+
+		/// <summary>
+		/// The watched directory, ending with a slash.
+		/// </summary>
+		eastl::string m_rootPath;
+
+		/// <summary>
+		/// How long a file must be quiet before it is reported.
+		/// </summary>
+		Clock::duration m_debounceTime;
+
+		/// <summary>
+		/// How often the directory is scanned when polling, and how often the
+		/// inotify thread checks if it should quit.
+		/// </summary>
+		uint32_t m_pollIntervalMilliseconds;
+
+		/// <summary>
+		/// Files that changed and have not been reported, with when they last changed.
+		/// </summary>
+		eastl::unordered_map<eastl::string, Clock::time_point> m_pendingChanges;
+
+		/// <summary>
+		/// Guards the pending changes.
+		/// </summary>
+		std::mutex m_changeLock;
+
+		std::thread m_watchThread;
+		std::atomic<bool> m_quitWatchThread;
+
+		/// <summary>
+		/// The inotify instance, or -1 when polling.
+		/// </summary>
+		int m_inotifyHandle;
+
+		/// <summary>
+		/// The watched directories, keyed by their inotify watch descriptor.
+		/// Only touched by the watch thread once it has started.
+		/// </summary>
+		eastl::unordered_map<int, eastl::string> m_watchedDirectories;
+
+		/// <summary>
+		/// The last modification time seen of each file, when polling.
+		/// Only touched by the watch thread once it has started.
+		/// </summary>
+		eastl::unordered_map<eastl::string, int64_t> m_fileWriteTimes;
+
+	public:
+		FileWatcher();
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher(FileWatcher&&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+		FileWatcher& operator=(FileWatcher&&) = delete;
+		~FileWatcher();
+
+		/// <summary>
+		/// Starts watching every file under a directory.
+		/// </summary>
+		/// <param name="pRootPath">- The directory to watch.</param>
+		/// <param name="debounceMilliseconds">- How long a file must be quiet before it is reported.</param>
+		/// <param name="pollIntervalMilliseconds">- How often to scan the directory, if inotify is unavailable.</param>
+		/// <returns>True if the directory is being watched.</returns>
+		bool Start(const char* pRootPath, uint32_t debounceMilliseconds, uint32_t pollIntervalMilliseconds = 500);
+
+		/// <summary>
+		/// Stops and joins the watch thread, dropping any changes not yet reported.
+		/// </summary>
+		void Stop();
+
+		bool IsRunning() const { return m_watchThread.joinable(); }
+		bool IsUsingInotify() const { return m_inotifyHandle != -1; }
+		const eastl::string& GetRootPath() const { return m_rootPath; }
+
+		/// <summary>
+		/// Takes the files that changed and have been quiet for the debounce time.
+		/// Files still changing are left for a later call.
+		/// </summary>
+		/// <param name="changedPaths">- Receives the paths of the changed files.</param>
+		void CollectChanges(eastl::vector<eastl::string>& changedPaths);
+
+	private:
+		/// <summary>
+		/// Runs on the watch thread, until Stop() is called.
+		/// </summary>
+		void WatchThread();
+
+		/// <summary>
+		/// Adds an inotify watch to a directory and every directory under it.
+		/// </summary>
+		/// <param name="directoryPath">- The directory to watch, ending with a slash.</param>
+		void AddWatches(const eastl::string& directoryPath);
+
+		/// <summary>
+		/// Reads the events waiting on the inotify instance and records the changed files.
+		/// </summary>
+		void ReadInotifyEvents();
+
+		/// <summary>
+		/// Scans the directory, recording every file whose modification time changed.
+		/// </summary>
+		/// <param name="recordChanges">- False for the first scan, which only learns the times.</param>
+		void PollFiles(bool recordChanges);
+
+		/// <summary>
+		/// Records that a file changed just now, restarting its debounce time.
+		/// </summary>
+		/// <param name="filePath">- The file that changed.</param>
+		void RecordChange(const eastl::string& filePath);
+	};
+}
\ No newline at end of file
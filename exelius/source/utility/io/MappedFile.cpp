@@ -0,0 +1,145 @@
+#include "EXEPCH.h"
+#include "source/utility/io/MappedFile.h"
+#include "source/utility/string/StringTransformation.h"
+
+#include <EASTL/string.h>
+#include <EASTL/utility.h>
+
+#if defined(EXE_WINDOWS)
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	MappedFile::MappedFile()
+		: m_pData(nullptr)
+		, m_size(0)
+	{
+		//
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+		: m_pData(other.m_pData)
+		, m_size(other.m_size)
+	{
+		other.m_pData = nullptr;
+		other.m_size = 0;
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		Close();
+		eastl::swap(m_pData, other.m_pData);
+		eastl::swap(m_size, other.m_size);
+		return *this;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::Open(const char* pFilePath)
+	{
+		EXE_ASSERT(pFilePath);
+		Close();
+
+		eastl::string filePath = pFilePath;
+		String::ToFilepath(filePath);
+
+		Log log;
+
+		// The view keeps the mapping alive on its own, so the handles are closed as soon as it exists.
+		#if defined(EXE_WINDOWS)
+		void* fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			log.Warn("Failed to open file to map: {}", filePath.c_str());
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart <= 0)
+		{
+			CloseHandle(fileHandle);
+			return false;
+		}
+
+		void* mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(fileHandle);
+		if (!mappingHandle)
+		{
+			log.Warn("Failed to create file mapping: {}", filePath.c_str());
+			return false;
+		}
+
+		void* pView = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mappingHandle);
+		if (!pView)
+		{
+			log.Warn("Failed to map view of file: {}", filePath.c_str());
+			return false;
+		}
+
+		m_pData = static_cast<const std::byte*>(pView);
+		m_size = static_cast<size_t>(fileSize.QuadPart);
+		#else
+		const int fileHandle = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fileHandle == -1)
+		{
+			log.Warn("Failed to open file to map: {}", filePath.c_str());
+			return false;
+		}
+
+		struct stat fileStatus;
+		if (fstat(fileHandle, &fileStatus) != 0 || fileStatus.st_size <= 0)
+		{
+			close(fileHandle);
+			return false;
+		}
+
+		const size_t fileSize = static_cast<size_t>(fileStatus.st_size);
+		void* pView = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileHandle, 0);
+		close(fileHandle);
+		if (pView == MAP_FAILED)
+		{
+			log.Warn("Failed to map file: {}", filePath.c_str());
+			return false;
+		}
+
+		// The whole file is about to be decoded, so start reading it in now.
+		madvise(pView, fileSize, MADV_WILLNEED);
+
+		m_pData = static_cast<const std::byte*>(pView);
+		m_size = fileSize;
+		#endif
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (!m_pData)
+			return;
+
+		#if defined(EXE_WINDOWS)
+		UnmapViewOfFile(m_pData);
+		#else
+		munmap(const_cast<std::byte*>(m_pData), m_size);
+		#endif
+
+		m_pData = nullptr;
+		m_size = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include <EASTL/span.h>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// A whole file mapped read only into memory. The bytes are paged in by the OS
+	/// as they are touched, so nothing is copied into a buffer of our own.
+	///
+	/// The view returned by GetBytes() is only valid while the file stays mapped.
+	/// Anything that needs the data afterwards must copy the parts it wants to keep.
+	///
+	/// Unlike File, this can be moved, so a mapping can be handed off between threads
+	/// along with the work that reads it.
+	/// </summary>
+	class MappedFile
+	{
+		const std::byte* m_pData;
+		size_t m_size;
+
+	public:
+		MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		~MappedFile();
+
+		/// <summary>
+		/// Maps the whole file. Any file that was already mapped is unmapped first.
+		/// Empty files can't be mapped, and fail to open.
+		/// </summary>
+		/// <param name="pFilePath">- The file to map.</param>
+		/// <returns>True if the file was mapped.</returns>
+		bool Open(const char* pFilePath);
+
+		/// <summary>
+		/// Unmaps the file. Any view of it is invalid afterwards.
+		/// </summary>
+		void Close();
+
+		bool IsOpen() const { return m_pData != nullptr; }
+		size_t GetSize() const { return m_size; }
+
+		/// <summary>
+		/// A read only view of the whole file. Empty if nothing is mapped.
+		/// </summary>
+		eastl::span<const std::byte> GetBytes() const { return eastl::span<const std::byte>(m_pData, m_size); }
+	};
+}
\ No newline at end of file
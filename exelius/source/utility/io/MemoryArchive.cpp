@@ -0,0 +1,76 @@
+#include "EXEPCH.h"
+#include "source/utility/io/MemoryArchive.h"
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	MemoryArchive::MemoryArchive()
+		: m_isOpen(false)
+	{
+		//
+	}
+
+	bool MemoryArchive::Open(const char* pArchivePath)
+	{
+		EXE_ASSERT(pArchivePath);
+
+		Close();
+		m_archivePath = pArchivePath;
+		m_isOpen = true;
+		return true;
+	}
+
+	void MemoryArchive::Close()
+	{
+		m_entries.clear();
+		m_archivePath.clear();
+		m_isOpen = false;
+	}
+
+	void MemoryArchive::AddEntry(const eastl::string& entryPath, eastl::vector<std::byte>&& data)
+	{
+		m_entries[entryPath] = std::move(data);
+	}
+
+	bool MemoryArchive::Contains(const eastl::string& entryPath) const
+	{
+		return m_entries.find(entryPath) != m_entries.end();
+	}
+
+	bool MemoryArchive::GetEntryOffset(const eastl::string& entryPath, uint64_t& offset) const
+	{
+		offset = 0;
+		return Contains(entryPath);
+	}
+
+	bool MemoryArchive::ReadEntry(const eastl::string& entryPath, eastl::vector<std::byte>& data) const
+	{
+		auto entryIterator = m_entries.find(entryPath);
+		if (entryIterator == m_entries.end())
+			return false;
+
+		data = entryIterator->second;
+		return true;
+	}
+
+	bool MemoryArchive::GetEntryView(const eastl::string& entryPath, eastl::span<const std::byte>& view) const
+	{
+		auto entryIterator = m_entries.find(entryPath);
+		if (entryIterator == m_entries.end() || entryIterator->second.empty())
+			return false;
+
+		view = eastl::span<const std::byte>(entryIterator->second.data(), entryIterator->second.size());
+		return true;
+	}
+
+	void MemoryArchive::ListEntries(const eastl::string& directoryPath, bool recursive, eastl::vector<eastl::string>& entryPaths) const
+	{
+		for (const auto& entry : m_entries)
+		{
+			if (IsUnderDirectory(entry.first.c_str(), entry.first.size(), directoryPath, recursive))
+				entryPaths.emplace_back(entry.first);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+#include "source/utility/io/Archive.h"
+
+#include <EASTL/span.h>
+#include <EASTL/string.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// Files held in memory, mounted like an archive. Used to feed resources to the
+	/// loader without touching the disk, for tests and for data built at runtime.
+	///
+	/// Entries are viewed in place, so their bytes are never copied when loaded.
+	/// AddEntry() must not be called while other threads are reading, so the store
+	/// should be filled before it is mounted.
+	/// </summary>
+	class MemoryArchive
+		: public Archive
+	{
+		eastl::string m_archivePath;
+		eastl::unordered_map<eastl::string, eastl::vector<std::byte>> m_entries;
+		bool m_isOpen;
+
+	public:
+		MemoryArchive();
+		MemoryArchive(const MemoryArchive&) = delete;
+		MemoryArchive(MemoryArchive&&) = delete;
+		MemoryArchive& operator=(const MemoryArchive&) = delete;
+		MemoryArchive& operator=(MemoryArchive&&) = delete;
+		virtual ~MemoryArchive() final override = default;
+
+		/// <summary>
+		/// Opens an empty store.
+		/// </summary>
+		/// <param name="pArchivePath">- A name for the store, used in logs.</param>
+		/// <returns>Always true.</returns>
+		virtual bool Open(const char* pArchivePath) final override;
+
+		/// <summary>
+		/// Drops every entry. Any view of them is invalid afterwards.
+		/// </summary>
+		virtual void Close() final override;
+
+		virtual bool IsOpen() const final override { return m_isOpen; }
+		virtual const eastl::string& GetArchivePath() const final override { return m_archivePath; }
+		virtual size_t GetEntryCount() const final override { return m_entries.size(); }
+
+		/// <summary>
+		/// Adds an entry, replacing any entry already at its path.
+		/// Must not be called while other threads are reading.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the store.</param>
+		/// <param name="data">- The contents of the entry.</param>
+		void AddEntry(const eastl::string& entryPath, eastl::vector<std::byte>&& data);
+
+		virtual bool Contains(const eastl::string& entryPath) const final override;
+
+		/// <summary>
+		/// Entries have no place in a file, so the offset is always 0 and reads are ordered by path.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the store.</param>
+		/// <param name="offset">- Receives 0.</param>
+		/// <returns>True if the store holds the entry.</returns>
+		virtual bool GetEntryOffset(const eastl::string& entryPath, uint64_t& offset) const final override;
+
+		virtual bool ReadEntry(const eastl::string& entryPath, eastl::vector<std::byte>& data) const final override;
+
+		/// <summary>
+		/// Views an entry in place.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the store.</param>
+		/// <param name="view">- Receives the entry's bytes. Valid until the entry is replaced or the store is closed.</param>
+		/// <returns>True if the store holds the entry, and it isn't empty.</returns>
+		virtual bool GetEntryView(const eastl::string& entryPath, eastl::span<const std::byte>& view) const final override;
+
+		virtual void ListEntries(const eastl::string& directoryPath, bool recursive, eastl::vector<eastl::string>& entryPaths) const final override;
+	};
+}
\ No newline at end of file
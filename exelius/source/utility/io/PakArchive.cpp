@@ -0,0 +1,298 @@
+#include "EXEPCH.h"
+#include "source/utility/io/PakArchive.h"
+#include "source/utility/io/PakFormat.h"
+#include "source/utility/string/StringHash.h"
+
+#include <EASTL/algorithm.h>
+#include <cstring>
+#include <limits>
+#include <zlib.h>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	// zlib takes sizes as uInt, so larger blobs are checksummed a piece at a time.
+	static constexpr uint64_t kMaxZlibChunkSize = std::numeric_limits<uInt>::max();
+
+	// Deflate can't expand data by more than this, so a larger inflated size means a corrupt entry.
+	static constexpr uint64_t kMaxZlibInflateRatio = 1032;
+
+	PakArchive::PakArchive()
+		: m_archiveLog("ResourceLoader")
+		, m_pEntries(nullptr)
+		, m_entryCount(0)
+		, m_pPathTable(nullptr)
+	{
+		//
+	}
+
+	PakArchive::~PakArchive()
+	{
+		Close();
+	}
+
+	bool PakArchive::Open(const char* pArchivePath)
+	{
+		EXE_ASSERT(pArchivePath);
+
+		if (IsOpen())
+		{
+			m_archiveLog.Warn("Attempting to open a pak archive that is already open: {}", m_archivePath.c_str());
+			Close();
+		}
+
+		if (!m_mappedFile.Open(pArchivePath))
+		{
+			m_archiveLog.Warn("Failed to map pak archive: {}", pArchivePath);
+			return false;
+		}
+
+		m_archivePath = pArchivePath;
+
+		if (!ValidateTableOfContents())
+		{
+			m_archiveLog.Warn("Invalid table of contents in pak archive: {}", pArchivePath);
+			Close();
+			return false;
+		}
+
+		m_archiveLog.Info("Opened pak archive '{}' with {} entries.", pArchivePath, m_entryCount);
+		return true;
+	}
+
+	void PakArchive::Close()
+	{
+		m_mappedFile.Close();
+		m_pEntries = nullptr;
+		m_entryCount = 0;
+		m_pPathTable = nullptr;
+		m_archivePath.clear();
+	}
+
+	bool PakArchive::Contains(const eastl::string& entryPath) const
+	{
+		return FindEntry(entryPath) != nullptr;
+	}
+
+	bool PakArchive::GetEntryOffset(const eastl::string& entryPath, uint64_t& offset) const
+	{
+		const PakEntry* pEntry = FindEntry(entryPath);
+		if (!pEntry)
+			return false;
+
+		offset = pEntry->m_offset;
+		return true;
+	}
+
+	bool PakArchive::ReadEntry(const eastl::string& entryPath, eastl::vector<std::byte>& data) const
+	{
+		const PakEntry* pEntry = FindEntry(entryPath);
+		if (!pEntry)
+			return false;
+
+		const eastl::span<const std::byte> storedBytes = GetStoredBytes(*pEntry);
+
+		// Check the size before allocating it, since a corrupt entry could ask for anything.
+		if (pEntry->m_compression == PakFormat::Compression::kZlib
+			&& (pEntry->m_size > pEntry->m_storedSize * kMaxZlibInflateRatio || pEntry->m_size > std::numeric_limits<uLong>::max()))
+		{
+			m_archiveLog.Warn("Cannot read '{}' from pak archive: {}. Its size of {} bytes is more than its compressed data can hold.", entryPath.c_str(), m_archivePath.c_str(), pEntry->m_size);
+			data.clear();
+			return false;
+		}
+
+		data.resize(static_cast<size_t>(pEntry->m_size));
+
+		switch (pEntry->m_compression)
+		{
+			case PakFormat::Compression::kNone:
+			{
+				if (!data.empty())
+					std::memcpy(data.data(), storedBytes.data(), data.size());
+				break;
+			}
+			case PakFormat::Compression::kZlib:
+			{
+				uLongf inflatedSize = static_cast<uLongf>(data.size());
+				const int result = uncompress(reinterpret_cast<Bytef*>(data.data()), &inflatedSize, reinterpret_cast<const Bytef*>(storedBytes.data()), static_cast<uLong>(storedBytes.size()));
+				if (result != Z_OK || inflatedSize != pEntry->m_size)
+				{
+					m_archiveLog.Warn("Failed to inflate '{}' from pak archive: {}. zlib result: {}", entryPath.c_str(), m_archivePath.c_str(), result);
+					data.clear();
+					return false;
+				}
+				break;
+			}
+			default:
+			{
+				m_archiveLog.Warn("Cannot read '{}' from pak archive: {}. It is compressed with LZ4, which this build does not support.", entryPath.c_str(), m_archivePath.c_str());
+				data.clear();
+				return false;
+			}
+		}
+
+		if (!VerifyChecksum(*pEntry, eastl::span<const std::byte>(data.data(), data.size())))
+		{
+			m_archiveLog.Warn("Checksum mismatch for '{}' in pak archive: {}", entryPath.c_str(), m_archivePath.c_str());
+			data.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool PakArchive::GetEntryView(const eastl::string& entryPath, eastl::span<const std::byte>& view) const
+	{
+		const PakEntry* pEntry = FindEntry(entryPath);
+		if (!pEntry || pEntry->m_compression != PakFormat::Compression::kNone)
+			return false;
+
+		const eastl::span<const std::byte> storedBytes = GetStoredBytes(*pEntry);
+		if (!VerifyChecksum(*pEntry, storedBytes))
+		{
+			m_archiveLog.Warn("Checksum mismatch for '{}' in pak archive: {}", entryPath.c_str(), m_archivePath.c_str());
+			return false;
+		}
+
+		view = storedBytes;
+		return true;
+	}
+
+	void PakArchive::ListEntries(const eastl::string& directoryPath, bool recursive, eastl::vector<eastl::string>& entryPaths) const
+	{
+		for (size_t i = 0; i < m_entryCount; ++i)
+		{
+			const char* pEntryPath = m_pPathTable + m_pEntries[i].m_pathOffset;
+			if (IsUnderDirectory(pEntryPath, m_pEntries[i].m_pathLength, directoryPath, recursive))
+				entryPaths.emplace_back(pEntryPath, m_pEntries[i].m_pathLength);
+		}
+	}
+
+	bool PakArchive::ValidateTableOfContents()
+	{
+		const eastl::span<const std::byte> archiveBytes = m_mappedFile.GetBytes();
+		const uint64_t archiveSize = archiveBytes.size();
+
+		if (archiveSize < sizeof(PakHeader))
+			return false;
+
+		// The mapping starts on a page, so the header and table of contents are aligned for reading in place.
+		const PakHeader* pHeader = reinterpret_cast<const PakHeader*>(archiveBytes.data());
+		if (pHeader->m_magic != PakFormat::kMagic)
+			return false;
+
+		if (pHeader->m_version != PakFormat::kVersion)
+		{
+			m_archiveLog.Warn("Pak archive '{}' is version {}, but only version {} can be read.", m_archivePath.c_str(), pHeader->m_version, PakFormat::kVersion);
+			return false;
+		}
+
+		const uint32_t blobAlignment = pHeader->m_blobAlignment;
+		if (pHeader->m_archiveSize != archiveSize || blobAlignment == 0 || (blobAlignment & (blobAlignment - 1)) != 0)
+			return false;
+
+		// The entry count is 32 bits, so this can't overflow.
+		const uint64_t pathTableOffset = sizeof(PakHeader) + static_cast<uint64_t>(pHeader->m_entryCount) * sizeof(PakEntry);
+		if (pathTableOffset > archiveSize || pHeader->m_pathTableSize > archiveSize - pathTableOffset)
+			return false;
+
+		const PakEntry* pEntries = reinterpret_cast<const PakEntry*>(archiveBytes.data() + sizeof(PakHeader));
+		const char* pPathTable = reinterpret_cast<const char*>(archiveBytes.data() + pathTableOffset);
+		const uint64_t pathTableSize = pHeader->m_pathTableSize;
+		const uint64_t blobsOffset = pathTableOffset + pathTableSize;
+
+		bool hasLZ4Entries = false;
+		for (uint32_t i = 0; i < pHeader->m_entryCount; ++i)
+		{
+			const PakEntry& entry = pEntries[i];
+
+			// Strictly increasing, so the binary search finds at most one entry per hash.
+			if (i > 0 && entry.m_pathHash <= pEntries[i - 1].m_pathHash)
+				return false;
+
+			if (static_cast<uint64_t>(entry.m_pathOffset) + entry.m_pathLength >= pathTableSize || pPathTable[entry.m_pathOffset + entry.m_pathLength] != '\0')
+				return false;
+
+			if (StringHash::HashString64(pPathTable + entry.m_pathOffset) != entry.m_pathHash)
+				return false;
+
+			// The offset is checked first, so the remaining size can't underflow.
+			if (entry.m_offset < blobsOffset || entry.m_offset > archiveSize || entry.m_offset % blobAlignment != 0 || entry.m_storedSize > archiveSize - entry.m_offset)
+				return false;
+
+			switch (entry.m_compression)
+			{
+				case PakFormat::Compression::kNone:
+				{
+					if (entry.m_storedSize != entry.m_size)
+						return false;
+					break;
+				}
+				case PakFormat::Compression::kZlib:
+				{
+					break;
+				}
+				case PakFormat::Compression::kLZ4:
+				{
+					hasLZ4Entries = true;
+					break;
+				}
+				default:
+				{
+					return false;
+				}
+			}
+		}
+
+		if (hasLZ4Entries)
+			m_archiveLog.Warn("Pak archive '{}' has entries compressed with LZ4, which this build does not support. They will fail to read.", m_archivePath.c_str());
+
+		m_pEntries = pEntries;
+		m_entryCount = pHeader->m_entryCount;
+		m_pPathTable = pPathTable;
+		return true;
+	}
+
+	const PakEntry* PakArchive::FindEntry(const eastl::string& entryPath) const
+	{
+		const uint64_t pathHash = StringHash::HashString64(entryPath.c_str());
+
+		const PakEntry* pEntriesEnd = m_pEntries + m_entryCount;
+		const PakEntry* pEntry = eastl::lower_bound(m_pEntries, pEntriesEnd, pathHash, [](const PakEntry& entry, uint64_t hash)
+			{
+				return entry.m_pathHash < hash;
+			});
+
+		if (pEntry == pEntriesEnd || pEntry->m_pathHash != pathHash)
+			return nullptr;
+
+		// A path that isn't in the pak may still share a hash with one that is.
+		if (pEntry->m_pathLength != entryPath.size() || std::memcmp(m_pPathTable + pEntry->m_pathOffset, entryPath.data(), entryPath.size()) != 0)
+			return nullptr;
+
+		return pEntry;
+	}
+
+	eastl::span<const std::byte> PakArchive::GetStoredBytes(const PakEntry& entry) const
+	{
+		return eastl::span<const std::byte>(m_mappedFile.GetBytes().data() + entry.m_offset, static_cast<size_t>(entry.m_storedSize));
+	}
+
+	bool PakArchive::VerifyChecksum(const PakEntry& entry, eastl::span<const std::byte> data) const
+	{
+		uLong crc = crc32(0L, Z_NULL, 0);
+		const Bytef* pData = reinterpret_cast<const Bytef*>(data.data());
+		uint64_t remainingSize = data.size();
+		while (remainingSize > 0)
+		{
+			const uInt chunkSize = static_cast<uInt>(eastl::min(remainingSize, kMaxZlibChunkSize));
+			crc = crc32(crc, pData, chunkSize);
+			pData += chunkSize;
+			remainingSize -= chunkSize;
+		}
+
+		return crc == entry.m_checksum;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#pragma once
+#include "source/debug/Log.h"
+#include "source/utility/io/Archive.h"
+#include "source/utility/io/MappedFile.h"
+
+#include <EASTL/span.h>
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	struct PakEntry;
+
+	/// <summary>
+	/// A read only pak, the engine's own archive format. The whole file is memory mapped
+	/// on Open(), and the table of contents is validated once and then used in place, so
+	/// opening a pak allocates nothing per entry. Entries are found with a binary search
+	/// over the path hashes.
+	///
+	/// Entries stored uncompressed are handed out as views of the mapping with
+	/// GetEntryView(), so their bytes are never copied. Compressed entries are inflated
+	/// into the caller's buffer with ReadEntry(). The checksum of an entry is checked
+	/// every time it is read or viewed.
+	///
+	/// Nothing is shared between reads, so any number of threads may read at once.
+	/// Open() and Close() must not be called while other threads are reading, and views
+	/// are only valid until Close().
+	///
+	/// Only uncompressed and zlib entries can be read. The format reserves a flag for LZ4,
+	/// but the engine isn't built with it, so those entries fail to read with a warning.
+	/// @see PakFormat
+	/// </summary>
+	class PakArchive
+		: public Archive
+	{
+		Log m_archiveLog;
+
+		MappedFile m_mappedFile;
+		eastl::string m_archivePath;
+
+		/// <summary>
+		/// The table of contents, inside the mapping. Sorted by path hash.
+		/// </summary>
+		const PakEntry* m_pEntries;
+		size_t m_entryCount;
+
+		/// <summary>
+		/// The null terminated paths of the entries, inside the mapping.
+		/// </summary>
+		const char* m_pPathTable;
+
+	public:
+		PakArchive();
+		PakArchive(const PakArchive&) = delete;
+		PakArchive(PakArchive&&) = delete;
+		PakArchive& operator=(const PakArchive&) = delete;
+		PakArchive& operator=(PakArchive&&) = delete;
+		virtual ~PakArchive() final override;
+
+		/// <summary>
+		/// Maps the pak and validates its header and table of contents.
+		/// </summary>
+		/// <param name="pArchivePath">- Path to the pak file.</param>
+		/// <returns>True if the pak was mapped and is valid.</returns>
+		virtual bool Open(const char* pArchivePath) final override;
+
+		/// <summary>
+		/// Unmaps the pak. Any view of its entries is invalid afterwards.
+		/// </summary>
+		virtual void Close() final override;
+
+		virtual bool IsOpen() const final override { return m_mappedFile.IsOpen(); }
+		virtual const eastl::string& GetArchivePath() const final override { return m_archivePath; }
+		virtual size_t GetEntryCount() const final override { return m_entryCount; }
+
+		/// <summary>
+		/// Searches the table of contents for an entry. Never touches the blobs.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the pak.</param>
+		/// <returns>True if the pak holds the entry.</returns>
+		virtual bool Contains(const eastl::string& entryPath) const final override;
+
+		/// <summary>
+		/// Finds where an entry's blob starts in the pak, for ordering reads. Never touches the blobs.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the pak.</param>
+		/// <param name="offset">- Receives the offset of the entry's blob.</param>
+		/// <returns>True if the pak holds the entry.</returns>
+		virtual bool GetEntryOffset(const eastl::string& entryPath, uint64_t& offset) const final override;
+
+		/// <summary>
+		/// Copies or inflates an entry into a buffer. Safe to call from multiple threads at once.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the pak.</param>
+		/// <param name="data">- Receives the uncompressed entry.</param>
+		/// <returns>True if the entry was found and read intact.</returns>
+		virtual bool ReadEntry(const eastl::string& entryPath, eastl::vector<std::byte>& data) const final override;
+
+		/// <summary>
+		/// Finds an entry stored uncompressed, and checks it is intact, without copying it.
+		/// Safe to call from multiple threads at once.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the pak.</param>
+		/// <param name="view">- Receives the entry's bytes in the mapping. Valid until Close().</param>
+		/// <returns>True if the entry was found intact and is stored uncompressed.</returns>
+		virtual bool GetEntryView(const eastl::string& entryPath, eastl::span<const std::byte>& view) const final override;
+
+		/// <summary>
+		/// Lists the entries under a directory of the pak. Never touches the blobs.
+		/// </summary>
+		/// <param name="directoryPath">- The directory, empty or ending with a slash.</param>
+		/// <param name="recursive">- True to include entries in every directory below it.</param>
+		/// <param name="entryPaths">- Receives the full path of each entry, in no particular order.</param>
+		virtual void ListEntries(const eastl::string& directoryPath, bool recursive, eastl::vector<eastl::string>& entryPaths) const final override;
+
+	private:
+		/// <summary>
+		/// Checks that the header and every entry of the table of contents are in bounds,
+		/// so nothing read later needs to be checked again.
+		/// </summary>
+		bool ValidateTableOfContents();
+
+		/// <summary>
+		/// Binary searches the table of contents for a path.
+		/// </summary>
+		/// <returns>The entry, or nullptr if the pak doesn't hold the path.</returns>
+		const PakEntry* FindEntry(const eastl::string& entryPath) const;
+
+		/// <summary>
+		/// The bytes of an entry's blob, as stored.
+		/// </summary>
+		eastl::span<const std::byte> GetStoredBytes(const PakEntry& entry) const;
+
+		/// <summary>
+		/// Checks the decompressed contents of an entry against its checksum.
+		/// </summary>
+		bool VerifyChecksum(const PakEntry& entry, eastl::span<const std::byte> data) const;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// The engine's own archive format, written by the asset packer (exeliuspacker) and
+	/// read by PakArchive. It is laid out to be memory mapped and read in place:
+	///
+	/// A PakHeader, then the table of contents, which is PakHeader::m_entryCount PakEntries
+	/// sorted by the 64 bit hash of their path. Then the path table, which is the null
+	/// terminated path of each entry. Then the blobs, each starting on a multiple of
+	/// PakHeader::m_blobAlignment, so an entry stored uncompressed starts on a page and
+	/// can be used straight from the mapping.
+	///
+	/// Paths are hashed with StringHash::HashString64(), and use forward slashes, same as
+	/// resource IDs. Every field is little-endian and naturally aligned. The version must
+	/// be bumped whenever the layout changes, and old paks are then rejected.
+	/// </summary>
+	namespace PakFormat
+	{
+		/// <summary>
+		/// "EXPK" when read as a little-endian uint32.
+		/// </summary>
+		static constexpr uint32_t kMagic = 0x4B505845;
+
+		static constexpr uint16_t kVersion = 1;
+
+		/// <summary>
+		/// The alignment the packer gives blobs by default. A page on the platforms the engine targets.
+		/// </summary>
+		static constexpr uint32_t kDefaultBlobAlignment = 4096;
+
+		/// <summary>
+		/// How an entry's blob is stored.
+		/// </summary>
+		enum class Compression : uint16_t
+		{
+			kNone = 0,
+			kZlib = 1,
+			kLZ4 = 2
+		};
+	}
+
+	/// <summary>
+	/// The start of every pak.
+	/// </summary>
+	struct PakHeader
+	{
+		uint32_t m_magic;
+		uint16_t m_version;
+		uint16_t m_reserved;
+		uint32_t m_entryCount;
+
+		/// <summary>
+		/// What every blob's offset is a multiple of. A power of two.
+		/// </summary>
+		uint32_t m_blobAlignment;
+
+		/// <summary>
+		/// The size of the path table, which follows the table of contents.
+		/// </summary>
+		uint64_t m_pathTableSize;
+
+		/// <summary>
+		/// The size of the whole pak, to catch truncated files.
+		/// </summary>
+		uint64_t m_archiveSize;
+	};
+
+	/// <summary>
+	/// One entry in the table of contents.
+	/// </summary>
+	struct PakEntry
+	{
+		uint64_t m_pathHash;
+
+		/// <summary>
+		/// Where the blob starts, from the start of the pak.
+		/// </summary>
+		uint64_t m_offset;
+
+		/// <summary>
+		/// The size of the blob as stored, and once decompressed.
+		/// </summary>
+		uint64_t m_storedSize;
+		uint64_t m_size;
+
+		/// <summary>
+		/// The CRC-32 of the decompressed contents.
+		/// </summary>
+		uint32_t m_checksum;
+
+		PakFormat::Compression m_compression;
+		uint16_t m_reserved;
+
+		/// <summary>
+		/// Where the entry's path starts in the path table.
+		/// </summary>
+		uint32_t m_pathOffset;
+		uint32_t m_pathLength;
+	};
+
+	static_assert(sizeof(PakHeader) == 32, "The pak header layout must not change without a version bump.");
+	static_assert(sizeof(PakEntry) == 48, "The pak entry layout must not change without a version bump.");
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include "EXEPCH.h"
+#include "source/utility/io/VirtualFileSystem.h"
+#include "source/utility/io/Archive.h"
+
+#include <EASTL/algorithm.h>
+#include <mutex>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	VirtualFileSystem::VirtualFileSystem()
+		: m_fileSystemLog("ResourceLoader")
+	{
+		//
+	}
+
+	VirtualFileSystem::~VirtualFileSystem()
+	{
+		UnmountAll();
+	}
+
+	bool VirtualFileSystem::Mount(Archive* pArchive, const char* pMountPoint, int priority)
+	{
+		EXE_ASSERT(pArchive);
+		EXE_ASSERT(pMountPoint);
+
+		if (!pArchive->IsOpen())
+		{
+			m_fileSystemLog.Warn("Cannot mount an archive that is not open.");
+			EXELIUS_DELETE(pArchive);
+			return false;
+		}
+
+		MountedArchive mount;
+		mount.m_pArchive = pArchive;
+		mount.m_mountPoint = pMountPoint;
+		mount.m_priority = priority;
+		if (!mount.m_mountPoint.empty() && mount.m_mountPoint.back() != '/')
+			mount.m_mountPoint.push_back('/');
+
+		m_fileSystemLog.Info("Mounting '{}' at '{}' with priority {}.", pArchive->GetArchivePath().c_str(), mount.m_mountPoint.c_str(), priority);
+
+		std::unique_lock<std::shared_mutex> mountLock(m_mountLock);
+
+		// In front of every mount with the same priority, so the most recent is looked up first.
+		auto insertPosition = eastl::find_if(m_mounts.begin(), m_mounts.end(), [priority](const MountedArchive& other)
+			{
+				return other.m_priority <= priority;
+			});
+		m_mounts.insert(insertPosition, mount);
+
+		ClearResolvedPaths();
+		return true;
+	}
+
+	bool VirtualFileSystem::Unmount(const Archive* pArchive)
+	{
+		std::unique_lock<std::shared_mutex> mountLock(m_mountLock);
+
+		auto found = eastl::find_if(m_mounts.begin(), m_mounts.end(), [pArchive](const MountedArchive& mount)
+			{
+				return mount.m_pArchive == pArchive;
+			});
+
+		if (found == m_mounts.end())
+			return false;
+
+		m_fileSystemLog.Info("Unmounting '{}'.", found->m_pArchive->GetArchivePath().c_str());
+		EXELIUS_DELETE(found->m_pArchive);
+		m_mounts.erase(found);
+
+		ClearResolvedPaths();
+		return true;
+	}
+
+	void VirtualFileSystem::UnmountAll()
+	{
+		std::unique_lock<std::shared_mutex> mountLock(m_mountLock);
+
+		for (MountedArchive& mount : m_mounts)
+		{
+			EXELIUS_DELETE(mount.m_pArchive);
+		}
+		m_mounts.clear();
+
+		ClearResolvedPaths();
+	}
+
+	size_t VirtualFileSystem::GetMountCount() const
+	{
+		std::shared_lock<std::shared_mutex> mountLock(m_mountLock);
+		return m_mounts.size();
+	}
+
+	bool VirtualFileSystem::Exists(const eastl::string& path) const
+	{
+		std::shared_lock<std::shared_mutex> mountLock(m_mountLock);
+		return ResolvePath(path) != s_kNotFound;
+	}
+
+	bool VirtualFileSystem::FindFile(const eastl::string& path, FileLocation& location) const
+	{
+		std::shared_lock<std::shared_mutex> mountLock(m_mountLock);
+
+		const size_t mountIndex = ResolvePath(path);
+		if (mountIndex == s_kNotFound)
+			return false;
+
+		const MountedArchive& mount = m_mounts[mountIndex];
+		location.m_pArchive = mount.m_pArchive;
+		location.m_entryPath.assign(path.begin() + mount.m_mountPoint.size(), path.end());
+		location.m_mountIndex = mountIndex;
+		return true;
+	}
+
+	bool VirtualFileSystem::ReadFile(const eastl::string& path, eastl::vector<std::byte>& data) const
+	{
+		FileLocation location;
+		if (!FindFile(path, location))
+			return false;
+
+		return location.m_pArchive->ReadEntry(location.m_entryPath, data);
+	}
+
+	void VirtualFileSystem::ListDirectory(const eastl::string& directoryPath, bool recursive, eastl::vector<eastl::string>& filePaths) const
+	{
+		eastl::string listedPath = directoryPath;
+		if (!listedPath.empty() && listedPath.back() != '/')
+			listedPath.push_back('/');
+
+		const size_t firstNewPath = filePaths.size();
+		eastl::vector<eastl::string> entryPaths;
+
+		std::shared_lock<std::shared_mutex> mountLock(m_mountLock);
+		for (const MountedArchive& mount : m_mounts)
+		{
+			entryPaths.clear();
+
+			if (listedPath.compare(0, mount.m_mountPoint.size(), mount.m_mountPoint) == 0)
+			{
+				// The directory is inside the mount.
+				mount.m_pArchive->ListEntries(listedPath.substr(mount.m_mountPoint.size()), recursive, entryPaths);
+			}
+			else if (recursive && mount.m_mountPoint.compare(0, listedPath.size(), listedPath) == 0)
+			{
+				// The whole mount is somewhere below the directory.
+				mount.m_pArchive->ListEntries(eastl::string(), true, entryPaths);
+			}
+
+			for (const eastl::string& entryPath : entryPaths)
+			{
+				filePaths.emplace_back(mount.m_mountPoint + entryPath);
+			}
+		}
+
+		// Paths overridden by another mount are listed once.
+		eastl::sort(filePaths.begin() + firstNewPath, filePaths.end());
+		filePaths.erase(eastl::unique(filePaths.begin() + firstNewPath, filePaths.end()), filePaths.end());
+	}
+
+	void VirtualFileSystem::InvalidatePath(const eastl::string& path)
+	{
+		// Exclusive, so a lookup of the path that is still running can't cache its old result afterwards.
+		std::unique_lock<std::shared_mutex> mountLock(m_mountLock);
+		std::unique_lock<std::shared_mutex> resolvedPathLock(m_resolvedPathLock);
+		m_resolvedPaths.erase(path);
+	}
+
+	size_t VirtualFileSystem::ResolvePath(const eastl::string& path) const
+	{
+		{
+			std::shared_lock<std::shared_mutex> resolvedPathLock(m_resolvedPathLock);
+			auto found = m_resolvedPaths.find(path);
+			if (found != m_resolvedPaths.end())
+				return found->second;
+		}
+
+		size_t mountIndex = s_kNotFound;
+		eastl::string entryPath;
+		for (size_t i = 0; i < m_mounts.size(); ++i)
+		{
+			const MountedArchive& mount = m_mounts[i];
+			if (path.size() <= mount.m_mountPoint.size() || path.compare(0, mount.m_mountPoint.size(), mount.m_mountPoint) != 0)
+				continue;
+
+			entryPath.assign(path.begin() + mount.m_mountPoint.size(), path.end());
+			if (mount.m_pArchive->Contains(entryPath))
+			{
+				mountIndex = i;
+				break;
+			}
+		}
+
+		// Still holding the mount lock, so no mount can change before this is cached.
+		std::unique_lock<std::shared_mutex> resolvedPathLock(m_resolvedPathLock);
+		m_resolvedPaths.emplace(path, mountIndex);
+		return mountIndex;
+	}
+
+	void VirtualFileSystem::ClearResolvedPaths()
+	{
+		std::unique_lock<std::shared_mutex> resolvedPathLock(m_resolvedPathLock);
+		m_resolvedPaths.clear();
+	}
+}
\ No newline at end of file
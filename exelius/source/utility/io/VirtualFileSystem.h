@@ -0,0 +1,178 @@
+#pragma once
+#include "source/debug/Log.h"
+
+#include <EASTL/string.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	class Archive;
+
+	/// <summary>
+	/// One tree of paths over every mounted Archive: loose directories, zips, paks and
+	/// in memory stores. Each archive is mounted at a mount point, a path prefix its
+	/// entries appear under, with a priority. A path is looked up in the mounts that
+	/// cover it from the highest priority to the lowest, and mounts with equal priority
+	/// from the most recently mounted, so patches and mods override what they replace.
+	///
+	/// Which mount a path resolved to, or that no mount has it, is cached. Repeated
+	/// lookups of a path cost a hash map lookup, and never ask the OS again. Mounting or
+	/// unmounting clears the cache, and InvalidatePath() drops a single path, for files
+	/// that appear on disk after they were looked up.
+	///
+	/// Lookups, reads and listings are safe from any number of threads at once. Mounting
+	/// is safe at any time, but an archive must not be unmounted while it is being read,
+	/// since the archives are used outside the lock.
+	/// @see Archive
+	/// </summary>
+	class VirtualFileSystem
+	{
+		/// <summary>
+		/// An archive and where it is mounted.
+		/// </summary>
+		struct MountedArchive
+		{
+			Archive* m_pArchive;
+
+			/// <summary>
+			/// Empty, or ending with a slash.
+			/// </summary>
+			eastl::string m_mountPoint;
+
+			int m_priority;
+		};
+
+		/// <summary>
+		/// Marks a path that no mount has in the cache.
+		/// </summary>
+		static constexpr size_t s_kNotFound = static_cast<size_t>(-1);
+
+		Log m_fileSystemLog;
+
+		/// <summary>
+		/// Every mount, in the order paths are looked up in them.
+		/// </summary>
+		eastl::vector<MountedArchive> m_mounts;
+
+		/// <summary>
+		/// Guards the mounts. Shared while looking up paths, exclusive while mounting.
+		/// </summary>
+		mutable std::shared_mutex m_mountLock;
+
+		/// <summary>
+		/// The index of the mount each path was found in, or s_kNotFound.
+		/// </summary>
+		mutable eastl::unordered_map<eastl::string, size_t> m_resolvedPaths;
+
+		/// <summary>
+		/// Guards the resolved paths, so threads looking up cached paths don't wait on each other.
+		/// </summary>
+		mutable std::shared_mutex m_resolvedPathLock;
+
+	public:
+		/// <summary>
+		/// Where a path was found.
+		/// </summary>
+		struct FileLocation
+		{
+			Archive* m_pArchive;
+
+			/// <summary>
+			/// The path inside the archive, without the mount point.
+			/// </summary>
+			eastl::string m_entryPath;
+
+			/// <summary>
+			/// The position of the mount in the lookup order. Lower is looked up first.
+			/// </summary>
+			size_t m_mountIndex;
+		};
+
+		VirtualFileSystem();
+		VirtualFileSystem(const VirtualFileSystem&) = delete;
+		VirtualFileSystem(VirtualFileSystem&&) = delete;
+		VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+		VirtualFileSystem& operator=(VirtualFileSystem&&) = delete;
+		~VirtualFileSystem();
+
+		/// <summary>
+		/// Mounts an open archive, taking ownership of it.
+		/// </summary>
+		/// <param name="pArchive">- The archive to mount. Deleted when unmounted, or here if mounting fails.</param>
+		/// <param name="pMountPoint">- The path prefix the archive's entries appear under. Empty for the root.</param>
+		/// <param name="priority">- Higher priorities are looked up first.</param>
+		/// <returns>True if the archive was mounted.</returns>
+		bool Mount(Archive* pArchive, const char* pMountPoint = "", int priority = 0);
+
+		/// <summary>
+		/// Unmounts and deletes an archive. Must not be called while the archive is being read.
+		/// </summary>
+		/// <param name="pArchive">- The archive to unmount.</param>
+		/// <returns>True if the archive was mounted.</returns>
+		bool Unmount(const Archive* pArchive);
+
+		/// <summary>
+		/// Unmounts and deletes every archive. Must not be called while files are being read.
+		/// </summary>
+		void UnmountAll();
+
+		size_t GetMountCount() const;
+
+		/// <summary>
+		/// Checks if any mount has a path.
+		/// </summary>
+		/// <param name="path">- The path to look up.</param>
+		/// <returns>True if the path was found.</returns>
+		bool Exists(const eastl::string& path) const;
+
+		/// <summary>
+		/// Finds the mount with the highest priority that has a path.
+		/// </summary>
+		/// <param name="path">- The path to look up.</param>
+		/// <param name="location">- Receives the archive and the path inside it.</param>
+		/// <returns>True if the path was found.</returns>
+		bool FindFile(const eastl::string& path, FileLocation& location) const;
+
+		/// <summary>
+		/// Reads the file at a path into a buffer, from the mount with the highest priority that has it.
+		/// </summary>
+		/// <param name="path">- The path to read.</param>
+		/// <param name="data">- Receives the file.</param>
+		/// <returns>True if the path was found and read.</returns>
+		bool ReadFile(const eastl::string& path, eastl::vector<std::byte>& data) const;
+
+		/// <summary>
+		/// Lists the files under a directory, across every mount. Each path is listed once,
+		/// however many mounts have it.
+		/// </summary>
+		/// <param name="directoryPath">- The directory. Empty for the root.</param>
+		/// <param name="recursive">- True to include files in every directory below it.</param>
+		/// <param name="filePaths">- Receives the path of each file, sorted.</param>
+		void ListDirectory(const eastl::string& directoryPath, bool recursive, eastl::vector<eastl::string>& filePaths) const;
+
+		/// <summary>
+		/// Drops the cached lookup of a path, so it is looked up in the mounts again.
+		/// </summary>
+		/// <param name="path">- The path that changed.</param>
+		void InvalidatePath(const eastl::string& path);
+
+	private:
+		/// <summary>
+		/// Looks up a path in the mounts, or the cache. The mount lock must be held.
+		/// </summary>
+		/// <returns>The index of the mount that has the path, or s_kNotFound.</returns>
+		size_t ResolvePath(const eastl::string& path) const;
+
+		/// <summary>
+		/// Drops every cached lookup. The mount lock must be held exclusively.
+		/// </summary>
+		void ClearResolvedPaths();
+	};
+}
\ No newline at end of file
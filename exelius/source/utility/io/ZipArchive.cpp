@@ -0,0 +1,328 @@
+#include "EXEPCH.h"
+#include "source/utility/io/ZipArchive.h"
+#include "source/utility/io/ZLIBStructs.h"
+
+#include <EASTL/algorithm.h>
+#include <cstring>
+#include <zlib.h>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	// Compression methods we can read.
+	static constexpr uint16_t kZipStored = 0;
+	static constexpr uint16_t kZipDeflated = Z_DEFLATED;
+
+	// General purpose flag bit set on encrypted entries.
+	static constexpr uint16_t kZipEncryptedFlag = 0x0001;
+
+	// The end of central directory record is followed by a comment of up to 64KB.
+	static constexpr size_t kMaxZipCommentSize = 0xFFFF;
+
+	ZipArchive::ZipArchive()
+		: m_archiveLog("ResourceLoader")
+		, m_pEntries(nullptr)
+		, m_entryCount(0)
+	{
+		//
+	}
+
+	ZipArchive::~ZipArchive()
+	{
+		Close();
+	}
+
+	bool ZipArchive::Open(const char* pArchivePath)
+	{
+		EXE_ASSERT(pArchivePath);
+
+		if (IsOpen())
+		{
+			m_archiveLog.Warn("Attempting to open a zip archive that is already open: {}", m_archivePath.c_str());
+			Close();
+		}
+
+		if (!m_mappedFile.Open(pArchivePath))
+		{
+			m_archiveLog.Warn("Failed to map zip archive: {}", pArchivePath);
+			return false;
+		}
+
+		m_archivePath = pArchivePath;
+
+		if (!ReadCentralDirectory(m_mappedFile.GetSize()))
+		{
+			m_archiveLog.Warn("Failed to read the central directory of zip archive: {}", pArchivePath);
+			Close();
+			return false;
+		}
+
+		m_archiveLog.Info("Opened zip archive '{}' with {} entries.", pArchivePath, m_entryCount);
+		return true;
+	}
+
+	void ZipArchive::Close()
+	{
+		m_mappedFile.Close();
+		EXELIUS_DELETE_ARRAY(m_pEntries);
+		m_entryCount = 0;
+		m_entryIndices.clear();
+		m_archivePath.clear();
+	}
+
+	bool ZipArchive::Contains(const eastl::string& entryPath) const
+	{
+		return m_entryIndices.find(NormalizePath(entryPath)) != m_entryIndices.end();
+	}
+
+	bool ZipArchive::GetEntryOffset(const eastl::string& entryPath, uint64_t& offset) const
+	{
+		auto indexIterator = m_entryIndices.find(NormalizePath(entryPath));
+		if (indexIterator == m_entryIndices.end())
+			return false;
+
+		offset = m_pEntries[indexIterator->second].m_localHeaderOffset;
+		return true;
+	}
+
+	bool ZipArchive::ReadEntry(const eastl::string& entryPath, eastl::vector<std::byte>& data) const
+	{
+		auto indexIterator = m_entryIndices.find(NormalizePath(entryPath));
+		if (indexIterator == m_entryIndices.end())
+			return false;
+
+		const Entry& entry = m_pEntries[indexIterator->second];
+		eastl::span<const std::byte> storedBytes;
+		if (!GetStoredBytes(entry, storedBytes))
+		{
+			m_archiveLog.Warn("Corrupt local header or size for '{}' in zip archive: {}", entryPath.c_str(), m_archivePath.c_str());
+			return false;
+		}
+
+		if (entry.m_compression == kZipStored)
+		{
+			data.assign(storedBytes.begin(), storedBytes.end());
+		}
+		else
+		{
+			data.resize(entry.m_uncompressedSize);
+
+			z_stream stream;
+			std::memset(&stream, 0, sizeof(stream));
+			stream.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(storedBytes.data()));
+			stream.avail_in = static_cast<uInt>(storedBytes.size());
+			stream.next_out = reinterpret_cast<Bytef*>(data.data());
+			stream.avail_out = static_cast<uInt>(data.size());
+
+			// Negative window bits: zip entries are raw deflate streams, without a zlib header.
+			int result = inflateInit2(&stream, -MAX_WBITS);
+			if (result == Z_OK)
+			{
+				result = inflate(&stream, Z_FINISH);
+				inflateEnd(&stream);
+			}
+
+			if (result != Z_STREAM_END || stream.total_out != entry.m_uncompressedSize)
+			{
+				m_archiveLog.Warn("Failed to inflate '{}' from zip archive: {}. zlib result: {}", entryPath.c_str(), m_archivePath.c_str(), result);
+				data.clear();
+				return false;
+			}
+		}
+
+		if (!VerifyChecksum(entry, data))
+		{
+			m_archiveLog.Warn("CRC mismatch for '{}' in zip archive: {}", entryPath.c_str(), m_archivePath.c_str());
+			data.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool ZipArchive::GetEntryView(const eastl::string& entryPath, eastl::span<const std::byte>& view) const
+	{
+		auto indexIterator = m_entryIndices.find(NormalizePath(entryPath));
+		if (indexIterator == m_entryIndices.end())
+			return false;
+
+		const Entry& entry = m_pEntries[indexIterator->second];
+		if (entry.m_compression != kZipStored)
+			return false;
+
+		eastl::span<const std::byte> storedBytes;
+		if (!GetStoredBytes(entry, storedBytes))
+		{
+			m_archiveLog.Warn("Corrupt local header or size for '{}' in zip archive: {}", entryPath.c_str(), m_archivePath.c_str());
+			return false;
+		}
+
+		if (!VerifyChecksum(entry, storedBytes))
+		{
+			m_archiveLog.Warn("CRC mismatch for '{}' in zip archive: {}", entryPath.c_str(), m_archivePath.c_str());
+			return false;
+		}
+
+		view = storedBytes;
+		return true;
+	}
+
+	void ZipArchive::ListEntries(const eastl::string& directoryPath, bool recursive, eastl::vector<eastl::string>& entryPaths) const
+	{
+		const eastl::string normalizedDirectoryPath = NormalizePath(directoryPath);
+		for (const auto& entryIndex : m_entryIndices)
+		{
+			if (IsUnderDirectory(entryIndex.first.c_str(), entryIndex.first.size(), normalizedDirectoryPath, recursive))
+				entryPaths.emplace_back(entryIndex.first);
+		}
+	}
+
+	bool ZipArchive::ReadCentralDirectory(uint64_t archiveSize)
+	{
+		if (archiveSize < sizeof(ZipDirHeader))
+			return false;
+
+		// The end of central directory record sits at the end of the file, before the comment.
+		const size_t tailSize = static_cast<size_t>(eastl::min<uint64_t>(archiveSize, sizeof(ZipDirHeader) + kMaxZipCommentSize));
+		eastl::span<const std::byte> tail;
+		if (!GetBytesAt(archiveSize - tailSize, tailSize, tail))
+			return false;
+
+		ZipDirHeader dirHeader;
+		bool foundDirHeader = false;
+		for (size_t headerOffset = tailSize - sizeof(ZipDirHeader) + 1; headerOffset-- > 0;)
+		{
+			std::memcpy(&dirHeader, tail.data() + headerOffset, sizeof(dirHeader));
+			if (dirHeader.sig == ZipDirHeader::kSignature)
+			{
+				foundDirHeader = true;
+				break;
+			}
+		}
+
+		if (!foundDirHeader || dirHeader.nDisk != 0 || dirHeader.nStartDisk != 0)
+			return false;
+
+		eastl::span<const std::byte> directory;
+		if (!GetBytesAt(dirHeader.dirOffset, dirHeader.dirSize, directory))
+			return false;
+
+		m_pEntries = EXELIUS_NEW_ARRAY(Entry, dirHeader.totalDirEntries);
+		m_entryIndices.reserve(dirHeader.totalDirEntries);
+
+		size_t directoryOffset = 0;
+		for (uint16_t entryIndex = 0; entryIndex < dirHeader.totalDirEntries; ++entryIndex)
+		{
+			ZipDirFileHeader fileHeader;
+			if (directoryOffset + sizeof(fileHeader) > directory.size())
+				return false;
+
+			std::memcpy(&fileHeader, directory.data() + directoryOffset, sizeof(fileHeader));
+			if (fileHeader.sig != ZipDirFileHeader::kSignature)
+				return false;
+
+			const size_t nameOffset = directoryOffset + sizeof(fileHeader);
+			directoryOffset = nameOffset + fileHeader.fnameLen + fileHeader.xtraLen + fileHeader.cmntLen;
+			if (directoryOffset > directory.size())
+				return false;
+
+			eastl::string entryPath(reinterpret_cast<const char*>(directory.data() + nameOffset), fileHeader.fnameLen);
+
+			// Directories have no data.
+			if (entryPath.empty() || entryPath.back() == '/')
+				continue;
+
+			if (fileHeader.flag & kZipEncryptedFlag)
+			{
+				m_archiveLog.Warn("Skipping encrypted entry '{}' in zip archive: {}", entryPath.c_str(), m_archivePath.c_str());
+				continue;
+			}
+
+			if (fileHeader.compression != kZipStored && fileHeader.compression != kZipDeflated)
+			{
+				m_archiveLog.Warn("Skipping entry '{}' with unsupported compression method {} in zip archive: {}", entryPath.c_str(), fileHeader.compression, m_archivePath.c_str());
+				continue;
+			}
+
+			if (fileHeader.cSize == 0xFFFFFFFF || fileHeader.ucSize == 0xFFFFFFFF || fileHeader.hdrOffset == 0xFFFFFFFF)
+			{
+				m_archiveLog.Warn("Skipping Zip64 entry '{}' in zip archive: {}", entryPath.c_str(), m_archivePath.c_str());
+				continue;
+			}
+
+			// Stored entries are viewed by their compressed size, so the two must agree.
+			if (fileHeader.compression == kZipStored && fileHeader.cSize != fileHeader.ucSize)
+			{
+				m_archiveLog.Warn("Skipping stored entry '{}' with mismatched sizes in zip archive: {}", entryPath.c_str(), m_archivePath.c_str());
+				continue;
+			}
+
+			Entry& entry = m_pEntries[m_entryCount];
+			entry.m_localHeaderOffset = fileHeader.hdrOffset;
+			entry.m_compressedSize = fileHeader.cSize;
+			entry.m_uncompressedSize = fileHeader.ucSize;
+			entry.m_crc32 = fileHeader.crc32;
+			entry.m_compression = fileHeader.compression;
+			entry.m_dataOffset.store(0, std::memory_order_relaxed);
+
+			if (!m_entryIndices.emplace(NormalizePath(entryPath), m_entryCount).second)
+			{
+				m_archiveLog.Warn("Skipping duplicate entry '{}' in zip archive: {}", entryPath.c_str(), m_archivePath.c_str());
+				continue;
+			}
+
+			++m_entryCount;
+		}
+
+		return true;
+	}
+
+	bool ZipArchive::GetStoredBytes(const Entry& entry, eastl::span<const std::byte>& storedBytes) const
+	{
+		uint64_t dataOffset = entry.m_dataOffset.load(std::memory_order_acquire);
+		if (dataOffset == 0)
+		{
+			// Two threads may both get here for the same entry. They will find the same answer.
+			eastl::span<const std::byte> localHeaderBytes;
+			if (!GetBytesAt(entry.m_localHeaderOffset, sizeof(ZipLocalHeader), localHeaderBytes))
+				return false;
+
+			// Local headers aren't aligned in the archive, so copy it out rather than reading it in place.
+			ZipLocalHeader localHeader;
+			std::memcpy(&localHeader, localHeaderBytes.data(), sizeof(localHeader));
+			if (localHeader.sig != ZipLocalHeader::kSignature)
+				return false;
+
+			dataOffset = entry.m_localHeaderOffset + sizeof(localHeader) + localHeader.fnameLen + localHeader.xtraLen;
+			entry.m_dataOffset.store(dataOffset, std::memory_order_release);
+		}
+
+		return GetBytesAt(dataOffset, entry.m_compressedSize, storedBytes);
+	}
+
+	bool ZipArchive::GetBytesAt(uint64_t offset, uint64_t size, eastl::span<const std::byte>& bytes) const
+	{
+		const eastl::span<const std::byte> archiveBytes = m_mappedFile.GetBytes();
+		if (offset > archiveBytes.size() || size > archiveBytes.size() - offset)
+			return false;
+
+		bytes = eastl::span<const std::byte>(archiveBytes.data() + offset, static_cast<size_t>(size));
+		return true;
+	}
+
+	bool ZipArchive::VerifyChecksum(const Entry& entry, eastl::span<const std::byte> data)
+	{
+		// Entry sizes are 32 bits, as Zip64 entries are skipped, so one call covers the whole entry.
+		const uLong crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size()));
+		return crc == entry.m_crc32;
+	}
+
+	eastl::string ZipArchive::NormalizePath(const eastl::string& path)
+	{
+		eastl::string normalizedPath = path;
+		eastl::replace(normalizedPath.begin(), normalizedPath.end(), '\\', '/');
+		return normalizedPath;
+	}
+}
\ No newline at end of file
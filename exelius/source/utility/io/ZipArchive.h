@@ -0,0 +1,163 @@
+#pragma once
+#include "source/debug/Log.h"
+#include "source/utility/io/Archive.h"
+#include "source/utility/io/MappedFile.h"
+
+#include <EASTL/string.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Engine namespace. Everything owned by the engine will be inside this namespace.
+/// </summary>
+namespace Exelius
+{
+	/// <summary>
+	/// A read only zip file. The whole file is memory mapped on Open(), and the central
+	/// directory is read once into an index keyed by path, so looking up an entry never
+	/// touches the archive.
+	///
+	/// Stored entries are handed out as views of the mapping with GetEntryView(), so their
+	/// bytes are never copied. Deflated entries are inflated from the mapping into the
+	/// caller's buffer with ReadEntry(). The CRC of an entry is checked every time it is
+	/// read or viewed.
+	///
+	/// Nothing is shared between reads, so any number of threads may read at once.
+	/// Open() and Close() must not be called while other threads are reading, and views
+	/// are only valid until Close().
+	///
+	/// Only stored and deflated entries are supported. Encrypted and Zip64 entries are
+	/// skipped with a warning when the archive is opened.
+	/// </summary>
+	class ZipArchive
+		: public Archive
+	{
+		/// <summary>
+		/// Everything needed to read an entry, taken from its central directory header.
+		/// </summary>
+		struct Entry
+		{
+			uint64_t m_localHeaderOffset;
+			uint32_t m_compressedSize;
+			uint32_t m_uncompressedSize;
+			uint32_t m_crc32;
+			uint16_t m_compression;
+
+			/// <summary>
+			/// Where the entry's data starts. The local header's extra field may not match
+			/// the central directory's, so this is 0 until the first read of the entry looks.
+			/// </summary>
+			mutable std::atomic<uint64_t> m_dataOffset;
+		};
+
+		Log m_archiveLog;
+
+		MappedFile m_mappedFile;
+		eastl::string m_archivePath;
+
+		/// <summary>
+		/// One entry per file in the archive. Never resized after Open().
+		/// </summary>
+		Entry* m_pEntries;
+		size_t m_entryCount;
+
+		/// <summary>
+		/// Index into m_pEntries, keyed by the entry's path with forward slashes.
+		/// </summary>
+		eastl::unordered_map<eastl::string, size_t> m_entryIndices;
+
+	public:
+		ZipArchive();
+		ZipArchive(const ZipArchive&) = delete;
+		ZipArchive(ZipArchive&&) = delete;
+		ZipArchive& operator=(const ZipArchive&) = delete;
+		ZipArchive& operator=(ZipArchive&&) = delete;
+		virtual ~ZipArchive() final override;
+
+		/// <summary>
+		/// Opens the archive and indexes its central directory.
+		/// </summary>
+		/// <param name="pArchivePath">- Path to the zip file.</param>
+		/// <returns>True if the archive was opened and indexed.</returns>
+		virtual bool Open(const char* pArchivePath) final override;
+
+		/// <summary>
+		/// Closes the archive and drops the index.
+		/// </summary>
+		virtual void Close() final override;
+
+		virtual bool IsOpen() const final override { return m_pEntries != nullptr; }
+		virtual const eastl::string& GetArchivePath() const final override { return m_archivePath; }
+		virtual size_t GetEntryCount() const final override { return m_entryCount; }
+
+		/// <summary>
+		/// Checks the index for an entry. Never touches the disk.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the archive.</param>
+		/// <returns>True if the archive holds the entry.</returns>
+		virtual bool Contains(const eastl::string& entryPath) const final override;
+
+		/// <summary>
+		/// Finds where an entry starts in the archive, for ordering reads. Never touches the disk.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the archive.</param>
+		/// <param name="offset">- Receives the offset of the entry's local header.</param>
+		/// <returns>True if the archive holds the entry.</returns>
+		virtual bool GetEntryOffset(const eastl::string& entryPath, uint64_t& offset) const final override;
+
+		/// <summary>
+		/// Copies or inflates an entry into a buffer. Safe to call from multiple threads at once.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the archive.</param>
+		/// <param name="data">- Receives the uncompressed entry.</param>
+		/// <returns>True if the entry was found and read intact.</returns>
+		virtual bool ReadEntry(const eastl::string& entryPath, eastl::vector<std::byte>& data) const final override;
+
+		/// <summary>
+		/// Finds a stored entry, and checks it is intact, without copying it.
+		/// Safe to call from multiple threads at once.
+		/// </summary>
+		/// <param name="entryPath">- Path of the entry inside the archive.</param>
+		/// <param name="view">- Receives the entry's bytes in the mapping. Valid until Close().</param>
+		/// <returns>True if the entry was found intact and is stored uncompressed.</returns>
+		virtual bool GetEntryView(const eastl::string& entryPath, eastl::span<const std::byte>& view) const final override;
+
+		/// <summary>
+		/// Lists the entries under a directory of the archive. Never touches the disk.
+		/// </summary>
+		/// <param name="directoryPath">- The directory, empty or ending with a slash.</param>
+		/// <param name="recursive">- True to include entries in every directory below it.</param>
+		/// <param name="entryPaths">- Receives the full path of each entry, in no particular order.</param>
+		virtual void ListEntries(const eastl::string& directoryPath, bool recursive, eastl::vector<eastl::string>& entryPaths) const final override;
+
+	private:
+		/// <summary>
+		/// Reads the central directory into m_pEntries and m_entryIndices.
+		/// </summary>
+		bool ReadCentralDirectory(uint64_t archiveSize);
+
+		/// <summary>
+		/// Finds an entry's data in the mapping, reading its local header the first time.
+		/// </summary>
+		bool GetStoredBytes(const Entry& entry, eastl::span<const std::byte>& storedBytes) const;
+
+		/// <summary>
+		/// Finds size bytes at offset in the mapping.
+		/// </summary>
+		/// <returns>False if any of them are past the end of the archive.</returns>
+		bool GetBytesAt(uint64_t offset, uint64_t size, eastl::span<const std::byte>& bytes) const;
+
+		/// <summary>
+		/// Checks an entry's uncompressed bytes against the CRC from its central directory header.
+		/// </summary>
+		static bool VerifyChecksum(const Entry& entry, eastl::span<const std::byte> data);
+
+		/// <summary>
+		/// Zip paths always use forward slashes, but our resource IDs may not.
+		/// </summary>
+		static eastl::string NormalizePath(const eastl::string& path);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "source/utility/containers/RingBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Microbenchmark for the ring buffers in RingBuffer.h.
+// Pushes the same number of elements through each buffer at every combination of 1 to N producers
+// and consumers, and prints the throughput. N defaults to the hardware thread count, or pass it in.
+//
+// Usage: exeliusbenchmarks [maxThreadsPerSide]
+
+namespace
+{
+	using Element = uint64_t;
+
+	static constexpr size_t kBufferSize = 1024;
+	static constexpr size_t kElementsPerRun = 1 << 21;
+
+	template <typename Buffer>
+	double RunBenchmark(uint32_t producerCount, uint32_t consumerCount)
+	{
+		std::unique_ptr<Buffer> pBuffer = std::make_unique<Buffer>();
+
+		const size_t elementsPerProducer = kElementsPerRun / producerCount;
+		std::atomic<bool> isStarted(false);
+		std::atomic<uint32_t> finishedProducers(0);
+
+		std::vector<std::thread> threads;
+		threads.reserve(producerCount + consumerCount);
+
+		for (uint32_t producerIndex = 0; producerIndex < producerCount; ++producerIndex)
+		{
+			threads.emplace_back([&pBuffer, &isStarted, &finishedProducers, elementsPerProducer]()
+				{
+					while (!isStarted.load(std::memory_order_acquire))
+						std::this_thread::yield();
+
+					for (size_t elementIndex = 0; elementIndex < elementsPerProducer; ++elementIndex)
+					{
+						while (!pBuffer->PushBack(static_cast<Element>(elementIndex)))
+							std::this_thread::yield();
+					}
+
+					finishedProducers.fetch_add(1, std::memory_order_release);
+				});
+		}
+
+		for (uint32_t consumerIndex = 0; consumerIndex < consumerCount; ++consumerIndex)
+		{
+			threads.emplace_back([&pBuffer, &isStarted, &finishedProducers, producerCount]()
+				{
+					while (!isStarted.load(std::memory_order_acquire))
+						std::this_thread::yield();
+
+					Element element = 0;
+					for (;;)
+					{
+						if (pBuffer->PopFront(element))
+							continue;
+
+						// Once every producer is done, an empty buffer means there is nothing left to take.
+						if (finishedProducers.load(std::memory_order_acquire) == producerCount)
+						{
+							if (!pBuffer->PopFront(element))
+								break;
+							continue;
+						}
+
+						std::this_thread::yield();
+					}
+				});
+		}
+
+		const auto startTime = std::chrono::high_resolution_clock::now();
+		isStarted.store(true, std::memory_order_release);
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+		return static_cast<double>(elementsPerProducer * producerCount) / elapsed.count() / 1000000.0;
+	}
+
+	template <typename Buffer>
+	void RunBenchmarks(const char* pBufferName, uint32_t maxProducers, uint32_t maxConsumers)
+	{
+		for (uint32_t producerCount = 1; producerCount <= maxProducers; ++producerCount)
+		{
+			for (uint32_t consumerCount = 1; consumerCount <= maxConsumers; ++consumerCount)
+			{
+				const double millionsPerSecond = RunBenchmark<Buffer>(producerCount, consumerCount);
+				std::printf("%-16s %9u %9u %14.2f\n", pBufferName, producerCount, consumerCount, millionsPerSecond);
+			}
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t maxThreads = std::thread::hardware_concurrency();
+	if (argc > 1)
+		maxThreads = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10));
+	if (maxThreads == 0)
+		maxThreads = 1;
+
+	std::printf("%zu elements per run, buffer size %zu.\n\n", kElementsPerRun, kBufferSize);
+	std::printf("%-16s %9s %9s %14s\n", "Buffer", "Producers", "Consumers", "M elements/s");
+
+	// The SPSC buffer only allows one thread on each side.
+	RunBenchmarks<Exelius::RingBufferSPSC<Element, kBufferSize>>("RingBufferSPSC", 1, 1);
+	RunBenchmarks<Exelius::RingBufferMT<Element, kBufferSize>>("RingBufferMT", maxThreads, maxThreads);
+	RunBenchmarks<Exelius::RingBufferMPMC<Element, kBufferSize>>("RingBufferMPMC", maxThreads, maxThreads);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "source/engine/resources/CookedResourceFormat.h"
+#include "source/utility/io/BlobWriter.h"
+
+#include <rapidjson/document.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+// Offline asset cooker. Mirrors a directory of raw assets into an output directory, converting
+// the JSON formats the engine can load in binary form (.spsh and .font) into the cooked formats
+// in CookedResourceFormat.h, and copying every other file as is. The output keeps the same names,
+// so it can be packed into an archive and loaded with the same resource IDs.
+//
+// Files whose output is newer than their source are skipped, unless --force is passed.
+//
+// Usage: exeliuscooker <sourceDirectory> <outputDirectory> [--force]
+
+namespace
+{
+	namespace fs = std::filesystem;
+	using namespace Exelius;
+
+	/// <summary>
+	/// Null terminated strings, each stored once, referred to by their offset.
+	/// </summary>
+	class StringTable
+	{
+		std::vector<char> m_chars;
+		std::unordered_map<std::string, uint32_t> m_offsets;
+
+	public:
+		uint32_t Add(const std::string& string)
+		{
+			auto found = m_offsets.find(string);
+			if (found != m_offsets.end())
+				return found->second;
+
+			const uint32_t offset = static_cast<uint32_t>(m_chars.size());
+			m_chars.insert(m_chars.end(), string.begin(), string.end());
+			m_chars.push_back('\0');
+			m_offsets.emplace(string, offset);
+			return offset;
+		}
+
+		uint32_t GetSize() const { return static_cast<uint32_t>(m_chars.size()); }
+		const std::vector<char>& GetChars() const { return m_chars; }
+	};
+
+	/// <summary>
+	/// Writes the header in front of a finished payload.
+	/// </summary>
+	std::vector<uint8_t> WriteCookedFile(CookedFormat::Kind kind, uint16_t version, const BlobWriter& payload)
+	{
+		BlobWriter file;
+		file.WriteU32(CookedFormat::kMagic);
+		file.WriteU16(static_cast<uint16_t>(kind));
+		file.WriteU16(version);
+		file.WriteU32(static_cast<uint32_t>(payload.GetSize()));
+		file.WriteU32(0);
+		file.WriteBytes(payload.GetBytes());
+		return file.GetBytes();
+	}
+
+	float GetFloatMember(const rapidjson::Value& object, const char* pName)
+	{
+		auto member = object.FindMember(pName);
+		if (member == object.MemberEnd() || !member->value.IsNumber())
+			return 0.0f;
+
+		return member->value.GetFloat();
+	}
+
+	/// <summary>
+	/// Cooks a spritesheet. Sprites missing a source field default it to 0, like the runtime does.
+	/// </summary>
+	bool CookSpritesheet(const rapidjson::Document& jsonDoc, std::vector<uint8_t>& cookedFile, std::string& error)
+	{
+		auto textureMember = jsonDoc.FindMember("Texture");
+		if (textureMember == jsonDoc.MemberEnd() || !textureMember->value.IsString())
+		{
+			error = "no 'Texture' string. Spritesheets must have a texture.";
+			return false;
+		}
+
+		auto spriteMember = jsonDoc.FindMember("Sprites");
+		if (spriteMember == jsonDoc.MemberEnd() || !spriteMember->value.IsObject() || spriteMember->value.MemberCount() == 0)
+		{
+			error = "no 'Sprites' object. Spritesheets must have at least 1 sprite.";
+			return false;
+		}
+
+		StringTable strings;
+		const uint32_t textureNameOffset = strings.Add(textureMember->value.GetString());
+
+		BlobWriter sprites;
+		uint32_t spriteCount = 0;
+		for (auto spriteItr = spriteMember->value.MemberBegin(); spriteItr != spriteMember->value.MemberEnd(); ++spriteItr)
+		{
+			if (!spriteItr->value.IsObject())
+			{
+				error = std::string("sprite '") + spriteItr->name.GetString() + "' is not an object.";
+				return false;
+			}
+
+			sprites.WriteU32(strings.Add(spriteItr->name.GetString()));
+			sprites.WriteF32(GetFloatMember(spriteItr->value, "sourceX"));
+			sprites.WriteF32(GetFloatMember(spriteItr->value, "sourceY"));
+			sprites.WriteF32(GetFloatMember(spriteItr->value, "sourceW"));
+			sprites.WriteF32(GetFloatMember(spriteItr->value, "sourceH"));
+			++spriteCount;
+		}
+
+		BlobWriter payload;
+		payload.WriteU32(textureNameOffset);
+		payload.WriteU32(spriteCount);
+		payload.WriteU32(strings.GetSize());
+		payload.WriteU32(0);
+		payload.WriteBytes(sprites.GetBytes());
+		payload.WriteChars(strings.GetChars());
+
+		cookedFile = WriteCookedFile(CookedFormat::Kind::kSpritesheet, CookedFormat::kSpritesheetVersion, payload);
+		return true;
+	}
+
+	/// <summary>
+	/// Cooks a font, laying out the glyphs of a monospaced font the same way the runtime does.
+	/// </summary>
+	bool CookFont(const rapidjson::Document& jsonDoc, std::vector<uint8_t>& cookedFile, std::string& error)
+	{
+		auto textureMember = jsonDoc.FindMember("Texture");
+		if (textureMember == jsonDoc.MemberEnd() || !textureMember->value.IsString())
+		{
+			error = "no 'Texture' string. Fonts must have a texture.";
+			return false;
+		}
+
+		StringTable strings;
+		const uint32_t textureNameOffset = strings.Add(textureMember->value.GetString());
+
+		BlobWriter glyphs;
+		uint32_t glyphCount = 0;
+		float defaultWidth = 0.0f;
+		float defaultHeight = 0.0f;
+
+		auto monospaced = jsonDoc.FindMember("Monospaced");
+		if (monospaced != jsonDoc.MemberEnd())
+		{
+			if (!monospaced->value.IsObject())
+			{
+				error = "'Monospaced' is not an object.";
+				return false;
+			}
+
+			// The glyph width and height, then how far across and down the texture the glyphs go.
+			auto monoData = monospaced->value.FindMember("MonoData");
+			if (monoData == monospaced->value.MemberEnd() || !monoData->value.IsArray() || monoData->value.Size() != 4)
+			{
+				error = "'MonoData' must be an array of 4 numbers.";
+				return false;
+			}
+
+			int monoDataValues[4] = { 0, 0, 0, 0 };
+			for (rapidjson::SizeType i = 0; i < 4; ++i)
+			{
+				if (!monoData->value[i].IsInt())
+				{
+					error = "'MonoData' must be an array of 4 numbers.";
+					return false;
+				}
+				monoDataValues[i] = monoData->value[i].GetInt();
+			}
+
+			defaultWidth = static_cast<float>(monoDataValues[0]);
+			defaultHeight = static_cast<float>(monoDataValues[1]);
+
+			auto nameOrder = monospaced->value.FindMember("NameOrder");
+			if (nameOrder == monospaced->value.MemberEnd() || !nameOrder->value.IsArray())
+			{
+				error = "monospaced fonts must provide a 'NameOrder' array.";
+				return false;
+			}
+
+			int x = 0;
+			int y = 0;
+			for (const auto& name : nameOrder->value.GetArray())
+			{
+				if (!name.IsString() || name.GetStringLength() == 0)
+				{
+					error = "'NameOrder' must only contain non-empty strings.";
+					return false;
+				}
+
+				if (y > monoDataValues[3])
+					break;
+
+				glyphs.WriteU32(static_cast<uint8_t>(name.GetString()[0]));
+				glyphs.WriteF32(static_cast<float>(x));
+				glyphs.WriteF32(static_cast<float>(y));
+				glyphs.WriteF32(static_cast<float>(monoDataValues[0]));
+				glyphs.WriteF32(static_cast<float>(monoDataValues[1]));
+				++glyphCount;
+
+				x += monoDataValues[0];
+				if (x >= monoDataValues[2])
+				{
+					x = 0;
+					y += monoDataValues[1];
+				}
+			}
+		}
+
+		BlobWriter payload;
+		payload.WriteU32(textureNameOffset);
+		payload.WriteU32(glyphCount);
+		payload.WriteU32(strings.GetSize());
+		payload.WriteF32(defaultWidth);
+		payload.WriteF32(defaultHeight);
+		payload.WriteU32(0);
+		payload.WriteBytes(glyphs.GetBytes());
+		payload.WriteChars(strings.GetChars());
+
+		cookedFile = WriteCookedFile(CookedFormat::Kind::kFont, CookedFormat::kFontVersion, payload);
+		return true;
+	}
+
+	enum class CookResult
+	{
+		kCooked,
+		kCopied,
+		kUpToDate,
+		kFailed
+	};
+
+	/// <summary>
+	/// Cooks or copies a single file to its place in the output directory.
+	/// </summary>
+	CookResult CookFile(const fs::path& sourcePath, const fs::path& outputPath, bool force)
+	{
+		std::error_code errorCode;
+		if (!force && fs::exists(outputPath, errorCode) && fs::last_write_time(outputPath, errorCode) >= fs::last_write_time(sourcePath, errorCode) && !errorCode)
+			return CookResult::kUpToDate;
+
+		fs::create_directories(outputPath.parent_path(), errorCode);
+
+		const std::string extension = sourcePath.extension().string();
+		if (extension != ".spsh" && extension != ".font")
+		{
+			if (!fs::copy_file(sourcePath, outputPath, fs::copy_options::overwrite_existing, errorCode))
+			{
+				std::fprintf(stderr, "Failed to copy '%s': %s\n", sourcePath.generic_string().c_str(), errorCode.message().c_str());
+				return CookResult::kFailed;
+			}
+			return CookResult::kCopied;
+		}
+
+		std::ifstream sourceFile(sourcePath, std::ios::binary);
+		const std::string jsonText((std::istreambuf_iterator<char>(sourceFile)), std::istreambuf_iterator<char>());
+
+		rapidjson::Document jsonDoc;
+		if (!sourceFile || jsonDoc.Parse(jsonText.c_str(), jsonText.size()).HasParseError() || !jsonDoc.IsObject())
+		{
+			std::fprintf(stderr, "Failed to cook '%s': it is not a JSON object.\n", sourcePath.generic_string().c_str());
+			return CookResult::kFailed;
+		}
+
+		std::vector<uint8_t> cookedFile;
+		std::string error;
+		const bool isCooked = (extension == ".spsh") ? CookSpritesheet(jsonDoc, cookedFile, error) : CookFont(jsonDoc, cookedFile, error);
+		if (!isCooked)
+		{
+			std::fprintf(stderr, "Failed to cook '%s': %s\n", sourcePath.generic_string().c_str(), error.c_str());
+			return CookResult::kFailed;
+		}
+
+		std::ofstream outputFile(outputPath, std::ios::binary | std::ios::trunc);
+		outputFile.write(reinterpret_cast<const char*>(cookedFile.data()), static_cast<std::streamsize>(cookedFile.size()));
+		if (!outputFile)
+		{
+			std::fprintf(stderr, "Failed to write '%s'.\n", outputPath.generic_string().c_str());
+			return CookResult::kFailed;
+		}
+
+		return CookResult::kCooked;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		std::printf("Usage: exeliuscooker <sourceDirectory> <outputDirectory> [--force]\n");
+		return 1;
+	}
+
+	const fs::path sourceDirectory(argv[1]);
+	const fs::path outputDirectory(argv[2]);
+	const bool force = (argc > 3 && std::strcmp(argv[3], "--force") == 0);
+
+	std::error_code errorCode;
+	if (!fs::is_directory(sourceDirectory, errorCode))
+	{
+		std::fprintf(stderr, "'%s' is not a directory.\n", sourceDirectory.generic_string().c_str());
+		return 1;
+	}
+
+	uint32_t counts[4] = { 0, 0, 0, 0 };
+	for (const auto& directoryEntry : fs::recursive_directory_iterator(sourceDirectory, errorCode))
+	{
+		if (!directoryEntry.is_regular_file(errorCode))
+			continue;
+
+		const fs::path outputPath = outputDirectory / fs::relative(directoryEntry.path(), sourceDirectory, errorCode);
+		++counts[static_cast<int>(CookFile(directoryEntry.path(), outputPath, force))];
+	}
+
+	std::printf("Cooked %u, copied %u, up to date %u, failed %u.\n",
+		counts[static_cast<int>(CookResult::kCooked)], counts[static_cast<int>(CookResult::kCopied)],
+		counts[static_cast<int>(CookResult::kUpToDate)], counts[static_cast<int>(CookResult::kFailed)]);
+
+	return counts[static_cast<int>(CookResult::kFailed)] == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,259 @@
+#include "source/utility/io/PakFormat.h"
+#include "source/utility/io/BlobWriter.h"
+#include "source/utility/string/StringHash.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+// Offline asset packer. Packs every file under a directory into a single pak, the engine's own
+// archive format described in PakFormat.h, for the resource loader to mount and load from.
+//
+// Each entry's path is the prefix followed by the file's path inside the directory. The prefix
+// defaults to the directory as given, so packing "assets" keeps the resource IDs "assets/...".
+// Pass --prefix to pack a cooked copy of the assets under their original IDs.
+//
+// Files are compressed with zlib when that saves at least an eighth of their size. Files that
+// don't compress well, like images and audio, are stored as they are, so the engine can use them
+// straight from the mapped pak. --store stores every file uncompressed.
+//
+// Usage: exeliuspacker <sourceDirectory> <outputPak> [--prefix <pathPrefix>] [--store]
+
+namespace
+{
+	namespace fs = std::filesystem;
+	using namespace Exelius;
+
+	struct PackedFile
+	{
+		fs::path m_sourcePath;
+		std::string m_entryPath;
+		PakEntry m_entry;
+	};
+
+	uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	uint32_t Checksum(const std::vector<uint8_t>& data)
+	{
+		uLong crc = crc32(0L, Z_NULL, 0);
+		size_t offset = 0;
+		while (offset < data.size())
+		{
+			const uInt chunkSize = static_cast<uInt>(std::min<size_t>(data.size() - offset, 0x40000000));
+			crc = crc32(crc, data.data() + offset, chunkSize);
+			offset += chunkSize;
+		}
+		return static_cast<uint32_t>(crc);
+	}
+
+	/// <summary>
+	/// Reads a file and works out how to store it.
+	/// </summary>
+	/// <param name="packedFile">- The file. Receives the sizes, checksum and compression of its entry.</param>
+	/// <param name="store">- True to never compress.</param>
+	/// <param name="storedBytes">- Receives the blob to write.</param>
+	/// <returns>True if the file was read.</returns>
+	bool PrepareBlob(PackedFile& packedFile, bool store, std::vector<uint8_t>& storedBytes)
+	{
+		std::ifstream sourceFile(packedFile.m_sourcePath, std::ios::binary);
+		if (!sourceFile)
+			return false;
+
+		std::vector<uint8_t> fileBytes((std::istreambuf_iterator<char>(sourceFile)), std::istreambuf_iterator<char>());
+
+		PakEntry& entry = packedFile.m_entry;
+		entry.m_size = fileBytes.size();
+		entry.m_checksum = Checksum(fileBytes);
+		entry.m_compression = PakFormat::Compression::kNone;
+
+		if (!store && !fileBytes.empty())
+		{
+			uLongf compressedSize = compressBound(static_cast<uLong>(fileBytes.size()));
+			std::vector<uint8_t> compressedBytes(compressedSize);
+			const int result = compress2(compressedBytes.data(), &compressedSize, fileBytes.data(), static_cast<uLong>(fileBytes.size()), Z_BEST_COMPRESSION);
+
+			// A file only a little smaller compressed isn't worth giving up reading it in place.
+			if (result == Z_OK && compressedSize <= fileBytes.size() - fileBytes.size() / 8)
+			{
+				compressedBytes.resize(compressedSize);
+				storedBytes = std::move(compressedBytes);
+				entry.m_compression = PakFormat::Compression::kZlib;
+				entry.m_storedSize = storedBytes.size();
+				return true;
+			}
+		}
+
+		storedBytes = std::move(fileBytes);
+		entry.m_storedSize = storedBytes.size();
+		return true;
+	}
+
+	void WritePadding(std::ofstream& outputFile, uint64_t size)
+	{
+		static const char kZeros[PakFormat::kDefaultBlobAlignment] = {};
+		while (size > 0)
+		{
+			const uint64_t chunkSize = std::min<uint64_t>(size, sizeof(kZeros));
+			outputFile.write(kZeros, static_cast<std::streamsize>(chunkSize));
+			size -= chunkSize;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		std::printf("Usage: exeliuspacker <sourceDirectory> <outputPak> [--prefix <pathPrefix>] [--store]\n");
+		return 1;
+	}
+
+	const fs::path sourceDirectory(argv[1]);
+	const fs::path outputPath(argv[2]);
+
+	std::string pathPrefix = sourceDirectory.lexically_normal().generic_string();
+	bool store = false;
+	for (int i = 3; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--store") == 0)
+			store = true;
+		else if (std::strcmp(argv[i], "--prefix") == 0 && i + 1 < argc)
+			pathPrefix = argv[++i];
+	}
+
+	if (!pathPrefix.empty() && pathPrefix.back() != '/')
+		pathPrefix.push_back('/');
+
+	std::error_code errorCode;
+	if (!fs::is_directory(sourceDirectory, errorCode))
+	{
+		std::fprintf(stderr, "'%s' is not a directory.\n", sourceDirectory.generic_string().c_str());
+		return 1;
+	}
+
+	std::vector<PackedFile> packedFiles;
+	for (const auto& directoryEntry : fs::recursive_directory_iterator(sourceDirectory, errorCode))
+	{
+		if (!directoryEntry.is_regular_file(errorCode))
+			continue;
+
+		PackedFile packedFile;
+		packedFile.m_sourcePath = directoryEntry.path();
+		packedFile.m_entryPath = pathPrefix + fs::relative(directoryEntry.path(), sourceDirectory, errorCode).generic_string();
+		std::memset(&packedFile.m_entry, 0, sizeof(packedFile.m_entry));
+		packedFile.m_entry.m_pathHash = StringHash::HashString64(packedFile.m_entryPath.c_str());
+		packedFiles.emplace_back(std::move(packedFile));
+	}
+
+	// Blobs are written in path order, so files in the same directory end up next to each other.
+	std::sort(packedFiles.begin(), packedFiles.end(), [](const PackedFile& left, const PackedFile& right) { return left.m_entryPath < right.m_entryPath; });
+
+	// The engine finds entries by hash alone, so two paths can't share one.
+	std::unordered_map<uint64_t, const std::string*> pathsByHash;
+	std::vector<char> pathTable;
+	for (PackedFile& packedFile : packedFiles)
+	{
+		auto [pathIterator, isNewHash] = pathsByHash.try_emplace(packedFile.m_entry.m_pathHash, &packedFile.m_entryPath);
+		if (!isNewHash)
+		{
+			std::fprintf(stderr, "'%s' and '%s' have the same path hash. Rename one of them.\n", pathIterator->second->c_str(), packedFile.m_entryPath.c_str());
+			return 1;
+		}
+
+		packedFile.m_entry.m_pathOffset = static_cast<uint32_t>(pathTable.size());
+		packedFile.m_entry.m_pathLength = static_cast<uint32_t>(packedFile.m_entryPath.size());
+		pathTable.insert(pathTable.end(), packedFile.m_entryPath.begin(), packedFile.m_entryPath.end());
+		pathTable.push_back('\0');
+	}
+
+	std::ofstream outputFile(outputPath, std::ios::binary | std::ios::trunc);
+	if (!outputFile)
+	{
+		std::fprintf(stderr, "Failed to create '%s'.\n", outputPath.generic_string().c_str());
+		return 1;
+	}
+
+	const uint64_t blobAlignment = PakFormat::kDefaultBlobAlignment;
+	const uint64_t tableOfContentsSize = sizeof(PakHeader) + packedFiles.size() * sizeof(PakEntry) + pathTable.size();
+
+	// The table of contents is written last, once every blob's place and size is known.
+	uint64_t archiveSize = AlignUp(tableOfContentsSize, blobAlignment);
+	WritePadding(outputFile, archiveSize);
+
+	uint64_t totalSize = 0;
+	uint32_t compressedCount = 0;
+	std::vector<uint8_t> storedBytes;
+	for (PackedFile& packedFile : packedFiles)
+	{
+		if (!PrepareBlob(packedFile, store, storedBytes))
+		{
+			std::fprintf(stderr, "Failed to read '%s'.\n", packedFile.m_sourcePath.generic_string().c_str());
+			return 1;
+		}
+
+		const uint64_t blobOffset = AlignUp(archiveSize, blobAlignment);
+		WritePadding(outputFile, blobOffset - archiveSize);
+		outputFile.write(reinterpret_cast<const char*>(storedBytes.data()), static_cast<std::streamsize>(storedBytes.size()));
+
+		packedFile.m_entry.m_offset = blobOffset;
+		archiveSize = blobOffset + storedBytes.size();
+
+		totalSize += packedFile.m_entry.m_size;
+		if (packedFile.m_entry.m_compression != PakFormat::Compression::kNone)
+			++compressedCount;
+	}
+
+	std::sort(packedFiles.begin(), packedFiles.end(), [](const PackedFile& left, const PackedFile& right) { return left.m_entry.m_pathHash < right.m_entry.m_pathHash; });
+
+	BlobWriter tableOfContents;
+	tableOfContents.WriteU32(PakFormat::kMagic);
+	tableOfContents.WriteU16(PakFormat::kVersion);
+	tableOfContents.WriteU16(0);
+	tableOfContents.WriteU32(static_cast<uint32_t>(packedFiles.size()));
+	tableOfContents.WriteU32(static_cast<uint32_t>(blobAlignment));
+	tableOfContents.WriteU64(pathTable.size());
+	tableOfContents.WriteU64(archiveSize);
+
+	for (const PackedFile& packedFile : packedFiles)
+	{
+		const PakEntry& entry = packedFile.m_entry;
+		tableOfContents.WriteU64(entry.m_pathHash);
+		tableOfContents.WriteU64(entry.m_offset);
+		tableOfContents.WriteU64(entry.m_storedSize);
+		tableOfContents.WriteU64(entry.m_size);
+		tableOfContents.WriteU32(entry.m_checksum);
+		tableOfContents.WriteU16(static_cast<uint16_t>(entry.m_compression));
+		tableOfContents.WriteU16(0);
+		tableOfContents.WriteU32(entry.m_pathOffset);
+		tableOfContents.WriteU32(entry.m_pathLength);
+	}
+	tableOfContents.WriteChars(pathTable);
+
+	outputFile.seekp(0);
+	outputFile.write(reinterpret_cast<const char*>(tableOfContents.GetBytes().data()), static_cast<std::streamsize>(tableOfContents.GetSize()));
+	outputFile.close();
+	if (!outputFile)
+	{
+		std::fprintf(stderr, "Failed to write '%s'.\n", outputPath.generic_string().c_str());
+		return 1;
+	}
+
+	std::printf("Packed %zu files (%zu compressed), %llu bytes into %llu.\n",
+		packedFiles.size(), static_cast<size_t>(compressedCount),
+		static_cast<unsigned long long>(totalSize), static_cast<unsigned long long>(archiveSize));
+
+	return 0;
+}
\ No newline at end of file